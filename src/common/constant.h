@@ -70,6 +70,8 @@ class Constant {
   inline static const std::string kStoreRegionMetaPrefix = "META_REGION";
   // Define store raft prefix.
   inline static const std::string kStoreRaftMetaPrefix = "META_RAFT";
+  // Define txn gc safe point key.
+  inline static const std::string kTxnGcSafePointKey = "META_TXN_GC_SAFE_POINT";
   // Define store region metrics prefix.
   inline static const std::string kStoreRegionMetricsPrefix = "METRICS_REGION";
   // Define region controller prefix.
@@ -99,8 +101,6 @@ class Constant {
 
   inline static const std::string kBlockSize = "block_size";
   inline static const std::string kBlockSizeDefaultValue = "131072";  // 128KB
-  inline static const std::string kBlockCache = "block_cache";
-  inline static const std::string kBlockCacheDefaultValue = "1073741824";  // 1GB
   inline static const std::string kArenaBlockSize = "arena_block_size";
   inline static const std::string kArenaBlockSizeDefaultValue = "67108864";  // 64MB
   inline static const std::string kMinWriteBufferNumberToMerge = "min_write_buffer_number_to_merge";
@@ -119,6 +119,24 @@ class Constant {
   inline static const std::string kTargetFileSizeBaseDefaultValue = "67108864";  // 64MB
   inline static const std::string kMaxBytesForLevelMultiplier = "max_bytes_for_level_multiplier";
   inline static const std::string kMaxBytesForLevelMultiplierDefaultValue = "10";
+  // blob files, the large values are kept out of the lsm tree
+  inline static const std::string kEnableBlobFiles = "enable_blob_files";
+  inline static const std::string kEnableBlobFilesDefaultValue = "false";
+  inline static const std::string kMinBlobSize = "min_blob_size";
+  inline static const std::string kMinBlobSizeDefaultValue = "1024";  // 1KB
+  inline static const std::string kBlobFileSize = "blob_file_size";
+  inline static const std::string kBlobFileSizeDefaultValue = "268435456";  // 256MB
+  inline static const std::string kEnableBlobGarbageCollection = "enable_blob_garbage_collection";
+  inline static const std::string kEnableBlobGarbageCollectionDefaultValue = "true";
+  inline static const std::string kBlobGarbageCollectionAgeCutoff = "blob_garbage_collection_age_cutoff";
+  inline static const std::string kBlobGarbageCollectionAgeCutoffDefaultValue = "0.25";
+
+  // block cache shared by all column families
+  inline static const std::string kBlockCacheSize = "store.block_cache_size";
+  static const int64_t kBlockCacheSizeDefaultValue = 4294967296;  // 4GB
+  inline static const std::string kBlockCacheType = "store.block_cache_type";
+  inline static const std::string kBlockCacheTypeLRU = "lru";
+  inline static const std::string kBlockCacheTypeHyperClock = "hyper_clock";
 
   static const int kRocksdbBackgroundThreadNumDefault = 16;
   static const int kStatsDumpPeriodSecDefault = 600;
@@ -129,6 +147,8 @@ class Constant {
   inline static const std::string kStoreScanMaxBytesRpc = "max_bytes_rpc";
   inline static const std::string kStoreScanMaxFetchCntByServer = "max_fetch_cnt_by_server";
   inline static const std::string kStoreScanScanIntervalS = "scan_interval_s";
+  inline static const std::string kStoreScanMaxPrefetchBytes = "max_prefetch_bytes";
+  inline static const std::string kStoreScanMaxParallelism = "max_parallelism";
 
   inline static const std::string kMetaRegionName = "0-META";
   inline static const std::string kKvRegionName = "1-KV";
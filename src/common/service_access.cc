@@ -221,6 +221,36 @@ butil::Status ServiceAccess::GetVectorIndexSnapshot(const pb::node::GetVectorInd
   return butil::Status();
 }
 
+butil::Status ServiceAccess::GetVectorImportFiles(const pb::node::GetVectorImportFilesRequest& request,
+                                                  const butil::EndPoint& endpoint,
+                                                  pb::node::GetVectorImportFilesResponse& response) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToStr(endpoint).c_str());
+  }
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(6000);
+  pb::node::NodeService_Stub stub(channel.get());
+
+  stub.GetVectorImportFiles(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    DINGO_LOG(ERROR) << fmt::format("Send GetVectorImportFiles request failed, error {}", cntl.ErrorText());
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+
+  if (response.error().errcode() != pb::error::OK) {
+    if (response.error().errcode() != pb::error::EFILE_NOT_FOUND_READER) {
+      DINGO_LOG(ERROR) << fmt::format("GetVectorImportFiles response failed, error {} {}",
+                                      static_cast<int>(response.error().errcode()), response.error().errmsg());
+    }
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  return butil::Status();
+}
+
 butil::Status ServiceAccess::CheckVectorIndex(const pb::node::CheckVectorIndexRequest& request,
                                               const butil::EndPoint& endpoint,
                                               pb::node::CheckVectorIndexResponse& response) {
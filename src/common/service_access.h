@@ -63,6 +63,9 @@ class ServiceAccess {
   static butil::Status GetVectorIndexSnapshot(const pb::node::GetVectorIndexSnapshotRequest& request,
                                               const butil::EndPoint& endpoint,
                                               pb::node::GetVectorIndexSnapshotResponse& response);
+  static butil::Status GetVectorImportFiles(const pb::node::GetVectorImportFilesRequest& request,
+                                            const butil::EndPoint& endpoint,
+                                            pb::node::GetVectorImportFilesResponse& response);
 
   static butil::Status CheckVectorIndex(const pb::node::CheckVectorIndexRequest& request,
                                         const butil::EndPoint& endpoint, pb::node::CheckVectorIndexResponse& response);
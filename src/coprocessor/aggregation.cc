@@ -20,6 +20,7 @@
 #include <optional>
 #include <string>
 #include <type_traits>
+#include <variant>
 
 #include "common/logging.h"
 #include "fmt/core.h"
@@ -27,18 +28,17 @@
 
 namespace dingodb {
 
-Aggregation::Aggregation() = default;
+Aggregation::Aggregation() : group_size_(0) {}
 Aggregation::~Aggregation() { Close(); }
 
 butil::Status Aggregation::Open(
     size_t start_aggregation_operators_index,
     const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
     const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators) {
-  butil::Status status;
+  types_.clear();
+  zero_initials_.clear();
+  group_size_ = 0;
 
-  result_record_ = std::make_shared<std::vector<std::any>>();
-
-  result_record_->reserve((*result_serial_schemas).size() - start_aggregation_operators_index);
   size_t j = 0;
   for (size_t i = start_aggregation_operators_index;
        i < result_serial_schemas->size() && j < aggregation_operators.size(); i++, j++) {
@@ -46,84 +46,115 @@ butil::Status Aggregation::Open(
     auto oper = aggregation_operators[j].oper();
 
     switch (type) {
-      case BaseSchema::Type::kBool: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<bool>(false));
-        } else {
-          result_record_->emplace_back(std::optional<bool>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kInteger: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<int32_t>(0));
-        } else {
-          result_record_->emplace_back(std::optional<int32_t>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kFloat: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<float>(0.0f));
-        } else {
-          result_record_->emplace_back(std::optional<float>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kLong: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<int64_t>(0));
-        } else {
-          result_record_->emplace_back(std::optional<int64_t>(std::nullopt));
-        }
+      case BaseSchema::Type::kBool:
+      case BaseSchema::Type::kInteger:
+      case BaseSchema::Type::kFloat:
+      case BaseSchema::Type::kLong:
+      case BaseSchema::Type::kDouble:
+      case BaseSchema::Type::kString:
         break;
-      }
-      case BaseSchema::Type::kDouble: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<double>(0.0));
-        } else {
-          result_record_->emplace_back(std::optional<double>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kString: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>()));
-        } else {
-          result_record_->emplace_back(std::optional<std::shared_ptr<std::string>>(std::nullopt));
-        }
-        break;
-      }
       default: {
         std::string error_message = fmt::format("unsupported serial_schema1 type: {}", static_cast<int>(type));
         DINGO_LOG(ERROR) << error_message;
         return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
       }
     }
+
+    types_.push_back(type);
+    zero_initials_.push_back(pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper ||
+                             pb::store::SUM0 == oper);
+  }
+
+  states_.clear();
+  states_.resize(types_.size());
+  for (size_t i = 0; i < types_.size(); i++) {
+    auto status = ColumnBatch::CreateColumn(types_[i], states_[i]);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return butil::Status();
 }
 
-butil::Status Aggregation::Execute(
-    const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
-    const std::vector<std::any>& group_by_operator_record) {
-  bool ret = false;
-  for (size_t i = 0; i < group_by_operator_record.size(); i++) {
-    ret = aggregation_functions[i](group_by_operator_record[i], &(*result_record_)[i]);
-    if (!ret) {
-      std::string error_message = fmt::format("Execute failed index :  {}", i);
-      DINGO_LOG(ERROR) << error_message;
-      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-    }
+void Aggregation::AddGroup() {
+  for (size_t i = 0; i < states_.size(); i++) {
+    bool zero_initial = zero_initials_[i];
+    std::visit(
+        [zero_initial](auto& state) {
+          using StateType = std::decay_t<decltype(state)>;
+          if constexpr (!std::is_same_v<StateType, std::vector<std::any>>) {
+            using ValueType = typename std::decay_t<decltype(state.values)>::value_type;
+            if (!zero_initial) {
+              state.Append(std::optional<ValueType>(std::nullopt));
+            } else if constexpr (std::is_same_v<ValueType, std::shared_ptr<std::string>>) {
+              state.Append(std::optional<ValueType>(std::make_shared<std::string>()));
+            } else {
+              state.Append(std::optional<ValueType>(ValueType()));
+            }
+          }
+        },
+        states_[i]);
   }
-  return butil::Status();
+  group_size_++;
 }
 
-void Aggregation::Close() {
-  if (result_record_) {
-    result_record_.reset();
+void Aggregation::GetResult(uint32_t group, std::vector<std::any>& result) const {
+  result.resize(states_.size());
+  for (size_t i = 0; i < states_.size(); i++) {
+    result[i] = std::visit(
+        [group](const auto& state) -> std::any {
+          using StateType = std::decay_t<decltype(state)>;
+          if constexpr (std::is_same_v<StateType, std::vector<std::any>>) {
+            return state[group];
+          } else {
+            return state.GetValue(group);
+          }
+        },
+        states_[i]);
+  }
+}
+
+size_t Aggregation::MemoryUsage() const {
+  size_t memory_usage = 0;
+  for (const auto& state : states_) {
+    memory_usage += std::visit(
+        [](const auto& state) -> size_t {
+          using StateType = std::decay_t<decltype(state)>;
+          if constexpr (std::is_same_v<StateType, std::vector<std::any>>) {
+            return state.capacity() * sizeof(std::any);
+          } else {
+            using ValueType = typename std::decay_t<decltype(state.values)>::value_type;
+            size_t value_size = sizeof(ValueType);
+            if constexpr (std::is_same_v<ValueType, std::shared_ptr<std::string>>) {
+              value_size += sizeof(std::string);
+            }
+            return state.values.capacity() * value_size + state.nulls.capacity() / 8;
+          }
+        },
+        state);
+  }
+  return memory_usage;
+}
+
+void Aggregation::Clear() {
+  for (auto& state : states_) {
+    std::visit(
+        [](auto& state) {
+          using StateType = std::decay_t<decltype(state)>;
+          // release memory, Clear is called when states are spilled.
+          state = StateType();
+        },
+        state);
   }
+  group_size_ = 0;
+}
+
+void Aggregation::Close() {
+  types_.clear();
+  zero_initials_.clear();
+  states_.clear();
+  group_size_ = 0;
 }
 
 }  // namespace dingodb
@@ -18,15 +18,17 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
-#include <functional>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "butil/status.h"
+#include "coprocessor/column_batch.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+// Aggregation states of all groups, one typed column per aggregation operator, the row is group index.
 class Aggregation {
  public:
   Aggregation();
@@ -42,15 +44,33 @@ class Aggregation {
       const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
       const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators);
 
-  butil::Status Execute(const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
-                        const std::vector<std::any>& group_by_operator_record);
+  // Append initial states of a new group.
+  void AddGroup();
 
-  const std::shared_ptr<std::vector<std::any>>& GetResult() const { return result_record_; }
+  size_t GroupSize() const { return group_size_; }
+
+  const std::vector<BaseSchema::Type>& GetTypes() const { return types_; }
+
+
+  ColumnBatch::Column& GetState(size_t i) { return states_[i]; }
+
+  // Result of a group, std::optional<T> of result type per aggregation operator.
+  void GetResult(uint32_t group, std::vector<std::any>& result) const;
+
+  // Approximate memory of the states, string content is not counted.
+  size_t MemoryUsage() const;
+
+  // Remove all groups, the operators are kept.
+  void Clear();
 
   void Close();
 
  private:
-  std::shared_ptr<std::vector<std::any>> result_record_;
+  std::vector<BaseSchema::Type> types_;
+  // COUNT/COUNTWITHNULL/SUM0 start from zero, others start from null.
+  std::vector<bool> zero_initials_;
+  std::vector<ColumnBatch::Column> states_;
+  size_t group_size_;
 };
 
 }  // namespace dingodb
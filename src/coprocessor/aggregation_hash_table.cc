@@ -0,0 +1,117 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coprocessor/aggregation_hash_table.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace dingodb {
+
+static size_t RoundUpPowerOfTwo(size_t n) {
+  size_t capacity = 16;
+  while (capacity < n) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+AggregationHashTable::AggregationHashTable(size_t capacity)
+    : initial_capacity_(RoundUpPowerOfTwo(capacity)), key_bytes_(0) {
+  slots_.resize(initial_capacity_, Slot{0, kEmptySlot});
+  mask_ = initial_capacity_ - 1;
+}
+
+uint32_t AggregationHashTable::FindOrInsert(std::string_view key, bool& inserted) {
+  uint64_t hash = std::hash<std::string_view>{}(key);
+
+  size_t pos = hash & mask_;
+  for (;;) {
+    Slot& slot = slots_[pos];
+    if (slot.group == kEmptySlot) {
+      break;
+    }
+    if (slot.hash == hash && keys_[slot.group] == key) {
+      inserted = false;
+      return slot.group;
+    }
+    pos = (pos + 1) & mask_;
+  }
+
+  uint32_t group = keys_.size();
+  keys_.emplace_back(key);
+  key_bytes_ += key.size();
+  slots_[pos] = Slot{hash, group};
+  inserted = true;
+
+  // keep load factor under 0.5, probe sequence is short.
+  if (keys_.size() * 2 > slots_.size()) {
+    Grow();
+  }
+
+  return group;
+}
+
+void AggregationHashTable::Grow() {
+  std::vector<Slot> old_slots;
+  old_slots.swap(slots_);
+
+  slots_.resize(old_slots.size() * 2, Slot{0, kEmptySlot});
+  mask_ = slots_.size() - 1;
+
+  for (const auto& slot : old_slots) {
+    if (slot.group == kEmptySlot) {
+      continue;
+    }
+
+    size_t pos = slot.hash & mask_;
+    while (slots_[pos].group != kEmptySlot) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = slot;
+  }
+}
+
+size_t AggregationHashTable::MemoryUsage() const {
+  return slots_.size() * sizeof(Slot) + keys_.capacity() * sizeof(std::string) + key_bytes_;
+}
+
+void AggregationHashTable::Clear() {
+  if (slots_.size() == initial_capacity_ && keys_.size() * kSparseClearRatio < slots_.size()) {
+    // streaming aggregation clears a few groups very often, only reset the used slots.
+    std::vector<size_t> positions;
+    positions.reserve(keys_.size());
+    for (uint32_t group = 0; group < keys_.size(); group++) {
+      size_t pos = std::hash<std::string_view>{}(keys_[group]) & mask_;
+      while (slots_[pos].group != group) {
+        pos = (pos + 1) & mask_;
+      }
+      positions.push_back(pos);
+    }
+    for (auto pos : positions) {
+      slots_[pos] = Slot{0, kEmptySlot};
+    }
+    keys_.clear();
+    key_bytes_ = 0;
+    return;
+  }
+
+  // release memory of the grown table, back to initial capacity.
+  std::vector<Slot>(initial_capacity_, Slot{0, kEmptySlot}).swap(slots_);
+  mask_ = initial_capacity_ - 1;
+  std::vector<std::string>().swap(keys_);
+  key_bytes_ = 0;
+}
+
+}  // namespace dingodb
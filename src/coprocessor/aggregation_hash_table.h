@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COPROCESSOR_AGGREGATION_HASH_TABLE_H_  // NOLINT
+#define DINGODB_COPROCESSOR_AGGREGATION_HASH_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dingodb {
+
+// Map encoded group by key to a dense group index [0, Size()), open addressing with linear probing.
+// The aggregation states are stored in arrays indexed by group index, group index is assigned by insertion order.
+class AggregationHashTable {
+ public:
+  explicit AggregationHashTable(size_t capacity = kDefaultCapacity);
+  ~AggregationHashTable() = default;
+
+  AggregationHashTable(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable& operator=(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable(AggregationHashTable&& rhs) = delete;
+  AggregationHashTable& operator=(AggregationHashTable&& rhs) = delete;
+
+  // Return group index of key, insert a new group if not exist.
+  uint32_t FindOrInsert(std::string_view key, bool& inserted);
+
+  size_t Size() const { return keys_.size(); }
+
+  const std::string& GetKey(uint32_t group) const { return keys_[group]; }
+
+  // Approximate memory of keys and slots.
+  size_t MemoryUsage() const;
+
+  // Remove all groups and release memory.
+  void Clear();
+
+ private:
+  static constexpr size_t kDefaultCapacity = 1024;
+  static constexpr uint32_t kEmptySlot = UINT32_MAX;
+  // Clear resets slot by slot when groups are less than 1/kSparseClearRatio of slots.
+  static constexpr size_t kSparseClearRatio = 8;
+
+  struct Slot {
+    uint64_t hash;
+    uint32_t group;
+  };
+
+  void Grow();
+
+  size_t initial_capacity_;
+  std::vector<Slot> slots_;
+  size_t mask_;
+  std::vector<std::string> keys_;
+  size_t key_bytes_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_AGGREGATION_HASH_TABLE_H_  // NOLINT
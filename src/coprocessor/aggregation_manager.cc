@@ -14,147 +14,154 @@
 
 #include "coprocessor/aggregation_manager.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <exception>
+#include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <variant>
 
 #include "common/logging.h"
+#include "config/config_manager.h"
+#include "coprocessor/column_batch.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+DEFINE_bool(coprocessor_aggregation_sorted_output, false, "coprocessor aggregation output sorted by group by key");
+DEFINE_int64(coprocessor_aggregation_memory_limit, 256 * 1024 * 1024,
+             "coprocessor aggregation memory quota of one request, groups spill to disk when exceeded, 0 is no limit");
+DEFINE_string(coprocessor_aggregation_spill_path, "",
+              "coprocessor aggregation spill path, default is aggregation_spill under store path");
+
+// Aggregation operator, Update aggregate a non null param(or any param if kWithNull) to the state of group.
+// MergeType aggregate a partial result of the operator, used to merge spilled states.
 template <typename PARAM, typename RESULT>
 struct SUM {
-  bool operator()(const std::any& param, std::any* result) {
-    static_assert(
-        !(std::is_same_v<std::string, PARAM> || std::is_same_v<std::string, RESULT> ||
-          std::is_same_v<std::shared_ptr<std::string>, PARAM> || std::is_same_v<std::shared_ptr<std::string>, RESULT>),
-        "SUM : unsupported shared_ptr<std::string> or std::string");
-
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        result_value = param_value;
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        result_value.value() += param_value.value();
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("SUM<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
+  static_assert(
+      !(std::is_same_v<std::string, PARAM> || std::is_same_v<std::string, RESULT> ||
+        std::is_same_v<std::shared_ptr<std::string>, PARAM> || std::is_same_v<std::shared_ptr<std::string>, RESULT>),
+      "SUM : unsupported shared_ptr<std::string> or std::string");
+
+  using ParamType = PARAM;
+  using ResultType = RESULT;
+  using MergeType = SUM<RESULT, RESULT>;
+  static constexpr bool kWithNull = false;
+
+  static void Update(ColumnVector<RESULT>& state, uint32_t group, const PARAM& param) {
+    if (state.nulls[group]) {
+      state.values[group] = param;
+      state.nulls[group] = false;
+    } else {
+      state.values[group] = state.values[group] + param;
     }
-
-    return true;
   }
 };
 
 template <typename PARAM, typename RESULT>
 struct COUNT {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        result_value = 1;
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        result_value.value() += 1;
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("COUNT<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
+  using ParamType = PARAM;
+  using ResultType = RESULT;
+  using MergeType = SUM<RESULT, RESULT>;
+  static constexpr bool kWithNull = false;
+
+  static void Update(ColumnVector<RESULT>& state, uint32_t group, [[maybe_unused]] const PARAM& param) {
+    if (state.nulls[group]) {
+      state.values[group] = 1;
+      state.nulls[group] = false;
+    } else {
+      state.values[group] = state.values[group] + 1;
     }
-
-    return true;
   }
 };
 
 template <typename PARAM, typename RESULT>
 struct COUNTWITHNULL {
-  bool operator()([[maybe_unused]] const std::any& param, std::any* result) {
-    try {
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
+  using ParamType = PARAM;
+  using ResultType = RESULT;
+  using MergeType = SUM<RESULT, RESULT>;
+  static constexpr bool kWithNull = true;
 
-      if (!result_value.has_value()) {
-        result_value = 1;
-      } else {
-        result_value.value() += 1;
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("COUNTWITHNULL<{},{}> exception : {}", typeid(PARAM).name(),
-                                      typeid(RESULT).name(), my_exception.what());
-      return false;
-    }
-
-    return true;
+  static void Update(ColumnVector<RESULT>& state, uint32_t group, [[maybe_unused]] const PARAM& param) {
+    COUNT<PARAM, RESULT>::Update(state, group, param);
   }
 };
 
 template <typename PARAM, typename RESULT>
 struct MAX {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
+  static_assert(std::is_same_v<PARAM, RESULT>, "MAX : param type must be same as result type");
+
+  using ParamType = PARAM;
+  using ResultType = RESULT;
+  using MergeType = MAX<RESULT, RESULT>;
+  static constexpr bool kWithNull = false;
+
+  static void Update(ColumnVector<RESULT>& state, uint32_t group, const PARAM& param) {
+    bool greater = false;
+    if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM>) {
+      greater = state.nulls[group] || *(state.values[group]) < *param;
+    } else {
+      greater = state.nulls[group] || state.values[group] < param;
+    }
 
-      if (param_value.has_value() && !result_value.has_value()) {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value = *(param_value.value());
+    if (greater) {
+      state.values[group] = param;
+      state.nulls[group] = false;
+    }
+  }
+};
 
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value.value() = std::make_shared<std::string>(param_value);
+template <typename PARAM, typename RESULT>
+struct MIN {
+  static_assert(std::is_same_v<PARAM, RESULT>, "MIN : param type must be same as result type");
+
+  using ParamType = PARAM;
+  using ResultType = RESULT;
+  using MergeType = MIN<RESULT, RESULT>;
+  static constexpr bool kWithNull = false;
+
+  static void Update(ColumnVector<RESULT>& state, uint32_t group, const PARAM& param) {
+    bool less = false;
+    if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM>) {
+      less = state.nulls[group] || *(state.values[group]) > *param;
+    } else {
+      less = state.nulls[group] || state.values[group] > param;
+    }
 
-        } else {
-          result_value = param_value;
-        }
+    if (less) {
+      state.values[group] = param;
+      state.nulls[group] = false;
+    }
+  }
+};
+
+template <typename OPER>
+struct RowAggregation {
+  using PARAM = typename OPER::ParamType;
+  using RESULT = typename OPER::ResultType;
 
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
+  bool operator()(const std::any& param, ColumnBatch::Column& state, uint32_t group) {
+    try {
+      auto& state_vector = std::get<ColumnVector<RESULT>>(state);
+      if constexpr (OPER::kWithNull) {
+        OPER::Update(state_vector, group, PARAM());
       } else {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (result_value.value() < *(param_value.value())) {
-            result_value = *(param_value.value());
-          }
-        } else if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) < *(param_value.value())) {
-            result_value = param_value;
-          }
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) < param_value.value()) {
-            *(result_value.value()) = param_value;
-          }
-        } else {
-          if (result_value.value() < param_value.value()) {
-            result_value = param_value;
-          }
+        const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
+        if (param_value.has_value()) {
+          OPER::Update(state_vector, group, param_value.value());
         }
       }
     } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("MAX<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
+      DINGO_LOG(ERROR) << fmt::format("RowAggregation<{}> exception : {}", typeid(OPER).name(), my_exception.what());
       return false;
     }
 
@@ -162,55 +169,30 @@ struct MAX {
   }
 };
 
-template <typename PARAM, typename RESULT>
-struct MIN {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
+template <typename OPER>
+struct BatchAggregation {
+  using PARAM = typename OPER::ParamType;
+  using RESULT = typename OPER::ResultType;
 
-      if (param_value.has_value() && !result_value.has_value()) {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value = *(param_value.value());
-
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value.value() = std::make_shared<std::string>(param_value);
-
-        } else {
-          result_value = param_value;
+  bool operator()(const ColumnBatch::Column& column, const std::vector<uint32_t>& rows,
+                  const std::vector<uint32_t>& groups, ColumnBatch::Column& state) {
+    try {
+      auto& state_vector = std::get<ColumnVector<RESULT>>(state);
+      if constexpr (OPER::kWithNull) {
+        for (auto group : groups) {
+          OPER::Update(state_vector, group, PARAM());
         }
-
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
       } else {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (result_value.value() > *(param_value.value())) {
-            result_value = *(param_value.value());
-          }
-        } else if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) > *(param_value.value())) {
-            result_value = param_value;
-          }
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) > param_value.value()) {
-            *(result_value.value()) = param_value;
-          }
-        } else {
-          if (result_value.value() > param_value.value()) {
-            result_value = param_value;
+        const auto& column_vector = std::get<ColumnVector<PARAM>>(column);
+        for (size_t i = 0; i < rows.size(); i++) {
+          if (column_vector.IsNull(rows[i])) {
+            continue;
           }
+          OPER::Update(state_vector, groups[i], column_vector.values[rows[i]]);
         }
       }
     } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("MIN<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
+      DINGO_LOG(ERROR) << fmt::format("BatchAggregation<{}> exception : {}", typeid(OPER).name(), my_exception.what());
       return false;
     }
 
@@ -218,7 +200,101 @@ struct MIN {
   }
 };
 
-AggregationManager::AggregationManager() = default;
+template <typename OPER>
+static void AddAggregationFunction(std::vector<AggregationFunction>& aggregation_functions,
+                                   std::vector<BatchAggregationFunction>& batch_aggregation_functions,
+                                   std::vector<AggregationFunction>& merge_functions) {
+  aggregation_functions.emplace_back(RowAggregation<OPER>());
+  batch_aggregation_functions.emplace_back(BatchAggregation<OPER>());
+  merge_functions.emplace_back(RowAggregation<typename OPER::MergeType>());
+}
+
+HashAggregationIterator::HashAggregationIterator(const std::shared_ptr<AggregationHashTable>& hash_table,
+                                                 const std::shared_ptr<Aggregation>& aggregation, bool sorted)
+    : hash_table_(hash_table), aggregation_(aggregation), pos_(0) {
+  groups_.resize(hash_table_->Size());
+  for (uint32_t i = 0; i < groups_.size(); i++) {
+    groups_[i] = i;
+  }
+
+  if (sorted) {
+    std::sort(groups_.begin(), groups_.end(),
+              [this](uint32_t lhs, uint32_t rhs) { return hash_table_->GetKey(lhs) < hash_table_->GetKey(rhs); });
+  }
+}
+
+const std::shared_ptr<std::vector<std::any>>& HashAggregationIterator::GetValue() const {
+  if (!value_) {
+    value_ = std::make_shared<std::vector<std::any>>();
+  }
+  aggregation_->GetResult(groups_[pos_], *value_);
+  return value_;
+}
+
+SpillAggregationIterator::SpillAggregationIterator(std::vector<std::shared_ptr<AggregationSpillReader>> readers,
+                                                   const std::shared_ptr<Aggregation>& merge_aggregation,
+                                                   const std::vector<AggregationFunction>& merge_functions)
+    : readers_(std::move(readers)),
+      merge_aggregation_(merge_aggregation),
+      merge_functions_(merge_functions),
+      has_value_(false),
+      value_(std::make_shared<std::vector<std::any>>()) {
+  for (size_t i = 0; i < readers_.size(); i++) {
+    if (readers_[i]->Valid()) {
+      heap_.push_back(i);
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), [this](size_t lhs, size_t rhs) {
+    return readers_[lhs]->Key() > readers_[rhs]->Key();
+  });
+
+  Merge();
+}
+
+void SpillAggregationIterator::Merge() {
+  auto greater = [this](size_t lhs, size_t rhs) { return readers_[lhs]->Key() > readers_[rhs]->Key(); };
+
+  has_value_ = false;
+  if (heap_.empty() || !status_.ok()) {
+    return;
+  }
+
+  key_ = readers_[heap_.front()]->Key();
+  merge_aggregation_->Clear();
+  merge_aggregation_->AddGroup();
+
+  while (!heap_.empty() && readers_[heap_.front()]->Key() == key_) {
+    std::pop_heap(heap_.begin(), heap_.end(), greater);
+    size_t index = heap_.back();
+    heap_.pop_back();
+
+    auto& reader = readers_[index];
+    const auto& values = reader->Values();
+    for (size_t i = 0; i < merge_functions_.size(); i++) {
+      bool ret = merge_functions_[i](values[i], merge_aggregation_->GetState(i), 0);
+      if (!ret) {
+        std::string error_message = fmt::format("merge spilled state failed index :  {}", i);
+        DINGO_LOG(ERROR) << error_message;
+        status_ = butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+        return;
+      }
+    }
+
+    status_ = reader->Next();
+    if (!status_.ok()) {
+      return;
+    }
+    if (reader->Valid()) {
+      heap_.push_back(index);
+      std::push_heap(heap_.begin(), heap_.end(), greater);
+    }
+  }
+
+  merge_aggregation_->GetResult(0, *value_);
+  has_value_ = true;
+}
+
+AggregationManager::AggregationManager() : start_aggregation_operators_index_(0), memory_limit_(0) {}
 AggregationManager::~AggregationManager() { Close(); }
 
 butil::Status AggregationManager::Open(
@@ -231,9 +307,13 @@ butil::Status AggregationManager::Open(
   result_serial_schemas_ = result_serial_schemas;
 
   size_t start_aggregation_operators_index = result_serial_schemas->size() - aggregation_operators.size();
+  start_aggregation_operators_index_ = start_aggregation_operators_index;
+  memory_limit_ = FLAGS_coprocessor_aggregation_memory_limit;
 
   size_t i = 0;
   aggregation_functions_.reserve(aggregation_operators.size());
+  batch_aggregation_functions_.reserve(aggregation_operators.size());
+  merge_functions_.reserve(aggregation_operators.size());
   for (const auto& aggregation_operator : aggregation_operators) {
     int32_t index = aggregation_operator.index_of_column();
     const auto& oper = aggregation_operator.oper();
@@ -314,43 +394,214 @@ butil::Status AggregationManager::Open(
     i++;
   }
 
+  hash_table_ = std::make_shared<AggregationHashTable>();
+  aggregation_ = std::make_shared<Aggregation>();
+  status = aggregation_->Open(start_aggregation_operators_index, result_serial_schemas_, aggregation_operators_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
+    return status;
+  }
+
   return butil::Status();
 }
 
 butil::Status AggregationManager::Execute(const std::string& group_by_key,
                                           const std::vector<std::any>& group_by_operator_record) {
-  butil::Status status;
-  std::shared_ptr<Aggregation> aggregation;
+  uint32_t group = FindOrInsertGroup(group_by_key);
+
+  for (size_t i = 0; i < group_by_operator_record.size(); i++) {
+    bool ret = aggregation_functions_[i](group_by_operator_record[i], aggregation_->GetState(i), group);
+    if (!ret) {
+      std::string error_message = fmt::format("Execute failed index :  {}", i);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
 
-  if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+  return CheckMemoryLimit();
+}
+
+butil::Status AggregationManager::ExecuteBatch(const std::vector<std::string>& group_by_keys, const ColumnBatch& batch,
+                                               const std::vector<int>& column_indexes,
+                                               const std::vector<uint32_t>& rows) {
+  batch_groups_.resize(rows.size());
+  if (group_by_keys.empty()) {
+    // no group by, all rows belong to one group.
+    uint32_t group = FindOrInsertGroup("");
+    std::fill(batch_groups_.begin(), batch_groups_.end(), group);
+  } else {
+    for (size_t i = 0; i < rows.size(); i++) {
+      batch_groups_[i] = FindOrInsertGroup(group_by_keys[i]);
+    }
   }
 
-  const auto& iter = aggregations_->find(group_by_key);
-  if (iter == aggregations_->end()) {
-    const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
-    aggregation = iter_new->second;
+  for (size_t i = 0; i < batch_aggregation_functions_.size(); i++) {
+    bool ret = batch_aggregation_functions_[i](batch.GetColumn(column_indexes[i]), rows, batch_groups_,
+                                               aggregation_->GetState(i));
+    if (!ret) {
+      std::string error_message = fmt::format("ExecuteBatch failed index :  {}", i);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+
+  return CheckMemoryLimit();
+}
+
+butil::Status AggregationManager::Merge(AggregationIterator* iter) {
+  while (iter->HasNext()) {
+    uint32_t group = FindOrInsertGroup(iter->GetKey());
+
+    const auto& values = *iter->GetValue();
+    for (size_t i = 0; i < merge_functions_.size(); i++) {
+      bool ret = merge_functions_[i](values[i], aggregation_->GetState(i), group);
+      if (!ret) {
+        std::string error_message = fmt::format("Merge failed index :  {}", i);
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+    }
 
-    status = aggregation->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
-                               result_serial_schemas_, aggregation_operators_);
+    auto status = CheckMemoryLimit();
     if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
       return status;
     }
-  } else {
-    aggregation = iter->second;
+
+    iter->Next();
+  }
+
+  return iter->GetStatus();
+}
+
+uint32_t AggregationManager::FindOrInsertGroup(std::string_view group_by_key) {
+  bool inserted = false;
+  uint32_t group = hash_table_->FindOrInsert(group_by_key, inserted);
+  if (inserted) {
+    aggregation_->AddGroup();
   }
+  return group;
+}
+
+size_t AggregationManager::MemoryUsage() const {
+  if (!hash_table_ || !aggregation_) {
+    return 0;
+  }
+  return hash_table_->MemoryUsage() + aggregation_->MemoryUsage();
+}
+
+butil::Status AggregationManager::CheckMemoryLimit() {
+  if (memory_limit_ <= 0 || MemoryUsage() <= static_cast<size_t>(memory_limit_)) {
+    return butil::Status();
+  }
+
+  return Spill();
+}
+
+std::string AggregationManager::GetSpillPath() {
+  if (!FLAGS_coprocessor_aggregation_spill_path.empty()) {
+    return FLAGS_coprocessor_aggregation_spill_path;
+  }
+
+  // the spill files are on the disk of store, so they are under its capacity check.
+  auto config = ConfigManager::GetInstance().GetRoleConfig();
+  std::string store_path = config == nullptr ? "" : config->GetString("store.path");
+  if (store_path.empty()) {
+    std::error_code ec;
+    return (std::filesystem::temp_directory_path(ec) / "dingo_aggregation_spill").string();
+  }
+
+  return fmt::format("{}/aggregation_spill", store_path);
+}
+
+void AggregationManager::CleanSpillPath() {
+  std::error_code ec;
+  std::filesystem::path spill_path(GetSpillPath());
+  if (!std::filesystem::exists(spill_path, ec)) {
+    return;
+  }
+
+  for (const auto& entry : std::filesystem::directory_iterator(spill_path, ec)) {
+    if (entry.path().extension() == ".run") {
+      DINGO_LOG(INFO) << fmt::format("remove aggregation spill file left by last run : {}", entry.path().string());
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+}
+
+butil::Status AggregationManager::Spill() {
+  static std::atomic<int64_t> spill_sequence{0};
 
-  status = aggregation->Execute(aggregation_functions_, group_by_operator_record);
+  std::error_code ec;
+  std::filesystem::path spill_path(GetSpillPath());
+  std::filesystem::create_directories(spill_path, ec);
+  if (ec) {
+    std::string error_message = fmt::format("create spill path {} failed, {}", spill_path.string(), ec.message());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  std::string spill_file =
+      (spill_path / fmt::format("{}_{}.run", static_cast<int64_t>(::getpid()), spill_sequence.fetch_add(1))).string();
+
+  DINGO_LOG(INFO) << fmt::format("aggregation spill groups : {} memory : {} limit : {} file : {}", hash_table_->Size(),
+                                 MemoryUsage(), memory_limit_, spill_file);
+
+  // a run is sorted by group by key, so runs could be merged.
+  std::vector<uint32_t> groups(hash_table_->Size());
+  for (uint32_t i = 0; i < groups.size(); i++) {
+    groups[i] = i;
+  }
+  std::sort(groups.begin(), groups.end(),
+            [this](uint32_t lhs, uint32_t rhs) { return hash_table_->GetKey(lhs) < hash_table_->GetKey(rhs); });
+
+  spill_files_.push_back(spill_file);
+  AggregationSpillWriter writer(aggregation_->GetTypes());
+  auto status = writer.Open(spill_file);
   if (!status.ok()) {
-    DINGO_LOG(ERROR) << fmt::format("Aggregation::Execute failed");
     return status;
   }
 
+  std::vector<std::any> values;
+  for (auto group : groups) {
+    aggregation_->GetResult(group, values);
+    status = writer.Append(hash_table_->GetKey(group), values);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  status = writer.Finish();
+  if (!status.ok()) {
+    return status;
+  }
+
+  hash_table_->Clear();
+  aggregation_->Clear();
+
   return butil::Status();
 }
 
+void AggregationManager::RemoveSpillFiles() {
+  for (const auto& spill_file : spill_files_) {
+    std::error_code ec;
+    std::filesystem::remove(spill_file, ec);
+    if (ec) {
+      DINGO_LOG(WARNING) << fmt::format("remove spill file {} failed, {}", spill_file, ec.message());
+    }
+  }
+  spill_files_.clear();
+}
+
+void AggregationManager::Clear() {
+  if (hash_table_) {
+    hash_table_->Clear();
+  }
+  if (aggregation_) {
+    aggregation_->Clear();
+  }
+  RemoveSpillFiles();
+}
+
 void AggregationManager::Close() {
   if (group_by_operator_serial_schemas_) {
     group_by_operator_serial_schemas_.reset();
@@ -363,33 +614,74 @@ void AggregationManager::Close() {
   }
 
   aggregation_functions_.clear();
+  batch_aggregation_functions_.clear();
+  merge_functions_.clear();
+
+  if (hash_table_) {
+    hash_table_.reset();
+  }
 
-  if (aggregations_) {
-    aggregations_.reset();
+  if (aggregation_) {
+    aggregation_.reset();
   }
+
+  batch_groups_.clear();
+
+  RemoveSpillFiles();
 }
 
-std::shared_ptr<AggregationIterator> AggregationManager::CreateIterator() {
-  if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+std::shared_ptr<AggregationIterator> AggregationManager::CreateIterator(bool sorted) {
+  DINGO_LOG(DEBUG) << "aggregations  size : " << hash_table_->Size() << " spill count : " << spill_files_.size();
+  if (spill_files_.empty()) {
+    return std::make_shared<HashAggregationIterator>(hash_table_, aggregation_,
+                                                     sorted || FLAGS_coprocessor_aggregation_sorted_output);
   }
-  DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->size();
-  return std::make_shared<AggregationIterator>(aggregations_);
+
+  butil::Status status;
+  if (hash_table_->Size() > 0) {
+    status = Spill();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Spill failed, {}", status.error_cstr());
+      return nullptr;
+    }
+  }
+
+  std::vector<std::shared_ptr<AggregationSpillReader>> readers;
+  readers.reserve(spill_files_.size());
+  for (const auto& spill_file : spill_files_) {
+    auto reader = std::make_shared<AggregationSpillReader>(aggregation_->GetTypes());
+    status = reader->Open(spill_file);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("open spill reader failed, {}", status.error_cstr());
+      return nullptr;
+    }
+    readers.push_back(std::move(reader));
+  }
+
+  auto merge_aggregation = std::make_shared<Aggregation>();
+  status = merge_aggregation->Open(start_aggregation_operators_index_, result_serial_schemas_, aggregation_operators_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed, {}", status.error_cstr());
+    return nullptr;
+  }
+
+  return std::make_shared<SpillAggregationIterator>(std::move(readers), merge_aggregation, merge_functions_);
 }
 
 butil::Status AggregationManager::AddSumFunction(BaseSchema::Type serial_schema_type,
                                                  BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(SUM<bool, bool>());
+    AddAggregationFunction<SUM<bool, bool>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(SUM<int32_t, int32_t>());
+    AddAggregationFunction<SUM<int32_t, int32_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(SUM<float, float>());
+    AddAggregationFunction<SUM<float, float>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(SUM<int64_t, int64_t>());
+    AddAggregationFunction<SUM<int64_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(SUM<double, double>());
+    AddAggregationFunction<SUM<double, double>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else {
     std::string error_message =
         fmt::format("SUM<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -404,17 +696,23 @@ butil::Status AggregationManager::AddSumFunction(BaseSchema::Type serial_schema_
 butil::Status AggregationManager::AddCountFunction(BaseSchema::Type serial_schema_type,
                                                    BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<bool, int64_t>());
+    AddAggregationFunction<COUNT<bool, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                 merge_functions_);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<int32_t, int64_t>());
+    AddAggregationFunction<COUNT<int32_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                    merge_functions_);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<float, int64_t>());
+    AddAggregationFunction<COUNT<float, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<int64_t, int64_t>());
+    AddAggregationFunction<COUNT<int64_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                    merge_functions_);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<double, int64_t>());
+    AddAggregationFunction<COUNT<double, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                   merge_functions_);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<std::shared_ptr<std::string>, int64_t>());
+    AddAggregationFunction<COUNT<std::shared_ptr<std::string>, int64_t>>(
+        aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else {
     std::string error_message =
         fmt::format("COUNT<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -427,17 +725,23 @@ butil::Status AggregationManager::AddCountFunction(BaseSchema::Type serial_schem
 butil::Status AggregationManager::AddCountWithNullFunction(BaseSchema::Type serial_schema_type,
                                                            BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<bool, int64_t>());
+    AddAggregationFunction<COUNTWITHNULL<bool, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                         merge_functions_);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<int32_t, int64_t>());
+    AddAggregationFunction<COUNTWITHNULL<int32_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                            merge_functions_);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<float, int64_t>());
+    AddAggregationFunction<COUNTWITHNULL<float, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                          merge_functions_);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<int64_t, int64_t>());
+    AddAggregationFunction<COUNTWITHNULL<int64_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                            merge_functions_);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<double, int64_t>());
+    AddAggregationFunction<COUNTWITHNULL<double, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                           merge_functions_);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<std::shared_ptr<std::string>, int64_t>());
+    AddAggregationFunction<COUNTWITHNULL<std::shared_ptr<std::string>, int64_t>>(
+        aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -450,17 +754,20 @@ butil::Status AggregationManager::AddCountWithNullFunction(BaseSchema::Type seri
 butil::Status AggregationManager::AddMaxFunction(BaseSchema::Type serial_schema_type,
                                                  BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(MAX<bool, bool>());
+    AddAggregationFunction<MAX<bool, bool>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(MAX<int32_t, int32_t>());
+    AddAggregationFunction<MAX<int32_t, int32_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(MAX<float, float>());
+    AddAggregationFunction<MAX<float, float>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(MAX<int64_t, int64_t>());
+    AddAggregationFunction<MAX<int64_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(MAX<double, double>());
+    AddAggregationFunction<MAX<double, double>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kString) {
-    aggregation_functions_.emplace_back(MAX<std::shared_ptr<std::string>, std::shared_ptr<std::string>>());
+    AddAggregationFunction<MAX<std::shared_ptr<std::string>, std::shared_ptr<std::string>>>(
+        aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -473,17 +780,20 @@ butil::Status AggregationManager::AddMaxFunction(BaseSchema::Type serial_schema_
 butil::Status AggregationManager::AddMinFunction(BaseSchema::Type serial_schema_type,
                                                  BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(MIN<bool, bool>());
+    AddAggregationFunction<MIN<bool, bool>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(MIN<int32_t, int32_t>());
+    AddAggregationFunction<MIN<int32_t, int32_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(MIN<float, float>());
+    AddAggregationFunction<MIN<float, float>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(MIN<int64_t, int64_t>());
+    AddAggregationFunction<MIN<int64_t, int64_t>>(aggregation_functions_, batch_aggregation_functions_,
+                                                  merge_functions_);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(MIN<double, double>());
+    AddAggregationFunction<MIN<double, double>>(aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kString) {
-    aggregation_functions_.emplace_back(MIN<std::shared_ptr<std::string>, std::shared_ptr<std::string>>());
+    AddAggregationFunction<MIN<std::shared_ptr<std::string>, std::shared_ptr<std::string>>>(
+        aggregation_functions_, batch_aggregation_functions_, merge_functions_);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
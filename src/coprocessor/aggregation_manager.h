@@ -18,35 +18,98 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
+#include <cstdint>
 #include <functional>
-#include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
 #include "coprocessor/aggregation.h"
+#include "coprocessor/aggregation_hash_table.h"
+#include "coprocessor/aggregation_spill.h"
+#include "coprocessor/column_batch.h"
+#include "gflags/gflags.h"
 #include "proto/store.pb.h"
 
+DECLARE_int64(coprocessor_aggregation_memory_limit);
+
 namespace dingodb {
 
+// Row aggregation function, aggregate param to the state of group.
+using AggregationFunction = std::function<bool(const std::any&, ColumnBatch::Column&, uint32_t)>;
+// Batch aggregation function, aggregate column[rows[i]] to the state of groups[i].
+using BatchAggregationFunction = std::function<bool(const ColumnBatch::Column&, const std::vector<uint32_t>&,
+                                                    const std::vector<uint32_t>&, ColumnBatch::Column&)>;
+
 class AggregationIterator {
  public:
-  explicit AggregationIterator(const std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>>& aggregations)
-      : aggregations_(aggregations) {
-    iter_ = aggregations_->begin();
+  virtual ~AggregationIterator() = default;
+
+  virtual bool HasNext() = 0;
+  virtual void Next() = 0;
+  virtual const std::string& GetKey() const = 0;
+  virtual const std::shared_ptr<std::vector<std::any>>& GetValue() const = 0;
+
+  // Error of reading spilled states, HasNext return false when error.
+  virtual butil::Status GetStatus() const { return butil::Status(); }
+};
+
+// Iterate the groups in memory.
+class HashAggregationIterator : public AggregationIterator {
+ public:
+  // Groups are in insertion order, or sorted by group by key if sorted is true.
+  HashAggregationIterator(const std::shared_ptr<AggregationHashTable>& hash_table,
+                          const std::shared_ptr<Aggregation>& aggregation, bool sorted);
+
+  ~HashAggregationIterator() override {
+    hash_table_.reset();
+    aggregation_.reset();
   }
 
-  ~AggregationIterator() { aggregations_.reset(); }
+  bool HasNext() override { return (pos_ < groups_.size()); }
+  void Next() override { ++pos_; }
+  const std::string& GetKey() const override { return hash_table_->GetKey(groups_[pos_]); }
+  const std::shared_ptr<std::vector<std::any>>& GetValue() const override;
+
+ private:
+  std::shared_ptr<AggregationHashTable> hash_table_;
+  std::shared_ptr<Aggregation> aggregation_;
+  std::vector<uint32_t> groups_;
+  size_t pos_;
+  mutable std::shared_ptr<std::vector<std::any>> value_;
+};
+
+// Merge the sorted spill runs, states of the same group by key are merged by merge functions.
+// Groups are always sorted by group by key.
+class SpillAggregationIterator : public AggregationIterator {
+ public:
+  SpillAggregationIterator(std::vector<std::shared_ptr<AggregationSpillReader>> readers,
+                           const std::shared_ptr<Aggregation>& merge_aggregation,
+                           const std::vector<AggregationFunction>& merge_functions);
+
+  ~SpillAggregationIterator() override = default;
 
-  bool HasNext() { return (iter_ != aggregations_->end()); }
-  void Next() { ++iter_; }
-  const std::string& GetKey() const { return iter_->first; }
-  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return iter_->second->GetResult(); }
+  bool HasNext() override { return has_value_; }
+  void Next() override { Merge(); }
+  const std::string& GetKey() const override { return key_; }
+  const std::shared_ptr<std::vector<std::any>>& GetValue() const override { return value_; }
+  butil::Status GetStatus() const override { return status_; }
 
  private:
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
-  std::map<std::string, std::shared_ptr<Aggregation>>::iterator iter_;
+  // Merge states of the smallest key of all runs.
+  void Merge();
+
+  std::vector<std::shared_ptr<AggregationSpillReader>> readers_;
+  // min heap of readers index by current key
+  std::vector<size_t> heap_;
+  std::shared_ptr<Aggregation> merge_aggregation_;
+  std::vector<AggregationFunction> merge_functions_;
+  bool has_value_;
+  std::string key_;
+  std::shared_ptr<std::vector<std::any>> value_;
+  butil::Status status_;
 };
 
 class AggregationManager {
@@ -65,11 +128,48 @@ class AggregationManager {
 
   butil::Status Execute(const std::string& group_by_key, const std::vector<std::any>& group_by_operator_record);
 
-  std::shared_ptr<AggregationIterator> CreateIterator();
+  // Batch version of Execute, group_by_keys[i] is the group by key of rows[i], empty means no group by.
+  // column_indexes[i] is the batch column of aggregation operator i.
+  butil::Status ExecuteBatch(const std::vector<std::string>& group_by_keys, const ColumnBatch& batch,
+                             const std::vector<int>& column_indexes, const std::vector<uint32_t>& rows);
+
+  // Merge the groups of another manager with the same aggregation operators, such as the partial result of a
+  // sub-range, states of the same group by key are merged by merge functions.
+  butil::Status Merge(AggregationIterator* iter);
+
+  // Sorted by group by key if sorted is true, otherwise in hash table order.
+  // If states were spilled, the rest are spilled too and the runs are merged in key order.
+  // Return nullptr if spill failed.
+  std::shared_ptr<AggregationIterator> CreateIterator(bool sorted = false);
+
+  // Memory quota of the groups in bytes, spill to disk when exceeded, 0 means no limit.
+  void SetMemoryLimit(int64_t memory_limit) { memory_limit_ = memory_limit; }
+
+  size_t MemoryUsage() const;
+
+  size_t SpillCount() const { return spill_files_.size(); }
+
+  // Remove all groups and spill files, the aggregation operators are kept.
+  void Clear();
 
   void Close();
 
+  // The directory of spill files, coprocessor_aggregation_spill_path or aggregation_spill under store path.
+  static std::string GetSpillPath();
+
+  // Remove the spill files left by the last run of process, called at startup.
+  static void CleanSpillPath();
+
  private:
+  uint32_t FindOrInsertGroup(std::string_view group_by_key);
+
+  butil::Status CheckMemoryLimit();
+
+  // Write groups in memory to a sorted run and clear them.
+  butil::Status Spill();
+
+  void RemoveSpillFiles();
+
   butil::Status AddSumFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
   butil::Status AddCountFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
   butil::Status AddCountWithNullFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
@@ -79,8 +179,17 @@ class AggregationManager {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_operator_serial_schemas_;
   ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
-  std::vector<std::function<bool(const std::any&, std::any*)>> aggregation_functions_;
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
+  std::vector<AggregationFunction> aggregation_functions_;
+  std::vector<BatchAggregationFunction> batch_aggregation_functions_;
+  // merge partial results of spilled states
+  std::vector<AggregationFunction> merge_functions_;
+  size_t start_aggregation_operators_index_;
+  std::shared_ptr<AggregationHashTable> hash_table_;
+  std::shared_ptr<Aggregation> aggregation_;
+  // group index of every row in batch, reused between batches
+  std::vector<uint32_t> batch_groups_;
+  int64_t memory_limit_;
+  std::vector<std::string> spill_files_;
 };
 
 }  // namespace dingodb
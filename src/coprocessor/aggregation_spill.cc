@@ -0,0 +1,252 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coprocessor/aggregation_spill.h"
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+template <typename T>
+static void AppendValue(std::string& buf, const std::any& value) {
+  const auto& optional_value = std::any_cast<const std::optional<T>&>(value);
+  buf.push_back(optional_value.has_value() ? 0 : 1);
+  if (!optional_value.has_value()) {
+    return;
+  }
+
+  if constexpr (std::is_same_v<T, std::shared_ptr<std::string>>) {
+    const auto& str = optional_value.value();
+    uint32_t size = str ? str->size() : 0;
+    buf.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    if (size > 0) {
+      buf.append(*str);
+    }
+  } else {
+    T data = optional_value.value();
+    buf.append(reinterpret_cast<const char*>(&data), sizeof(data));
+  }
+}
+
+AggregationSpillWriter::AggregationSpillWriter(const std::vector<BaseSchema::Type>& types) : types_(types) {}
+
+AggregationSpillWriter::~AggregationSpillWriter() {
+  if (file_.is_open()) {
+    file_.close();
+  }
+}
+
+butil::Status AggregationSpillWriter::Open(const std::string& path) {
+  path_ = path;
+  file_.open(path_, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file_.is_open()) {
+    std::string error_message = fmt::format("open spill file {} failed", path_);
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  return butil::Status();
+}
+
+butil::Status AggregationSpillWriter::Append(const std::string& key, const std::vector<std::any>& values) {
+  buf_.clear();
+  uint32_t key_size = key.size();
+  buf_.append(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+  buf_.append(key);
+
+  try {
+    for (size_t i = 0; i < types_.size(); i++) {
+      switch (types_[i]) {
+        case BaseSchema::Type::kBool:
+          AppendValue<bool>(buf_, values[i]);
+          break;
+        case BaseSchema::Type::kInteger:
+          AppendValue<int32_t>(buf_, values[i]);
+          break;
+        case BaseSchema::Type::kFloat:
+          AppendValue<float>(buf_, values[i]);
+          break;
+        case BaseSchema::Type::kLong:
+          AppendValue<int64_t>(buf_, values[i]);
+          break;
+        case BaseSchema::Type::kDouble:
+          AppendValue<double>(buf_, values[i]);
+          break;
+        case BaseSchema::Type::kString:
+          AppendValue<std::shared_ptr<std::string>>(buf_, values[i]);
+          break;
+        default: {
+          std::string error_message = fmt::format("unsupported spill type: {}", static_cast<int>(types_[i]));
+          DINGO_LOG(ERROR) << error_message;
+          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+        }
+      }
+    }
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("spill value exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  file_.write(buf_.data(), buf_.size());
+  if (!file_.good()) {
+    std::string error_message = fmt::format("write spill file {} failed", path_);
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  return butil::Status();
+}
+
+butil::Status AggregationSpillWriter::Finish() {
+  file_.flush();
+  bool good = file_.good();
+  file_.close();
+  if (!good) {
+    std::string error_message = fmt::format("flush spill file {} failed", path_);
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  return butil::Status();
+}
+
+AggregationSpillReader::AggregationSpillReader(const std::vector<BaseSchema::Type>& types)
+    : types_(types), valid_(false) {}
+
+AggregationSpillReader::~AggregationSpillReader() {
+  if (file_.is_open()) {
+    file_.close();
+  }
+}
+
+butil::Status AggregationSpillReader::Open(const std::string& path) {
+  path_ = path;
+  file_.open(path_, std::ios::in | std::ios::binary);
+  if (!file_.is_open()) {
+    std::string error_message = fmt::format("open spill file {} failed", path_);
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  valid_ = true;
+  return Next();
+}
+
+bool AggregationSpillReader::Read(void* data, size_t size) {
+  file_.read(static_cast<char*>(data), size);
+  return file_.gcount() == static_cast<std::streamsize>(size);
+}
+
+template <typename T>
+static bool ReadValue(const std::function<bool(void*, size_t)>& read, std::any& value) {
+  uint8_t is_null = 0;
+  if (!read(&is_null, sizeof(is_null))) {
+    return false;
+  }
+  if (is_null) {
+    value = std::optional<T>(std::nullopt);
+    return true;
+  }
+
+  if constexpr (std::is_same_v<T, std::shared_ptr<std::string>>) {
+    uint32_t size = 0;
+    if (!read(&size, sizeof(size))) {
+      return false;
+    }
+    auto str = std::make_shared<std::string>(size, '\0');
+    if (size > 0 && !read(str->data(), size)) {
+      return false;
+    }
+    value = std::optional<T>(std::move(str));
+  } else {
+    T data;
+    if (!read(&data, sizeof(data))) {
+      return false;
+    }
+    value = std::optional<T>(data);
+  }
+
+  return true;
+}
+
+butil::Status AggregationSpillReader::Next() {
+  if (!valid_) {
+    return butil::Status();
+  }
+
+  uint32_t key_size = 0;
+  if (!Read(&key_size, sizeof(key_size))) {
+    // end of run
+    valid_ = false;
+    return butil::Status();
+  }
+
+  key_.resize(key_size);
+  if (key_size > 0 && !Read(key_.data(), key_size)) {
+    valid_ = false;
+    std::string error_message = fmt::format("read spill file {} key failed", path_);
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  auto read = [this](void* data, size_t size) { return Read(data, size); };
+  values_.resize(types_.size());
+  for (size_t i = 0; i < types_.size(); i++) {
+    bool ret = false;
+    switch (types_[i]) {
+      case BaseSchema::Type::kBool:
+        ret = ReadValue<bool>(read, values_[i]);
+        break;
+      case BaseSchema::Type::kInteger:
+        ret = ReadValue<int32_t>(read, values_[i]);
+        break;
+      case BaseSchema::Type::kFloat:
+        ret = ReadValue<float>(read, values_[i]);
+        break;
+      case BaseSchema::Type::kLong:
+        ret = ReadValue<int64_t>(read, values_[i]);
+        break;
+      case BaseSchema::Type::kDouble:
+        ret = ReadValue<double>(read, values_[i]);
+        break;
+      case BaseSchema::Type::kString:
+        ret = ReadValue<std::shared_ptr<std::string>>(read, values_[i]);
+        break;
+      default:
+        break;
+    }
+
+    if (!ret) {
+      valid_ = false;
+      std::string error_message = fmt::format("read spill file {} value {} failed", path_, i);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EINTERNAL, error_message);
+    }
+  }
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COPROCESSOR_AGGREGATION_SPILL_H_  // NOLINT
+#define DINGODB_COPROCESSOR_AGGREGATION_SPILL_H_
+
+#include <serial/schema/base_schema.h>
+
+#include <any>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+
+namespace dingodb {
+
+// A spill run is a temporary file of partial aggregation results sorted by group by key.
+// Record layout: key_size(uint32) key, then per aggregation operator a null flag(uint8) and the value,
+// fixed size in host byte order or size(uint32) bytes for string. The file only lives during one request.
+class AggregationSpillWriter {
+ public:
+  explicit AggregationSpillWriter(const std::vector<BaseSchema::Type>& types);
+  ~AggregationSpillWriter();
+
+  AggregationSpillWriter(const AggregationSpillWriter& rhs) = delete;
+  AggregationSpillWriter& operator=(const AggregationSpillWriter& rhs) = delete;
+  AggregationSpillWriter(AggregationSpillWriter&& rhs) = delete;
+  AggregationSpillWriter& operator=(AggregationSpillWriter&& rhs) = delete;
+
+  butil::Status Open(const std::string& path);
+
+  // Keys must be appended in ascending order, values are std::optional<T> of the operator result type.
+  butil::Status Append(const std::string& key, const std::vector<std::any>& values);
+
+  butil::Status Finish();
+
+ private:
+  std::vector<BaseSchema::Type> types_;
+  std::string path_;
+  std::ofstream file_;
+  std::string buf_;
+};
+
+class AggregationSpillReader {
+ public:
+  explicit AggregationSpillReader(const std::vector<BaseSchema::Type>& types);
+  ~AggregationSpillReader();
+
+  AggregationSpillReader(const AggregationSpillReader& rhs) = delete;
+  AggregationSpillReader& operator=(const AggregationSpillReader& rhs) = delete;
+  AggregationSpillReader(AggregationSpillReader&& rhs) = delete;
+  AggregationSpillReader& operator=(AggregationSpillReader&& rhs) = delete;
+
+  // Open and read the first record.
+  butil::Status Open(const std::string& path);
+
+  bool Valid() const { return valid_; }
+
+  butil::Status Next();
+
+  const std::string& Key() const { return key_; }
+  const std::vector<std::any>& Values() const { return values_; }
+
+ private:
+  bool Read(void* data, size_t size);
+
+  std::vector<BaseSchema::Type> types_;
+  std::string path_;
+  std::ifstream file_;
+  bool valid_;
+  std::string key_;
+  std::vector<std::any> values_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_AGGREGATION_SPILL_H_  // NOLINT
@@ -0,0 +1,200 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coprocessor/column_batch.h"
+
+#include <exception>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+butil::Status ColumnBatch::CreateColumn(BaseSchema::Type type, Column& column) {
+  switch (type) {
+    case BaseSchema::Type::kBool:
+      column = ColumnVector<bool>();
+      break;
+    case BaseSchema::Type::kInteger:
+      column = ColumnVector<int32_t>();
+      break;
+    case BaseSchema::Type::kFloat:
+      column = ColumnVector<float>();
+      break;
+    case BaseSchema::Type::kLong:
+      column = ColumnVector<int64_t>();
+      break;
+    case BaseSchema::Type::kDouble:
+      column = ColumnVector<double>();
+      break;
+    case BaseSchema::Type::kString:
+      column = ColumnVector<std::shared_ptr<std::string>>();
+      break;
+    case BaseSchema::Type::kBoolList:
+    case BaseSchema::Type::kIntegerList:
+    case BaseSchema::Type::kFloatList:
+    case BaseSchema::Type::kLongList:
+    case BaseSchema::Type::kDoubleList:
+    case BaseSchema::Type::kStringList:
+      column = std::vector<std::any>();
+      break;
+    default: {
+      std::string error_message = fmt::format("ColumnBatch unsupported type: {}", static_cast<int>(type));
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status ColumnBatch::Open(const std::vector<BaseSchema::Type>& types, size_t capacity) {
+  types_ = types;
+  columns_.clear();
+  columns_.resize(types.size());
+  size_ = 0;
+
+  for (size_t i = 0; i < types.size(); i++) {
+    auto status = CreateColumn(types[i], columns_[i]);
+    if (!status.ok()) {
+      return status;
+    }
+
+    std::visit(
+        [capacity](auto& column) {
+          using ColumnType = std::decay_t<decltype(column)>;
+          if constexpr (std::is_same_v<ColumnType, std::vector<std::any>>) {
+            column.reserve(capacity);
+          } else {
+            column.Reserve(capacity);
+          }
+        },
+        columns_[i]);
+  }
+
+  return butil::Status();
+}
+
+butil::Status ColumnBatch::AppendRecord(std::vector<std::any>& record) {
+  if (record.size() != columns_.size()) {
+    std::string error_message =
+        fmt::format("ColumnBatch record size {} unequal column size {}", record.size(), columns_.size());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  try {
+    for (size_t i = 0; i < columns_.size(); i++) {
+      std::visit(
+          [&record, i](auto& column) {
+            using ColumnType = std::decay_t<decltype(column)>;
+            if constexpr (std::is_same_v<ColumnType, std::vector<std::any>>) {
+              column.emplace_back(std::move(record[i]));
+            } else {
+              using ValueType = typename std::decay_t<decltype(column.values)>::value_type;
+              column.Append(std::any_cast<std::optional<ValueType>>(std::move(record[i])));
+            }
+          },
+          columns_[i]);
+    }
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("ColumnBatch append record exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  size_++;
+  return butil::Status();
+}
+
+butil::Status ColumnBatch::AppendRecordView(RecordView& view, const std::vector<int>& column_indexes) {
+  if (column_indexes.size() != columns_.size()) {
+    std::string error_message =
+        fmt::format("ColumnBatch column index size {} unequal column size {}", column_indexes.size(), columns_.size());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  try {
+    for (size_t i = 0; i < columns_.size(); i++) {
+      int index = column_indexes[i];
+      std::visit(
+          [&view, index](auto& column) {
+            using ColumnType = std::decay_t<decltype(column)>;
+            if constexpr (std::is_same_v<ColumnType, std::vector<std::any>>) {
+              column.emplace_back(view.GetAny(index));
+            } else {
+              using ValueType = typename std::decay_t<decltype(column.values)>::value_type;
+              if constexpr (std::is_same_v<ValueType, std::shared_ptr<std::string>>) {
+                auto value = view.GetString(index);
+                column.Append(value.has_value() ? std::optional<ValueType>(std::make_shared<std::string>(*value))
+                                                : std::nullopt);
+              } else {
+                column.Append(view.Get<ValueType>(index));
+              }
+            }
+          },
+          columns_[i]);
+    }
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("ColumnBatch append record view exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  size_++;
+  return butil::Status();
+}
+
+std::any ColumnBatch::GetValue(size_t column, size_t row) const {
+  return std::visit(
+      [row](const auto& column) -> std::any {
+        using ColumnType = std::decay_t<decltype(column)>;
+        if constexpr (std::is_same_v<ColumnType, std::vector<std::any>>) {
+          return column[row];
+        } else {
+          return column.GetValue(row);
+        }
+      },
+      columns_[column]);
+}
+
+void ColumnBatch::GetRecord(size_t row, std::vector<std::any>& record) const {
+  record.resize(columns_.size());
+  for (size_t i = 0; i < columns_.size(); i++) {
+    record[i] = GetValue(i, row);
+  }
+}
+
+void ColumnBatch::Clear() {
+  for (auto& column : columns_) {
+    std::visit(
+        [](auto& column) {
+          using ColumnType = std::decay_t<decltype(column)>;
+          if constexpr (std::is_same_v<ColumnType, std::vector<std::any>>) {
+            column.clear();
+          } else {
+            column.Clear();
+          }
+        },
+        column);
+  }
+  size_ = 0;
+}
+
+}  // namespace dingodb
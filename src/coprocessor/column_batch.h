@@ -0,0 +1,112 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COPROCESSOR_COLUMN_BATCH_H_  // NOLINT
+#define DINGODB_COPROCESSOR_COLUMN_BATCH_H_
+
+#include <serial/schema/base_schema.h>
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "butil/status.h"
+#include "serial/record_view.h"
+
+namespace dingodb {
+
+// One column of a batch, values and null bitmap are stored separately.
+// The value of a null row is default constructed.
+template <typename T>
+struct ColumnVector {
+  std::vector<T> values;
+  std::vector<bool> nulls;
+
+  size_t Size() const { return values.size(); }
+  bool IsNull(size_t row) const { return nulls[row]; }
+
+  void Append(std::optional<T>&& value) {
+    nulls.push_back(!value.has_value());
+    values.emplace_back(value.has_value() ? std::move(value.value()) : T());
+  }
+
+  std::any GetValue(size_t row) const {
+    return nulls[row] ? std::optional<T>(std::nullopt) : std::optional<T>(values[row]);
+  }
+
+  void Reserve(size_t size) {
+    values.reserve(size);
+    nulls.reserve(size);
+  }
+
+  void Clear() {
+    values.clear();
+    nulls.clear();
+  }
+};
+
+// Decoded records of a batch in column layout, so filter/aggregation could loop over a typed column.
+// List types are not used by aggregation, they are kept as std::any.
+class ColumnBatch {
+ public:
+  using Column =
+      std::variant<ColumnVector<bool>, ColumnVector<int32_t>, ColumnVector<float>, ColumnVector<int64_t>,
+                   ColumnVector<double>, ColumnVector<std::shared_ptr<std::string>>, std::vector<std::any>>;
+
+  ColumnBatch() = default;
+  ~ColumnBatch() = default;
+
+  ColumnBatch(const ColumnBatch& rhs) = delete;
+  ColumnBatch& operator=(const ColumnBatch& rhs) = delete;
+  ColumnBatch(ColumnBatch&& rhs) = delete;
+  ColumnBatch& operator=(ColumnBatch&& rhs) = delete;
+
+  // Create a empty column of the type.
+  static butil::Status CreateColumn(BaseSchema::Type type, Column& column);
+
+  butil::Status Open(const std::vector<BaseSchema::Type>& types, size_t capacity);
+
+  // Move the columns of record to batch, record size must equal column size.
+  butil::Status AppendRecord(std::vector<std::any>& record);
+
+  // Read the columns of view to batch in place, column_indexes is the schema index of every batch column.
+  butil::Status AppendRecordView(RecordView& view, const std::vector<int>& column_indexes);
+
+  size_t Size() const { return size_; }
+  size_t ColumnSize() const { return columns_.size(); }
+
+  const Column& GetColumn(size_t column) const { return columns_[column]; }
+
+  // Return std::optional<T> of the column type.
+  std::any GetValue(size_t column, size_t row) const;
+
+  // Row view of the batch, for expression and encoder.
+  void GetRecord(size_t row, std::vector<std::any>& record) const;
+
+  void Clear();
+
+ private:
+  std::vector<BaseSchema::Type> types_;
+  std::vector<Column> columns_;
+  size_t size_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_COLUMN_BATCH_H_  // NOLINT
@@ -20,23 +20,37 @@
 #include <exception>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "common/logging.h"
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
 #include "serial/record_decoder.h"
 #include "serial/record_encoder.h"
+#include "serial/record_view.h"
 
 // Must be after proto, otherwise it will cause naming collision. such as TYPE_STRING
-#include "libexpr/src/runner.h"
 
 namespace dingodb {
 
-Coprocessor::Coprocessor() : enable_expression_(true), end_of_group_by_(true) {}
+DEFINE_int32(coprocessor_batch_size, 1024, "coprocessor decode and execute rows in batch, 0 or 1 is row by row");
+DEFINE_bool(coprocessor_compiled_expression, true, "coprocessor evaluate expression over batch by compiled operators");
+
+Coprocessor::Coprocessor()
+    : enable_expression_(true),
+      end_of_group_by_(true),
+      top_n_pos_(0),
+      result_count_(0),
+      limit_reached_(false),
+      streaming_aggregation_(false),
+      has_streaming_group_(false),
+      partial_(false),
+      aggregation_memory_limit_(0) {}
 Coprocessor::~Coprocessor() { Close(); }
 
 butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
@@ -75,6 +89,9 @@ butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
   }
   Utils::DebugSerialSchema(original_serial_schemas_, "original_serial_schemas");
 
+  original_record_codec_ = RecordCodec::Get(coprocessor_.schema_version(), original_serial_schemas_,
+                                            coprocessor_.original_schema().common_id());
+
   // original_serial_schemas_sorted_ = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
   // Utils::CloneCloneSerialSchemaVector(original_serial_schemas_, &original_serial_schemas_sorted_);
   // sort by index
@@ -141,6 +158,22 @@ butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
     DINGO_LOG(ERROR) << fmt::format("InitGroupBySerialSchema failed");
     return status;
   }
+
+  for (const auto& index : selection_column_indexes_) {
+    if (index < 0 || index >= original_serial_schemas_->size()) {
+      std::string error_message = fmt::format("selection column index {} out of range", index);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+    selection_column_types_.push_back((*original_serial_schemas_)[index]->GetType());
+  }
+
+  for (const auto& aggregation : coprocessor_.aggregation_operators()) {
+    aggregation_column_indexes_.push_back(
+        (aggregation.index_of_column() < 0 || aggregation.index_of_column() >= selection_column_indexes_.size())
+            ? 0
+            : aggregation.index_of_column());
+  }
   status = Utils::CheckPbSchema(coprocessor_.result_schema().schema());
   if (!status.ok()) {
     std::string error_message = fmt::format("result_schema check failed");
@@ -174,7 +207,22 @@ butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
   }
   enable_expression_ = !coprocessor_.expression().empty();
 
-  DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open enable_expression_ : {}", enable_expression_);
+  status = InitExpression();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("InitExpression failed");
+    return status;
+  }
+
+  status = InitTopN();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("InitTopN failed");
+    return status;
+  }
+
+  streaming_aggregation_ = end_of_group_by_ && IsGroupByKeyPrefix();
+
+  DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open enable_expression_ : {} streaming_aggregation_ : {}",
+                                  enable_expression_, streaming_aggregation_);
 
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open Leave");
 
@@ -191,7 +239,22 @@ butil::Status Coprocessor::Open(const pb::store::Coprocessor& coprocessor) {
 
 butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                    std::vector<pb::common::KeyValue>* kvs) {
+  VectorKeyValueSink sink(kvs);
+  return Execute(iter, key_only, max_fetch_cnt, max_bytes_rpc, &sink);
+}
+
+butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                                   KeyValueSink* sink) {
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Execute Enter");
+  // limit reached, no more data of this scan
+  if (limit_reached_) {
+    return butil::Status();
+  }
+
+  if (FLAGS_coprocessor_batch_size > 1) {
+    return ExecuteBatch(iter, key_only, max_fetch_cnt, max_bytes_rpc, sink);
+  }
+
   ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
   while (iter->Valid()) {
@@ -216,21 +279,97 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
       result_key_value.set_value("");
     }
 
-    kvs->emplace_back(result_key_value);
+    sink->Append(std::move(result_key_value));
 
-    if (scan_filter.UptoLimit(result_key_value)) {
+    if (UptoLimit()) {
+      return butil::Status();
+    }
+
+    if (scan_filter.UptoLimit(*sink->Back())) {
       iter->Next();
       return butil::Status();
     }
     iter->Next();
   }
 
-  status = GetKeyValueFromAggregation(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+  if (partial_) {
+    return butil::Status();
+  }
+
+  status = GetKeyValueFromAggregation(key_only, max_fetch_cnt, max_bytes_rpc, sink);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = GetKeyValueFromTopN(key_only, max_fetch_cnt, max_bytes_rpc, sink);
 
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Execute Leave");
 
   return status;
 }
+bool Coprocessor::IsParallelizable() const { return (end_of_group_by_ && !streaming_aggregation_) || top_n_ != nullptr; }
+
+int64_t Coprocessor::AggregationMemoryLimit() const {
+  if (aggregation_memory_limit_ > 0) {
+    return aggregation_memory_limit_;
+  }
+
+  // the limit of request only lowers the quota of server, it can not disable spilling
+  int64_t memory_limit = coprocessor_.aggregation_memory_limit();
+  if (memory_limit > 0 &&
+      (FLAGS_coprocessor_aggregation_memory_limit <= 0 || memory_limit < FLAGS_coprocessor_aggregation_memory_limit)) {
+    return memory_limit;
+  }
+  return FLAGS_coprocessor_aggregation_memory_limit;
+}
+
+void Coprocessor::SetAggregationMemoryLimit(int64_t memory_limit) { aggregation_memory_limit_ = memory_limit; }
+
+butil::Status Coprocessor::ExecutePartial(IteratorPtr iter) {
+  if (!IsParallelizable()) {
+    std::string error_message = fmt::format("partial execute of selection or streaming aggregation. not support");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  partial_ = true;
+
+  // aggregation and top n output nothing until the iterator is done, all rows are consumed by one execute.
+  std::vector<pb::common::KeyValue> kvs;
+  VectorKeyValueSink sink(&kvs);
+  return Execute(iter, false, 0, 0, &sink);
+}
+
+butil::Status Coprocessor::MergePartial(Coprocessor* partial) {
+  butil::Status status;
+
+  if (partial->aggregation_manager_) {
+    status = InitAggregationManager();
+    if (!status.ok()) {
+      return status;
+    }
+
+    auto iter = partial->aggregation_manager_->CreateIterator();
+    if (!iter) {
+      std::string error_message = fmt::format("AggregationManager::CreateIterator failed");
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EINTERNAL, error_message);
+    }
+
+    status = aggregation_manager_->Merge(iter.get());
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("AggregationManager::Merge failed");
+      return status;
+    }
+  }
+
+  if (top_n_ && partial->top_n_) {
+    top_n_->Merge(partial->top_n_.get());
+  }
+
+  return butil::Status();
+}
+
 butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_result_kv,
                                      pb::common::KeyValue* result_kv) {
   butil::Status status;
@@ -288,17 +427,13 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
 
   bool is_key_value_reserve = true;
   if (enable_expression_) {
-    expr::Runner runner;
-
     try {
-      runner.Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
-                    coprocessor_.expression().length());
-      runner.BindTuple(reinterpret_cast<const expr::Tuple*>(&original_record));
-      runner.Run();
-      expr::Wrap<bool> ok = runner.GetResult<bool>();
+      runner_->BindTuple(reinterpret_cast<const expr::Tuple*>(&original_record));
+      runner_->Run();
+      expr::Wrap<bool> ok = runner_->GetResult<bool>();
       is_key_value_reserve = ok.has_value() && ok.value();
     } catch (const std::exception& my_exception) {
-      std::string error_message = fmt::format("expr::Runner Decode or Run failed. exception : {}", my_exception.what());
+      std::string error_message = fmt::format("expr::Runner Run failed. exception : {}", my_exception.what());
       DINGO_LOG(ERROR) << error_message;
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
@@ -310,13 +445,22 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
   }
 
   if (end_of_group_by_) {  // group by
-    status = DoExecuteForAggregation(original_record);
+    // streaming aggregation return the finished group
+    status = DoExecuteForAggregation(original_record, has_result_kv, result_kv);
     if (!status.ok()) {
       std::string error_message = fmt::format("Coprocessor::DoExecuteForAggregation failed");
       DINGO_LOG(ERROR) << error_message;
       return status;
     }
 
+  } else if (top_n_) {  // order by ... limit n
+    status = DoExecuteForTopN(original_record);
+    if (!status.ok()) {
+      std::string error_message = fmt::format("Coprocessor::DoExecuteForTopN failed");
+      DINGO_LOG(ERROR) << error_message;
+      return status;
+    }
+
     *has_result_kv = false;
 
   } else {  // selection
@@ -331,7 +475,323 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
   return butil::Status();
 }
 
-butil::Status Coprocessor::DoExecuteForAggregation(const std::vector<std::any>& selection_record) {
+butil::Status Coprocessor::ExecuteBatch(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                                        KeyValueSink* sink) {
+  DINGO_LOG(DEBUG) << fmt::format("Coprocessor::ExecuteBatch Enter");
+  ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
+  butil::Status status;
+
+  // read the selection columns in place, without the std::any record
+  RecordView original_record_view(original_record_codec_);
+  RecordEncoder result_record_encoder(coprocessor_.schema_version(), result_serial_schemas_sorted_,
+                                      coprocessor_.result_schema().common_id());
+
+  ColumnBatch batch;
+  status = batch.Open(selection_column_types_, FLAGS_coprocessor_batch_size);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("ColumnBatch::Open failed");
+    return status;
+  }
+
+  // original keys of batch, for seek back when selection reach limit in the middle of batch.
+  std::vector<std::string> batch_keys;
+  std::vector<uint32_t> rows;
+  std::vector<std::any> record;
+
+  while (iter->Valid()) {
+    batch.Clear();
+    batch_keys.clear();
+
+    while (iter->Valid() && batch.Size() < FLAGS_coprocessor_batch_size) {
+      if (original_record_view.Reset(iter->Key(), iter->Value()) < 0) {
+        std::string error_message = fmt::format("serial::Decode failed");
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+
+      status = batch.AppendRecordView(original_record_view, selection_column_indexes_);
+      if (!status.ok()) {
+        return status;
+      }
+
+      if (!end_of_group_by_) {
+        batch_keys.emplace_back(iter->Key());
+      }
+      iter->Next();
+    }
+
+    status = DoExecuteBatchForFilter(batch, rows);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Coprocessor::DoExecuteBatchForFilter failed");
+      return status;
+    }
+
+    if (rows.empty()) {
+      continue;
+    }
+
+    if (end_of_group_by_) {  // group by
+      size_t sink_size = sink->Size();
+      status = DoExecuteBatchForAggregation(batch, rows, sink);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("Coprocessor::DoExecuteBatchForAggregation failed");
+        return status;
+      }
+
+      // finished groups of streaming aggregation, all rows of batch are consumed.
+      bool upto_limit = false;
+      for (size_t i = sink_size; i < sink->Size(); i++) {
+        if (key_only) {
+          sink->Mutable(i)->set_value("");
+        }
+        upto_limit = scan_filter.UptoLimit(*sink->Mutable(i)) || upto_limit;
+      }
+      if (upto_limit) {
+        return butil::Status();
+      }
+      continue;
+    }
+
+    if (top_n_) {  // order by ... limit n
+      for (auto row : rows) {
+        batch.GetRecord(row, record);
+        status = DoExecuteForTopN(record);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("Coprocessor::DoExecuteForTopN failed");
+          return status;
+        }
+      }
+      continue;
+    }
+
+    // selection
+    for (auto row : rows) {
+      batch.GetRecord(row, record);
+
+      pb::common::KeyValue result_key_value;
+      int ret = 0;
+      try {
+        ret = result_record_encoder.Encode(record, result_key_value);
+      } catch (const std::exception& my_exception) {
+        std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+      if (ret < 0) {
+        std::string error_message = fmt::format("serial::Encode failed");
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+
+      if (key_only) {
+        result_key_value.set_value("");
+      }
+
+      sink->Append(std::move(result_key_value));
+
+      if (UptoLimit()) {
+        return butil::Status();
+      }
+
+      if (scan_filter.UptoLimit(*sink->Back())) {
+        // the rest rows of batch are not consumed, seek back for next execute.
+        if (row + 1 < batch.Size()) {
+          iter->Seek(batch_keys[row + 1]);
+        }
+        return butil::Status();
+      }
+    }
+  }
+
+  if (partial_) {
+    return butil::Status();
+  }
+
+  status = GetKeyValueFromAggregation(key_only, max_fetch_cnt, max_bytes_rpc, sink);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = GetKeyValueFromTopN(key_only, max_fetch_cnt, max_bytes_rpc, sink);
+
+  DINGO_LOG(DEBUG) << fmt::format("Coprocessor::ExecuteBatch Leave");
+
+  return status;
+}
+
+butil::Status Coprocessor::DoExecuteBatchForFilter(const ColumnBatch& batch, std::vector<uint32_t>& rows) {
+  rows.clear();
+  rows.reserve(batch.Size());
+
+  if (!enable_expression_) {
+    for (uint32_t row = 0; row < batch.Size(); row++) {
+      rows.push_back(row);
+    }
+    return butil::Status();
+  }
+
+  if (expression_) {
+    return expression_->Filter(batch, rows);
+  }
+
+  // expression is not compiled, bind every row of the batch to runner.
+  try {
+    std::vector<std::any> record;
+    for (uint32_t row = 0; row < batch.Size(); row++) {
+      batch.GetRecord(row, record);
+      runner_->BindTuple(reinterpret_cast<const expr::Tuple*>(&record));
+      runner_->Run();
+      expr::Wrap<bool> ok = runner_->GetResult<bool>();
+      if (ok.has_value() && ok.value()) {
+        rows.push_back(row);
+      }
+    }
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("expr::Runner Run failed. exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  return butil::Status();
+}
+
+butil::Status Coprocessor::DoExecuteBatchForAggregation(const ColumnBatch& batch, const std::vector<uint32_t>& rows,
+                                                        KeyValueSink* sink) {
+  butil::Status status;
+
+  // group by key of every row, encoded same as DoExecuteForAggregation.
+  std::vector<std::string> group_by_keys;
+  if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
+    RecordEncoder group_by_key_encoder(coprocessor_.schema_version(), group_by_key_serial_schemas_,
+                                       coprocessor_.result_schema().common_id());
+
+    std::vector<std::any> group_by_key_record(coprocessor_.group_by_columns_size());
+    group_by_keys.reserve(rows.size());
+    for (auto row : rows) {
+      for (int i = 0; i < coprocessor_.group_by_columns_size(); i++) {
+        group_by_key_record[i] = batch.GetValue(coprocessor_.group_by_columns(i), row);
+      }
+
+      std::string group_by_key;
+      int ret = 0;
+      try {
+        ret = group_by_key_encoder.EncodeKey(group_by_key_record, group_by_key);
+      } catch (const std::exception& my_exception) {
+        std::string error_message = fmt::format("serial::EncodeKey failed exception : {}", my_exception.what());
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+      if (ret < 0) {
+        std::string error_message = fmt::format("serial::EncodeKey failed");
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+
+      group_by_keys.emplace_back(std::move(group_by_key));
+    }
+  }
+
+  status = InitAggregationManager();
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (!streaming_aggregation_) {
+    status = aggregation_manager_->ExecuteBatch(group_by_keys, batch, aggregation_column_indexes_, rows);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("AggregationManager::ExecuteBatch failed");
+      return status;
+    }
+
+    return butil::Status();
+  }
+
+  // streaming aggregation, execute every run of rows with same group by key.
+  std::vector<std::string> run_keys;
+  std::vector<uint32_t> run_rows;
+  size_t start = 0;
+  while (start < rows.size()) {
+    size_t end = start + 1;
+    while (end < rows.size() && group_by_keys[end] == group_by_keys[start]) {
+      end++;
+    }
+
+    bool has_result_kv = false;
+    pb::common::KeyValue result_key_value;
+    status = SwitchStreamingGroup(group_by_keys[start], &has_result_kv, &result_key_value);
+    if (!status.ok()) {
+      return status;
+    }
+    if (has_result_kv) {
+      sink->Append(std::move(result_key_value));
+    }
+
+    run_keys.assign(group_by_keys.begin() + start, group_by_keys.begin() + end);
+    run_rows.assign(rows.begin() + start, rows.begin() + end);
+    status = aggregation_manager_->ExecuteBatch(run_keys, batch, aggregation_column_indexes_, run_rows);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("AggregationManager::ExecuteBatch failed");
+      return status;
+    }
+
+    start = end;
+  }
+
+  return butil::Status();
+}
+
+butil::Status Coprocessor::SwitchStreamingGroup(const std::string& group_by_key, bool* has_result_kv,
+                                                pb::common::KeyValue* result_kv) {
+  if (has_streaming_group_ && group_by_key == streaming_group_key_) {
+    return butil::Status();
+  }
+
+  if (has_streaming_group_) {
+    // the group is finished, rows of next group will not come back.
+    auto iter = aggregation_manager_->CreateIterator();
+    if (!iter) {
+      std::string error_message = fmt::format("AggregationManager::CreateIterator failed");
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EINTERNAL, error_message);
+    }
+
+    if (iter->HasNext()) {
+      auto status = EncodeAggregationResult(iter->GetKey(), *iter->GetValue(), result_kv);
+      if (!status.ok()) {
+        return status;
+      }
+      *has_result_kv = true;
+    }
+
+    aggregation_manager_->Clear();
+  }
+
+  streaming_group_key_ = group_by_key;
+  has_streaming_group_ = true;
+
+  return butil::Status();
+}
+
+butil::Status Coprocessor::InitAggregationManager() {
+  if (aggregation_manager_) {
+    return butil::Status();
+  }
+
+  aggregation_manager_ = std::make_shared<AggregationManager>();
+  auto status = aggregation_manager_->Open(group_by_operator_serial_schemas_, coprocessor_.aggregation_operators(),
+                                           result_serial_schemas_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("AggregationManager::Open failed");
+    return status;
+  }
+
+  aggregation_manager_->SetMemoryLimit(AggregationMemoryLimit());
+
+  return butil::Status();
+}
+
+butil::Status Coprocessor::DoExecuteForAggregation(const std::vector<std::any>& selection_record,
+                                                   bool* has_result_kv, pb::common::KeyValue* result_kv) {
   butil::Status status;
   // group by
   std::vector<std::any> group_by_key_record;
@@ -406,12 +866,14 @@ butil::Status Coprocessor::DoExecuteForAggregation(const std::vector<std::any>&
 
   Utils::DebugGroupByKey(group_by_key, "group_by_key");
 
-  if (!aggregation_manager_) {
-    aggregation_manager_ = std::make_shared<AggregationManager>();
-    status = aggregation_manager_->Open(group_by_operator_serial_schemas_, coprocessor_.aggregation_operators(),
-                                        result_serial_schemas_);
+  status = InitAggregationManager();
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (streaming_aggregation_) {
+    status = SwitchStreamingGroup(group_by_key, has_result_kv, result_kv);
     if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("AggregationManager::Open failed");
       return status;
     }
   }
@@ -451,107 +913,266 @@ butil::Status Coprocessor::DoExecuteForSelection(const std::vector<std::any>& se
   return butil::Status();
 }
 
+butil::Status Coprocessor::DoExecuteForTopN(const std::vector<std::any>& selection_record) {
+  std::string sort_key;
+  auto status = top_n_->EncodeSortKey(selection_record, sort_key);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // not in top n, skip encoding
+  if (!top_n_->Accept(sort_key)) {
+    return butil::Status();
+  }
+
+  bool has_result_kv = false;
+  pb::common::KeyValue result_key_value;
+  status = DoExecuteForSelection(selection_record, &has_result_kv, &result_key_value);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (has_result_kv) {
+    top_n_->Push(std::move(sort_key), std::move(result_key_value));
+  }
+
+  return butil::Status();
+}
+
+butil::Status Coprocessor::GetKeyValueFromTopN(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                                               KeyValueSink* sink) {
+  if (!top_n_) {
+    return butil::Status();
+  }
+
+  top_n_->Finish();
+
+  ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
+  while (top_n_pos_ < top_n_->Size()) {
+    pb::common::KeyValue result_key_value = top_n_->Get(top_n_pos_++);
+    if (key_only) {
+      result_key_value.set_value("");
+    }
+
+    sink->Append(std::move(result_key_value));
+
+    if (scan_filter.UptoLimit(*sink->Back())) {
+      break;
+    }
+  }
+
+  return butil::Status();
+}
+
+bool Coprocessor::UptoLimit() {
+  if (coprocessor_.limit() <= 0) {
+    return false;
+  }
+
+  result_count_++;
+  if (result_count_ >= coprocessor_.limit()) {
+    limit_reached_ = true;
+  }
+  return limit_reached_;
+}
+
+butil::Status Coprocessor::InitTopN() {
+  if (coprocessor_.limit() <= 0 && coprocessor_.order_by_columns().empty()) {
+    return butil::Status();
+  }
+
+  if (end_of_group_by_) {
+    std::string error_message = fmt::format("limit or order by with group by. not support");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  if (coprocessor_.order_by_columns().empty()) {
+    return butil::Status();
+  }
+
+  top_n_ = std::make_shared<TopN>();
+  return top_n_->Open(coprocessor_.order_by_columns(), selection_column_types_,
+                      coprocessor_.limit() > 0 ? coprocessor_.limit() : 0);
+}
+
+butil::Status Coprocessor::InitExpression() {
+  if (!enable_expression_) {
+    return butil::Status();
+  }
+
+  try {
+    runner_ = std::make_shared<expr::Runner>();
+    runner_->Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
+                    coprocessor_.expression().length());
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("expr::Runner Decode failed. exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  if (!FLAGS_coprocessor_compiled_expression) {
+    return butil::Status();
+  }
+
+  expression_ = std::make_shared<Expression>();
+  auto status = expression_->Compile(coprocessor_.expression(), selection_column_types_);
+  if (!status.ok()) {
+    // operators not supported by compiled expression, use runner.
+    DINGO_LOG(DEBUG) << fmt::format("compile expression failed, fallback to expr::Runner, {}", status.error_cstr());
+    expression_.reset();
+  }
+
+  return butil::Status();
+}
+
+bool Coprocessor::IsGroupByKeyPrefix() const {
+  if (coprocessor_.group_by_columns().empty()) {
+    return false;
+  }
+
+  // key columns are encoded in original schema order
+  std::vector<int> key_prefix_indexes;
+  for (int i = 0; i < original_serial_schemas_->size(); i++) {
+    if (key_prefix_indexes.size() >= coprocessor_.group_by_columns_size()) {
+      break;
+    }
+    if ((*original_serial_schemas_)[i]->IsKey()) {
+      key_prefix_indexes.push_back(i);
+    }
+  }
+
+  std::vector<int> group_by_indexes;
+  for (auto index : coprocessor_.group_by_columns()) {
+    group_by_indexes.push_back(selection_column_indexes_[index]);
+  }
+
+  std::sort(group_by_indexes.begin(), group_by_indexes.end());
+  return group_by_indexes == key_prefix_indexes;
+}
+
+butil::Status Coprocessor::EncodeAggregationResult(const std::string& key, const std::vector<std::any>& value,
+                                                   pb::common::KeyValue* result_kv) {
+  std::vector<std::any> result_key_record;
+  int ret = 0;
+  if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
+    RecordDecoder result_record_decoder(coprocessor_.schema_version(), group_by_key_serial_schemas_,
+                                        coprocessor_.result_schema().common_id());
+
+    try {
+      ret = result_record_decoder.DecodeKey(key, result_key_record);
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("serial::DecodeKey failed exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+    if (ret < 0) {
+      std::string error_message = fmt::format("serial::DecodeKey failed");
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+
+  std::vector<std::any> result_record;
+  result_record.reserve(result_key_record.size() + value.size());
+  size_t i = 0;
+  for (const auto& column : result_key_record) {
+    std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
+    if (!column_clone.has_value()) {
+      std::string error_message = fmt::format(
+          "CloneColumn failed result_key_record index : {} result_serial_schemas_sorted_ i : {} "
+          "result_serial_schemas_sorted_ "
+          "type : {}",
+          i, i, BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+    Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Key");
+    result_record.emplace_back(std::move(column_clone));
+    i++;
+  }
+
+  for (const auto& column : value) {
+    std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
+    if (!column_clone.has_value()) {
+      std::string error_message = fmt::format(
+          "CloneColumn failed result_aggregation_record  index : {} result_serial_schemas_sorted_ i : {} "
+          "result_serial_schemas_sorted_ type : {}",
+          (i - result_key_record.size()), i,
+          BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+    Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Value");
+    result_record.emplace_back(std::move(column_clone));
+    i++;
+  }
+
+  RecordEncoder result_record_encoder(coprocessor_.schema_version(), result_serial_schemas_,
+                                      coprocessor_.result_schema().common_id());
+  ret = 0;
+  try {
+    ret = result_record_encoder.Encode(result_record, *result_kv);
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+  if (ret < 0) {
+    std::string error_message = fmt::format("serial::Encode failed");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  return butil::Status();
+}
+
 butil::Status Coprocessor::GetKeyValueFromAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
-                                                      std::vector<pb::common::KeyValue>* kvs) {
+                                                      KeyValueSink* sink) {
   butil::Status status;
 
   if (end_of_group_by_ && aggregation_manager_) {
     if (!aggregation_iterator_) {
       aggregation_iterator_ = aggregation_manager_->CreateIterator();
+      if (!aggregation_iterator_) {
+        std::string error_message = fmt::format("AggregationManager::CreateIterator failed");
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EINTERNAL, error_message);
+      }
     }
     ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
 
-    RecordEncoder result_record_encoder(coprocessor_.schema_version(), result_serial_schemas_,
-                                        coprocessor_.result_schema().common_id());
-
     while (aggregation_iterator_->HasNext()) {
       Utils::DebugGroupByKey("", "Key Value pair");
       const std::string& key = aggregation_iterator_->GetKey();
       const std::shared_ptr<std::vector<std::any>>& value = aggregation_iterator_->GetValue();
 
-      std::vector<std::any> result_key_record;
-      int ret = 0;
-      if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
-        RecordDecoder result_record_decoder(coprocessor_.schema_version(), group_by_key_serial_schemas_,
-                                            coprocessor_.result_schema().common_id());
-
-        try {
-          ret = result_record_decoder.DecodeKey(key, result_key_record);
-        } catch (const std::exception& my_exception) {
-          std::string error_message = fmt::format("serial::DecodeKey failed exception : {}", my_exception.what());
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-        if (ret < 0) {
-          std::string error_message = fmt::format("serial::DecodeKey failed");
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-      }
-
-      std::vector<std::any> result_record;
-      result_record.reserve(result_key_record.size() + value->size());
-      size_t i = 0;
-      for (const auto& column : result_key_record) {
-        std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
-        if (!column_clone.has_value()) {
-          std::string error_message = fmt::format(
-              "CloneColumn failed result_key_record index : {} result_serial_schemas_sorted_ i : {} "
-              "result_serial_schemas_sorted_ "
-              "type : {}",
-              i, i, BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-        Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Key");
-        result_record.emplace_back(std::move(column_clone));
-        i++;
-      }
-
-      for (const auto& column : *value) {
-        std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
-        if (!column_clone.has_value()) {
-          std::string error_message = fmt::format(
-              "CloneColumn failed result_aggregation_record  index : {} result_serial_schemas_sorted_ i : {} "
-              "result_serial_schemas_sorted_ type : {}",
-              (i - result_key_record.size()), i,
-              BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-        Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Value");
-        result_record.emplace_back(std::move(column_clone));
-        i++;
-      }
-
       pb::common::KeyValue result_key_value;
-      ret = 0;
-      try {
-        ret = result_record_encoder.Encode(result_record, result_key_value);
-      } catch (const std::exception& my_exception) {
-        std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
-        DINGO_LOG(ERROR) << error_message;
-        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-      }
-      if (ret < 0) {
-        std::string error_message = fmt::format("serial::Encode failed");
-        DINGO_LOG(ERROR) << error_message;
-        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      status = EncodeAggregationResult(key, *value, &result_key_value);
+      if (!status.ok()) {
+        return status;
       }
 
       if (key_only) {
         result_key_value.set_value("");
       }
 
-      kvs->emplace_back(result_key_value);
+      sink->Append(std::move(result_key_value));
 
-      if (scan_filter.UptoLimit(result_key_value)) {
+      if (scan_filter.UptoLimit(*sink->Back())) {
         aggregation_iterator_->Next();
         return butil::Status();
       }
 
       aggregation_iterator_->Next();
     }
+
+    // read spilled states failed
+    status = aggregation_iterator_->GetStatus();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("AggregationIterator failed, {}", status.error_cstr());
+      return status;
+    }
   }
 
   return butil::Status();
@@ -583,9 +1204,19 @@ void Coprocessor::Close() {
     result_serial_schemas_->clear();
   }
 
+  original_record_codec_.reset();
+
   enable_expression_ = false;
   end_of_group_by_ = false;
 
+  if (runner_) {
+    runner_.reset();
+  }
+
+  if (expression_) {
+    expression_.reset();
+  }
+
   if (aggregation_manager_) {
     aggregation_manager_.reset();
   }
@@ -594,8 +1225,21 @@ void Coprocessor::Close() {
     aggregation_iterator_.reset();
   }
 
+  if (top_n_) {
+    top_n_.reset();
+  }
+  top_n_pos_ = 0;
+  result_count_ = 0;
+  limit_reached_ = false;
+  streaming_aggregation_ = false;
+  streaming_group_key_.clear();
+  has_streaming_group_ = false;
+  partial_ = false;
+
   original_column_indexes_.clear();
   selection_column_indexes_.clear();
+  selection_column_types_.clear();
+  aggregation_column_indexes_.clear();
 
   if (original_serial_schemas_sorted_) {
     original_serial_schemas_sorted_.reset();
@@ -24,9 +24,15 @@
 
 #include "butil/status.h"
 #include "coprocessor/aggregation_manager.h"
+#include "coprocessor/column_batch.h"
+#include "coprocessor/expression.h"
+#include "coprocessor/top_n.h"
 #include "engine/iterator.h"
+#include "engine/key_value_sink.h"
+#include "libexpr/src/runner.h"
 #include "proto/store.pb.h"
 #include "scan/scan_filter.h"
+#include "serial/record_codec.h"
 
 namespace dingodb {
 
@@ -42,19 +48,72 @@ class Coprocessor {
 
   butil::Status Open(const pb::store::Coprocessor& coprocessor);
 
+  // Append the results to sink, at most max_fetch_cnt kvs or max_bytes_rpc bytes, no more result if nothing is
+  // appended.
+  butil::Status Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                        KeyValueSink* sink);
   butil::Status Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                         std::vector<pb::common::KeyValue>* kvs);
+
+  // Aggregation without streaming and order by could run on sub-ranges concurrently, then merge the partial results.
+  bool IsParallelizable() const;
+  // Aggregate or keep top n of the rows of iter, without output. The partial result is merged by MergePartial.
+  butil::Status ExecutePartial(IteratorPtr iter);
+  // Merge the partial result of a sub-range, in scan order of the sub-ranges.
+  butil::Status MergePartial(Coprocessor* partial);
+
+  // Memory quota of aggregation, the limit of request clamped by the store default if not set.
+  int64_t AggregationMemoryLimit() const;
+  // The sub-ranges of a parallel scan share the quota of the scan.
+  void SetAggregationMemoryLimit(int64_t memory_limit);
+
   void Close();
 
  private:
   butil::Status DoExecute(const pb::common::KeyValue& kv, bool* has_result_kv, pb::common::KeyValue* result_kv);
 
-  butil::Status DoExecuteForAggregation(const std::vector<std::any>& selection_record);
+  // Batch mode, decode rows to column batch, then filter/aggregate/encode the whole batch.
+  butil::Status ExecuteBatch(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                             KeyValueSink* sink);
+
+  butil::Status DoExecuteBatchForFilter(const ColumnBatch& batch, std::vector<uint32_t>& rows);
+
+  // sink is the output of the finished groups in streaming aggregation.
+  butil::Status DoExecuteBatchForAggregation(const ColumnBatch& batch, const std::vector<uint32_t>& rows,
+                                             KeyValueSink* sink);
+
+  butil::Status InitAggregationManager();
+
+  butil::Status DoExecuteForAggregation(const std::vector<std::any>& selection_record, bool* has_result_kv,
+                                        pb::common::KeyValue* result_kv);
+
+  // Streaming aggregation, when group by key changes, the current group is finished and encoded to result_kv.
+  butil::Status SwitchStreamingGroup(const std::string& group_by_key, bool* has_result_kv,
+                                     pb::common::KeyValue* result_kv);
+
+  butil::Status EncodeAggregationResult(const std::string& key, const std::vector<std::any>& value,
+                                        pb::common::KeyValue* result_kv);
 
   butil::Status DoExecuteForSelection(const std::vector<std::any>& selection_record, bool* has_result_kv,
                                       pb::common::KeyValue* result_kv);
+
+  // Keep the row in top n heap, the result key value is only encoded when the row is accepted.
+  butil::Status DoExecuteForTopN(const std::vector<std::any>& selection_record);
+
   butil::Status GetKeyValueFromAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
-                                           std::vector<pb::common::KeyValue>* kvs);
+                                           KeyValueSink* sink);
+  butil::Status GetKeyValueFromTopN(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc, KeyValueSink* sink);
+
+  // Count a selection result for limit, return true if reach limit.
+  bool UptoLimit();
+
+  butil::Status InitTopN();
+
+  // Decode the expression once, and compile it for batch mode if all operators are supported.
+  butil::Status InitExpression();
+
+  // Group by columns are the prefix of primary key, rows of a group are adjacent in scan order.
+  bool IsGroupByKeyPrefix() const;
 
   butil::Status CompareSerialSchema(const pb::store::Coprocessor& coprocessor);
 
@@ -65,6 +124,9 @@ class Coprocessor {
 
   pb::store::Coprocessor coprocessor_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas_;
+
+  // compiled codec of original_serial_schemas_, shared by the scans of same table and schema version
+  std::shared_ptr<RecordCodec> original_record_codec_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> selection_serial_schemas_;
   // such as  group by a, b ..
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_key_serial_schemas_;
@@ -74,11 +136,33 @@ class Coprocessor {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_serial_schemas_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
   bool enable_expression_;
+  // row mode and the fallback of batch mode
+  std::shared_ptr<expr::Runner> runner_;
+  // compiled expression of batch mode, nullptr if not supported
+  std::shared_ptr<Expression> expression_;
   bool end_of_group_by_;
   std::shared_ptr<AggregationManager> aggregation_manager_;
   std::shared_ptr<AggregationIterator> aggregation_iterator_;
   std::vector<int> original_column_indexes_;
   std::vector<int> selection_column_indexes_;
+  // column types of decoded record, same order as selection_column_indexes_
+  std::vector<BaseSchema::Type> selection_column_types_;
+  // batch column of every aggregation operator
+  std::vector<int> aggregation_column_indexes_;
+  // order by ... limit n
+  std::shared_ptr<TopN> top_n_;
+  size_t top_n_pos_;
+  // selection results of limit
+  int64_t result_count_;
+  bool limit_reached_;
+  // group by key prefix, only keep the current group in aggregation manager.
+  bool streaming_aggregation_;
+  std::string streaming_group_key_;
+  bool has_streaming_group_;
+  // executed by ExecutePartial, the result is not output.
+  bool partial_;
+  // set by SetAggregationMemoryLimit, 0 is not set
+  int64_t aggregation_memory_limit_;
 
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas_sorted_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> selection_serial_schemas_sorted_;
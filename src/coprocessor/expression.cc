@@ -0,0 +1,1016 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coprocessor/expression.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+// Codes of libexpr runner. null/const/var are combined with the type code in one byte, operators are followed by a
+// byte of the operand type, cast is followed by a byte of (dst type << 4 | src type).
+static constexpr uint8_t kTypeInt32 = 0x01;
+static constexpr uint8_t kTypeInt64 = 0x02;
+static constexpr uint8_t kTypeBool = 0x03;
+static constexpr uint8_t kTypeFloat = 0x04;
+static constexpr uint8_t kTypeDouble = 0x05;
+static constexpr uint8_t kTypeString = 0x07;
+
+static constexpr uint8_t kNull = 0x00;
+static constexpr uint8_t kConst = 0x10;
+static constexpr uint8_t kConstN = 0x20;
+static constexpr uint8_t kVarI = 0x30;
+
+static constexpr uint8_t kNot = 0x51;
+static constexpr uint8_t kAnd = 0x52;
+static constexpr uint8_t kOr = 0x53;
+
+static constexpr uint8_t kPos = 0x81;
+static constexpr uint8_t kNeg = 0x82;
+static constexpr uint8_t kAdd = 0x83;
+static constexpr uint8_t kSub = 0x84;
+static constexpr uint8_t kMul = 0x85;
+static constexpr uint8_t kDiv = 0x86;
+static constexpr uint8_t kMod = 0x87;
+
+static constexpr uint8_t kEq = 0x91;
+static constexpr uint8_t kGe = 0x92;
+static constexpr uint8_t kGt = 0x93;
+static constexpr uint8_t kLe = 0x94;
+static constexpr uint8_t kLt = 0x95;
+static constexpr uint8_t kNe = 0x96;
+
+static constexpr uint8_t kIsNull = 0xA1;
+static constexpr uint8_t kIsTrue = 0xA2;
+static constexpr uint8_t kIsFalse = 0xA3;
+
+static constexpr uint8_t kCast = 0xF0;
+
+// bool is stored as byte, std::vector<bool> could not be vectorized.
+using BoolValue = uint8_t;
+
+// Result of a node, indexed by row of batch, only the selected rows are valid.
+template <typename T>
+struct ValueVector {
+  std::vector<T> values;
+  std::vector<uint8_t> nulls;
+
+  void Resize(size_t size) {
+    if (values.size() < size) {
+      values.resize(size);
+      nulls.resize(size);
+    }
+  }
+};
+
+struct ExpressionResult : public ValueVector<BoolValue> {};
+
+// Rows to evaluate, all rows of batch if dense.
+struct Selection {
+  const uint32_t* rows;
+  size_t size;
+  size_t batch_size;
+
+  bool Dense() const { return size == batch_size; }
+};
+
+template <typename F>
+static inline void ForEachRow(const Selection& selection, F&& f) {
+  if (selection.Dense()) {
+    for (uint32_t row = 0; row < selection.batch_size; row++) {
+      f(row);
+    }
+  } else {
+    for (size_t i = 0; i < selection.size; i++) {
+      f(selection.rows[i]);
+    }
+  }
+}
+
+class ExpressionNode {
+ public:
+  explicit ExpressionNode(BaseSchema::Type type) : type_(type) {}
+  virtual ~ExpressionNode() = default;
+
+  BaseSchema::Type Type() const { return type_; }
+
+ private:
+  BaseSchema::Type type_;
+};
+
+template <typename T>
+class TypedNode : public ExpressionNode {
+ public:
+  using ExpressionNode::ExpressionNode;
+
+  virtual void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<T>& out) = 0;
+};
+
+using NodePtr = std::unique_ptr<ExpressionNode>;
+
+template <typename T>
+static TypedNode<T>* Typed(const NodePtr& node) {
+  return static_cast<TypedNode<T>*>(node.get());
+}
+
+// value type of expression and storage type of batch column
+template <typename T>
+struct ColumnType {
+  using Type = T;
+};
+template <>
+struct ColumnType<BoolValue> {
+  using Type = bool;
+};
+template <>
+struct ColumnType<std::string_view> {
+  using Type = std::shared_ptr<std::string>;
+};
+
+template <typename T>
+static inline T ColumnValue(const T& value) {
+  return value;
+}
+static inline std::string_view ColumnValue(const std::shared_ptr<std::string>& value) {
+  return value ? std::string_view(*value) : std::string_view();
+}
+
+template <typename T>
+class ColumnNode : public TypedNode<T> {
+ public:
+  ColumnNode(BaseSchema::Type type, int index) : TypedNode<T>(type), index_(index) {}
+
+  int Index() const { return index_; }
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<T>& out) override {
+    const auto& column = std::get<ColumnVector<typename ColumnType<T>::Type>>(batch.GetColumn(index_));
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      out.nulls[row] = column.nulls[row];
+      out.values[row] = static_cast<T>(ColumnValue(column.values[row]));
+    });
+  }
+
+ private:
+  int index_;
+};
+
+template <typename T>
+class ConstNode : public TypedNode<T> {
+ public:
+  ConstNode(BaseSchema::Type type, bool is_null, T value) : TypedNode<T>(type), is_null_(is_null), value_(value) {}
+  // string const own the string
+  ConstNode(BaseSchema::Type type, std::string&& str) : TypedNode<T>(type), is_null_(false), str_(std::move(str)) {
+    value_ = T(str_);
+  }
+
+  bool IsNull() const { return is_null_; }
+  T Value() const { return value_; }
+
+  void Eval(const ColumnBatch& /*batch*/, const Selection& selection, ValueVector<T>& out) override {
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      out.nulls[row] = is_null_;
+      out.values[row] = value_;
+    });
+  }
+
+ private:
+  bool is_null_;
+  std::string str_;
+  T value_;
+};
+
+// Op::Apply(value, result) return false if result is null.
+template <typename R, typename T, typename Op>
+class UnaryNode : public TypedNode<R> {
+ public:
+  UnaryNode(BaseSchema::Type type, NodePtr child) : TypedNode<R>(type), child_(std::move(child)) {}
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<R>& out) override {
+    Typed<T>(child_)->Eval(batch, selection, values_);
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      out.nulls[row] = values_.nulls[row] | !Op::Apply(values_.values[row], out.values[row]);
+    });
+  }
+
+ private:
+  NodePtr child_;
+  ValueVector<T> values_;
+};
+
+// Op::Apply(left, right, result) return false if result is null.
+template <typename R, typename T, typename Op>
+class BinaryNode : public TypedNode<R> {
+ public:
+  BinaryNode(BaseSchema::Type type, NodePtr left, NodePtr right)
+      : TypedNode<R>(type), left_(std::move(left)), right_(std::move(right)) {}
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<R>& out) override {
+    Typed<T>(left_)->Eval(batch, selection, left_values_);
+    Typed<T>(right_)->Eval(batch, selection, right_values_);
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      out.nulls[row] = left_values_.nulls[row] | right_values_.nulls[row] |
+                       !Op::Apply(left_values_.values[row], right_values_.values[row], out.values[row]);
+    });
+  }
+
+ private:
+  NodePtr left_;
+  NodePtr right_;
+  ValueVector<T> left_values_;
+  ValueVector<T> right_values_;
+};
+
+// Compare a numeric column with a const, most predicates of a scan. Loop over the column values directly,
+// the dense loop has no branch and is vectorized by compiler.
+template <typename T, typename Op>
+class ColumnConstCompareNode : public TypedNode<BoolValue> {
+ public:
+  ColumnConstCompareNode(int index, T value)
+      : TypedNode<BoolValue>(BaseSchema::Type::kBool), index_(index), value_(value) {}
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<BoolValue>& out) override {
+    const auto& column = std::get<ColumnVector<T>>(batch.GetColumn(index_));
+    out.Resize(selection.batch_size);
+
+    const T* values = column.values.data();
+    BoolValue* results = out.values.data();
+    const T value = value_;
+    if (selection.Dense()) {
+      for (size_t row = 0; row < selection.batch_size; row++) {
+        Op::Apply(values[row], value, results[row]);
+      }
+      for (size_t row = 0; row < selection.batch_size; row++) {
+        out.nulls[row] = column.nulls[row];
+      }
+    } else {
+      for (size_t i = 0; i < selection.size; i++) {
+        uint32_t row = selection.rows[i];
+        Op::Apply(values[row], value, results[row]);
+        out.nulls[row] = column.nulls[row];
+      }
+    }
+  }
+
+ private:
+  int index_;
+  T value_;
+};
+
+// AND short circuit on false, OR short circuit on true. The right side is only evaluated on the rows where the left
+// side is not the short circuit value. Null follows three-valued logic.
+template <BoolValue kShortCircuit>
+class LogicNode : public TypedNode<BoolValue> {
+ public:
+  LogicNode(NodePtr left, NodePtr right)
+      : TypedNode<BoolValue>(BaseSchema::Type::kBool), left_(std::move(left)), right_(std::move(right)) {}
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<BoolValue>& out) override {
+    Typed<BoolValue>(left_)->Eval(batch, selection, left_values_);
+
+    rows_.clear();
+    ForEachRow(selection, [&](uint32_t row) {
+      if (left_values_.nulls[row] || left_values_.values[row] != kShortCircuit) {
+        rows_.push_back(row);
+      }
+    });
+    if (!rows_.empty()) {
+      Typed<BoolValue>(right_)->Eval(batch, Selection{rows_.data(), rows_.size(), selection.batch_size},
+                                     right_values_);
+    }
+
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      bool left_null = left_values_.nulls[row];
+      if (!left_null && left_values_.values[row] == kShortCircuit) {
+        out.nulls[row] = 0;
+        out.values[row] = kShortCircuit;
+        return;
+      }
+
+      bool right_null = right_values_.nulls[row];
+      if (!right_null && right_values_.values[row] == kShortCircuit) {
+        out.nulls[row] = 0;
+        out.values[row] = kShortCircuit;
+      } else if (left_null || right_null) {
+        out.nulls[row] = 1;
+      } else {
+        out.nulls[row] = 0;
+        out.values[row] = !kShortCircuit;
+      }
+    });
+  }
+
+ private:
+  NodePtr left_;
+  NodePtr right_;
+  ValueVector<BoolValue> left_values_;
+  ValueVector<BoolValue> right_values_;
+  std::vector<uint32_t> rows_;
+};
+
+template <typename T>
+class IsNullNode : public TypedNode<BoolValue> {
+ public:
+  explicit IsNullNode(NodePtr child) : TypedNode<BoolValue>(BaseSchema::Type::kBool), child_(std::move(child)) {}
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<BoolValue>& out) override {
+    Typed<T>(child_)->Eval(batch, selection, values_);
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      out.nulls[row] = 0;
+      out.values[row] = values_.nulls[row];
+    });
+  }
+
+ private:
+  NodePtr child_;
+  ValueVector<T> values_;
+};
+
+// IS TRUE / IS FALSE, never null.
+template <BoolValue kValue>
+class IsValueNode : public TypedNode<BoolValue> {
+ public:
+  explicit IsValueNode(NodePtr child) : TypedNode<BoolValue>(BaseSchema::Type::kBool), child_(std::move(child)) {}
+
+  void Eval(const ColumnBatch& batch, const Selection& selection, ValueVector<BoolValue>& out) override {
+    Typed<BoolValue>(child_)->Eval(batch, selection, values_);
+    out.Resize(selection.batch_size);
+    ForEachRow(selection, [&](uint32_t row) {
+      out.nulls[row] = 0;
+      out.values[row] = !values_.nulls[row] && values_.values[row] == kValue;
+    });
+  }
+
+ private:
+  NodePtr child_;
+  ValueVector<BoolValue> values_;
+};
+
+struct NotOp {
+  static bool Apply(BoolValue value, BoolValue& result) {
+    result = !value;
+    return true;
+  }
+};
+
+struct NegOp {
+  template <typename T>
+  static bool Apply(T value, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      // wrap around like java, no undefined behavior of min value
+      result = static_cast<T>(0 - static_cast<std::make_unsigned_t<T>>(value));
+    } else {
+      result = -value;
+    }
+    return true;
+  }
+};
+
+template <typename R>
+struct CastOp {
+  template <typename T>
+  static bool Apply(T value, R& result) {
+    result = static_cast<R>(value);
+    return true;
+  }
+};
+
+struct AddOp {
+  template <typename T>
+  static bool Apply(T left, T right, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      result = static_cast<T>(static_cast<U>(left) + static_cast<U>(right));
+    } else {
+      result = left + right;
+    }
+    return true;
+  }
+};
+
+struct SubOp {
+  template <typename T>
+  static bool Apply(T left, T right, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      result = static_cast<T>(static_cast<U>(left) - static_cast<U>(right));
+    } else {
+      result = left - right;
+    }
+    return true;
+  }
+};
+
+struct MulOp {
+  template <typename T>
+  static bool Apply(T left, T right, T& result) {
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      result = static_cast<T>(static_cast<U>(left) * static_cast<U>(right));
+    } else {
+      result = left * right;
+    }
+    return true;
+  }
+};
+
+// divide by zero is null
+struct DivOp {
+  template <typename T>
+  static bool Apply(T left, T right, T& result) {
+    if (right == 0) {
+      return false;
+    }
+    if constexpr (std::is_integral_v<T>) {
+      if (right == -1) {
+        return NegOp::Apply(left, result);
+      }
+    }
+    result = left / right;
+    return true;
+  }
+};
+
+struct ModOp {
+  template <typename T>
+  static bool Apply(T left, T right, T& result) {
+    if (right == 0) {
+      return false;
+    }
+    if constexpr (std::is_integral_v<T>) {
+      result = right == -1 ? 0 : left % right;
+    } else {
+      result = std::fmod(left, right);
+    }
+    return true;
+  }
+};
+
+struct EqOp {
+  template <typename T>
+  static bool Apply(T left, T right, BoolValue& result) {
+    result = left == right;
+    return true;
+  }
+};
+
+struct NeOp {
+  template <typename T>
+  static bool Apply(T left, T right, BoolValue& result) {
+    result = left != right;
+    return true;
+  }
+};
+
+struct LtOp {
+  template <typename T>
+  static bool Apply(T left, T right, BoolValue& result) {
+    result = left < right;
+    return true;
+  }
+};
+
+struct LeOp {
+  template <typename T>
+  static bool Apply(T left, T right, BoolValue& result) {
+    result = left <= right;
+    return true;
+  }
+};
+
+struct GtOp {
+  template <typename T>
+  static bool Apply(T left, T right, BoolValue& result) {
+    result = left > right;
+    return true;
+  }
+};
+
+struct GeOp {
+  template <typename T>
+  static bool Apply(T left, T right, BoolValue& result) {
+    result = left >= right;
+    return true;
+  }
+};
+
+static bool ToSchemaType(uint8_t code, BaseSchema::Type& type) {
+  switch (code) {
+    case kTypeInt32:
+      type = BaseSchema::Type::kInteger;
+      return true;
+    case kTypeInt64:
+      type = BaseSchema::Type::kLong;
+      return true;
+    case kTypeBool:
+      type = BaseSchema::Type::kBool;
+      return true;
+    case kTypeFloat:
+      type = BaseSchema::Type::kFloat;
+      return true;
+    case kTypeDouble:
+      type = BaseSchema::Type::kDouble;
+      return true;
+    case kTypeString:
+      type = BaseSchema::Type::kString;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Call f with a value of the expression type, return false if the type is not supported.
+template <typename F>
+static bool VisitType(BaseSchema::Type type, F&& f) {
+  switch (type) {
+    case BaseSchema::Type::kBool:
+      f(BoolValue());
+      return true;
+    case BaseSchema::Type::kInteger:
+      f(int32_t());
+      return true;
+    case BaseSchema::Type::kLong:
+      f(int64_t());
+      return true;
+    case BaseSchema::Type::kFloat:
+      f(float());
+      return true;
+    case BaseSchema::Type::kDouble:
+      f(double());
+      return true;
+    case BaseSchema::Type::kString:
+      f(std::string_view());
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+static constexpr bool kIsNumeric = std::is_arithmetic_v<T> && !std::is_same_v<T, BoolValue>;
+
+static uint8_t MirrorCompare(uint8_t op) {
+  switch (op) {
+    case kLt:
+      return kGt;
+    case kLe:
+      return kGe;
+    case kGt:
+      return kLt;
+    case kGe:
+      return kLe;
+    default:
+      return op;
+  }
+}
+
+template <template <typename, typename> class Node, typename T, typename... Args>
+static NodePtr CreateCompareNode(uint8_t op, Args&&... args) {
+  switch (op) {
+    case kEq:
+      return std::make_unique<Node<T, EqOp>>(std::forward<Args>(args)...);
+    case kNe:
+      return std::make_unique<Node<T, NeOp>>(std::forward<Args>(args)...);
+    case kLt:
+      return std::make_unique<Node<T, LtOp>>(std::forward<Args>(args)...);
+    case kLe:
+      return std::make_unique<Node<T, LeOp>>(std::forward<Args>(args)...);
+    case kGt:
+      return std::make_unique<Node<T, GtOp>>(std::forward<Args>(args)...);
+    case kGe:
+      return std::make_unique<Node<T, GeOp>>(std::forward<Args>(args)...);
+    default:
+      return nullptr;
+  }
+}
+
+template <typename T, typename Op>
+using CompareNode = BinaryNode<BoolValue, T, Op>;
+
+template <typename T>
+static NodePtr CreateCompare(uint8_t op, NodePtr left, NodePtr right) {
+  if constexpr (kIsNumeric<T>) {
+    // column op const
+    auto* column = dynamic_cast<ColumnNode<T>*>(left.get());
+    auto* value = dynamic_cast<ConstNode<T>*>(right.get());
+    if (column != nullptr && value != nullptr && !value->IsNull()) {
+      return CreateCompareNode<ColumnConstCompareNode, T>(op, column->Index(), value->Value());
+    }
+
+    // const op column
+    column = dynamic_cast<ColumnNode<T>*>(right.get());
+    value = dynamic_cast<ConstNode<T>*>(left.get());
+    if (column != nullptr && value != nullptr && !value->IsNull()) {
+      return CreateCompareNode<ColumnConstCompareNode, T>(MirrorCompare(op), column->Index(), value->Value());
+    }
+  }
+
+  return CreateCompareNode<CompareNode, T>(op, BaseSchema::Type::kBool, std::move(left), std::move(right));
+}
+
+template <typename T>
+static NodePtr CreateArithmetic(uint8_t op, BaseSchema::Type type, NodePtr left, NodePtr right) {
+  switch (op) {
+    case kAdd:
+      return std::make_unique<BinaryNode<T, T, AddOp>>(type, std::move(left), std::move(right));
+    case kSub:
+      return std::make_unique<BinaryNode<T, T, SubOp>>(type, std::move(left), std::move(right));
+    case kMul:
+      return std::make_unique<BinaryNode<T, T, MulOp>>(type, std::move(left), std::move(right));
+    case kDiv:
+      return std::make_unique<BinaryNode<T, T, DivOp>>(type, std::move(left), std::move(right));
+    case kMod:
+      return std::make_unique<BinaryNode<T, T, ModOp>>(type, std::move(left), std::move(right));
+    default:
+      return nullptr;
+  }
+}
+
+// Decode the postfix code to the operator tree with a stack of nodes.
+class ExpressionCompiler {
+ public:
+  ExpressionCompiler(const std::string& code, const std::vector<BaseSchema::Type>& column_types)
+      : p_(reinterpret_cast<const uint8_t*>(code.data())),
+        end_(reinterpret_cast<const uint8_t*>(code.data()) + code.size()),
+        column_types_(column_types) {}
+
+  butil::Status Compile(NodePtr& root) {
+    while (p_ < end_) {
+      uint8_t code = *p_++;
+      bool ok = false;
+      switch (code & 0xF0) {
+        case kNull:
+          ok = CompileConst(code & 0x0F, true, false);
+          break;
+        case kConst:
+          ok = CompileConst(code & 0x0F, false, false);
+          break;
+        case kConstN:
+          ok = CompileConst(code & 0x0F, false, true);
+          break;
+        case kVarI:
+          ok = CompileVar(code & 0x0F);
+          break;
+        default:
+          ok = CompileOperator(code);
+          break;
+      }
+
+      if (!ok) {
+        return NotSupport(code);
+      }
+    }
+
+    if (stack_.size() != 1 || stack_.back()->Type() != BaseSchema::Type::kBool) {
+      return NotSupport(0);
+    }
+
+    root = std::move(stack_.back());
+    stack_.clear();
+    return butil::Status();
+  }
+
+ private:
+  butil::Status NotSupport(uint8_t code) {
+    std::string error_message =
+        fmt::format("compile expression failed, code : {:#04x} stack size : {} left bytes : {}. not support", code,
+                    stack_.size(), static_cast<size_t>(end_ - p_));
+    DINGO_LOG(DEBUG) << error_message;
+    return butil::Status(pb::error::ENOT_SUPPORT, error_message);
+  }
+
+  bool ReadByte(uint8_t& value) {
+    if (p_ >= end_) {
+      return false;
+    }
+    value = *p_++;
+    return true;
+  }
+
+  bool ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = 0;
+      if (!ReadByte(byte)) {
+        return false;
+      }
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // big endian
+  template <typename T, typename U>
+  bool ReadFixed(T& value) {
+    static_assert(sizeof(T) == sizeof(U));
+    if (end_ - p_ < static_cast<ptrdiff_t>(sizeof(U))) {
+      return false;
+    }
+    U bits = 0;
+    for (size_t i = 0; i < sizeof(U); i++) {
+      bits = (bits << 8) | *p_++;
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+  }
+
+  bool Pop(NodePtr& node) {
+    if (stack_.empty()) {
+      return false;
+    }
+    node = std::move(stack_.back());
+    stack_.pop_back();
+    return true;
+  }
+
+  bool CompileConst(uint8_t type_code, bool is_null, bool negative) {
+    BaseSchema::Type type;
+    if (!ToSchemaType(type_code, type)) {
+      return false;
+    }
+
+    bool ok = true;
+    VisitType(type, [&](auto tag) {
+      using T = decltype(tag);
+      if (is_null) {
+        stack_.push_back(std::make_unique<ConstNode<T>>(type, true, T()));
+        return;
+      }
+
+      if constexpr (std::is_same_v<T, BoolValue>) {
+        stack_.push_back(std::make_unique<ConstNode<T>>(type, false, negative ? 0 : 1));
+      } else if constexpr (std::is_integral_v<T>) {
+        uint64_t value = 0;
+        ok = ReadVarint(value);
+        T result = static_cast<T>(value);
+        if (negative) {
+          NegOp::Apply(result, result);
+        }
+        stack_.push_back(std::make_unique<ConstNode<T>>(type, false, result));
+      } else if constexpr (std::is_same_v<T, float>) {
+        float value = 0;
+        ok = ReadFixed<float, uint32_t>(value);
+        stack_.push_back(std::make_unique<ConstNode<T>>(type, false, negative ? -value : value));
+      } else if constexpr (std::is_same_v<T, double>) {
+        double value = 0;
+        ok = ReadFixed<double, uint64_t>(value);
+        stack_.push_back(std::make_unique<ConstNode<T>>(type, false, negative ? -value : value));
+      } else {
+        uint64_t size = 0;
+        ok = !negative && ReadVarint(size) && end_ - p_ >= static_cast<ptrdiff_t>(size);
+        if (ok) {
+          std::string str(reinterpret_cast<const char*>(p_), size);
+          p_ += size;
+          stack_.push_back(std::make_unique<ConstNode<T>>(type, std::move(str)));
+        }
+      }
+    });
+
+    return ok;
+  }
+
+  bool CompileVar(uint8_t type_code) {
+    BaseSchema::Type type;
+    uint64_t index = 0;
+    if (!ToSchemaType(type_code, type) || !ReadVarint(index)) {
+      return false;
+    }
+    // the column must be decoded as the type of var
+    if (index >= column_types_.size() || column_types_[index] != type) {
+      return false;
+    }
+
+    VisitType(type, [&](auto tag) {
+      using T = decltype(tag);
+      stack_.push_back(std::make_unique<ColumnNode<T>>(type, static_cast<int>(index)));
+    });
+    return true;
+  }
+
+  bool CompileOperator(uint8_t code) {
+    switch (code) {
+      case kNot:
+      case kIsTrue:
+      case kIsFalse: {
+        if (code != kNot) {
+          // operand type of is true/false
+          uint8_t type_code = 0;
+          if (!ReadByte(type_code) || type_code != kTypeBool) {
+            return false;
+          }
+        }
+        NodePtr child;
+        if (!Pop(child) || child->Type() != BaseSchema::Type::kBool) {
+          return false;
+        }
+        if (code == kNot) {
+          stack_.push_back(
+              std::make_unique<UnaryNode<BoolValue, BoolValue, NotOp>>(BaseSchema::Type::kBool, std::move(child)));
+        } else if (code == kIsTrue) {
+          stack_.push_back(std::make_unique<IsValueNode<1>>(std::move(child)));
+        } else {
+          stack_.push_back(std::make_unique<IsValueNode<0>>(std::move(child)));
+        }
+        return true;
+      }
+      case kAnd:
+      case kOr: {
+        NodePtr right;
+        NodePtr left;
+        if (!Pop(right) || !Pop(left) || left->Type() != BaseSchema::Type::kBool ||
+            right->Type() != BaseSchema::Type::kBool) {
+          return false;
+        }
+        if (code == kAnd) {
+          stack_.push_back(std::make_unique<LogicNode<0>>(std::move(left), std::move(right)));
+        } else {
+          stack_.push_back(std::make_unique<LogicNode<1>>(std::move(left), std::move(right)));
+        }
+        return true;
+      }
+      case kIsNull:
+      case kPos:
+      case kNeg:
+        return CompileUnary(code);
+      case kAdd:
+      case kSub:
+      case kMul:
+      case kDiv:
+      case kMod:
+      case kEq:
+      case kGe:
+      case kGt:
+      case kLe:
+      case kLt:
+      case kNe:
+        return CompileBinary(code);
+      case kCast:
+        return CompileCast();
+      default:
+        return false;
+    }
+  }
+
+  bool CompileUnary(uint8_t code) {
+    uint8_t type_code = 0;
+    BaseSchema::Type type;
+    NodePtr child;
+    if (!ReadByte(type_code) || !ToSchemaType(type_code, type) || !Pop(child) || child->Type() != type) {
+      return false;
+    }
+
+    bool ok = true;
+    VisitType(type, [&](auto tag) {
+      using T = decltype(tag);
+      if (code == kIsNull) {
+        stack_.push_back(std::make_unique<IsNullNode<T>>(std::move(child)));
+      } else if constexpr (kIsNumeric<T>) {
+        if (code == kPos) {
+          stack_.push_back(std::move(child));
+        } else {
+          stack_.push_back(std::make_unique<UnaryNode<T, T, NegOp>>(type, std::move(child)));
+        }
+      } else {
+        ok = false;
+      }
+    });
+    return ok;
+  }
+
+  bool CompileBinary(uint8_t code) {
+    uint8_t type_code = 0;
+    BaseSchema::Type type;
+    NodePtr right;
+    NodePtr left;
+    if (!ReadByte(type_code) || !ToSchemaType(type_code, type) || !Pop(right) || !Pop(left) ||
+        left->Type() != type || right->Type() != type) {
+      return false;
+    }
+
+    NodePtr node;
+    VisitType(type, [&](auto tag) {
+      using T = decltype(tag);
+      if (code >= kEq && code <= kNe) {
+        node = CreateCompare<T>(code, std::move(left), std::move(right));
+      } else if constexpr (kIsNumeric<T>) {
+        node = CreateArithmetic<T>(code, type, std::move(left), std::move(right));
+      }
+    });
+    if (!node) {
+      return false;
+    }
+
+    stack_.push_back(std::move(node));
+    return true;
+  }
+
+  bool CompileCast() {
+    uint8_t types = 0;
+    BaseSchema::Type dst_type;
+    BaseSchema::Type src_type;
+    NodePtr child;
+    if (!ReadByte(types) || !ToSchemaType(types >> 4, dst_type) || !ToSchemaType(types & 0x0F, src_type) ||
+        !Pop(child) || child->Type() != src_type) {
+      return false;
+    }
+
+    if (dst_type == src_type) {
+      stack_.push_back(std::move(child));
+      return true;
+    }
+
+    // only widening casts, others have rounding/parsing rules of libexpr
+    NodePtr node;
+    VisitType(dst_type, [&](auto dst_tag) {
+      using R = decltype(dst_tag);
+      VisitType(src_type, [&](auto src_tag) {
+        using T = decltype(src_tag);
+        if constexpr (kIsNumeric<R> && kIsNumeric<T> && !(std::is_integral_v<R> && std::is_floating_point_v<T>) &&
+                      sizeof(R) >= sizeof(T)) {
+          node = std::make_unique<UnaryNode<R, T, CastOp<R>>>(dst_type, std::move(child));
+        }
+      });
+    });
+    if (!node) {
+      return false;
+    }
+
+    stack_.push_back(std::move(node));
+    return true;
+  }
+
+  const uint8_t* p_;
+  const uint8_t* end_;
+  const std::vector<BaseSchema::Type>& column_types_;
+  std::vector<NodePtr> stack_;
+};
+
+Expression::Expression() : result_(std::make_unique<ExpressionResult>()) {}
+Expression::~Expression() = default;
+
+butil::Status Expression::Compile(const std::string& code, const std::vector<BaseSchema::Type>& column_types) {
+  root_.reset();
+
+  ExpressionCompiler compiler(code, column_types);
+  return compiler.Compile(root_);
+}
+
+butil::Status Expression::Filter(const ColumnBatch& batch, std::vector<uint32_t>& rows) {
+  rows.clear();
+  if (!root_) {
+    std::string error_message = fmt::format("expression not compiled");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EINTERNAL, error_message);
+  }
+
+  try {
+    Typed<BoolValue>(root_)->Eval(batch, Selection{nullptr, batch.Size(), batch.Size()}, *result_);
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("expression eval failed exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  for (uint32_t row = 0; row < batch.Size(); row++) {
+    if (!result_->nulls[row] && result_->values[row]) {
+      rows.push_back(row);
+    }
+  }
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COPROCESSOR_EXPRESSION_H_  // NOLINT
+#define DINGODB_COPROCESSOR_EXPRESSION_H_
+
+#include <serial/schema/base_schema.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/column_batch.h"
+
+namespace dingodb {
+
+class ExpressionNode;
+struct ExpressionResult;
+
+// Filter expression of coprocessor, compiled once from the postfix code of libexpr runner to a typed operator tree,
+// then evaluated column by column over a batch. AND/OR only evaluate the right side on rows not decided by the left
+// side, compare of a column and a const is a tight loop over the column values.
+// Supported: bool/int/long/float/double/string of null, const, var, compare, not/and/or, is null/true/false,
+// arithmetic and numeric cast. Compile return ENOT_SUPPORT for others, the caller should fallback to libexpr runner.
+class Expression {
+ public:
+  Expression();
+  ~Expression();
+
+  Expression(const Expression& rhs) = delete;
+  Expression& operator=(const Expression& rhs) = delete;
+  Expression(Expression&& rhs) = delete;
+  Expression& operator=(Expression&& rhs) = delete;
+
+  // column_types is the type of batch columns, var index of expression is the batch column.
+  butil::Status Compile(const std::string& code, const std::vector<BaseSchema::Type>& column_types);
+
+  // rows is the rows of batch where the expression is true, null is same as false.
+  butil::Status Filter(const ColumnBatch& batch, std::vector<uint32_t>& rows);
+
+ private:
+  std::unique_ptr<ExpressionNode> root_;
+  std::unique_ptr<ExpressionResult> result_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_EXPRESSION_H_  // NOLINT
@@ -0,0 +1,225 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coprocessor/top_n.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "serial/buf.h"
+#include "serial/schema/boolean_schema.h"
+#include "serial/schema/double_schema.h"
+#include "serial/schema/float_schema.h"
+#include "serial/schema/integer_schema.h"
+#include "serial/schema/long_schema.h"
+#include "serial/schema/string_schema.h"
+#include "serial/utils.h"
+
+namespace dingodb {
+
+template <typename T>
+static std::shared_ptr<BaseSchema> CreateSortKeySchema() {
+  auto schema = std::make_shared<DingoSchema<std::optional<T>>>();
+  schema->SetAllowNull(true);
+  schema->SetIsKey(true);
+  if constexpr (!std::is_same_v<T, bool> && !std::is_same_v<T, std::shared_ptr<std::string>>) {
+    schema->SetIsLe(IsLE());
+  }
+  return schema;
+}
+
+template <typename T>
+static void EncodeSortKeyColumn(const std::shared_ptr<BaseSchema>& schema, const std::any& column, Buf* buf) {
+  auto typed_schema = std::dynamic_pointer_cast<DingoSchema<std::optional<T>>>(schema);
+  typed_schema->EncodeKeyPrefix(buf, std::any_cast<std::optional<T>>(column));
+}
+
+TopN::TopN() : limit_(0), sequence_(0), finished_(false) {}
+TopN::~TopN() { Close(); }
+
+butil::Status TopN::Open(const ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy>& order_by_columns,
+                         const std::vector<BaseSchema::Type>& selection_column_types, size_t limit) {
+  Close();
+
+  if (limit == 0) {
+    std::string error_message = fmt::format("order by without limit. not support");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  for (const auto& order_by : order_by_columns) {
+    int index = order_by.index_of_column();
+    if (index < 0 || index >= selection_column_types.size()) {
+      std::string error_message =
+          fmt::format("order_by_columns index:{} < 0 || >= selection_columns.size : {} . not support", index,
+                      selection_column_types.size());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+
+    std::shared_ptr<BaseSchema> schema;
+    switch (selection_column_types[index]) {
+      case BaseSchema::Type::kBool:
+        schema = CreateSortKeySchema<bool>();
+        break;
+      case BaseSchema::Type::kInteger:
+        schema = CreateSortKeySchema<int32_t>();
+        break;
+      case BaseSchema::Type::kFloat:
+        schema = CreateSortKeySchema<float>();
+        break;
+      case BaseSchema::Type::kLong:
+        schema = CreateSortKeySchema<int64_t>();
+        break;
+      case BaseSchema::Type::kDouble:
+        schema = CreateSortKeySchema<double>();
+        break;
+      case BaseSchema::Type::kString:
+        schema = CreateSortKeySchema<std::shared_ptr<std::string>>();
+        break;
+      default: {
+        std::string error_message = fmt::format("order by column index:{} type : {}. not support", index,
+                                                BaseSchema::GetTypeString(selection_column_types[index]));
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      }
+    }
+
+    indexes_.push_back(index);
+    descs_.push_back(order_by.desc());
+    schemas_.push_back(std::move(schema));
+  }
+
+  limit_ = limit;
+  rows_.reserve(std::min(limit_, static_cast<size_t>(1024)));
+
+  return butil::Status();
+}
+
+butil::Status TopN::EncodeSortKey(const std::vector<std::any>& record, std::string& sort_key) {
+  sort_key.clear();
+
+  std::string column_key;
+  for (size_t i = 0; i < schemas_.size(); i++) {
+    Buf buf(16, IsLE());
+    try {
+      const auto& column = record[indexes_[i]];
+      switch (schemas_[i]->GetType()) {
+        case BaseSchema::Type::kBool:
+          EncodeSortKeyColumn<bool>(schemas_[i], column, &buf);
+          break;
+        case BaseSchema::Type::kInteger:
+          EncodeSortKeyColumn<int32_t>(schemas_[i], column, &buf);
+          break;
+        case BaseSchema::Type::kFloat:
+          EncodeSortKeyColumn<float>(schemas_[i], column, &buf);
+          break;
+        case BaseSchema::Type::kLong:
+          EncodeSortKeyColumn<int64_t>(schemas_[i], column, &buf);
+          break;
+        case BaseSchema::Type::kDouble:
+          EncodeSortKeyColumn<double>(schemas_[i], column, &buf);
+          break;
+        case BaseSchema::Type::kString:
+          EncodeSortKeyColumn<std::shared_ptr<std::string>>(schemas_[i], column, &buf);
+          break;
+        default:
+          break;
+      }
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("encode sort key failed exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+
+    buf.GetBytes(column_key);
+    if (descs_[i]) {
+      for (auto& c : column_key) {
+        c = static_cast<char>(~static_cast<uint8_t>(c));
+      }
+    }
+    sort_key.append(column_key);
+  }
+
+  // big endian sequence, the earlier row is smaller when sort key is same.
+  uint64_t sequence = sequence_++;
+  for (int i = 7; i >= 0; i--) {
+    sort_key.push_back(static_cast<char>((sequence >> (i * 8)) & 0xFF));
+  }
+
+  return butil::Status();
+}
+
+bool TopN::Accept(const std::string& sort_key) const {
+  return rows_.size() < limit_ || sort_key < rows_.front().sort_key;
+}
+
+void TopN::Push(std::string&& sort_key, pb::common::KeyValue&& kv) {
+  if (rows_.size() >= limit_) {
+    // replace the largest row
+    std::pop_heap(rows_.begin(), rows_.end(), Less);
+    rows_.pop_back();
+  }
+
+  rows_.push_back(Row{std::move(sort_key), std::move(kv)});
+  std::push_heap(rows_.begin(), rows_.end(), Less);
+}
+
+void TopN::Merge(TopN* other) {
+  other->Finish();
+
+  for (auto& row : other->rows_) {
+    // replace the sequence of other with the sequence of this
+    uint64_t sequence = sequence_++;
+    for (int i = 0; i < 8; i++) {
+      row.sort_key[row.sort_key.size() - 8 + i] = static_cast<char>((sequence >> ((7 - i) * 8)) & 0xFF);
+    }
+
+    if (!Accept(row.sort_key)) {
+      // rows of other are sorted, the rest are not in top n either
+      break;
+    }
+    Push(std::move(row.sort_key), std::move(row.kv));
+  }
+
+  other->rows_.clear();
+}
+
+void TopN::Finish() {
+  if (!finished_) {
+    std::sort_heap(rows_.begin(), rows_.end(), Less);
+    finished_ = true;
+  }
+}
+
+void TopN::Close() {
+  indexes_.clear();
+  descs_.clear();
+  schemas_.clear();
+  limit_ = 0;
+  sequence_ = 0;
+  finished_ = false;
+  rows_.clear();
+}
+
+}  // namespace dingodb
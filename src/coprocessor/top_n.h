@@ -0,0 +1,91 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COPROCESSOR_TOP_N_H_  // NOLINT
+#define DINGODB_COPROCESSOR_TOP_N_H_
+
+#include <serial/schema/base_schema.h>
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Keep the first limit rows of a region ordered by order by columns.
+// The sort key is the memcomparable key encoding of the order by columns, bytes of desc column are inverted,
+// null is the smallest value. Rows with the same sort key keep scan order.
+class TopN {
+ public:
+  TopN();
+  ~TopN();
+
+  TopN(const TopN& rhs) = delete;
+  TopN& operator=(const TopN& rhs) = delete;
+  TopN(TopN&& rhs) = delete;
+  TopN& operator=(TopN&& rhs) = delete;
+
+  // selection_column_types is the type of selection record, index_of_column of order by is the selection column.
+  butil::Status Open(const ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy>& order_by_columns,
+                     const std::vector<BaseSchema::Type>& selection_column_types, size_t limit);
+
+  butil::Status EncodeSortKey(const std::vector<std::any>& record, std::string& sort_key);
+
+  // Whether a row of sort key could be in top n, check before encoding the result key value.
+  bool Accept(const std::string& sort_key) const;
+
+  void Push(std::string&& sort_key, pb::common::KeyValue&& kv);
+
+  // Push the rows of other, such as the partial result of a sub-range, other is empty after merge.
+  // Merge in scan order of the sub-ranges, so rows with the same sort key keep scan order.
+  void Merge(TopN* other);
+
+  // Sort the rows, then could be read by Size/Get. Call more than once is ok.
+  void Finish();
+
+  size_t Size() const { return rows_.size(); }
+
+  const pb::common::KeyValue& Get(size_t i) const { return rows_[i].kv; }
+
+  void Close();
+
+ private:
+  struct Row {
+    std::string sort_key;
+    pb::common::KeyValue kv;
+  };
+
+  static bool Less(const Row& lhs, const Row& rhs) { return lhs.sort_key < rhs.sort_key; }
+
+  std::vector<int> indexes_;
+  std::vector<bool> descs_;
+  std::vector<std::shared_ptr<BaseSchema>> schemas_;
+  size_t limit_;
+  // scan sequence, appended to sort key for stable order
+  uint64_t sequence_;
+  bool finished_;
+  // max heap of sort key before Finish, sorted rows after Finish.
+  std::vector<Row> rows_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_TOP_N_H_  // NOLINT
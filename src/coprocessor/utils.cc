@@ -981,6 +981,14 @@ bool Utils::CoprocessorParamEmpty(const pb::store::Coprocessor& coprocessor) {
     return false;
   }
 
+  if (!coprocessor.order_by_columns().empty()) {
+    return false;
+  }
+
+  if (0 != coprocessor.limit()) {
+    return false;
+  }
+
   return true;
 }
 
@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_KEY_VALUE_SINK_H_  // NOLINT
+#define DINGODB_ENGINE_KEY_VALUE_SINK_H_
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/repeated_field.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Output of scan, the kvs are written to the place they are returned from, such as the response, without an
+// intermediate vector of pb::common::KeyValue.
+class KeyValueSink {
+ public:
+  KeyValueSink() = default;
+  virtual ~KeyValueSink() = default;
+
+  KeyValueSink(const KeyValueSink& rhs) = delete;
+  KeyValueSink& operator=(const KeyValueSink& rhs) = delete;
+
+  // Copy the slices of key and value, such as the key and value of iterator.
+  virtual void Append(std::string_view key, std::string_view value) = 0;
+  // Take the kv built by caller.
+  virtual void Append(pb::common::KeyValue&& kv) = 0;
+
+  virtual size_t Size() const = 0;
+  virtual pb::common::KeyValue* Mutable(size_t index) = 0;
+
+  bool Empty() const { return Size() == 0; }
+  pb::common::KeyValue* Back() { return Mutable(Size() - 1); }
+};
+
+// Append to std::vector, for the callers still want a vector.
+class VectorKeyValueSink : public KeyValueSink {
+ public:
+  explicit VectorKeyValueSink(std::vector<pb::common::KeyValue>* kvs) : kvs_(kvs) {}
+  ~VectorKeyValueSink() override = default;
+
+  void Append(std::string_view key, std::string_view value) override {
+    auto& kv = kvs_->emplace_back();
+    kv.set_key(key.data(), key.size());
+    kv.set_value(value.data(), value.size());
+  }
+  void Append(pb::common::KeyValue&& kv) override { kvs_->emplace_back(std::move(kv)); }
+
+  size_t Size() const override { return kvs_->size(); }
+  pb::common::KeyValue* Mutable(size_t index) override { return &(*kvs_)[index]; }
+
+ private:
+  std::vector<pb::common::KeyValue>* kvs_;
+};
+
+// Append to the repeated field of response, the kv is allocated on the arena of response if it has one.
+class RepeatedKeyValueSink : public KeyValueSink {
+ public:
+  explicit RepeatedKeyValueSink(google::protobuf::RepeatedPtrField<pb::common::KeyValue>* kvs) : kvs_(kvs) {}
+  ~RepeatedKeyValueSink() override = default;
+
+  void Append(std::string_view key, std::string_view value) override {
+    auto* kv = kvs_->Add();
+    kv->set_key(key.data(), key.size());
+    kv->set_value(value.data(), value.size());
+  }
+  void Append(pb::common::KeyValue&& kv) override { *kvs_->Add() = std::move(kv); }
+
+  size_t Size() const override { return kvs_->size(); }
+  pb::common::KeyValue* Mutable(size_t index) override { return kvs_->Mutable(index); }
+
+ private:
+  google::protobuf::RepeatedPtrField<pb::common::KeyValue>* kvs_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_KEY_VALUE_SINK_H_  // NOLINT
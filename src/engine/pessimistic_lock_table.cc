@@ -0,0 +1,192 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/pessimistic_lock_table.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "proto/store.pb.h"
+
+DEFINE_bool(enable_pessimistic_lock_in_memory, true, "keep pessimistic locks in memory of region leader");
+
+namespace dingodb {
+
+PessimisticLockTable& PessimisticLockTable::GetInstance() {
+  static PessimisticLockTable instance;
+  return instance;
+}
+
+bool PessimisticLockTable::Get(const std::string& key, pb::store::LockInfo& lock_info) {
+  if (Size() == 0) {
+    return false;
+  }
+
+  auto& shard = GetShard(key);
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  auto it = shard.one_pc_locks.find(key);
+  if (it == shard.one_pc_locks.end()) {
+    it = shard.locks.find(key);
+    if (it == shard.locks.end()) {
+      return false;
+    }
+  }
+
+  lock_info = it->second;
+  return true;
+}
+
+bool PessimisticLockTable::GetPessimisticLock(const std::string& key, pb::store::LockInfo& lock_info) {
+  if (Size() == 0) {
+    return false;
+  }
+
+  auto& shard = GetShard(key);
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  auto it = shard.locks.find(key);
+  if (it == shard.locks.end()) {
+    return false;
+  }
+
+  lock_info = it->second;
+  return true;
+}
+
+void PessimisticLockTable::Put(const pb::store::LockInfo& lock_info) {
+  auto& shard = GetShard(lock_info.key());
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  auto ret = shard.locks.insert_or_assign(lock_info.key(), lock_info);
+  if (ret.second) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void PessimisticLockTable::Erase(const std::string& key) {
+  if (Size() == 0) {
+    return;
+  }
+
+  auto& shard = GetShard(key);
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  if (shard.locks.erase(key) > 0) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+bool PessimisticLockTable::EraseIfMatch(const std::string& key, int64_t lock_ts, int64_t for_update_ts) {
+  if (Size() == 0) {
+    return false;
+  }
+
+  auto& shard = GetShard(key);
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  auto it = shard.locks.find(key);
+  if (it == shard.locks.end() || it->second.lock_ts() != lock_ts || it->second.for_update_ts() != for_update_ts) {
+    return false;
+  }
+
+  shard.locks.erase(it);
+  size_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+void PessimisticLockTable::EraseRange(const std::string& start_key, const std::string& end_key) {
+  if (Size() == 0) {
+    return;
+  }
+
+  for (auto& shard : shards_) {
+    std::unique_lock<bthread::Mutex> lock(shard.mutex);
+    size_t count = 0;
+    for (auto it = shard.locks.begin(); it != shard.locks.end();) {
+      if (it->first >= start_key && it->first < end_key) {
+        it = shard.locks.erase(it);
+        ++count;
+      } else {
+        ++it;
+      }
+    }
+    if (count > 0) {
+      size_.fetch_sub(count, std::memory_order_relaxed);
+    }
+  }
+}
+
+void PessimisticLockTable::PutOnePcLock(const pb::store::LockInfo& lock_info) {
+  auto& shard = GetShard(lock_info.key());
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  auto ret = shard.one_pc_locks.insert_or_assign(lock_info.key(), lock_info);
+  if (ret.second) {
+    size_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void PessimisticLockTable::EraseOnePcLock(const std::string& key) {
+  if (Size() == 0) {
+    return;
+  }
+
+  auto& shard = GetShard(key);
+  std::unique_lock<bthread::Mutex> lock(shard.mutex);
+  if (shard.one_pc_locks.erase(key) > 0) {
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+std::vector<pb::store::LockInfo> PessimisticLockTable::GetLocks(const std::string& start_key,
+                                                                const std::string& end_key) {
+  std::vector<pb::store::LockInfo> lock_infos;
+  if (Size() == 0) {
+    return lock_infos;
+  }
+
+  for (auto& shard : shards_) {
+    std::unique_lock<bthread::Mutex> lock(shard.mutex);
+    for (const auto& [key, lock_info] : shard.one_pc_locks) {
+      if (key >= start_key && key < end_key) {
+        lock_infos.push_back(lock_info);
+      }
+    }
+    for (const auto& [key, lock_info] : shard.locks) {
+      if (key >= start_key && key < end_key && shard.one_pc_locks.count(key) == 0) {
+        lock_infos.push_back(lock_info);
+      }
+    }
+  }
+
+  return lock_infos;
+}
+
+std::vector<pb::store::LockInfo> PessimisticLockTable::GetPessimisticLocks(const std::string& start_key,
+                                                                           const std::string& end_key) {
+  std::vector<pb::store::LockInfo> lock_infos;
+  if (Size() == 0) {
+    return lock_infos;
+  }
+
+  for (auto& shard : shards_) {
+    std::unique_lock<bthread::Mutex> lock(shard.mutex);
+    for (const auto& [key, lock_info] : shard.locks) {
+      if (key >= start_key && key < end_key) {
+        lock_infos.push_back(lock_info);
+      }
+    }
+  }
+
+  return lock_infos;
+}
+
+}  // namespace dingodb
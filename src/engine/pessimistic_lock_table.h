@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_PESSIMISTIC_LOCK_TABLE_H_  // NOLINT
+#define DINGODB_ENGINE_PESSIMISTIC_LOCK_TABLE_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "gflags/gflags.h"
+#include "proto/store.pb.h"
+
+DECLARE_bool(enable_pessimistic_lock_in_memory);
+
+namespace dingodb {
+
+// The pessimistic locks of the region leaders on this store, they are not written to lock cf until the txn prewrites
+// them, or the region leaves the leader by transfer, split or merge. The locks are lost if the leader stops by other
+// reasons, the prewrite of the txn finds it by pessimistic check and the client retries.
+// The keys of regions on a store do not overlap, so the table is keyed by user key.
+// The locks of a 1PC prewrite are kept here apart from the pessimistic locks while its write is in flight. The
+// readers see them, but they are never flushed to lock cf nor erased by the applied writes, only by the 1PC itself.
+class PessimisticLockTable {
+ public:
+  static PessimisticLockTable& GetInstance();
+
+  PessimisticLockTable(const PessimisticLockTable& rhs) = delete;
+  PessimisticLockTable& operator=(const PessimisticLockTable& rhs) = delete;
+
+  // Return false if the key has no lock in memory, the 1PC lock of the key goes first.
+  bool Get(const std::string& key, pb::store::LockInfo& lock_info);
+  // Return false if the key has no pessimistic lock in memory.
+  bool GetPessimisticLock(const std::string& key, pb::store::LockInfo& lock_info);
+  // Put the lock of lock_info.key(), the lock of the same key is replaced.
+  void Put(const pb::store::LockInfo& lock_info);
+  void Erase(const std::string& key);
+  // Remove the lock of key only if it is the lock of lock_ts and for_update_ts, return false if it is not.
+  bool EraseIfMatch(const std::string& key, int64_t lock_ts, int64_t for_update_ts);
+  void EraseRange(const std::string& start_key, const std::string& end_key);
+
+  void PutOnePcLock(const pb::store::LockInfo& lock_info);
+  void EraseOnePcLock(const std::string& key);
+
+  // The locks of keys in [start_key, end_key), the 1PC lock of a key goes first.
+  std::vector<pb::store::LockInfo> GetLocks(const std::string& start_key, const std::string& end_key);
+  // The pessimistic locks of keys in [start_key, end_key), without the 1PC locks.
+  std::vector<pb::store::LockInfo> GetPessimisticLocks(const std::string& start_key, const std::string& end_key);
+
+  int64_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  PessimisticLockTable() = default;
+  ~PessimisticLockTable() = default;
+
+  static const size_t kShardNum = 64;
+
+  struct Shard {
+    bthread::Mutex mutex;
+    std::unordered_map<std::string, pb::store::LockInfo> locks;
+    std::unordered_map<std::string, pb::store::LockInfo> one_pc_locks;
+  };
+
+  Shard& GetShard(const std::string& key) { return shards_[std::hash<std::string>{}(key) % kShardNum]; }
+
+  std::array<Shard, kShardNum> shards_;
+  // the count of pessimistic locks and 1PC locks
+  std::atomic<int64_t> size_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_PESSIMISTIC_LOCK_TABLE_H_  // NOLINT
@@ -327,8 +327,20 @@ butil::Status RaftStoreEngine::TransferLeader(int64_t region_id, const pb::commo
     return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
   }
 
+  // the new leader knows nothing about the pessimistic locks in memory of this store
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region != nullptr) {
+    auto status = TxnEngineHelper::FlushPessimisticLocks(Server::GetInstance().GetEngine(), region);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   auto ret = node->TransferLeadershipTo(Helper::LocationToPeer(peer.raft_location()));
   if (ret != 0) {
+    if (region != nullptr) {
+      region->SetDisablePessimisticLockInMemory(false);
+    }
     return butil::Status(pb::error::ERAFT_TRANSFER_LEADER, fmt::format("Transfer leader failed, ret_code {}", ret));
   }
 
@@ -393,6 +405,11 @@ butil::Status RaftStoreEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const
   return reader_->KvGet(ctx->CfName(), key, value);
 }
 
+butil::Status RaftStoreEngine::Reader::KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                                  std::vector<pb::common::KeyValue>& kvs) {
+  return reader_->KvBatchGet(ctx->CfName(), keys, kvs);
+}
+
 butil::Status RaftStoreEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
                                               const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
   return reader_->KvScan(ctx->CfName(), start_key, end_key, kvs);
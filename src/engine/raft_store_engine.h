@@ -111,6 +111,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
    public:
     Reader(RawEngine::ReaderPtr reader) : reader_(reader) {}
     butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) override;
+    butil::Status KvBatchGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                             std::vector<pb::common::KeyValue>& kvs) override;
 
     butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                          std::vector<pb::common::KeyValue>& kvs) override;
@@ -15,6 +15,11 @@
 
 #include <gflags/gflags.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <optional>
+
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -393,6 +398,108 @@ butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr sna
   return butil::Status(pb::error::EBDB_UNKNOW, "unknow error.");
 }
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+#ifdef BDB_BUILD_USE_SNAPSHOT
+  return KvBatchGet(cf_name, GetSnapshot(), keys, kvs);
+#else
+  return KvBatchGet(cf_name, nullptr, keys, kvs);
+#endif
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // visit the keys in order with one cursor, the btree pages of adjacent keys are likely still pinned.
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  // Acquire a cursor
+  Dbc* cursorp = nullptr;
+  // Release the cursor later
+  DEFER(  // FOR_CLANG_FORMAT
+      if (cursorp != nullptr) {
+        try {
+          cursorp->close();
+        } catch (DbException& db_exception) {
+          LOG(WARNING) << fmt::format("cursor close failed, exception: {}.", db_exception.what());
+        }
+      });
+
+  // the value buffer is reused by all keys
+  Dbt bdb_value;
+  bdb_value.set_flags(DB_DBT_REALLOC);
+  DEFER(free(bdb_value.get_data()));
+
+  try {
+    int ret = 0;
+    if (snapshot != nullptr) {
+      std::shared_ptr<bdb::Snapshot> ss = std::dynamic_pointer_cast<bdb::Snapshot>(snapshot);
+      if (ss == nullptr) {
+        DINGO_LOG(ERROR) << "[bdb] snapshot pointer cast error.";
+        return butil::Status(pb::error::EINTERNAL, "snapshot pointer cast error.");
+      }
+      ret = GetDb()->cursor(ss->GetDbTxn(), &cursorp, DB_TXN_SNAPSHOT);
+    } else {
+      ret = GetDb()->cursor(nullptr, &cursorp, DB_READ_COMMITTED);
+    }
+
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] create cursor failed ret: {}.", ret);
+      return butil::Status(pb::error::EINTERNAL, "Internal create cursor error.");
+    }
+
+    std::vector<std::optional<std::string>> values(keys.size());
+    for (size_t index : order) {
+      std::string store_key = BdbHelper::EncodeKey(cf_name, keys[index]);
+      Dbt bdb_key;
+      BdbHelper::BinaryToDbt(store_key, bdb_key);
+
+      ret = cursorp->get(&bdb_key, &bdb_value, DB_SET);
+      if (ret == DB_NOTFOUND) {
+        continue;
+      } else if (ret != 0) {
+        DINGO_LOG(ERROR) << fmt::format("[bdb] cursor get failed, ret: {}.", ret);
+        return butil::Status(pb::error::EINTERNAL, "Internal batch get error.");
+      }
+
+      BdbHelper::DbtToBinary(bdb_value, values[index].emplace());
+    }
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (values[i].has_value()) {
+        auto& kv = kvs.emplace_back();
+        kv.set_key(keys[i]);
+        kv.set_value(std::move(values[i].value()));
+      }
+    }
+
+    return butil::Status();
+  } catch (DbDeadlockException&) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] batch get, got deadlock.");
+    return butil::Status(pb::error::EBDB_DEADLOCK, "batch get, got deadlock.");
+  } catch (DbException& db_exception) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] batch get failed, exception: {}.", db_exception.what());
+    return butil::Status(pb::error::EBDB_EXCEPTION, fmt::format("batch get failed, {}.", db_exception.what()));
+  } catch (std::exception& std_exception) {
+    DINGO_LOG(ERROR) << fmt::format("[bdb] std exception, {}.", std_exception.what());
+    return butil::Status(pb::error::ESTD_EXCEPTION, fmt::format("std exception, {}.", std_exception.what()));
+  }
+
+  return butil::Status(pb::error::EBDB_UNKNOW, "unknown error.");
+}
+
 butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
 #ifdef BDB_BUILD_USE_SNAPSHOT
@@ -404,6 +511,12 @@ butil::Status Reader::KvScan(const std::string& cf_name, const std::string& star
 
 butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
                              const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
+  VectorKeyValueSink sink(&kvs);
+  return KvScan(cf_name, snapshot, start_key, end_key, &sink);
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                             const std::string& end_key, KeyValueSink* sink) {
   if (BAIDU_UNLIKELY(start_key.empty())) {
     DINGO_LOG(ERROR) << fmt::format("[bdb] not support empty start_key.");
     return butil::Status(pb::error::EKEY_EMPTY, "Start key is empty");
@@ -478,7 +591,7 @@ butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr sn
     }
 
     DINGO_LOG(INFO) << fmt::format("[bdb] get real start key: {}, value: {}", bdb_key.get_data(), bdb_value.get_data());
-    kvs.emplace_back(std::move(first_kv));
+    sink->Append(std::move(first_kv));
 
     int index = 0;
     while (cursorp->get(&bdb_key, &bdb_value, DB_NEXT) == 0) {
@@ -490,7 +603,7 @@ butil::Status Reader::KvScan(const std::string& cf_name, dingodb::SnapshotPtr sn
           return butil::Status();
         }
         DINGO_LOG(INFO) << fmt::format("[bdb] get real key: {}, value: {}", bdb_key.get_data(), bdb_value.get_data());
-        kvs.emplace_back(std::move(kv));
+        sink->Append(std::move(kv));
       }
     }
     return butil::Status();
@@ -2150,6 +2263,19 @@ butil::Status RawBdbEngine::IngestExternalFile(const std::string& cf_name, const
   return butil::Status();
 }
 
+// Not atomic across column families, but the batch put is idempotent, the replay of the apply completes the
+// interrupted ingest.
+butil::Status RawBdbEngine::IngestExternalFiles(const std::map<std::string, std::vector<std::string>>& cf_files) {
+  for (const auto& [cf_name, files] : cf_files) {
+    auto status = IngestExternalFile(cf_name, files);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
 void RawBdbEngine::Flush(const std::string& /*cf_name*/) {
   try {
     int ret = db_->sync(0);
@@ -122,11 +122,17 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, const std::string& key, std::string& value) override;
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
+  butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) override;
 
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
                        const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
+                       const std::string& end_key, KeyValueSink* sink) override;
 
   butil::Status KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                         int64_t& count) override;
@@ -228,6 +234,7 @@ class RawBdbEngine : public RawEngine {
   RawEngine::WriterPtr Writer() override { return writer_; }
 
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
+  butil::Status IngestExternalFiles(const std::map<std::string, std::vector<std::string>>& cf_files) override;
   void Flush(const std::string& cf_name) override;
   butil::Status Compact(const std::string& cf_name) override;
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
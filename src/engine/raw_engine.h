@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "common/context.h"
 #include "config/config.h"
 #include "engine/iterator.h"
+#include "engine/key_value_sink.h"
 #include "engine/snapshot.h"
 #include "engine/write_data.h"
 #include "proto/common.pb.h"
@@ -44,12 +46,20 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
     virtual butil::Status KvGet(const std::string& cf_name, const std::string& key, std::string& value) = 0;
     virtual butil::Status KvGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                 const std::string& key, std::string& value) = 0;
+    // Get many keys in one batch, kvs hold the found keys in the order of keys, the missing keys are skipped.
+    virtual butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                     std::vector<pb::common::KeyValue>& kvs) = 0;
+    virtual butil::Status KvBatchGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                     const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) = 0;
 
     virtual butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
     virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                  const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
+    // Append the kvs of range to sink, without an intermediate vector.
+    virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                 const std::string& start_key, const std::string& end_key, KeyValueSink* sink) = 0;
 
     virtual butil::Status KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                   int64_t& count) = 0;
@@ -117,6 +127,8 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
   virtual WriterPtr Writer() = 0;
 
   virtual butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) = 0;
+  // Ingest the files of multiple column families, all of them are visible or none.
+  virtual butil::Status IngestExternalFiles(const std::map<std::string, std::vector<std::string>>& cf_files) = 0;
 
   virtual std::vector<int64_t> GetApproximateSizes(const std::string& cf_name,
                                                    std::vector<pb::common::Range>& ranges) = 0;
@@ -124,6 +136,12 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
   virtual void Flush(const std::string& cf_name) = 0;
   virtual butil::Status Compact(const std::string& cf_name) = 0;
 
+  // Delete the range which is not read any more, e.g. the data of a deleted region.
+  // The engine may drop whole files, the snapshots taken before may not see the data either.
+  virtual butil::Status DropRange(const std::vector<std::string>& cf_names, const pb::common::Range& range) {
+    return Writer()->KvDeleteRange(cf_names, range);
+  }
+
  protected:
   RawEngine() = default;
 };
@@ -20,13 +20,16 @@
 #include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <filesystem>
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -36,30 +39,55 @@
 
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/bvar.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/role.h"
 #include "config/config_helper.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
+#include "engine/txn_engine_helper.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "google/protobuf/message_lite.h"
+#include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "proto/store.pb.h"
+#include "rocksdb/advanced_cache.h"
 #include "rocksdb/advanced_options.h"
 #include "rocksdb/cache.h"
+#include "rocksdb/compaction_filter.h"
 #include "rocksdb/db.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/iterator.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/table.h"
 #include "rocksdb/write_batch.h"
 #include "server/server.h"
 #include "store/heartbeat.h"
 
+DEFINE_bool(rocksdb_disable_wal, false,
+            "write data column families without rocksdb wal, the raft log is the wal, meta column family keeps wal");
+DEFINE_bool(rocksdb_sst_partition_by_region, true, "cut the sst files of data column families at region boundaries");
+DEFINE_bool(rocksdb_txn_gc_compaction_filter, true, "drop the old mvcc versions of txn write cf and data cf when compacting");
+
 namespace dingodb {
 
 namespace rocks {
 
+// The raft log is replayed from the applied index persisted after flush, the meta column family always keeps wal.
+static bool IsWalDisabled(const std::string& cf_name) {
+  return FLAGS_rocksdb_disable_wal && cf_name != Constant::kStoreMetaCF;
+}
+
+static rocksdb::WriteOptions GenWriteOptions(bool disable_wal) {
+  rocksdb::WriteOptions write_options;
+  write_options.disableWAL = disable_wal;
+  return write_options;
+}
+
 ColumnFamily::ColumnFamily(const std::string& cf_name, const ColumnFamilyConfig& config,
                            rocksdb::ColumnFamilyHandle* handle)
     : name_(cf_name), config_(config), handle_(handle) {}
@@ -86,6 +114,74 @@ std::string ColumnFamily::GetConfItem(const std::string& name) {
   return it == config_.end() ? "" : it->second;
 }
 
+void ColumnFamily::SetFlushedSequence(uint64_t sequence) {
+  uint64_t current = flushed_sequence_.load(std::memory_order_relaxed);
+  while (current < sequence &&
+         !flushed_sequence_.compare_exchange_weak(current, sequence, std::memory_order_release)) {
+  }
+}
+
+void FlushListener::OnFlushCompleted(rocksdb::DB* /*db*/, const rocksdb::FlushJobInfo& info) {
+  auto it = column_families_.find(info.cf_name);
+  if (it == column_families_.end()) {
+    return;
+  }
+
+  it->second->SetFlushedSequence(info.largest_seqno);
+  DINGO_LOG(DEBUG) << fmt::format("[rocksdb] flush completed, column family({}) largest_seqno({})", info.cf_name,
+                                  info.largest_seqno);
+}
+
+bool RegionSstPartitioner::HasBoundary(const rocksdb::Slice& start_key, const rocksdb::Slice& end_key) const {
+  auto it = std::upper_bound(boundaries_.begin(), boundaries_.end(), start_key,
+                             [](const rocksdb::Slice& key, const std::string& boundary) {
+                               return key.compare(rocksdb::Slice(boundary)) < 0;
+                             });
+  return it != boundaries_.end() && end_key.compare(rocksdb::Slice(*it)) >= 0;
+}
+
+rocksdb::PartitionerResult RegionSstPartitioner::ShouldPartition(const rocksdb::PartitionerRequest& request) {
+  return HasBoundary(*request.prev_user_key, *request.current_user_key) ? rocksdb::kRequired
+                                                                        : rocksdb::kNotRequired;
+}
+
+bool RegionSstPartitioner::CanDoTrivialMove(const rocksdb::Slice& smallest_user_key,
+                                            const rocksdb::Slice& largest_user_key) {
+  return !HasBoundary(smallest_user_key, largest_user_key);
+}
+
+std::unique_ptr<rocksdb::SstPartitioner> RegionSstPartitionerFactory::CreatePartitioner(
+    const rocksdb::SstPartitioner::Context& context) const {
+  auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
+  if (store_meta_manager == nullptr || store_meta_manager->GetStoreRegionMeta() == nullptr) {
+    return nullptr;
+  }
+
+  // only the boundaries in (smallest_user_key, largest_user_key] can cut the output
+  std::vector<std::string> boundaries;
+  auto in_output = [&context](const std::string& key) {
+    return !key.empty() && context.smallest_user_key.compare(rocksdb::Slice(key)) < 0 &&
+           context.largest_user_key.compare(rocksdb::Slice(key)) >= 0;
+  };
+  for (const auto& region : store_meta_manager->GetStoreRegionMeta()->GetAllAliveRegion()) {
+    auto range = region->Range();
+    if (in_output(range.start_key())) {
+      boundaries.push_back(range.start_key());
+    }
+    if (in_output(range.end_key())) {
+      boundaries.push_back(range.end_key());
+    }
+  }
+  if (boundaries.empty()) {
+    return nullptr;
+  }
+
+  std::sort(boundaries.begin(), boundaries.end());
+  boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+  return std::make_unique<RegionSstPartitioner>(std::move(boundaries));
+}
+
 void ColumnFamily::Dump() {
   for (const auto& [name, value] : config_) {
     DINGO_LOG(INFO) << fmt::format("[rocksdb.dump][column_family({})] {} : {}", Name(), name, value);
@@ -345,9 +441,72 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(GetColumnFamily(cf_name), GetSnapshot(), keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  return KvBatchGet(GetColumnFamily(cf_name), snapshot, keys, kvs);
+}
+
+butil::Status Reader::KvBatchGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  // MultiGet with sorted_input skips its own sort, so the keys are sorted by index and the result is restored to the
+  // order of keys.
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+  std::vector<rocksdb::Slice> slices;
+  slices.reserve(keys.size());
+  std::vector<size_t> positions(keys.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    const auto& key = keys[order[i]];
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    slices.emplace_back(key);
+    positions[order[i]] = i;
+  }
+
+  rocksdb::ReadOptions read_option;
+  read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+  // read the blocks of different sst files in parallel, it is ignored if rocksdb is built without async io support
+  read_option.async_io = true;
+
+  std::vector<rocksdb::PinnableSlice> values(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), slices.size(), slices.data(), values.data(),
+                    statuses.data(), true);
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    size_t pos = positions[i];
+    const auto& s = statuses[pos];
+    if (!s.ok()) {
+      if (s.IsNotFound()) {
+        continue;
+      }
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] batch get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal batch get error");
+    }
+
+    auto& kv = kvs.emplace_back();
+    kv.set_key(keys[i]);
+    kv.set_value(values[pos].data(), values[pos].size());
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
-                             const std::string& start_key, const std::string& end_key,
-                             std::vector<pb::common::KeyValue>& kvs) {
+                             const std::string& start_key, const std::string& end_key, KeyValueSink* sink) {
   if (BAIDU_UNLIKELY(start_key.empty())) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty start_key.");
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
@@ -365,11 +524,7 @@ butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<ding
   std::string_view end_key_view(end_key);
   rocksdb::Iterator* it = GetDB()->NewIterator(read_option, column_family->GetHandle());
   for (it->Seek(start_key); it->Valid() && it->key().ToStringView() < end_key_view; it->Next()) {
-    pb::common::KeyValue kv;
-    kv.set_key(it->key().data(), it->key().size());
-    kv.set_value(it->value().data(), it->value().size());
-
-    kvs.emplace_back(std::move(kv));
+    sink->Append(it->key().ToStringView(), it->value().ToStringView());
   }
   delete it;
 
@@ -378,13 +533,20 @@ butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<ding
 
 butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
-  return KvScan(GetColumnFamily(cf_name), GetSnapshot(), start_key, end_key, kvs);
+  VectorKeyValueSink sink(&kvs);
+  return KvScan(GetColumnFamily(cf_name), GetSnapshot(), start_key, end_key, &sink);
 }
 
 butil::Status Reader::KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
-  return KvScan(GetColumnFamily(cf_name), snapshot, start_key, end_key, kvs);
+  VectorKeyValueSink sink(&kvs);
+  return KvScan(GetColumnFamily(cf_name), snapshot, start_key, end_key, &sink);
+}
+
+butil::Status Reader::KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                             const std::string& start_key, const std::string& end_key, KeyValueSink* sink) {
+  return KvScan(GetColumnFamily(cf_name), snapshot, start_key, end_key, sink);
 }
 
 butil::Status Reader::KvCount(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
@@ -466,7 +628,7 @@ butil::Status Writer::KvPut(ColumnFamilyPtr column_family, const pb::common::Key
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  rocksdb::WriteOptions write_options;
+  rocksdb::WriteOptions write_options = GenWriteOptions(IsWalDisabled(column_family->Name()));
   rocksdb::Status s =
       GetDB()->Put(write_options, column_family->GetHandle(), rocksdb::Slice(kv.key()), rocksdb::Slice(kv.value()));
   if (!s.ok()) {
@@ -524,7 +686,7 @@ butil::Status Writer::KvBatchPutAndDelete(ColumnFamilyPtr column_family,
       }
     }
   }
-  rocksdb::WriteOptions write_options;
+  rocksdb::WriteOptions write_options = GenWriteOptions(IsWalDisabled(column_family->Name()));
   rocksdb::Status s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
@@ -541,7 +703,10 @@ butil::Status Writer::KvBatchPutAndDelete(
                                  kv_puts_with_cf.size(), kv_deletes_with_cf.size());
 
   rocksdb::WriteBatch batch;
+  // the batch is written without wal only if all of its column families are
+  bool disable_wal = true;
   for (const auto& [cf_name, kv_puts] : kv_puts_with_cf) {
+    disable_wal = disable_wal && IsWalDisabled(cf_name);
     if (BAIDU_UNLIKELY(kv_puts.empty())) {
       DINGO_LOG(ERROR) << fmt::format("[rocksdb] keys empty not support");
       return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
@@ -563,6 +728,7 @@ butil::Status Writer::KvBatchPutAndDelete(
   }
 
   for (const auto& [cf_name, kv_deletes] : kv_deletes_with_cf) {
+    disable_wal = disable_wal && IsWalDisabled(cf_name);
     if (BAIDU_UNLIKELY(kv_deletes.empty())) {
       DINGO_LOG(ERROR) << fmt::format("[rocksdb] keys empty not support");
       return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
@@ -583,7 +749,7 @@ butil::Status Writer::KvBatchPutAndDelete(
     }
   }
 
-  rocksdb::WriteOptions write_options;
+  rocksdb::WriteOptions write_options = GenWriteOptions(disable_wal);
   rocksdb::Status s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
@@ -627,7 +793,7 @@ butil::Status Writer::KvCompareAndSet(ColumnFamilyPtr column_family, const pb::c
   }
 
   // write a key
-  s = GetDB()->Put(rocksdb::WriteOptions(), column_family->GetHandle(),
+  s = GetDB()->Put(GenWriteOptions(IsWalDisabled(column_family->Name())), column_family->GetHandle(),
                    rocksdb::Slice(kv.key().data(), kv.key().size()), rocksdb::Slice(value.data(), value.size()));
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] put failed, error: {}.", s.ToString());
@@ -702,7 +868,7 @@ butil::Status Writer::KvBatchPutIfAbsent(ColumnFamilyPtr column_family, const st
     key_index++;
   }
 
-  rocksdb::Status s = GetDB()->Write(rocksdb::WriteOptions(), &batch);
+  rocksdb::Status s = GetDB()->Write(GenWriteOptions(IsWalDisabled(column_family->Name())), &batch);
   if (!s.ok()) {
     key_states.clear();
     key_states.resize(kvs.size(), false);
@@ -823,7 +989,7 @@ butil::Status Writer::KvBatchCompareAndSet(ColumnFamilyPtr column_family, const
     key_index++;
   }
 
-  rocksdb::Status s = GetDB()->Write(rocksdb::WriteOptions(), &batch);
+  rocksdb::Status s = GetDB()->Write(GenWriteOptions(IsWalDisabled(column_family->Name())), &batch);
   if (!s.ok()) {
     key_states.clear();
     key_states.resize(kvs.size(), false);
@@ -846,7 +1012,7 @@ butil::Status Writer::KvDelete(ColumnFamilyPtr column_family, const std::string&
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  rocksdb::WriteOptions const write_options;
+  rocksdb::WriteOptions const write_options = GenWriteOptions(IsWalDisabled(column_family->Name()));
   rocksdb::Status const s =
       GetDB()->Delete(write_options, column_family->GetHandle(), rocksdb::Slice(key.data(), key.size()));
   if (!s.ok()) {
@@ -895,6 +1061,7 @@ butil::Status Writer::KvBatchDeleteRange(std::vector<ColumnFamilyPtr> column_fam
     }
   }
 
+  // keep wal, the raft log of a deleted region is not replayed, the range must not come back after restart
   rocksdb::Status s = GetDB()->Write(rocksdb::WriteOptions(), &batch);
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}.", s.ToString());
@@ -974,7 +1141,7 @@ butil::Status Writer::KvDeleteIfEqual(ColumnFamilyPtr column_family, const pb::c
   }
 
   // delete a key
-  s = GetDB()->Delete(rocksdb::WriteOptions(), column_family->GetHandle(),
+  s = GetDB()->Delete(GenWriteOptions(IsWalDisabled(column_family->Name())), column_family->GetHandle(),
                       rocksdb::Slice(kv.key().data(), kv.key().size()));
   if (BAIDU_UNLIKELY(!s.ok())) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] delete failed, error: {}.", s.ToString());
@@ -988,6 +1155,242 @@ butil::Status Writer::KvDeleteIfEqual(const std::string& cf_name, const pb::comm
   return KvDeleteIfEqual(GetColumnFamily(cf_name), kv);
 }
 
+// The view of a column family on the shared block cache, it counts the hit and miss of the column family.
+class ColumnFamilyBlockCache : public rocksdb::CacheWrapper {
+ public:
+  ColumnFamilyBlockCache(std::shared_ptr<rocksdb::Cache> target, const std::string& cf_name)
+      : rocksdb::CacheWrapper(std::move(target)),
+        hit_count_(fmt::format("dingo_rocksdb_block_cache_{}_hit_count", cf_name)),
+        miss_count_(fmt::format("dingo_rocksdb_block_cache_{}_miss_count", cf_name)),
+        hit_per_second_(fmt::format("dingo_rocksdb_block_cache_{}_hit_per_second", cf_name), &hit_count_),
+        miss_per_second_(fmt::format("dingo_rocksdb_block_cache_{}_miss_per_second", cf_name), &miss_count_) {}
+  ~ColumnFamilyBlockCache() override = default;
+
+  const char* Name() const override { return "ColumnFamilyBlockCache"; }
+
+  Handle* Lookup(const rocksdb::Slice& key, const CacheItemHelper* helper, CreateContext* create_context,
+                 Priority priority, rocksdb::Statistics* stats) override {
+    Handle* handle = target_->Lookup(key, helper, create_context, priority, stats);
+    if (handle != nullptr) {
+      hit_count_ << 1;
+    } else {
+      miss_count_ << 1;
+    }
+    return handle;
+  }
+
+ private:
+  bvar::Adder<int64_t> hit_count_;
+  bvar::Adder<int64_t> miss_count_;
+  bvar::PerSecond<bvar::Adder<int64_t>> hit_per_second_;
+  bvar::PerSecond<bvar::Adder<int64_t>> miss_per_second_;
+};
+
+// Drop the records of write cf which can not be read at or after the gc safe point. Their values in data cf are dropped
+// by TxnGcDataCompactionFilter, nothing is written to the db here.
+class TxnGcWriteCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit TxnGcWriteCompactionFilter(int64_t safe_point_ts) : checker_(safe_point_ts) {}
+  ~TxnGcWriteCompactionFilter() override = default;
+
+  const char* Name() const override { return "TxnGcWriteCompactionFilter"; }
+
+  // One filter is used by one sub compaction in key order, so the checker is not shared.
+  bool Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+              std::string* /*new_value*/, bool* /*value_changed*/) const override {
+    std::string data_key;
+    return checker_.IsGarbage(std::string_view(key.data(), key.size()),
+                              std::string_view(existing_value.data(), existing_value.size()), data_key);
+  }
+
+ private:
+  mutable TxnGcChecker checker_;
+};
+
+// Drop the values of data cf which no write record can read at or after the gc safe point, with the same safe point
+// and the same TxnGcChecker decision as TxnGcWriteCompactionFilter. A value is kept if its txn still holds the lock,
+// or it is committed after the safe point, or it is the newest put committed before the safe point.
+// The keys of a compaction come in order, so the lock cf and write cf are walked by one cursor each along with them,
+// the decision of a user key is made once for all its versions, no point lookup per key.
+class TxnGcDataCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  TxnGcDataCompactionFilter(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* lock_handle,
+                            rocksdb::ColumnFamilyHandle* write_handle, int64_t safe_point_ts)
+      : db_(db), safe_point_ts_(safe_point_ts), snapshot_(db->GetSnapshot()) {
+    rocksdb::ReadOptions read_options;
+    read_options.snapshot = snapshot_;
+    read_options.fill_cache = false;
+    lock_cursor_.iter.reset(db_->NewIterator(read_options, lock_handle));
+    write_cursor_.iter.reset(db_->NewIterator(read_options, write_handle));
+  }
+  ~TxnGcDataCompactionFilter() override {
+    lock_cursor_.iter.reset();
+    write_cursor_.iter.reset();
+    db_->ReleaseSnapshot(snapshot_);
+  }
+
+  const char* Name() const override { return "TxnGcDataCompactionFilter"; }
+
+  // One filter is used by one sub compaction in key order, so the cursors are not shared.
+  bool Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& /*existing_value*/,
+              std::string* /*new_value*/, bool* /*value_changed*/) const override {
+    std::string user_key;
+    int64_t start_ts = 0;
+    auto ret = Helper::DecodeTxnKey(std::string_view(key.data(), key.size()), user_key, start_ts);
+    if (!ret.ok() || start_ts > safe_point_ts_) {
+      return false;
+    }
+
+    if (!has_decision_ || user_key != user_key_) {
+      Decide(user_key);
+    }
+
+    return !unsure_ && lock_ts_ != start_ts && referenced_start_ts_.count(start_ts) == 0;
+  }
+
+ private:
+  struct Cursor {
+    std::unique_ptr<rocksdb::Iterator> iter;
+    std::string last_target;
+  };
+
+  // Position the cursor at the first key not less than target. The targets mostly grow with the compaction keys, so
+  // step forward a few keys before falling back to seek.
+  static void MoveTo(Cursor& cursor, const std::string& target) {
+    constexpr int kMaxNextSteps = 8;
+
+    if (!cursor.last_target.empty() && target >= cursor.last_target && cursor.iter->status().ok()) {
+      for (int i = 0; i < kMaxNextSteps; ++i) {
+        if (!cursor.iter->Valid() || cursor.iter->key().compare(target) >= 0) {
+          cursor.last_target = target;
+          return;
+        }
+        cursor.iter->Next();
+      }
+    }
+
+    cursor.iter->Seek(target);
+    cursor.last_target = target;
+  }
+
+  // The values in compaction are written by prewrite before the snapshot, so the snapshot sees either the lock or the
+  // commit or rollback of their txn. Keep the values when anything is not sure.
+  void Decide(const std::string& user_key) const {
+    user_key_ = user_key;
+    has_decision_ = true;
+    unsure_ = false;
+    lock_ts_ = 0;
+    referenced_start_ts_.clear();
+
+    std::string lock_key = Helper::EncodeTxnKey(user_key, Constant::kLockVer);
+    MoveTo(lock_cursor_, lock_key);
+    if (lock_cursor_.iter->Valid() && lock_cursor_.iter->key() == lock_key) {
+      pb::store::LockInfo lock_info;
+      if (!lock_info.ParseFromArray(lock_cursor_.iter->value().data(), lock_cursor_.iter->value().size())) {
+        unsure_ = true;
+        return;
+      }
+      lock_ts_ = lock_info.lock_ts();
+    } else if (!lock_cursor_.iter->status().ok()) {
+      unsure_ = true;
+      return;
+    }
+
+    // the versions of user_key, newest first, the keys having user_key as prefix may be mixed in
+    std::string upper_key = Helper::EncodeTxnKey(user_key, 0);
+    TxnGcChecker checker(safe_point_ts_);
+    std::string data_key;
+    auto& iter = write_cursor_.iter;
+    for (MoveTo(write_cursor_, Helper::EncodeTxnKey(user_key, Constant::kMaxVer));
+         iter->Valid() && iter->key().compare(upper_key) <= 0; iter->Next()) {
+      std::string_view write_key(iter->key().data(), iter->key().size());
+      std::string write_user_key;
+      int64_t commit_ts = 0;
+      if (!Helper::DecodeTxnKey(write_key, write_user_key, commit_ts).ok()) {
+        unsure_ = true;
+        return;
+      }
+      if (write_user_key != user_key) {
+        continue;
+      }
+
+      pb::store::WriteInfo write_info;
+      if (!write_info.ParseFromArray(iter->value().data(), iter->value().size())) {
+        unsure_ = true;
+        return;
+      }
+      // the put records kept by the write cf filter are the readable versions
+      std::string_view write_value(iter->value().data(), iter->value().size());
+      if (!checker.IsGarbage(write_key, write_value, data_key) && write_info.op() == pb::store::Op::Put) {
+        referenced_start_ts_.insert(write_info.start_ts());
+      }
+    }
+    // the cursor passed the versions, the next target is after it or it is sought again
+    write_cursor_.last_target = upper_key;
+
+    unsure_ = !iter->status().ok();
+  }
+
+  rocksdb::DB* db_;
+  int64_t safe_point_ts_;
+  const rocksdb::Snapshot* snapshot_;
+
+  mutable Cursor lock_cursor_;
+  mutable Cursor write_cursor_;
+
+  // the decision of the versions of user_key_
+  mutable bool has_decision_{false};
+  mutable std::string user_key_;
+  mutable bool unsure_{false};
+  mutable int64_t lock_ts_{0};
+  mutable std::set<int64_t> referenced_start_ts_;
+};
+
+// Shared by write cf and data cf, so both filters use the same gc safe point. The filters are created only after the
+// db is open and the store knows the gc safe point.
+class TxnGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  TxnGcCompactionFilterFactory() = default;
+  ~TxnGcCompactionFilterFactory() override = default;
+
+  const char* Name() const override { return "TxnGcCompactionFilterFactory"; }
+
+  void SetDB(rocksdb::DB* db, rocksdb::ColumnFamilyHandle* lock_handle, rocksdb::ColumnFamilyHandle* write_handle) {
+    lock_handle_.store(lock_handle);
+    write_handle_.store(write_handle);
+    db_.store(db);
+  }
+
+  void UpdateSafePoint(int64_t safe_point_ts) {
+    int64_t current = safe_point_ts_.load(std::memory_order_relaxed);
+    while (current < safe_point_ts && !safe_point_ts_.compare_exchange_weak(current, safe_point_ts)) {
+    }
+  }
+
+  int64_t GetSafePoint() const { return safe_point_ts_.load(std::memory_order_relaxed); }
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override {
+    int64_t safe_point_ts = GetSafePoint();
+    rocksdb::DB* db = db_.load();
+    auto* write_handle = write_handle_.load();
+    if (safe_point_ts <= 0 || db == nullptr || write_handle == nullptr) {
+      return nullptr;
+    }
+
+    if (context.column_family_id == write_handle->GetID()) {
+      return std::make_unique<TxnGcWriteCompactionFilter>(safe_point_ts);
+    }
+    return std::make_unique<TxnGcDataCompactionFilter>(db, lock_handle_.load(), write_handle, safe_point_ts);
+  }
+
+ private:
+  std::atomic<rocksdb::DB*> db_{nullptr};
+  std::atomic<rocksdb::ColumnFamilyHandle*> lock_handle_{nullptr};
+  std::atomic<rocksdb::ColumnFamilyHandle*> write_handle_{nullptr};
+  std::atomic<int64_t> safe_point_ts_{0};
+};
+
 }  // namespace rocks
 
 RawRocksEngine::RawRocksEngine() : db_(nullptr), column_families_({}) {}
@@ -997,7 +1400,6 @@ RawRocksEngine::~RawRocksEngine() = default;
 static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<std::string>& column_family_names) {
   rocks::ColumnFamily::ColumnFamilyConfig default_config;
   default_config.emplace(Constant::kBlockSize, Constant::kBlockSizeDefaultValue);
-  default_config.emplace(Constant::kBlockCache, Constant::kBlockCacheDefaultValue);
   default_config.emplace(Constant::kArenaBlockSize, Constant::kArenaBlockSizeDefaultValue);
   default_config.emplace(Constant::kMinWriteBufferNumberToMerge, Constant::kMinWriteBufferNumberToMergeDefaultValue);
   default_config.emplace(Constant::kMaxWriteBufferNumber, Constant::kMaxWriteBufferNumberDefaultValue);
@@ -1007,10 +1409,22 @@ static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<s
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kEnableBlobFiles, Constant::kEnableBlobFilesDefaultValue);
+  default_config.emplace(Constant::kMinBlobSize, Constant::kMinBlobSizeDefaultValue);
+  default_config.emplace(Constant::kBlobFileSize, Constant::kBlobFileSizeDefaultValue);
+  default_config.emplace(Constant::kEnableBlobGarbageCollection, Constant::kEnableBlobGarbageCollectionDefaultValue);
+  default_config.emplace(Constant::kBlobGarbageCollectionAgeCutoff,
+                         Constant::kBlobGarbageCollectionAgeCutoffDefaultValue);
 
   rocks::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
-    column_families.emplace(cf_name, rocks::ColumnFamily::New(cf_name, default_config));
+    auto column_family = rocks::ColumnFamily::New(cf_name, default_config);
+    // the vector and table rows are several KB, compaction should not rewrite them again and again
+    if (GetRole() == pb::common::ClusterRole::INDEX &&
+        (cf_name == Constant::kVectorDataCF || cf_name == Constant::kVectorTableCF)) {
+      column_family->SetConfItem(Constant::kEnableBlobFiles, "true");
+    }
+    column_families.emplace(cf_name, column_family);
   }
 
   return column_families;
@@ -1070,6 +1484,8 @@ bool CastValue(std::string value, T& dst_value) {
       dst_value = std::stof(value);
     } else if (std::is_same_v<double, std::remove_reference_t<std::remove_cv_t<T>>>) {
       dst_value = std::stod(value);
+    } else if (std::is_same_v<bool, std::remove_reference_t<std::remove_cv_t<T>>>) {
+      dst_value = (value == "true" || value == "1");
     } else {
       DINGO_LOG(FATAL) << fmt::format("[rocksdb] not match type failed, value: {}.", value);
       return false;
@@ -1091,8 +1507,40 @@ bool CastValue(std::string value, std::string& dst_value) {
   return true;
 }
 
+// One block cache for all column families, so the hot column family can use the space of the cold ones.
+static std::shared_ptr<rocksdb::Cache> NewBlockCache(std::shared_ptr<Config> config) {
+  int64_t capacity = config->GetInt64(Constant::kBlockCacheSize);
+  if (capacity <= 0) {
+    capacity = Constant::kBlockCacheSizeDefaultValue;
+  }
+
+  std::string cache_type = config->GetString(Constant::kBlockCacheType);
+  DINGO_LOG(INFO) << fmt::format("[rocksdb] block cache type({}) capacity({})", cache_type, capacity);
+
+  if (cache_type == Constant::kBlockCacheTypeHyperClock) {
+    // the charge of a data block
+    size_t estimated_entry_charge = 0;
+    CastValue(Constant::kBlockSizeDefaultValue, estimated_entry_charge);
+    rocksdb::HyperClockCacheOptions options(capacity, estimated_entry_charge);
+    return options.MakeSharedCache();
+  }
+
+  if (!cache_type.empty() && cache_type != Constant::kBlockCacheTypeLRU) {
+    DINGO_LOG(WARNING) << fmt::format("[rocksdb] unknown block cache type({}), use {}", cache_type,
+                                      Constant::kBlockCacheTypeLRU);
+  }
+
+  rocksdb::LRUCacheOptions options;
+  options.capacity = capacity;
+  // index and filter blocks are inserted with high priority, they are evicted after the data blocks
+  options.high_pri_pool_ratio = 0.5;
+  return rocksdb::NewLRUCache(options);
+}
+
 // set cf config
-static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnFamilyPtr column_family) {
+static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(
+    rocks::ColumnFamilyPtr column_family, std::shared_ptr<rocksdb::Cache> block_cache,
+    std::shared_ptr<rocks::TxnGcCompactionFilterFactory> txn_gc_filter_factory) {
   rocksdb::ColumnFamilyOptions family_options;
   rocksdb::BlockBasedTableOptions table_options;
 
@@ -1100,12 +1548,16 @@ static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnF
   CastValue(column_family->GetConfItem(Constant::kBlockSize), table_options.block_size);
 
   // block_cache
-  {
-    size_t option_value = 0;
-    CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
+  table_options.block_cache = std::make_shared<rocks::ColumnFamilyBlockCache>(block_cache, column_family->Name());
 
-    table_options.block_cache = rocksdb::NewLRUCache(option_value);  // LRUcache
-  }
+  // partitioned index and filter, the partitions are cached with high priority and only the top level index is pinned
+  table_options.index_type = rocksdb::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+  table_options.partition_filters = true;
+  table_options.metadata_block_size = 4096;
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.cache_index_and_filter_blocks_with_high_priority = true;
+  table_options.pin_top_level_index_and_filter = true;
+  table_options.pin_l0_filter_and_index_blocks_in_cache = true;
 
   // arena_block_size
   CastValue(column_family->GetConfItem(Constant::kArenaBlockSize), family_options.arena_block_size);
@@ -1141,6 +1593,16 @@ static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnF
   // target_file_size_base
   CastValue(column_family->GetConfItem(Constant::kTargetFileSizeBase), family_options.target_file_size_base);
 
+  // blob files, the blobs are cached in the block cache
+  CastValue(column_family->GetConfItem(Constant::kEnableBlobFiles), family_options.enable_blob_files);
+  CastValue(column_family->GetConfItem(Constant::kMinBlobSize), family_options.min_blob_size);
+  CastValue(column_family->GetConfItem(Constant::kBlobFileSize), family_options.blob_file_size);
+  CastValue(column_family->GetConfItem(Constant::kEnableBlobGarbageCollection),
+            family_options.enable_blob_garbage_collection);
+  CastValue(column_family->GetConfItem(Constant::kBlobGarbageCollectionAgeCutoff),
+            family_options.blob_garbage_collection_age_cutoff);
+  family_options.blob_cache = block_cache;
+
   family_options.compression_per_level = {
       rocksdb::CompressionType::kNoCompression,  rocksdb::CompressionType::kNoCompression,
       rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kLZ4Compression,
@@ -1151,22 +1613,39 @@ static rocksdb::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(rocks::ColumnF
   table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10.0, false));
   table_options.whole_key_filtering = true;
 
+  // region aligned sst files, meta column family is not split by region
+  if (FLAGS_rocksdb_sst_partition_by_region && column_family->Name() != Constant::kStoreMetaCF) {
+    family_options.sst_partitioner_factory = std::make_shared<rocks::RegionSstPartitionerFactory>();
+  }
+
+  // mvcc gc
+  if (FLAGS_rocksdb_txn_gc_compaction_filter &&
+      (column_family->Name() == Constant::kTxnWriteCF || column_family->Name() == Constant::kTxnDataCF)) {
+    family_options.compaction_filter_factory = txn_gc_filter_factory;
+  }
+
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
 
   return family_options;
 }
 
-static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families) {
+static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families,
+                           std::shared_ptr<rocksdb::Cache> block_cache,
+                           std::shared_ptr<rocks::TxnGcCompactionFilterFactory> txn_gc_filter_factory) {
   // Cast ColumnFamily to rocksdb::ColumnFamilyOptions
   std::vector<rocksdb::ColumnFamilyDescriptor> column_family_descs;
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
-    rocksdb::ColumnFamilyOptions family_options = GenRcoksDBColumnFamilyOptions(column_family);
+    rocksdb::ColumnFamilyOptions family_options =
+        GenRcoksDBColumnFamilyOptions(column_family, block_cache, txn_gc_filter_factory);
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
   rocksdb::DBOptions db_options;
+  db_options.listeners.push_back(std::make_shared<rocks::FlushListener>(column_families));
+  // the applied index in meta column family is flushed together with the data written without wal before it
+  db_options.atomic_flush = FLAGS_rocksdb_disable_wal;
   db_options.create_if_missing = true;
   db_options.create_missing_column_families = true;
   db_options.max_background_jobs = ConfigHelper::GetRocksDBBackgroundThreadNum();
@@ -1212,12 +1691,31 @@ bool RawRocksEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   auto column_families = GenColumnFamilyByDefaultConfig(cf_names);
   SetColumnFamilyCustomConfig(config, column_families);
 
-  rocksdb::DB* db = InitDB(db_path_, column_families);
+  auto block_cache = NewBlockCache(config);
+  auto txn_gc_filter_factory = std::make_shared<rocks::TxnGcCompactionFilterFactory>();
+  rocksdb::DB* db = InitDB(db_path_, column_families, block_cache, txn_gc_filter_factory);
   if (db == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] open failed, path: {}", db_path_);
     return false;
   }
+  auto lock_cf = column_families.find(Constant::kTxnLockCF);
+  auto write_cf = column_families.find(Constant::kTxnWriteCF);
+  if (lock_cf != column_families.end() && write_cf != column_families.end()) {
+    txn_gc_filter_factory->SetDB(db, lock_cf->second->GetHandle(), write_cf->second->GetHandle());
+  }
+  auto meta_cf = column_families.find(Constant::kStoreMetaCF);
+  if (meta_cf != column_families.end()) {
+    std::string value;
+    auto status = db->Get(rocksdb::ReadOptions(), meta_cf->second->GetHandle(), Constant::kTxnGcSafePointKey, &value);
+    if (status.ok()) {
+      txn_gc_filter_factory->UpdateSafePoint(strtoll(value.c_str(), nullptr, 10));
+    } else if (!status.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] get txn gc safe point failed, error: {}", status.ToString());
+    }
+  }
   column_families_ = column_families;
+  block_cache_ = block_cache;
+  txn_gc_filter_factory_ = txn_gc_filter_factory;
   db_.reset(db);
 
   reader_ = std::make_shared<rocks::Reader>(GetSelfPtr());
@@ -1404,6 +1902,26 @@ butil::Status RawRocksEngine::IngestExternalFile(const std::string& cf_name, con
   return butil::Status();
 }
 
+butil::Status RawRocksEngine::IngestExternalFiles(const std::map<std::string, std::vector<std::string>>& cf_files) {
+  std::vector<rocksdb::IngestExternalFileArg> args;
+  args.reserve(cf_files.size());
+  for (const auto& [cf_name, files] : cf_files) {
+    rocksdb::IngestExternalFileArg arg;
+    arg.column_family = GetColumnFamily(cf_name)->GetHandle();
+    arg.external_files = files;
+    arg.options.write_global_seqno = false;
+    args.push_back(std::move(arg));
+  }
+
+  auto status = db_->IngestExternalFiles(args);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] ingest external files failed, error: {}", status.ToString());
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  return butil::Status();
+}
+
 void RawRocksEngine::Flush(const std::string& cf_name) {
   if (db_) {
     rocksdb::FlushOptions flush_options;
@@ -1411,6 +1929,78 @@ void RawRocksEngine::Flush(const std::string& cf_name) {
   }
 }
 
+butil::Status RawRocksEngine::FlushUnpersisted(const std::vector<std::string>& cf_names) {
+  if (db_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not init db");
+  }
+
+  // the flushed sequence is only a hint to skip the column families without new writes
+  rocksdb::SequenceNumber latest_sequence = db_->GetLatestSequenceNumber();
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  // the applied index written without wal is in meta column family
+  std::vector<std::string> flush_cf_names = cf_names;
+  flush_cf_names.push_back(Constant::kStoreMetaCF);
+  for (const auto& cf_name : flush_cf_names) {
+    auto column_family = GetColumnFamily(cf_name);
+    if ((cf_name != Constant::kStoreMetaCF && !rocks::IsWalDisabled(cf_name)) ||
+        column_family->FlushedSequence() >= latest_sequence) {
+      continue;
+    }
+    handles.push_back(column_family->GetHandle());
+  }
+  if (handles.empty()) {
+    return butil::Status();
+  }
+
+  rocksdb::FlushOptions flush_options;
+  flush_options.wait = true;
+  flush_options.allow_write_stall = true;
+  auto status = db_->Flush(flush_options, handles);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] flush unpersisted failed, error: {}", status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Flush failed, %s", status.ToString().c_str());
+  }
+
+  return butil::Status();
+}
+
+butil::Status RawRocksEngine::DropRange(const std::vector<std::string>& cf_names, const pb::common::Range& range) {
+  if (db_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not init db");
+  }
+
+  // drop the sst files entirely in range, it is a metadata operation when the files are cut at region boundaries
+  rocksdb::Slice start_key(range.start_key());
+  rocksdb::Slice end_key(range.end_key());
+  rocksdb::RangePtr range_ptr(&start_key, &end_key);
+  for (const auto& cf_name : cf_names) {
+    auto status = rocksdb::DeleteFilesInRanges(db_.get(), GetColumnFamily(cf_name)->GetHandle(), &range_ptr, 1, false);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[rocksdb] delete files in range failed, column family({}) error: {}", cf_name,
+                                        status.ToString());
+    }
+  }
+
+  // the rest is in memtable and the sst files across the boundaries
+  return Writer()->KvDeleteRange(cf_names, range);
+}
+
+butil::Status RawRocksEngine::PutWithoutWal(const std::string& cf_name, const pb::common::KeyValue& kv) {
+  if (db_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not init db");
+  }
+
+  auto column_family = GetColumnFamily(cf_name);
+  auto status = db_->Put(rocks::GenWriteOptions(true), column_family->GetHandle(), rocksdb::Slice(kv.key()),
+                         rocksdb::Slice(kv.value()));
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] put without wal failed, error: {}", status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Internal put error");
+  }
+
+  return butil::Status();
+}
+
 butil::Status RawRocksEngine::Compact(const std::string& cf_name) {
   DINGO_LOG(INFO) << fmt::format("[rocksdb] compact column family {}", cf_name);
   if (db_ != nullptr) {
@@ -1427,6 +2017,25 @@ butil::Status RawRocksEngine::Compact(const std::string& cf_name) {
   return butil::Status();
 }
 
+butil::Status RawRocksEngine::UpdateTxnGcSafePoint(int64_t safe_point_ts) {
+  if (safe_point_ts <= txn_gc_filter_factory_->GetSafePoint()) {
+    return butil::Status();
+  }
+
+  auto status = db_->Put(rocksdb::WriteOptions(), GetColumnFamily(Constant::kStoreMetaCF)->GetHandle(),
+                         Constant::kTxnGcSafePointKey, std::to_string(safe_point_ts));
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] put txn gc safe point {} failed, error: {}", safe_point_ts,
+                                    status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Internal put error");
+  }
+  txn_gc_filter_factory_->UpdateSafePoint(safe_point_ts);
+
+  return butil::Status();
+}
+
+int64_t RawRocksEngine::GetTxnGcSafePoint() { return txn_gc_filter_factory_->GetSafePoint(); }
+
 void RawRocksEngine::Destroy() { rocksdb::DestroyDB(db_path_, rocksdb::Options()); }
 
 void RawRocksEngine::Close() {
@@ -15,6 +15,7 @@
 #ifndef DINGODB_ENGINE_ROCKS_KV_ENGINE_H_  // NOLINT
 #define DINGODB_ENGINE_ROCKS_KV_ENGINE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -28,16 +29,23 @@
 #include "engine/iterator.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/store_internal.pb.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/listener.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/utilities/checkpoint.h"
 
+DECLARE_bool(rocksdb_disable_wal);
+DECLARE_bool(rocksdb_sst_partition_by_region);
+DECLARE_bool(rocksdb_txn_gc_compaction_filter);
+
 namespace dingodb {
 
 class RawRocksEngine;
@@ -67,6 +75,10 @@ class ColumnFamily {
   void SetHandle(rocksdb::ColumnFamilyHandle* handle) { handle_ = handle; }
   rocksdb::ColumnFamilyHandle* GetHandle() const { return handle_; }
 
+  // The largest sequence number written to sst, updated by FlushListener.
+  void SetFlushedSequence(uint64_t sequence);
+  uint64_t FlushedSequence() const { return flushed_sequence_.load(std::memory_order_acquire); }
+
   void Dump();
 
  private:
@@ -74,11 +86,57 @@ class ColumnFamily {
   ColumnFamilyConfig config_;
   // reference family_handles_  do not release this handle
   rocksdb::ColumnFamilyHandle* handle_;
+  std::atomic<uint64_t> flushed_sequence_{0};
 };
 
 using ColumnFamilyPtr = std::shared_ptr<ColumnFamily>;
 using ColumnFamilyMap = std::map<std::string, ColumnFamilyPtr>;
 
+// Track the flush progress of each column family, the data written without wal is persisted only after flush.
+class FlushListener : public rocksdb::EventListener {
+ public:
+  explicit FlushListener(const ColumnFamilyMap& column_families) : column_families_(column_families) {}
+  ~FlushListener() override = default;
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override;
+
+ private:
+  ColumnFamilyMap column_families_;
+};
+
+// Cut the compaction output at region boundaries, so a region is covered by whole sst files,
+// which can be dropped by DeleteFilesInRange or linked into snapshot without the data of other regions.
+class RegionSstPartitioner : public rocksdb::SstPartitioner {
+ public:
+  // boundaries is sorted
+  explicit RegionSstPartitioner(std::vector<std::string> boundaries) : boundaries_(std::move(boundaries)) {}
+  ~RegionSstPartitioner() override = default;
+
+  const char* Name() const override { return "RegionSstPartitioner"; }
+
+  rocksdb::PartitionerResult ShouldPartition(const rocksdb::PartitionerRequest& request) override;
+  bool CanDoTrivialMove(const rocksdb::Slice& smallest_user_key, const rocksdb::Slice& largest_user_key) override;
+
+ private:
+  // Whether there is a boundary in (start_key, end_key].
+  bool HasBoundary(const rocksdb::Slice& start_key, const rocksdb::Slice& end_key) const;
+
+  std::vector<std::string> boundaries_;
+};
+
+// The boundaries are the start and end keys of the alive regions of this store, read when compaction starts.
+class RegionSstPartitionerFactory : public rocksdb::SstPartitionerFactory {
+ public:
+  RegionSstPartitionerFactory() = default;
+  ~RegionSstPartitionerFactory() override = default;
+
+  static const char* kClassName() { return "RegionSstPartitionerFactory"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<rocksdb::SstPartitioner> CreatePartitioner(
+      const rocksdb::SstPartitioner::Context& context) const override;
+};
+
 class Iterator : public dingodb::Iterator {
  public:
   explicit Iterator(IteratorOptions options, rocksdb::Iterator* iter)
@@ -176,6 +234,8 @@ class Checkpoint {
 };
 using CheckpointPtr = std::shared_ptr<Checkpoint>;
 
+class TxnGcCompactionFilterFactory;
+
 class Reader : public RawEngine::Reader {
  public:
   Reader(std::shared_ptr<RawRocksEngine> raw_engine) : raw_engine_(raw_engine){};
@@ -184,12 +244,18 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, const std::string& key, std::string& value) override;
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
+  butil::Status KvBatchGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) override;
 
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                        const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
+  butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                       const std::string& start_key, const std::string& end_key, KeyValueSink* sink) override;
 
   butil::Status KvCount(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                         int64_t& count) override;
@@ -209,9 +275,10 @@ class Reader : public RawEngine::Reader {
 
   butil::Status KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value);
+  butil::Status KvBatchGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs);
   butil::Status KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
-                       const std::string& start_key, const std::string& end_key,
-                       std::vector<pb::common::KeyValue>& kvs);
+                       const std::string& start_key, const std::string& end_key, KeyValueSink* sink);
   butil::Status KvCount(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                         const std::string& start_key, const std::string& end_key, int64_t& count);
   dingodb::IteratorPtr NewIterator(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
@@ -313,10 +380,23 @@ class RawRocksEngine : public RawEngine {
                                             std::vector<std::string>& merge_sst_paths);
 
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
+  butil::Status IngestExternalFiles(const std::map<std::string, std::vector<std::string>>& cf_files) override;
 
   void Flush(const std::string& cf_name) override;
+  // Flush the column families which have data not in sst and the meta column family atomically, wait until the flush
+  // is done. Used when rocksdb_disable_wal is set, before the raft log is truncated.
+  butil::Status FlushUnpersisted(const std::vector<std::string>& cf_names);
+  // Put without wal even to the meta column family. With atomic flush, it is persisted together with the data written
+  // without wal before it, e.g. the applied index of raft.
+  butil::Status PutWithoutWal(const std::string& cf_name, const pb::common::KeyValue& kv);
+  butil::Status DropRange(const std::vector<std::string>& cf_names, const pb::common::Range& range) override;
   butil::Status Compact(const std::string& cf_name) override;
 
+  // The gc safe point of txn used by the compaction filters of write cf and data cf. It only moves forward, and is
+  // persisted in meta column family, so the filters work again after restart before the next gc.
+  butil::Status UpdateTxnGcSafePoint(int64_t safe_point_ts);
+  int64_t GetTxnGcSafePoint();
+
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
 
  private:
@@ -333,6 +413,9 @@ class RawRocksEngine : public RawEngine {
   std::string db_path_;
   std::shared_ptr<rocksdb::DB> db_;
   rocks::ColumnFamilyMap column_families_;
+  // shared by all column families
+  std::shared_ptr<rocksdb::Cache> block_cache_;
+  std::shared_ptr<rocks::TxnGcCompactionFilterFactory> txn_gc_filter_factory_;
 
   RawEngine::ReaderPtr reader_;
   RawEngine::WriterPtr writer_;
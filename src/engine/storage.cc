@@ -27,6 +27,7 @@
 #include "engine/iterator.h"
 #include "engine/raft_store_engine.h"
 #include "engine/snapshot.h"
+#include "engine/txn_latches.h"
 #include "engine/write_data.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -38,13 +39,24 @@
 #include "proto/store.pb.h"
 #include "scan/scan.h"
 #include "scan/scan_manager.h"
+#include "scan/scan_stream.h"
 #include "serial/buf.h"
 #include "server/server.h"
+#include "vector/vector_import.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
-Storage::Storage(std::shared_ptr<Engine> engine) : engine_(engine) {}
+Storage::Storage(std::shared_ptr<Engine> engine) : engine_(engine), latches_(FLAGS_txn_latch_slot_num) {}
+
+static std::vector<std::string> GetMutationKeys(const std::vector<pb::store::Mutation>& mutations) {
+  std::vector<std::string> keys;
+  keys.reserve(mutations.size());
+  for (const auto& mutation : mutations) {
+    keys.push_back(mutation.key());
+  }
+  return keys;
+}
 
 std::shared_ptr<Engine> Storage::GetEngine() { return engine_; }
 std::shared_ptr<RaftStoreEngine> Storage::GetRaftStoreEngine() {
@@ -90,21 +102,10 @@ butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std
       Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->GetRegion(ctx->RegionId());
   assert(region != nullptr);
   auto reader = engine_->NewReader(region->GetRawEngineType());
-  for (const auto& key : keys) {
-    std::string value;
-    auto status = reader->KvGet(ctx, key, value);
-    if (!status.ok()) {
-      if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
-        continue;
-      }
-      kvs.clear();
-      return status;
-    }
-
-    pb::common::KeyValue kv;
-    kv.set_key(key);
-    kv.set_value(value);
-    kvs.emplace_back(kv);
+  status = reader->KvBatchGet(ctx, keys, kvs);
+  if (!status.ok()) {
+    kvs.clear();
+    return status;
   }
 
   return butil::Status();
@@ -203,8 +204,8 @@ butil::Status Storage::KvCompareAndSet(std::shared_ptr<Context> ctx, bool is_syn
 butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::string& cf_name, int64_t region_id,
                                    const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
                                    bool disable_auto_release, bool disable_coprocessor,
-                                   const pb::store::Coprocessor& coprocessor, std::string* scan_id,
-                                   std::vector<pb::common::KeyValue>* kvs) {
+                                   const pb::store::Coprocessor& coprocessor, int64_t parallelism,
+                                   std::string* scan_id, KeyValueSink* sink) {
   auto status = ValidateLeader(ctx->RegionId());
   if (!status.ok()) {
     return status;
@@ -222,12 +223,11 @@ butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::stri
   }
 
   status = ScanHandler::ScanBegin(scan, region_id, range, max_fetch_cnt, key_only, disable_auto_release,
-                                  disable_coprocessor, coprocessor, kvs);
+                                  disable_coprocessor, coprocessor, parallelism, sink);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("ScanContext::ScanBegin failed: {}", *scan_id);
     manager.DeleteScan(*scan_id);
     *scan_id = "";
-    kvs->clear();
     return status;
   }
 
@@ -235,7 +235,7 @@ butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::stri
 }
 
 butil::Status Storage::KvScanContinue(std::shared_ptr<Context>, const std::string& scan_id, int64_t max_fetch_cnt,
-                                      std::vector<pb::common::KeyValue>* kvs) {
+                                      KeyValueSink* sink) {
   ScanManager& manager = ScanManager::GetInstance();
   std::shared_ptr<ScanContext> scan = manager.FindScan(scan_id);
   butil::Status status;
@@ -244,7 +244,7 @@ butil::Status Storage::KvScanContinue(std::shared_ptr<Context>, const std::strin
     return butil::Status(pb::error::ESCAN_NOTFOUND, "Not found scan_id");
   }
 
-  status = ScanHandler::ScanContinue(scan, scan_id, max_fetch_cnt, kvs);
+  status = ScanHandler::ScanContinue(scan, scan_id, max_fetch_cnt, sink);
   if (!status.ok()) {
     manager.DeleteScan(scan_id);
     DINGO_LOG(ERROR) << fmt::format("ScanContext::ScanBegin failed scan : {} max_fetch_cnt : {}", scan_id,
@@ -277,6 +277,26 @@ butil::Status Storage::KvScanRelease(std::shared_ptr<Context>, const std::string
   return status;
 }
 
+butil::Status Storage::KvScanStream(std::shared_ptr<Context> ctx, const std::string& cf_name,
+                                    const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
+                                    bool disable_coprocessor, const pb::store::Coprocessor& coprocessor,
+                                    std::shared_ptr<ScanStream>* stream) {
+  auto status = ValidateLeader(ctx->RegionId());
+  if (!status.ok()) {
+    return status;
+  }
+
+  *stream = std::make_shared<ScanStream>(engine_->GetRawEngine(), cf_name);
+  status = (*stream)->Open(range, max_fetch_cnt, key_only, disable_coprocessor, coprocessor);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("ScanStream::Open failed region: {}", ctx->RegionId());
+    stream->reset();
+    return status;
+  }
+
+  return status;
+}
+
 butil::Status Storage::VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
                                  const std::vector<pb::common::VectorWithId>& vectors) {
   if (is_sync) {
@@ -304,6 +324,33 @@ butil::Status Storage::VectorDelete(std::shared_ptr<Context> ctx, bool is_sync,
                              });
 }
 
+butil::Status Storage::VectorImport(std::shared_ptr<Context> ctx, const std::vector<pb::common::VectorWithId>& vectors,
+                                   bool finish) {
+  auto status = ValidateLeader(ctx->RegionId());
+  if (!status.ok()) {
+    return status;
+  }
+
+  store::RegionPtr region =
+      Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->GetRegion(ctx->RegionId());
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region %ld", ctx->RegionId());
+  }
+
+  // Raft only record the ingest marker, followers pull the sst files from peers when apply.
+  int64_t import_id = Helper::TimestampNs();
+  std::vector<pb::raft::IngestSstFile> files;
+  if (!vectors.empty()) {
+    status = VectorImporter::BuildSstFiles(region, vectors, import_id, files);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  // Keep the sst files no matter write success or not, the marker maybe had been replicated.
+  return engine_->Write(ctx, WriteDataBuilder::BuildWrite(import_id, files, finish));
+}
+
 butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                         std::vector<pb::common::VectorWithId>& vector_with_ids) {
   auto status = ValidateLeader(ctx->region_id);
@@ -571,6 +618,8 @@ butil::Status Storage::TxnPessimisticLock(std::shared_ptr<Context> ctx,
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, GetMutationKeys(mutations));
+
   DINGO_LOG(INFO) << "TxnPessimisticLock mutations size : " << mutations.size() << " primary_lock : " << primary_lock
                   << " start_ts : " << start_ts << " lock_ttl : " << lock_ttl << " for_update_ts : " << for_update_ts;
 
@@ -590,6 +639,8 @@ butil::Status Storage::TxnPessimisticRollback(std::shared_ptr<Context> ctx, int6
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, keys);
+
   DINGO_LOG(INFO) << "TxnPessimisticRollback start_ts : " << start_ts << " for_update_ts : " << for_update_ts
                   << " keys size : " << keys.size();
 
@@ -613,6 +664,8 @@ butil::Status Storage::TxnPrewrite(std::shared_ptr<Context> ctx, const std::vect
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, GetMutationKeys(mutations));
+
   DINGO_LOG(INFO) << "TxnPrewrite mutations size : " << mutations.size() << " primary_lock : " << primary_lock
                   << " start_ts : " << start_ts << " lock_ttl : " << lock_ttl << " txn_size : " << txn_size
                   << " try_one_pc : " << try_one_pc << " max_commit_ts : " << max_commit_ts;
@@ -634,6 +687,8 @@ butil::Status Storage::TxnCommit(std::shared_ptr<Context> ctx, int64_t start_ts,
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, keys);
+
   DINGO_LOG(INFO) << "TxnCommit start_ts : " << start_ts << " commit_ts : " << commit_ts
                   << " keys size : " << keys.size();
 
@@ -653,6 +708,8 @@ butil::Status Storage::TxnCheckTxnStatus(std::shared_ptr<Context> ctx, const std
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, {primary_key});
+
   DINGO_LOG(INFO) << "TxnCheckTxnStatus primary_key : " << primary_key << " lock_ts : " << lock_ts
                   << " caller_start_ts : " << caller_start_ts << " current_ts : " << current_ts;
 
@@ -672,6 +729,8 @@ butil::Status Storage::TxnResolveLock(std::shared_ptr<Context> ctx, int64_t star
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, keys);
+
   DINGO_LOG(INFO) << "TxnResolveLock start_ts : " << start_ts << " commit_ts : " << commit_ts
                   << " keys size : " << keys.size();
 
@@ -691,6 +750,8 @@ butil::Status Storage::TxnBatchRollback(std::shared_ptr<Context> ctx, int64_t st
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, keys);
+
   DINGO_LOG(INFO) << "TxnBatchRollback keys size : " << keys.size() << ", start_ts: " << start_ts;
 
   auto writer = engine_->NewTxnWriter(engine_);
@@ -734,6 +795,8 @@ butil::Status Storage::TxnHeartBeat(std::shared_ptr<Context> ctx, const std::str
     return status;
   }
 
+  TxnLatchGuard latch_guard(latches_, {primary_lock});
+
   DINGO_LOG(INFO) << "TxnHeartBeat primary_lock : " << primary_lock << " start_ts : " << start_ts
                   << " advise_lock_ttl : " << advise_lock_ttl;
 
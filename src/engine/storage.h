@@ -24,10 +24,13 @@
 #include "butil/status.h"
 #include "common/context.h"
 #include "engine/engine.h"
+#include "engine/key_value_sink.h"
 #include "engine/raft_store_engine.h"
+#include "engine/txn_latches.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
+#include "scan/scan_stream.h"
 
 namespace dingodb {
 
@@ -49,14 +52,19 @@ class Storage {
   butil::Status KvScanBegin(std::shared_ptr<Context> ctx, const std::string& cf_name, int64_t region_id,
                             const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
                             bool disable_auto_release, bool disable_coprocessor,
-                            const pb::store::Coprocessor& coprocessor, std::string* scan_id,
-                            std::vector<pb::common::KeyValue>* kvs);
+                            const pb::store::Coprocessor& coprocessor, int64_t parallelism, std::string* scan_id,
+                            KeyValueSink* sink);
 
   static butil::Status KvScanContinue(std::shared_ptr<Context> ctx, const std::string& scan_id, int64_t max_fetch_cnt,
-                                      std::vector<pb::common::KeyValue>* kvs);
+                                      KeyValueSink* sink);
 
   static butil::Status KvScanRelease(std::shared_ptr<Context> ctx, const std::string& scan_id);
 
+  // Open a server push scan of the range, the caller accept the stream and start it.
+  butil::Status KvScanStream(std::shared_ptr<Context> ctx, const std::string& cf_name, const pb::common::Range& range,
+                             int64_t max_fetch_cnt, bool key_only, bool disable_coprocessor,
+                             const pb::store::Coprocessor& coprocessor, std::shared_ptr<ScanStream>* stream);
+
   // kv write
   butil::Status KvPut(std::shared_ptr<Context> ctx, bool is_sync, const std::vector<pb::common::KeyValue>& kvs);
 
@@ -115,6 +123,9 @@ class Storage {
   butil::Status VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
                           const std::vector<pb::common::VectorWithId>& vectors);
   butil::Status VectorDelete(std::shared_ptr<Context> ctx, bool is_sync, const std::vector<int64_t>& ids);
+  // Bulk load vectors by sst ingest, vector index is rebuilt offline after the finish request.
+  butil::Status VectorImport(std::shared_ptr<Context> ctx, const std::vector<pb::common::VectorWithId>& vectors,
+                             bool finish);
 
   butil::Status VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                  std::vector<pb::common::VectorWithId>& vector_with_ids);
@@ -142,6 +153,9 @@ class Storage {
                                        int64_t& deserialization_id_time_us, int64_t& scan_scalar_time_us,
                                        int64_t& search_time_us);
 
+  // The txn writes issued outside the txn commands, like the flush of pessimistic locks, latch their keys too.
+  TxnLatches& GetTxnLatches() { return latches_; }
+
   butil::Status ValidateLeader(int64_t region_id);
   bool IsLeader(int64_t region_id);
 
@@ -153,6 +167,8 @@ class Storage {
 
  private:
   std::shared_ptr<Engine> engine_;
+  // serialize the txn write commands of the same keys
+  TxnLatches latches_;
 };
 
 using StoragePtr = std::shared_ptr<Storage>;
@@ -14,10 +14,12 @@
 
 #include "engine/txn_engine_helper.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -27,14 +29,22 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
+#include "coordinator/tso_control.h"
+#include "engine/pessimistic_lock_table.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine/txn_latches.h"
 #include "proto/common.pb.h"
+#include "proto/meta.pb.h"
 #include "proto/raft.pb.h"
 #include "proto/store.pb.h"
 #include "server/server.h"
+#include "server/service_helper.h"
 
 namespace dingodb {
 
-DEFINE_int64(max_short_value_in_write_cf, 1024, "max short value in write cf");
+DEFINE_int64(max_short_value_in_write_cf, 256,
+             "the values shorter than it are inlined in lock and write info, not written to data cf");
 DEFINE_int64(max_batch_get_count, 1024, "max batch get count");
 DEFINE_int64(max_batch_get_memory_size, 32 * 1024 * 1024, "max batch get memory size");
 DEFINE_int64(max_scan_memory_size, 32 * 1024 * 1024, "max scan memory size");
@@ -45,6 +55,84 @@ DEFINE_int64(max_commit_count, 1024, "max commit count");
 DEFINE_int64(max_rollback_count, 1024, "max rollback count");
 DEFINE_int64(max_resolve_count, 1024, "max rollback count");
 DEFINE_int64(max_pessimistic_count, 1024, "max pessimistic count");
+DEFINE_int64(max_gc_count, 1024, "max gc write key count of a scan gc");
+DEFINE_bool(enable_txn_one_pc, true, "commit the txn in prewrite if client tries one phase commit");
+
+// The empty value can not be told from no short value in proto3, so it goes to data cf.
+static bool IsShortValue(const std::string &value) {
+  return !value.empty() && value.length() < FLAGS_max_short_value_in_write_cf;
+}
+
+// Reply the request which has nothing to write by raft.
+static void RunDoneWithoutWrite(std::shared_ptr<Context> ctx) {
+  auto *done = ctx->Done();
+  if (done != nullptr) {
+    ctx->SetDone(nullptr);
+    done->Run();
+  }
+}
+
+// Get a ts from tso of coordinator, it is composed of physical and logical like the ts of client.
+static butil::Status GenTso(int64_t &ts) {
+  auto coordinator_interaction = Server::GetInstance().GetCoordinatorInteractionMeta();
+  if (coordinator_interaction == nullptr) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "coordinator interaction of meta is nullptr");
+  }
+
+  pb::meta::TsoRequest request;
+  pb::meta::TsoResponse response;
+  request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
+  request.set_count(1);
+
+  auto status = coordinator_interaction->SendRequest("TsoService", request, response);
+  if (!status.ok()) {
+    return status;
+  }
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+
+  ts = (response.start_timestamp().physical() << kLogicalBits) + response.start_timestamp().logical();
+  return butil::Status::OK();
+}
+
+bool TxnGcChecker::IsGarbage(const std::string_view &write_key, const std::string_view &write_value,
+                             std::string &data_key) {
+  data_key.clear();
+
+  std::string user_key;
+  int64_t commit_ts = 0;
+  auto ret = Helper::DecodeTxnKey(write_key, user_key, commit_ts);
+  if (!ret.ok()) {
+    return false;
+  }
+  if (user_key != user_key_) {
+    user_key_.swap(user_key);
+    found_latest_ = false;
+  }
+  if (commit_ts > safe_point_ts_) {
+    return false;
+  }
+
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(write_value.data(), write_value.size())) {
+    return false;
+  }
+
+  if (!found_latest_) {
+    if (write_info.op() == pb::store::Op::Put || write_info.op() == pb::store::Op::Delete) {
+      found_latest_ = true;
+      return false;
+    }
+    // rollback and lock are skipped by read
+    return true;
+  }
+
+  if (write_info.op() == pb::store::Op::Put && write_info.short_value().empty()) {
+    data_key = Helper::EncodeTxnKey(user_key_, write_info.start_ts());
+  }
+  return true;
+}
 
 butil::Status TxnIterator::Init() {
   snapshot_ = raw_engine_->GetSnapshot();
@@ -133,8 +221,8 @@ butil::Status TxnIterator::Seek(const std::string &key) {
 
   auto ret = GetCurrentValue();
   if (ret.ok()) {
-    DINGO_LOG(INFO) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_) << ", value_: " << value_
-                    << ", start_ts: " << start_ts_;
+    DINGO_LOG(DEBUG) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_) << ", value_: " << value_
+                     << ", start_ts: " << start_ts_;
     return butil::Status::OK();
   } else {
     DINGO_LOG(ERROR) << "[txn]GetCurrentValue failed, errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
@@ -213,8 +301,8 @@ butil::Status TxnIterator::Next() {
 
   auto ret = GetCurrentValue();
   if (ret.ok()) {
-    DINGO_LOG(INFO) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_) << ", value_: " << value_
-                    << ", start_ts: " << start_ts_;
+    DINGO_LOG(DEBUG) << "[txn]GetCurrentValue OK, key_: " << Helper::StringToHex(key_) << ", value_: " << value_
+                     << ", start_ts: " << start_ts_;
     return butil::Status::OK();
   } else {
     DINGO_LOG(ERROR) << "[txn]GetCurrentValue failed, errcode: " << ret.error_code() << ", errmsg: " << ret.error_str();
@@ -312,6 +400,18 @@ butil::Status TxnIterator::GetCurrentValue() {
   } else if (last_write_key_ > last_lock_key_) {
     key_ = last_write_key_;
 
+    // the pessimistic lock kept in memory is not in lock cf
+    pb::store::LockInfo lock_info;
+    if (PessimisticLockTable::GetInstance().Get(key_, lock_info) &&
+        TxnEngineHelper::CheckLockConflict(lock_info, isolation_level_, start_ts_, txn_result_info_)) {
+      DINGO_LOG(WARNING) << "[txn]Scan CheckLockConflict return conflict, key: " << Helper::StringToHex(key_)
+                         << ", isolation_level: " << isolation_level_ << ", start_ts: " << start_ts_
+                         << ", lock_info: " << lock_info.ShortDebugString();
+      key_.clear();
+      value_.clear();
+      return butil::Status(pb::error::Errno::EBRAFT_EINVAL, "lock conflict");
+    }
+
     while (write_iter_->Valid()) {
       int64_t tmp_ts;
       auto ret1 = Helper::DecodeTxnKey(write_iter_->Key(), last_write_key_, tmp_ts);
@@ -458,6 +558,11 @@ bool TxnEngineHelper::CheckLockConflict(const pb::store::LockInfo &lock_info, pb
 
 butil::Status TxnEngineHelper::GetLockInfo(RawEngine::ReaderPtr reader, const std::string &key,
                                            pb::store::LockInfo &lock_info) {
+  // the pessimistic lock kept in memory is not in lock cf
+  if (PessimisticLockTable::GetInstance().Get(key, lock_info)) {
+    return butil::Status::OK();
+  }
+
   std::string lock_value;
   auto status = reader->KvGet(Constant::kTxnLockCF, Helper::EncodeTxnKey(key, Constant::kLockVer), lock_value);
   // if lock_value is not found or it is empty, then the key is not locked
@@ -563,6 +668,38 @@ butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_loc
     iter->Next();
   }
 
+  // merge the pessimistic locks kept in memory in key order
+  auto memory_lock_infos = PessimisticLockTable::GetInstance().GetLocks(start_key, end_key);
+  if (!memory_lock_infos.empty()) {
+    for (auto &lock_info : memory_lock_infos) {
+      if (lock_info.lock_ts() >= min_lock_ts && lock_info.lock_ts() < max_lock_ts) {
+        lock_infos.push_back(std::move(lock_info));
+      }
+    }
+    std::sort(lock_infos.begin(), lock_infos.end(),
+              [](const pb::store::LockInfo &lhs, const pb::store::LockInfo &rhs) { return lhs.key() < rhs.key(); });
+    if (limit > 0 && lock_infos.size() > limit) {
+      lock_infos.resize(limit);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status TxnEngineHelper::CheckGcSafePoint(RawEnginePtr raw_engine,
+                                                const pb::store::IsolationLevel &isolation_level, int64_t start_ts) {
+  // read committed reads the latest versions, they are never dropped by gc
+  if (isolation_level != pb::store::SnapshotIsolation || raw_engine->GetID() != pb::common::RAW_ENG_ROCKSDB) {
+    return butil::Status::OK();
+  }
+
+  auto safe_point_ts = std::dynamic_pointer_cast<RawRocksEngine>(raw_engine)->GetTxnGcSafePoint();
+  if (start_ts < safe_point_ts) {
+    DINGO_LOG(WARNING) << "[txn]start_ts: " << start_ts << " is before gc safe_point_ts: " << safe_point_ts;
+    return butil::Status(pb::error::Errno::ETXN_BEFORE_GC_SAFE_POINT, "start_ts %ld is before gc safe point %ld",
+                         start_ts, safe_point_ts);
+  }
+
   return butil::Status::OK();
 }
 
@@ -570,14 +707,14 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
                                         int64_t start_ts, const std::vector<std::string> &keys,
                                         std::vector<pb::common::KeyValue> &kvs,
                                         pb::store::TxnResultInfo &txn_result_info) {
-  DINGO_LOG(INFO) << "[txn]BatchGet keys_count: " << keys.size() << ", isolation_level: " << isolation_level
-                  << ", start_ts: " << start_ts << ", first_key: " << Helper::StringToHex(keys[0])
-                  << ", last_key: " << Helper::StringToHex(keys[keys.size() - 1]);
-
   if (keys.empty()) {
     return butil::Status::OK();
   }
 
+  DINGO_LOG(DEBUG) << "[txn]BatchGet keys_count: " << keys.size() << ", isolation_level: " << isolation_level
+                   << ", start_ts: " << start_ts << ", first_key: " << Helper::StringToHex(keys[0])
+                   << ", last_key: " << Helper::StringToHex(keys[keys.size() - 1]);
+
   if (engine == nullptr) {
     DINGO_LOG(FATAL) << "[txn]BatchGet engine is null";
   }
@@ -592,6 +729,11 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "keys_count is too large");
   }
 
+  auto ret = CheckGcSafePoint(engine, isolation_level, start_ts);
+  if (!ret.ok()) {
+    return ret;
+  }
+
   if (isolation_level != pb::store::SnapshotIsolation && isolation_level != pb::store::ReadCommitted) {
     DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
@@ -601,120 +743,168 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "txn_result_info is not empty");
   }
 
-  auto reader = engine->Reader();
+  int64_t iter_start_ts = 0;
+  if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
+    iter_start_ts = start_ts;
+  } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
+    iter_start_ts = Constant::kMaxVer;
+  } else {
+    DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+  }
 
-  int64_t response_memory_size = 0;
+  // lock, write and data cf are read from the same snapshot
+  auto reader = engine->Reader();
+  auto snapshot = engine->GetSnapshot();
 
-  // for every key in keys, get lock info, if lock_ts < start_ts, return LockInfo
-  // else find the latest write below our start_ts
-  // then read data from data_cf
+  // read the locks of all keys in one batch, the found lock kvs are in the order of keys
+  std::vector<std::string> lock_keys;
+  lock_keys.reserve(keys.size());
   for (const auto &key : keys) {
-    pb::common::KeyValue kv;
-    kv.set_key(key);
+    lock_keys.push_back(Helper::EncodeTxnKey(key, Constant::kLockVer));
+  }
+  std::vector<pb::common::KeyValue> lock_kvs;
+  ret = reader->KvBatchGet(Constant::kTxnLockCF, snapshot, lock_keys, lock_kvs);
+  if (!ret.ok()) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet read lock failed, keys_count: " << keys.size()
+                     << ", status: " << ret.error_str();
+  }
 
+  // the keys before the first conflict lock are read, as the keys are checked one by one in order
+  size_t read_count = keys.size();
+  size_t lock_pos = 0;
+  for (size_t i = 0; i < keys.size(); ++i) {
     pb::store::LockInfo lock_info;
-    auto ret = GetLockInfo(reader, key, lock_info);
-    if (!ret.ok()) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet GetLockInfo failed, key: " << Helper::StringToHex(key)
-                       << ", status: " << ret.error_str();
+    if (lock_pos < lock_kvs.size() && lock_kvs[lock_pos].key() == lock_keys[i]) {
+      const auto &lock_value = lock_kvs[lock_pos++].value();
+      // if lock_value is empty, the key is not locked
+      if (!lock_value.empty() && !lock_info.ParseFromString(lock_value)) {
+        DINGO_LOG(FATAL) << "[txn]BatchGet parse lock info failed, lock_key: " << Helper::StringToHex(keys[i])
+                         << ", lock_value: " << Helper::StringToHex(lock_value);
+      }
+    } else if (!PessimisticLockTable::GetInstance().Get(keys[i], lock_info)) {
+      // not locked in lock cf and memory
+      continue;
     }
 
-    auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, txn_result_info);
-    if (is_lock_conflict) {
-      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
+    if (CheckLockConflict(lock_info, isolation_level, start_ts, txn_result_info)) {
+      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(keys[i])
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
                          << ", lock_info: " << lock_info.ShortDebugString();
-      return butil::Status::OK();
-    }
-
-    int64_t iter_start_ts;
-    bool is_valid = false;
-    if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-      iter_start_ts = start_ts;
-    } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-      iter_start_ts = Constant::kMaxVer;
-    } else {
-      DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+      read_count = i;
+      break;
     }
+  }
 
-    DINGO_LOG(INFO) << "key: " << Helper::StringToHex(key) << ", iter_start_ts: " << iter_start_ts;
+  kvs.resize(read_count);
+  for (size_t i = 0; i < read_count; ++i) {
+    kvs[i].set_key(keys[i]);
+  }
+  if (read_count == 0) {
+    return butil::Status::OK();
+  }
 
-    IteratorOptions iter_options;
-    iter_options.lower_bound = Helper::EncodeTxnKey(key, iter_start_ts);
-    iter_options.upper_bound = Helper::EncodeTxnKey(key, 0);
-    auto iter = reader->NewIterator(Constant::kTxnWriteCF, iter_options);
-    if (iter == nullptr) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet NewIterator failed, start_ts: " << start_ts;
+  // sweep the write cf with one iterator in the order of the encoded seek keys, every seek stops at the versions of
+  // its key. The raw key order is not the encoded order when a key is the prefix of another, e.g. "a"+~ts may be
+  // after "ab"+~ts, so the order and the bounds are both of the encoded keys.
+  std::vector<std::string> seek_keys(read_count);
+  std::string max_write_key;
+  for (size_t i = 0; i < read_count; ++i) {
+    seek_keys[i] = Helper::EncodeTxnKey(keys[i], iter_start_ts);
+    auto write_key = Helper::EncodeTxnKey(keys[i], 0);
+    if (write_key > max_write_key) {
+      max_write_key = std::move(write_key);
     }
+  }
 
-    DINGO_LOG(INFO) << "iter_options.lower_bound: " << Helper::StringToHex(iter_options.lower_bound)
-                    << ", iter_options.upper_bound: " << Helper::StringToHex(iter_options.upper_bound);
+  std::vector<size_t> order(read_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&seek_keys](size_t lhs, size_t rhs) { return seek_keys[lhs] < seek_keys[rhs]; });
 
-    // check isolation level and return value
-    iter->Seek(iter_options.lower_bound);
-    while (iter->Valid()) {
-      if (iter->Key().length() <= 8) {
-        DINGO_LOG(ERROR) << ", invalid write_key, key: " << Helper::StringToHex(iter->Key())
-                         << ", start_ts: " << start_ts
-                         << ", write_key is less than 8 bytes: " << Helper::StringToHex(iter->Key());
-        return butil::Status(pb::error::Errno::EINTERNAL, "invalid write_key");
-      }
-      std::string write_key;
-      int64_t write_ts;
-      Helper::DecodeTxnKey(iter->Key(), write_key, write_ts);
-
-      bool is_valid = false;
-      if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-        if (write_ts <= start_ts) {
-          is_valid = true;
-        }
-      } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-        is_valid = true;
+  IteratorOptions iter_options;
+  iter_options.lower_bound = seek_keys[order.front()];
+  iter_options.upper_bound = max_write_key;
+  auto iter = reader->NewIterator(Constant::kTxnWriteCF, snapshot, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet NewIterator failed, start_ts: " << start_ts;
+  }
+
+  // the data_cf keys of the values which are not inlined in write_info, and their index in kvs
+  std::vector<std::string> data_keys;
+  std::vector<size_t> data_indexes;
+
+  for (size_t pos = 0; pos < order.size(); ++pos) {
+    size_t index = order[pos];
+    const auto &key = keys[index];
+    // the same key is read once
+    if (pos > 0 && keys[order[pos - 1]] == key) {
+      size_t prev_index = order[pos - 1];
+      if (!data_indexes.empty() && data_indexes.back() == prev_index) {
+        data_keys.push_back(data_keys.back());
+        data_indexes.push_back(index);
       } else {
-        DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-        return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+        kvs[index].set_value(kvs[prev_index].value());
       }
+      continue;
+    }
 
-      if (is_valid) {
-        // write_ts <= start_ts, return write_info
-        pb::store::WriteInfo write_info;
-        auto ret = write_info.ParseFromArray(iter->Value().data(), iter->Value().size());
-        if (!ret) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet parse write info failed, key: " << Helper::StringToHex(key)
-                           << ", write_key: " << Helper::StringToHex(iter->Key())
-                           << ", write_value(hex): " << Helper::StringToHex(iter->Value());
-        }
+    // the versions at or before iter_start_ts, newest first
+    for (iter->Seek(seek_keys[index]); iter->Valid(); iter->Next()) {
+      auto write_key = iter->Key();
+      if (write_key.size() != key.size() + 8 || write_key.compare(0, key.size(), key) != 0) {
+        break;
+      }
 
-        if (!write_info.short_value().empty()) {
-          kv.set_value(write_info.short_value());
-          break;
-        }
+      pb::store::WriteInfo write_info;
+      if (!write_info.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+        DINGO_LOG(FATAL) << "[txn]BatchGet parse write info failed, key: " << Helper::StringToHex(key)
+                         << ", write_key: " << Helper::StringToHex(write_key)
+                         << ", write_value(hex): " << Helper::StringToHex(iter->Value());
+      }
 
-        auto ret1 =
-            reader->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(key, write_info.start_ts()), *kv.mutable_value());
-        if (!ret1.ok() && ret1.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, key: " << Helper::StringToHex(key)
-                           << ", status: " << ret1.error_str();
-        } else if (ret1.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
-                           << Helper::StringToHex(key) << ", status: " << ret1.error_str()
-                           << ", raw_key: " << Helper::EncodeTxnKey(key, write_info.start_ts());
+      if (write_info.op() == pb::store::Op::Put) {
+        if (!write_info.short_value().empty()) {
+          kvs[index].set_value(write_info.short_value());
+        } else {
+          data_keys.push_back(Helper::EncodeTxnKey(key, write_info.start_ts()));
+          data_indexes.push_back(index);
         }
         break;
-      } else {
-        DINGO_LOG(ERROR) << "[txn]BatchGet write_ts: " << write_ts << " >= start_ts: " << start_ts
-                         << ", key: " << Helper::StringToHex(key)
-                         << ", write_key: " << Helper::StringToHex(iter->Key());
+      } else if (write_info.op() == pb::store::Op::Delete) {
+        // if op is delete, value is null
+        break;
       }
+      // rollback and lock have no value, go to the older version
+    }
+  }
 
-      iter->Next();
+  // read data from data_cf in one batch
+  std::vector<pb::common::KeyValue> data_kvs;
+  ret = reader->KvBatchGet(Constant::kTxnDataCF, snapshot, data_keys, data_kvs);
+  if (!ret.ok()) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, keys_count: " << data_keys.size()
+                     << ", status: " << ret.error_str();
+  }
+
+  size_t data_pos = 0;
+  for (size_t i = 0; i < data_keys.size(); ++i) {
+    if (data_pos < data_kvs.size() && data_kvs[data_pos].key() == data_keys[i]) {
+      kvs[data_indexes[i]].set_value(std::move(*data_kvs[data_pos++].mutable_value()));
+    } else {
+      DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
+                       << Helper::StringToHex(kvs[data_indexes[i]].key()) << ", raw_key: " << data_keys[i];
     }
+  }
 
-    kvs.emplace_back(kv);
-    response_memory_size += kv.ByteSizeLong();
+  int64_t response_memory_size = 0;
+  for (size_t i = 0; i < kvs.size(); ++i) {
+    response_memory_size += kvs[i].ByteSizeLong();
 
     if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
+      kvs.resize(i + 1);
+      // the locked key is beyond the returned kvs, the client will read it in the next batch
+      txn_result_info.Clear();
       DINGO_LOG(INFO) << "[txn]BatchGet kvs.size: " << kvs.size() << ", response_memory_size: " << response_memory_size
                       << ", max_batch_get_count: " << FLAGS_max_batch_get_count
                       << ", max_batch_get_memory_size: " << FLAGS_max_batch_get_memory_size;
@@ -748,6 +938,11 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return butil::Status::OK();
   }
 
+  auto ret = CheckGcSafePoint(raw_engine, isolation_level, start_ts);
+  if (!ret.ok()) {
+    return ret;
+  }
+
   if (isolation_level != pb::store::SnapshotIsolation && isolation_level != pb::store::ReadCommitted) {
     DINGO_LOG(ERROR) << "[txn]TxnScan invalid isolation_level: " << isolation_level;
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
@@ -761,8 +956,19 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "has_more or end_key is not empty");
   }
 
+  // the keys of one phase commit are locked in memory until the write is applied, they may have no write yet
+  for (const auto &lock_info : PessimisticLockTable::GetInstance().GetLocks(range.start_key(), range.end_key())) {
+    if (lock_info.lock_type() != pb::store::Op::Lock &&
+        CheckLockConflict(lock_info, isolation_level, start_ts, txn_result_info)) {
+      DINGO_LOG(WARNING) << "[txn]Scan CheckLockConflict return conflict in memory, key: "
+                         << Helper::StringToHex(lock_info.key()) << ", start_ts: " << start_ts
+                         << ", lock_info: " << lock_info.ShortDebugString();
+      return butil::Status::OK();
+    }
+  }
+
   TxnIterator txn_iter(raw_engine, range, start_ts, isolation_level);
-  auto ret = txn_iter.Init();
+  ret = txn_iter.Init();
   if (!ret.ok()) {
     DINGO_LOG(ERROR) << "[txn]Scan init txn_iter failed, start_ts: " << start_ts
                      << ", range: " << range.ShortDebugString() << ", status: " << ret.error_str();
@@ -970,6 +1176,13 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   auto *error = response->mutable_error();
 
   auto reader = raw_engine->Reader();
+
+  // the pessimistic locks are kept in memory of leader, unless the region is changing
+  bool lock_in_memory = FLAGS_enable_pessimistic_lock_in_memory &&
+                        region->State() == pb::common::StoreRegionState::NORMAL && !region->DisableChange() &&
+                        !region->DisablePessimisticLockInMemory();
+  std::vector<pb::store::LockInfo> memory_locks;
+
   // for every mutation, check and do lock, if any one of the mutation is failed, the whole lock is failed
   // 1. check if a lock is exists:
   for (const auto &mutation : mutations) {
@@ -1027,6 +1240,10 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
           lock_info.set_lock_ttl(lock_ttl);
           lock_info.set_lock_type(pb::store::Op::Lock);
           lock_info.set_extra_data(mutation.value());
+          if (lock_in_memory) {
+            memory_locks.push_back(lock_info);
+            continue;
+          }
           kv.set_value(lock_info.SerializeAsString());
 
           kv_puts_lock.push_back(kv);
@@ -1107,6 +1324,10 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
         lock_info.set_lock_ttl(lock_ttl);
         lock_info.set_lock_type(pb::store::Op::Lock);
         lock_info.set_extra_data(mutation.value());
+        if (lock_in_memory) {
+          memory_locks.push_back(lock_info);
+          continue;
+        }
         kv.set_value(lock_info.SerializeAsString());
 
         kv_puts_lock.push_back(kv);
@@ -1122,11 +1343,17 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
     return butil::Status::OK();
   }
 
+  // the locks in memory are written to lock cf when the txn prewrites them
+  for (const auto &lock_info : memory_locks) {
+    PessimisticLockTable::GetInstance().Put(lock_info);
+  }
+
   if (kv_puts_lock.empty()) {
     DINGO_LOG(INFO) << fmt::format("[txn][region({})] PessimisticLock return empty kv_puts_lock,", region->Id())
-                    << ", kv_puts_lock_size: " << kv_puts_lock.size() << ", start_ts: " << start_ts
-                    << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString()
+                    << ", kv_puts_lock_size: " << kv_puts_lock.size() << ", memory_locks_size: " << memory_locks.size()
+                    << ", start_ts: " << start_ts << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString()
                     << ", mutations_size: " << mutations.size();
+    RunDoneWithoutWrite(ctx);
     return butil::Status::OK();
   }
 
@@ -1219,6 +1446,19 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
           DINGO_LOG(INFO) << fmt::format("[txn][region({})] PessimisticRollback,", region->Id())
                           << ", key: " << Helper::StringToHex(key)
                           << " is locked by self, can do rollback, lock_info: " << lock_info.ShortDebugString();
+          // the lock in memory is released without raft, lock cf may still have a lock of the txn which is flushed
+          // or has an older for_update_ts
+          pb::store::LockInfo memory_lock_info;
+          if (PessimisticLockTable::GetInstance().Get(key, memory_lock_info) &&
+              memory_lock_info.lock_ts() == start_ts) {
+            PessimisticLockTable::GetInstance().Erase(key);
+
+            pb::store::LockInfo cf_lock_info;
+            auto ret2 = GetLockInfo(reader, key, cf_lock_info);
+            if (ret2.ok() && cf_lock_info.lock_ts() != start_ts) {
+              continue;
+            }
+          }
           kv_dels_lock.push_back(Helper::EncodeTxnKey(key, Constant::kLockVer));
           continue;
         } else {
@@ -1262,6 +1502,7 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
     DINGO_LOG(INFO) << fmt::format("[txn][region({})] PessimisticRollback,", region->Id())
                     << ", kv_dels_lock is empty, start_ts: " << start_ts
                     << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString() << ", keys_size: " << keys.size();
+    RunDoneWithoutWrite(ctx);
     return butil::Status::OK();
   }
 
@@ -1326,6 +1567,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
 
   std::vector<pb::common::KeyValue> kv_puts_data;
   std::vector<pb::common::KeyValue> kv_puts_lock;
+  std::vector<pb::store::LockInfo> lock_infos;  // for one phase commit
   std::vector<std::string> kv_dels_lock;  // for PutIfAbsent on pessimistic lock, if key is exists, no put will be
                                           // done, need to delete the lock in prewrite
 
@@ -1545,7 +1787,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     // 3.do Put/Delete/PutIfAbsent
     if (mutation.op() == pb::store::Op::Put) {
       // put data
-      if (mutation.value().length() >= FLAGS_max_short_value_in_write_cf) {
+      if (!IsShortValue(mutation.value())) {
         pb::common::KeyValue kv;
         std::string data_key = Helper::EncodeTxnKey(mutation.key(), start_ts);
         kv.set_key(data_key);
@@ -1566,7 +1808,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
         lock_info.set_lock_ttl(lock_ttl);
         lock_info.set_txn_size(txn_size);
         lock_info.set_lock_type(pb::store::Op::Put);
-        if (mutation.value().length() < FLAGS_max_short_value_in_write_cf) {
+        if (IsShortValue(mutation.value())) {
           lock_info.set_short_value(mutation.value());
         }
         if (lock_extra_datas.find(i) != lock_extra_datas.end()) {
@@ -1575,6 +1817,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
         kv.set_value(lock_info.SerializeAsString());
 
         kv_puts_lock.push_back(kv);
+        lock_infos.push_back(lock_info);
       }
     } else if (mutation.op() == pb::store::Op::PutIfAbsent) {
       DINGO_LOG(INFO) << fmt::format("[txn][region({})] Prewrite", region->Id())
@@ -1607,12 +1850,13 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
           kv.set_value(lock_info.SerializeAsString());
 
           kv_puts_lock.push_back(kv);
+          lock_infos.push_back(lock_info);
         }
         continue;
 
       } else {
         // put data
-        if (mutation.value().length() >= FLAGS_max_short_value_in_write_cf) {
+        if (!IsShortValue(mutation.value())) {
           pb::common::KeyValue kv;
           std::string data_key = Helper::EncodeTxnKey(mutation.key(), start_ts);
           kv.set_key(data_key);
@@ -1633,7 +1877,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
           lock_info.set_lock_ttl(lock_ttl);
           lock_info.set_txn_size(txn_size);
           lock_info.set_lock_type(pb::store::Op::Put);
-          if (mutation.value().length() < FLAGS_max_short_value_in_write_cf) {
+          if (IsShortValue(mutation.value())) {
             lock_info.set_short_value(mutation.value());
           }
           if (lock_extra_datas.find(i) != lock_extra_datas.end()) {
@@ -1642,6 +1886,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
           kv.set_value(lock_info.SerializeAsString());
 
           kv_puts_lock.push_back(kv);
+          lock_infos.push_back(lock_info);
         }
       }
     } else if (mutation.op() == pb::store::Op::Delete) {
@@ -1667,6 +1912,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
         kv.set_value(lock_info.SerializeAsString());
 
         kv_puts_lock.push_back(kv);
+        lock_infos.push_back(lock_info);
       }
     } else {
       DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite,", region->Id())
@@ -1685,6 +1931,16 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     return butil::Status::OK();
   }
 
+  // all mutations are checked without conflict, try to commit them at once
+  if (try_one_pc && CanOnePcCommit(*response, mutations.size(), lock_infos.size())) {
+    int64_t one_pc_commit_ts = 0;
+    auto ret = DoOnePcCommit(raft_engine, ctx, region, lock_infos, kv_puts_data, start_ts, max_commit_ts,
+                             one_pc_commit_ts);
+    if (!ret.ok() || one_pc_commit_ts > 0) {
+      return ret;
+    }
+  }
+
   // after all mutations is processed, write into raft engine
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
@@ -1717,6 +1973,134 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
   return raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
 }
 
+bool TxnEngineHelper::CanOnePcCommit(const pb::store::TxnPrewriteResponse &response, size_t mutations_size,
+                                     size_t lock_infos_size) {
+  // the client of PutIfAbsent learns the existed keys from the 2PC prewrite, 1PC would commit the other keys first
+  return FLAGS_enable_txn_one_pc && response.txn_result_size() == 0 && response.keys_already_exist_size() == 0 &&
+         lock_infos_size == mutations_size;
+}
+
+bool TxnEngineHelper::IsOnePcCommitTsValid(int64_t start_ts, int64_t max_commit_ts, int64_t commit_ts) {
+  return commit_ts > start_ts && (max_commit_ts == 0 || commit_ts <= max_commit_ts);
+}
+
+void TxnEngineHelper::GenOnePcWrite(const std::vector<pb::store::LockInfo> &lock_infos,
+                                    const std::vector<pb::common::KeyValue> &kv_puts_data, int64_t start_ts,
+                                    int64_t commit_ts, pb::raft::MultiCfPutAndDeleteRequest &request) {
+  if (!kv_puts_data.empty()) {
+    auto *data_puts = request.add_puts_with_cf();
+    data_puts->set_cf_name(Constant::kTxnDataCF);
+    for (const auto &kv_put : kv_puts_data) {
+      *data_puts->add_kvs() = kv_put;
+    }
+  }
+
+  pb::raft::PutsWithCf *write_puts = nullptr;
+  auto *lock_dels = request.add_deletes_with_cf();
+  lock_dels->set_cf_name(Constant::kTxnLockCF);
+  for (const auto &lock_info : lock_infos) {
+    // the prewrite found no lock of other txn, a lock of the txn in lock cf is a flushed pessimistic lock or left by
+    // an earlier prewrite of it, it is done by the commit
+    lock_dels->add_keys(Helper::EncodeTxnKey(lock_info.key(), Constant::kLockVer));
+
+    // the key of PutIfAbsent exists, nothing to write
+    if (lock_info.lock_type() == pb::store::Op::PutIfAbsent) {
+      continue;
+    }
+
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(lock_info.lock_type());
+    if (!lock_info.short_value().empty()) {
+      write_info.set_short_value(lock_info.short_value());
+    }
+
+    if (write_puts == nullptr) {
+      write_puts = request.add_puts_with_cf();
+      write_puts->set_cf_name(Constant::kTxnWriteCF);
+    }
+    auto *kv = write_puts->add_kvs();
+    kv->set_key(Helper::EncodeTxnKey(lock_info.key(), commit_ts));
+    kv->set_value(write_info.SerializeAsString());
+  }
+}
+
+butil::Status TxnEngineHelper::DoOnePcCommit(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                             store::RegionPtr region,
+                                             const std::vector<pb::store::LockInfo> &lock_infos,
+                                             const std::vector<pb::common::KeyValue> &kv_puts_data, int64_t start_ts,
+                                             int64_t max_commit_ts, int64_t &commit_ts) {
+  commit_ts = 0;
+
+  // the vector index is built in DoTxnCommit, so vector index region uses 2PC
+  if (region->Type() == pb::common::INDEX_REGION &&
+      region->Definition().index_parameter().has_vector_index_parameter()) {
+    DINGO_LOG(INFO) << fmt::format("[txn][region({})] DoOnePcCommit, start_ts: {}", region->Id(), start_ts)
+                    << ", vector index region does not support one phase commit, fall back to 2PC";
+    return butil::Status::OK();
+  }
+
+  // lock the keys in memory before getting commit_ts, then the readers with ts later than commit_ts meet the locks
+  // until the write is applied. The 1PC locks are kept apart from the pessimistic locks of the txn, which are
+  // released only if the write is done.
+  auto &lock_table = PessimisticLockTable::GetInstance();
+  for (const auto &lock_info : lock_infos) {
+    lock_table.PutOnePcLock(lock_info);
+  }
+  auto release_locks = [&](bool committed) {
+    for (const auto &lock_info : lock_infos) {
+      lock_table.EraseOnePcLock(lock_info.key());
+      pb::store::LockInfo pessimistic_lock;
+      if (committed && lock_table.GetPessimisticLock(lock_info.key(), pessimistic_lock) &&
+          pessimistic_lock.lock_ts() == start_ts) {
+        lock_table.EraseIfMatch(lock_info.key(), pessimistic_lock.lock_ts(), pessimistic_lock.for_update_ts());
+      }
+    }
+  };
+
+  int64_t ts = 0;
+  auto ret = GenTso(ts);
+  if (!ret.ok() || !IsOnePcCommitTsValid(start_ts, max_commit_ts, ts)) {
+    DINGO_LOG(WARNING) << fmt::format("[txn][region({})] DoOnePcCommit, start_ts: {}", region->Id(), start_ts)
+                       << ", gen commit_ts failed or out of range, fall back to 2PC, commit_ts: " << ts
+                       << ", max_commit_ts: " << max_commit_ts << ", status: " << ret.error_str();
+    // the keys are latched by storage, the locks of 2PC are written before other commands of them
+    release_locks(false);
+    return butil::Status::OK();
+  }
+
+  pb::raft::TxnRaftRequest txn_raft_request;
+  auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
+  GenOnePcWrite(lock_infos, kv_puts_data, start_ts, ts, *cf_put_delete);
+
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] DoOnePcCommit, start_ts: {}, commit_ts: {}", region->Id(),
+                                 start_ts, ts)
+                  << ", kv_puts_data_size: " << kv_puts_data.size() << ", lock_infos_size: " << lock_infos.size();
+
+  if (cf_put_delete->puts_with_cf_size() == 0 && cf_put_delete->deletes_with_cf_size() == 0) {
+    RunDoneWithoutWrite(ctx);
+  } else {
+    ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  }
+
+  release_locks(ret.ok());
+
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] DoOnePcCommit, start_ts: {}, commit_ts: {}", region->Id(),
+                                    start_ts, ts)
+                     << ", write failed, status: " << ret.error_str();
+    return ret;
+  }
+
+  commit_ts = ts;
+  auto *response = dynamic_cast<pb::store::TxnPrewriteResponse *>(ctx->Response());
+  if (response != nullptr) {
+    response->set_one_pc_commit_ts(commit_ts);
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status TxnEngineHelper::Commit(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                       std::shared_ptr<Context> ctx, int64_t start_ts, int64_t commit_ts,
                                       const std::vector<std::string> &keys) {
@@ -2670,7 +3054,103 @@ butil::Status TxnEngineHelper::DeleteRange(RawEnginePtr /*raw_engine*/, std::sha
   return raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
 }
 
-butil::Status TxnEngineHelper::Gc(RawEnginePtr /*raw_engine*/, std::shared_ptr<Engine> raft_engine,
+butil::Status TxnEngineHelper::FlushPessimisticLocks(std::shared_ptr<Engine> raft_engine, store::RegionPtr region) {
+  // run on the worker of txn commands of region, no lock is taken or released between reading and applying them
+  auto worker_set = Server::GetInstance().GetServiceWorkerSet();
+  if (worker_set == nullptr) {
+    return DoFlushPessimisticLocks(raft_engine, region);
+  }
+
+  butil::Status status;
+  auto cond = std::make_shared<BthreadCond>();
+  auto task = std::make_shared<ServiceTask>([&status, cond, raft_engine, region]() {
+    status = DoFlushPessimisticLocks(raft_engine, region);
+    cond->DecreaseSignal();
+  });
+  if (!worker_set->ExecuteHashByRegionId(region->Id(), task)) {
+    return butil::Status(pb::error::Errno::EREQUEST_FULL, "Commit execute queue failed");
+  }
+  cond->IncreaseWait();
+
+  return status;
+}
+
+butil::Status TxnEngineHelper::DoFlushPessimisticLocks(std::shared_ptr<Engine> raft_engine, store::RegionPtr region) {
+  // the later pessimistic locks are written to lock cf, until the region change is done or given up
+  region->SetDisablePessimisticLockInMemory(true);
+
+  // the locks of 1PC in flight are not flushed, the commit writes the data or they are given up
+  auto range = region->Range();
+  auto lock_infos = PessimisticLockTable::GetInstance().GetPessimisticLocks(range.start_key(), range.end_key());
+  if (lock_infos.empty()) {
+    return butil::Status::OK();
+  }
+
+  // latch the keys as the txn commands do, the commands of the merged or split regions run on other workers, the
+  // locks are read again under the latches
+  std::vector<std::string> keys;
+  keys.reserve(lock_infos.size());
+  for (const auto &lock_info : lock_infos) {
+    keys.push_back(lock_info.key());
+  }
+  std::unique_ptr<TxnLatchGuard> latch_guard;
+  auto storage = Server::GetInstance().GetStorage();
+  if (storage != nullptr) {
+    latch_guard = std::make_unique<TxnLatchGuard>(storage->GetTxnLatches(), keys);
+  }
+
+  lock_infos.clear();
+  for (const auto &key : keys) {
+    pb::store::LockInfo lock_info;
+    if (PessimisticLockTable::GetInstance().GetPessimisticLock(key, lock_info)) {
+      lock_infos.push_back(lock_info);
+    }
+  }
+  if (lock_infos.empty()) {
+    return butil::Status::OK();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] FlushPessimisticLocks, count: {}", region->Id(),
+                                 lock_infos.size());
+
+  // the locks are erased from memory when the puts of lock cf are applied
+  pb::raft::TxnRaftRequest txn_raft_request;
+  auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
+  auto *lock_puts = cf_put_delete->add_puts_with_cf();
+  lock_puts->set_cf_name(Constant::kTxnLockCF);
+  for (const auto &lock_info : lock_infos) {
+    auto *kv = lock_puts->add_kvs();
+    kv->set_key(Helper::EncodeTxnKey(lock_info.key(), Constant::kLockVer));
+    kv->set_value(lock_info.SerializeAsString());
+  }
+
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region->Id());
+  ctx->SetRegionEpoch(region->Epoch());
+  auto status = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] FlushPessimisticLocks failed, count: {}", region->Id(),
+                                    lock_infos.size())
+                     << ", errcode: " << status.error_code() << ", errmsg: " << status.error_str();
+    region->SetDisablePessimisticLockInMemory(false);
+  }
+
+  return status;
+}
+
+void TxnEngineHelper::DropPessimisticLocks(store::RegionPtr region) {
+  auto range = region->Range();
+  auto lock_infos = PessimisticLockTable::GetInstance().GetPessimisticLocks(range.start_key(), range.end_key());
+  if (lock_infos.empty()) {
+    return;
+  }
+
+  DINGO_LOG(WARNING) << fmt::format("[txn][region({})] DropPessimisticLocks, count: {}", region->Id(),
+                                    lock_infos.size());
+  PessimisticLockTable::GetInstance().EraseRange(range.start_key(), range.end_key());
+}
+
+butil::Status TxnEngineHelper::Gc(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                   std::shared_ptr<Context> ctx, int64_t safe_point_ts) {
   DINGO_LOG(INFO) << fmt::format("[txn][region({})] Gc, safe_point_ts: {}", ctx->RegionId(), safe_point_ts)
                   << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString();
@@ -2690,11 +3170,68 @@ butil::Status TxnEngineHelper::Gc(RawEnginePtr /*raw_engine*/, std::shared_ptr<E
   }
   auto *error = response->mutable_error();
 
+  // every replica learns the safe point by raft, it rejects the reads before it and its compaction filters drop the
+  // old versions of write cf and data cf
+  if (raw_engine->GetID() == pb::common::RAW_ENG_ROCKSDB) {
+    pb::raft::TxnRaftRequest txn_raft_request;
+    txn_raft_request.mutable_gc_safe_point()->set_safe_point_ts(safe_point_ts);
+
+    if (FLAGS_rocksdb_txn_gc_compaction_filter) {
+      return raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+    }
+
+    auto safe_point_ctx = std::make_shared<Context>();
+    safe_point_ctx->SetRegionId(region->Id());
+    safe_point_ctx->SetRegionEpoch(ctx->RegionEpoch());
+    auto ret = raft_engine->Write(safe_point_ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Gc, safe_point_ts: {}", region->Id(), safe_point_ts)
+                       << ", write gc safe point failed, errcode: " << ret.error_code()
+                       << ", errmsg: " << ret.error_str();
+      return ret;
+    }
+  }
+
+  // without the compaction filters, the old versions are deleted through raft
   std::vector<std::string> kv_deletes_lock;
   std::vector<std::string> kv_deletes_data;
   std::vector<std::string> kv_deletes_write;
 
-  // TODO: scan data to be delete and add items to kv_deletes_*
+  // scan the write cf of region, at most max_gc_count keys are deleted, the rest is left to the next gc
+  auto range = region->Range();
+  IteratorOptions iter_options;
+  iter_options.lower_bound = Helper::EncodeTxnKey(range.start_key(), Constant::kMaxVer);
+  iter_options.upper_bound = Helper::EncodeTxnKey(range.end_key(), Constant::kMaxVer);
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kTxnWriteCF, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Gc, safe_point_ts: {}", region->Id(), safe_point_ts)
+                     << ", NewIterator failed";
+    return butil::Status(pb::error::Errno::EINTERNAL, "NewIterator failed");
+  }
+
+  TxnGcChecker checker(safe_point_ts);
+  std::string data_key;
+  for (iter->Seek(iter_options.lower_bound); iter->Valid(); iter->Next()) {
+    if (!checker.IsGarbage(iter->Key(), iter->Value(), data_key)) {
+      continue;
+    }
+
+    kv_deletes_write.emplace_back(iter->Key());
+    if (!data_key.empty()) {
+      kv_deletes_data.push_back(data_key);
+    }
+    if (kv_deletes_write.size() >= FLAGS_max_gc_count) {
+      break;
+    }
+  }
+
+  if (kv_deletes_write.empty()) {
+    RunDoneWithoutWrite(ctx);
+    return butil::Status::OK();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] Gc, safe_point_ts: {} delete write keys: {} data keys: {}",
+                                 region->Id(), safe_point_ts, kv_deletes_write.size(), kv_deletes_data.size());
 
   // after all mutations is processed, write into raft engine
   pb::raft::TxnRaftRequest txn_raft_request;
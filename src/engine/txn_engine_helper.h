@@ -19,6 +19,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
@@ -26,6 +28,7 @@
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
 #include "meta/store_meta_manager.h"
+#include "proto/raft.pb.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
@@ -73,6 +76,24 @@ class TxnIterator {
   std::string value_{};
 };
 
+// Decide which records of write cf can not be read at or after the safe point, they are the records older than the
+// newest put or delete committed before the safe point, and the rollback and lock records before the safe point.
+// The write keys must be checked in order, as compaction and iterator see them.
+class TxnGcChecker {
+ public:
+  explicit TxnGcChecker(int64_t safe_point_ts) : safe_point_ts_(safe_point_ts) {}
+  ~TxnGcChecker() = default;
+
+  // Return true if the write record is garbage, data_key is set if its value is in data cf.
+  bool IsGarbage(const std::string_view &write_key, const std::string_view &write_value, std::string &data_key);
+
+ private:
+  int64_t safe_point_ts_;
+  std::string user_key_;
+  // the newest put or delete before the safe point of user_key_ is found
+  bool found_latest_{false};
+};
+
 class TxnEngineHelper {
  public:
   static bool CheckLockConflict(const pb::store::LockInfo &lock_info, pb::store::IsolationLevel isolation_level,
@@ -83,6 +104,10 @@ class TxnEngineHelper {
                                     const std::string &start_key, const std::string &end_key, int64_t limit,
                                     std::vector<pb::store::LockInfo> &lock_infos);
 
+  // The old versions before the gc safe point may have been dropped, the reads before it are rejected.
+  static butil::Status CheckGcSafePoint(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
+                                        int64_t start_ts);
+
   static butil::Status BatchGet(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
                                 int64_t start_ts, const std::vector<std::string> &keys,
                                 std::vector<pb::common::KeyValue> &kvs, pb::store::TxnResultInfo &txn_result_info);
@@ -106,6 +131,23 @@ class TxnEngineHelper {
                                    const std::vector<pb::store::LockInfo> &lock_infos, int64_t start_ts,
                                    int64_t commit_ts);
 
+  // The prewrite is checked without any conflict or existed key of PutIfAbsent, and every mutation has its lock.
+  static bool CanOnePcCommit(const pb::store::TxnPrewriteResponse &response, size_t mutations_size,
+                             size_t lock_infos_size);
+  // The commit_ts from tso must be after start_ts and not after max_commit_ts, max_commit_ts 0 is no limit.
+  static bool IsOnePcCommitTsValid(int64_t start_ts, int64_t max_commit_ts, int64_t commit_ts);
+  // The data/write records of the prewrite at commit_ts, and the deletes of the locks of the txn in lock cf.
+  static void GenOnePcWrite(const std::vector<pb::store::LockInfo> &lock_infos,
+                            const std::vector<pb::common::KeyValue> &kv_puts_data, int64_t start_ts, int64_t commit_ts,
+                            pb::raft::MultiCfPutAndDeleteRequest &request);
+
+  // Write the write/data records of the prewrite at a commit_ts from tso in one raft entry, commit_ts is 0 if it
+  // falls back to 2PC.
+  static butil::Status DoOnePcCommit(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                     store::RegionPtr region, const std::vector<pb::store::LockInfo> &lock_infos,
+                                     const std::vector<pb::common::KeyValue> &kv_puts_data, int64_t start_ts,
+                                     int64_t max_commit_ts, int64_t &commit_ts);
+
   static butil::Status DoRollback(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                   std::shared_ptr<Context> ctx, std::vector<std::string> &keys_to_rollback_with_data,
                                   std::vector<std::string> &keys_to_rollback_without_data, int64_t start_ts);
@@ -151,6 +193,14 @@ class TxnEngineHelper {
 
   static butil::Status Gc(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
                           int64_t safe_point_ts);
+
+  // The pessimistic locks of region kept in memory of leader, they are written to lock cf by raft before the region
+  // leaves the leader by transfer, split or merge, and dropped if the leader stops by other reasons.
+  // The flush runs on the service worker of region in order with its txn commands. From then on the new pessimistic
+  // locks are written to lock cf, the caller enables the memory locks again if it gives up the region change.
+  static butil::Status FlushPessimisticLocks(std::shared_ptr<Engine> raft_engine, store::RegionPtr region);
+  static butil::Status DoFlushPessimisticLocks(std::shared_ptr<Engine> raft_engine, store::RegionPtr region);
+  static void DropPessimisticLocks(store::RegionPtr region);
 };
 
 }  // namespace dingodb
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_latches.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/compiler_specific.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+DEFINE_bool(enable_txn_latch, true, "serialize the txn write commands of the same keys before raft proposal");
+DEFINE_int64(txn_latch_slot_num, 4096, "slot num of txn latches");
+
+namespace dingodb {
+
+TxnLatches::TxnLatches(size_t slot_num) : slot_num_(std::max(slot_num, static_cast<size_t>(1))) {
+  slots_ = std::make_unique<Slot[]>(slot_num_);
+}
+
+std::vector<size_t> TxnLatches::GenSlots(const std::vector<std::string>& keys) const {
+  std::vector<size_t> slots;
+  slots.reserve(keys.size());
+  for (const auto& key : keys) {
+    slots.push_back(std::hash<std::string>{}(key) % slot_num_);
+  }
+
+  std::sort(slots.begin(), slots.end());
+  slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+  return slots;
+}
+
+void TxnLatches::Acquire(const std::vector<size_t>& slots, int64_t command_id) {
+  for (auto index : slots) {
+    auto& slot = slots_[index];
+    std::unique_lock<bthread::Mutex> lock(slot.mutex);
+    slot.command_ids.push_back(command_id);
+    while (slot.command_ids.front() != command_id) {
+      slot.cond.wait(lock);
+    }
+  }
+}
+
+void TxnLatches::Release(const std::vector<size_t>& slots, int64_t command_id) {
+  for (auto index : slots) {
+    auto& slot = slots_[index];
+    std::unique_lock<bthread::Mutex> lock(slot.mutex);
+    if (BAIDU_UNLIKELY(slot.command_ids.empty() || slot.command_ids.front() != command_id)) {
+      DINGO_LOG(FATAL) << fmt::format("[txn] release latch of slot({}) which is not held by command({})", index,
+                                      command_id);
+    }
+    slot.command_ids.pop_front();
+    if (!slot.command_ids.empty()) {
+      slot.cond.notify_all();
+    }
+  }
+}
+
+TxnLatchGuard::TxnLatchGuard(TxnLatches& latches, const std::vector<std::string>& keys)
+    : latches_(latches), command_id_(0) {
+  if (!FLAGS_enable_txn_latch) {
+    return;
+  }
+
+  slots_ = latches_.GenSlots(keys);
+  command_id_ = latches_.GenCommandId();
+  latches_.Acquire(slots_, command_id_);
+}
+
+TxnLatchGuard::~TxnLatchGuard() {
+  if (!slots_.empty()) {
+    latches_.Release(slots_, command_id_);
+  }
+}
+
+}  // namespace dingodb
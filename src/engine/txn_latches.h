@@ -0,0 +1,84 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_LATCHES_H_  // NOLINT
+#define DINGODB_ENGINE_TXN_LATCHES_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "gflags/gflags.h"
+
+DECLARE_bool(enable_txn_latch);
+DECLARE_int64(txn_latch_slot_num);
+
+namespace dingodb {
+
+// Serialize the txn write commands of the same keys on this store, from reading lock/write cf until the raft write is
+// applied, so the conflict is found before proposing instead of after the raft round trip. The keys are hashed to
+// slots, every slot is a FIFO queue of commands, the commands of different slots run in parallel.
+class TxnLatches {
+ public:
+  explicit TxnLatches(size_t slot_num);
+  ~TxnLatches() = default;
+
+  TxnLatches(const TxnLatches& rhs) = delete;
+  TxnLatches& operator=(const TxnLatches& rhs) = delete;
+
+  // The sorted and unique slots of keys, they are acquired in order so there is no deadlock.
+  std::vector<size_t> GenSlots(const std::vector<std::string>& keys) const;
+
+  int64_t GenCommandId() { return next_command_id_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Wait until the command is the first of all its slots.
+  void Acquire(const std::vector<size_t>& slots, int64_t command_id);
+  void Release(const std::vector<size_t>& slots, int64_t command_id);
+
+ private:
+  struct Slot {
+    bthread::Mutex mutex;
+    bthread::ConditionVariable cond;
+    std::deque<int64_t> command_ids;
+  };
+
+  size_t slot_num_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<int64_t> next_command_id_{1};
+};
+
+// Hold the latches of keys in the scope of a txn command.
+class TxnLatchGuard {
+ public:
+  TxnLatchGuard(TxnLatches& latches, const std::vector<std::string>& keys);
+  ~TxnLatchGuard();
+
+  TxnLatchGuard(const TxnLatchGuard& rhs) = delete;
+  TxnLatchGuard& operator=(const TxnLatchGuard& rhs) = delete;
+
+ private:
+  TxnLatches& latches_;
+  std::vector<size_t> slots_;
+  int64_t command_id_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_LATCHES_H_  // NOLINT
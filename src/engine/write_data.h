@@ -42,6 +42,7 @@ enum class DatumType {
   kRebuildVectorIndex = 11,
   kSaveRaftSnapshot = 12,
   kTxn = 13,
+  kIngestSst = 14,
 };
 
 class DatumAble {
@@ -406,6 +407,30 @@ struct SaveRaftSnapshotDatum : public DatumAble {
   int64_t region_id;
 };
 
+struct IngestSstDatum : public DatumAble {
+  DatumType GetType() override { return DatumType::kIngestSst; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::INGEST_SST);
+    auto* ingest_request = request->mutable_ingest_sst();
+    ingest_request->set_import_id(import_id);
+    for (auto& file : files) {
+      ingest_request->add_files()->Swap(&file);
+    }
+    ingest_request->set_rebuild_vector_index(rebuild_vector_index);
+
+    return request;
+  };
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  int64_t import_id;
+  std::vector<pb::raft::IngestSstFile> files;
+  bool rebuild_vector_index;
+};
+
 class WriteData {
  public:
   std::vector<std::shared_ptr<DatumAble>> Datums() const { return datums_; }
@@ -613,6 +638,20 @@ class WriteDataBuilder {
     return write_data;
   }
 
+  // IngestSstDatum
+  static std::shared_ptr<WriteData> BuildWrite(int64_t import_id, const std::vector<pb::raft::IngestSstFile>& files,
+                                               bool rebuild_vector_index) {
+    auto datum = std::make_shared<IngestSstDatum>();
+    datum->import_id = import_id;
+    datum->files = files;
+    datum->rebuild_vector_index = rebuild_vector_index;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
   // SaveRaftSnapshotDatum
   static std::shared_ptr<WriteData> BuildWrite(int64_t region_id) {
     auto datum = std::make_shared<SaveRaftSnapshotDatum>();
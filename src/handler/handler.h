@@ -47,6 +47,7 @@ enum class HandlerType {
   kVectorAdd = pb::raft::VECTOR_ADD,
   kVectorDelete = pb::raft::VECTOR_DELETE,
   kRebuildVectorIndex = pb::raft::REBUILD_VECTOR_INDEX,
+  kIngestSst = pb::raft::INGEST_SST,
 
   // txn
   kTxn = pb::raft::TXN,
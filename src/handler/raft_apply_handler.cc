@@ -40,6 +40,7 @@
 #include "proto/raft.pb.h"
 #include "server/server.h"
 #include "vector/codec.h"
+#include "vector/vector_import.h"
 
 namespace dingodb {
 
@@ -646,6 +647,9 @@ int SplitHandler::Handle(std::shared_ptr<Context>, store::RegionPtr from_region,
     store_raft_meata->SaveRaftMeta(from_region->Id());
   }
 
+  // the pessimistic locks were flushed before split, the later ones are kept in memory of the new range
+  from_region->SetDisablePessimisticLockInMemory(false);
+
   // Update region metrics min/max key policy
   if (region_metrics != nullptr) {
     region_metrics->UpdateMaxAndMinKeyPolicy();
@@ -1228,6 +1232,33 @@ int RebuildVectorIndexHandler::Handle(std::shared_ptr<Context>, store::RegionPtr
   return 0;
 }
 
+int IngestSstHandler::Handle(std::shared_ptr<Context>, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                             const pb::raft::Request &req, store::RegionMetricsPtr, int64_t, int64_t log_id) {
+  const auto &request = req.ingest_sst();
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_import][region({})] Handle ingest sst, import_id: {} file_count: {} apply_log_id: {}", region->Id(),
+      request.import_id(), request.files_size(), log_id);
+
+  if (request.files_size() > 0) {
+    auto status = VectorImporter::Ingest(region, engine, request, log_id);
+    if (!status.ok()) {
+      // The later logs depend on the ingested data, skip it would make the replica diverge silently.
+      DINGO_LOG(FATAL) << fmt::format("[vector_import][region({})] Ingest sst failed, import_id: {} error: {}",
+                                      region->Id(), request.import_id(), status.error_str());
+      return -1;
+    }
+  }
+
+  // Vector index not include the ingested vectors, rebuild it offline once after the last batch.
+  // The apply log id is advanced by the rebuilt index when it is switched in.
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (request.rebuild_vector_index() && vector_index_wrapper != nullptr) {
+    VectorIndexManager::LaunchRebuildVectorIndex(vector_index_wrapper, true);
+  }
+
+  return 0;
+}
+
 std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   auto handler_collection = std::make_shared<HandlerCollection>();
   handler_collection->Register(std::make_shared<PutHandler>());
@@ -1242,6 +1273,7 @@ std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   handler_collection->Register(std::make_shared<VectorAddHandler>());
   handler_collection->Register(std::make_shared<VectorDeleteHandler>());
   handler_collection->Register(std::make_shared<RebuildVectorIndexHandler>());
+  handler_collection->Register(std::make_shared<IngestSstHandler>());
   handler_collection->Register(std::make_shared<SaveRaftSnapshotHandler>());
   handler_collection->Register(std::make_shared<TxnHandler>());
 
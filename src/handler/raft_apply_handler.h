@@ -153,6 +153,15 @@ class RebuildVectorIndexHandler : public BaseHandler {
              int64_t log_id) override;
 };
 
+// Ingest sst handler
+class IngestSstHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kIngestSst; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+};
+
 class TxnHandler : public BaseHandler {
  public:
   HandlerType GetType() override { return HandlerType::kTxn; }
@@ -169,6 +178,10 @@ class TxnHandler : public BaseHandler {
                                           std::shared_ptr<RawEngine> engine,
                                           const pb::raft::TxnDeleteRangeRequest &request,
                                           store::RegionMetricsPtr region_metrics, int64_t term_id, int64_t log_id);
+
+  static void HandleTxnGcSafePointRequest(store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                                          const pb::raft::TxnGcSafePointRequest &request, int64_t term_id,
+                                          int64_t log_id);
 };
 
 class RaftApplyHandlerFactory : public HandlerFactory {
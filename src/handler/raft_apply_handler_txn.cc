@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <vector>
 
 #include "butil/status.h"
@@ -27,6 +28,8 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "engine/iterator.h"
+#include "engine/pessimistic_lock_table.h"
+#include "engine/raw_rocks_engine.h"
 #include "engine/txn_engine_helper.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -119,6 +122,40 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
     kv_deletes_with_cf.insert_or_assign(dels.cf_name(), kv_deletes);
   }
 
+  // The lock cf is written by prewrite, commit, rollback or flush, the pessimistic lock in memory of the same txn is
+  // done. The lock of other txn which is taken after the write is proposed must be kept, so the lock in memory is
+  // erased only if its lock_ts and for_update_ts are of the put lock, or of the lock in lock cf which is deleted.
+  std::vector<std::tuple<std::string, int64_t, int64_t>> released_locks;
+  if (PessimisticLockTable::GetInstance().Size() > 0) {
+    auto reader = engine->Reader();
+    std::string key;
+    int64_t ts = 0;
+    for (const auto &puts : request.puts_with_cf()) {
+      if (puts.cf_name() != Constant::kTxnLockCF) {
+        continue;
+      }
+      for (const auto &kv : puts.kvs()) {
+        pb::store::LockInfo lock_info;
+        if (Helper::DecodeTxnKey(kv.key(), key, ts).ok() && lock_info.ParseFromString(kv.value())) {
+          released_locks.emplace_back(key, lock_info.lock_ts(), lock_info.for_update_ts());
+        }
+      }
+    }
+    for (const auto &dels : request.deletes_with_cf()) {
+      if (dels.cf_name() != Constant::kTxnLockCF) {
+        continue;
+      }
+      for (const auto &lock_key : dels.keys()) {
+        std::string lock_value;
+        pb::store::LockInfo lock_info;
+        if (Helper::DecodeTxnKey(lock_key, key, ts).ok() &&
+            reader->KvGet(Constant::kTxnLockCF, lock_key, lock_value).ok() && lock_info.ParseFromString(lock_value)) {
+          released_locks.emplace_back(key, lock_info.lock_ts(), lock_info.for_update_ts());
+        }
+      }
+    }
+  }
+
   auto writer = engine->Writer();
   status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
   if (!status.ok()) {
@@ -127,6 +164,11 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
                      << ", write failed, request: " << request.ShortDebugString();
   }
 
+  // the pessimistic locks in memory which are done by this write, they are erased after the write
+  for (const auto &[key, lock_ts, for_update_ts] : released_locks) {
+    PessimisticLockTable::GetInstance().EraseIfMatch(key, lock_ts, for_update_ts);
+  }
+
   // check if need to commit to vector index
   const auto &vector_add = request.vector_add();
   if (vector_add.vectors_size() > 0) {
@@ -232,6 +274,29 @@ void TxnHandler::HandleTxnDeleteRangeRequest(std::shared_ptr<Context> ctx, store
                                     term_id, log_id)
                      << ", write failed, request: " << request.ShortDebugString() << ", status: " << status.error_str();
   }
+
+  PessimisticLockTable::GetInstance().EraseRange(request.start_key(), request.end_key());
+}
+
+void TxnHandler::HandleTxnGcSafePointRequest(store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                                             const pb::raft::TxnGcSafePointRequest &request, int64_t term_id,
+                                             int64_t log_id) {
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] HandleTxnGcSafePoint, term: {} apply_log_id: {}", region->Id(),
+                                 term_id, log_id)
+                  << ", safe_point_ts: " << request.safe_point_ts();
+
+  if (engine->GetID() != pb::common::RAW_ENG_ROCKSDB) {
+    return;
+  }
+
+  // the safe point of store only moves forward, the entries of the other regions may have moved it further
+  auto rocks_engine = std::dynamic_pointer_cast<RawRocksEngine>(engine);
+  auto status = rocks_engine->UpdateTxnGcSafePoint(request.safe_point_ts());
+  if (!status.ok()) {
+    DINGO_LOG(FATAL) << fmt::format("[txn][region({})] HandleTxnGcSafePoint, term: {} apply_log_id: {}", region->Id(),
+                                    term_id, log_id)
+                     << ", update gc safe point failed, status: " << status.error_str();
+  }
 }
 
 int TxnHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
@@ -246,6 +311,8 @@ int TxnHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
                                      log_id);
   } else if (txn_raft_req.has_mvcc_delete_range()) {
     HandleTxnDeleteRangeRequest(ctx, region, engine, txn_raft_req.mvcc_delete_range(), region_metrics, term, log_id);
+  } else if (txn_raft_req.has_gc_safe_point()) {
+    HandleTxnGcSafePointRequest(region, engine, txn_raft_req.gc_safe_point(), term, log_id);
   } else {
     DINGO_LOG(FATAL) << fmt::format("[txn][region({})] Unknown txn request", region->Id())
                      << ", txn_raft_req: " << txn_raft_req.DebugString();
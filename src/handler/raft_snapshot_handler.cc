@@ -96,7 +96,8 @@ butil::Status RaftSnapshot::GenSnapshotFileByScan(const std::string& checkpoint_
   return butil::Status();
 }
 
-// Filter sst file by range
+// Filter sst file by range, with rocksdb_sst_partition_by_region the picked files hold only the data of the region
+// except the files flushed from memtable.
 std::vector<pb::store_internal::SstFileInfo> FilterSstFile(  // NOLINT
     std::vector<pb::store_internal::SstFileInfo>& sst_files, const pb::common::Range& range) {
   std::vector<pb::store_internal::SstFileInfo> filter_sst_files;
@@ -256,7 +257,7 @@ butil::Status RaftSnapshot::HandleRaftSnapshotRegionMeta(braft::SnapshotReader*
   }
 
   // Delete old region datas
-  status = engine_->Writer()->KvDeleteRange(Helper::GetColumnFamilyNames(region->Range().start_key()), region->Range());
+  status = engine_->DropRange(Helper::GetColumnFamilyNames(region->Range().start_key()), region->Range());
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] delete old region data failed, error: {}",
                                     region->Id(), status.error_str());
@@ -17,6 +17,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "engine/raw_rocks_engine.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
@@ -38,6 +39,24 @@ bool MetaWriter::Put(const std::shared_ptr<pb::common::KeyValue> kv) {
   return true;
 }
 
+bool MetaWriter::PutWithoutWal(const std::shared_ptr<pb::common::KeyValue> kv) {
+  if (kv == nullptr) return true;
+  auto raw_rocks_engine = std::dynamic_pointer_cast<RawRocksEngine>(engine_);
+  if (raw_rocks_engine == nullptr) {
+    return Put(kv);
+  }
+
+  DINGO_LOG(DEBUG) << "Put meta data without wal, key: " << kv->key();
+  auto status = raw_rocks_engine->PutWithoutWal(Constant::kStoreMetaCF, *kv);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "Meta write without wal failed, errcode: " << status.error_code() << " "
+                     << status.error_str();
+    return false;
+  }
+
+  return true;
+}
+
 bool MetaWriter::Put(const std::vector<pb::common::KeyValue> kvs) {
   DINGO_LOG(DEBUG) << "Put meta data, key nums: " << kvs.size();
   if (kvs.empty()) return true;
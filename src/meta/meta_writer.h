@@ -32,6 +32,8 @@ class MetaWriter {
   const MetaWriter &operator=(const MetaWriter &) = delete;
 
   bool Put(std::shared_ptr<pb::common::KeyValue> kv);
+  // Put without wal if the engine is rocksdb, it is persisted by the next flush, see RawRocksEngine::PutWithoutWal.
+  bool PutWithoutWal(std::shared_ptr<pb::common::KeyValue> kv);
   bool Put(std::vector<pb::common::KeyValue> kvs);
   bool PutAndDelete(std::vector<pb::common::KeyValue> kvs_put, std::vector<pb::common::KeyValue> kvs_delete);
   bool Delete(const std::string &key);
@@ -730,6 +730,15 @@ void StoreRaftMeta::UpdateRaftMeta(RaftMetaPtr raft_meta) {
   meta_writer_->Put(TransformToKv(raft_meta));
 }
 
+void StoreRaftMeta::UpdateRaftMetaWithoutWal(RaftMetaPtr raft_meta) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    raft_metas_.insert_or_assign(raft_meta->region_id(), raft_meta);
+  }
+
+  meta_writer_->PutWithoutWal(TransformToKv(raft_meta));
+}
+
 void StoreRaftMeta::SaveRaftMeta(int64_t region_id) {
   auto raft_meta = GetRaftMeta(region_id);
   if (raft_meta != nullptr) {
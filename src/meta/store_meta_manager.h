@@ -98,6 +98,10 @@ class Region {
   bool TemporaryDisableChange();
   void SetTemporaryDisableChange(bool disable_change);
 
+  // The new pessimistic locks go to lock cf while the region leaves the leader by transfer, split or merge.
+  bool DisablePessimisticLockInMemory() const { return disable_pessimistic_lock_in_memory_.load(); }
+  void SetDisablePessimisticLockInMemory(bool disable) { disable_pessimistic_lock_in_memory_.store(disable); }
+
   pb::raft::SplitStrategy SplitStrategy();
   void SetSplitStrategy(pb::raft::SplitStrategy split_strategy);
 
@@ -130,6 +134,7 @@ class Region {
   bthread_mutex_t mutex_;
   pb::store_internal::Region inner_region_;
   std::atomic<pb::common::StoreRegionState> state_;
+  std::atomic<bool> disable_pessimistic_lock_in_memory_{false};
 
   pb::raft::SplitStrategy split_strategy_{};
 
@@ -251,6 +256,8 @@ class StoreRaftMeta : public TransformKvAble {
 
   void AddRaftMeta(RaftMetaPtr raft_meta);
   void UpdateRaftMeta(RaftMetaPtr raft_meta);
+  // Persist the applied index without wal, for the data column families written without wal.
+  void UpdateRaftMetaWithoutWal(RaftMetaPtr raft_meta);
   void SaveRaftMeta(int64_t region_id);
   void DeleteRaftMeta(int64_t region_id);
   RaftMetaPtr GetRaftMeta(int64_t region_id);
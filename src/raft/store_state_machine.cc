@@ -24,6 +24,8 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine/txn_engine_helper.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
 #include "meta/meta_writer.h"
@@ -34,11 +36,27 @@
 #include "proto/raft.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
 #include "server/server.h"
+#include "vector/vector_import.h"
 
 const int kSaveAppliedIndexStep = 10;
 
 namespace dingodb {
 
+// The data written without wal is lost by crash until flush, so the applied index is written without wal too. Atomic
+// flush persists it together with the data applied before it, and the raft log is replayed from it after crash.
+static bool IsSaveAppliedIndexWithoutWal(std::shared_ptr<RawEngine> engine) {
+  return FLAGS_rocksdb_disable_wal && engine->GetID() == pb::common::RAW_ENG_ROCKSDB;
+}
+
+static void SaveAppliedIndex(std::shared_ptr<RawEngine> engine, StoreRaftMeta::RaftMetaPtr raft_meta) {
+  auto store_raft_meta = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
+  if (IsSaveAppliedIndexWithoutWal(engine)) {
+    store_raft_meta->UpdateRaftMetaWithoutWal(raft_meta);
+  } else {
+    store_raft_meta->UpdateRaftMeta(raft_meta);
+  }
+}
+
 void StoreClosure::Run() {
   // Delete self after run
   std::unique_ptr<StoreClosure> self_guard(this);
@@ -185,7 +203,7 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
     if (applied_index_ % kSaveAppliedIndexStep == 0) {
       raft_meta_->set_term(applied_term_);
       raft_meta_->set_applied_index(applied_index_);
-      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+      SaveAppliedIndex(engine_, raft_meta_);
     }
   }
 }
@@ -238,7 +256,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       if (applied_index_ % kSaveAppliedIndexStep == 0) {
         raft_meta_->set_term(applied_term_);
         raft_meta_->set_applied_index(applied_index_);
-        Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+        SaveAppliedIndex(engine_, raft_meta_);
       }
 
       ++actual_apply_log_count;
@@ -273,6 +291,26 @@ void StoreStateMachine::on_shutdown() {
 
 void StoreStateMachine::on_snapshot_save(braft::SnapshotWriter* writer, braft::Closure* done) {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_snapshot_save", region_->Id());
+
+  // The snapshot truncates the raft log, the applied data and the applied index must be in sst before that.
+  if (IsSaveAppliedIndexWithoutWal(engine_)) {
+    if (raft_meta_ != nullptr) {
+      raft_meta_->set_term(applied_term_);
+      raft_meta_->set_applied_index(applied_index_);
+      SaveAppliedIndex(engine_, raft_meta_);
+    }
+
+    auto raw_rocks_engine = std::dynamic_pointer_cast<RawRocksEngine>(engine_);
+    auto status = raw_rocks_engine->FlushUnpersisted(Helper::GetColumnFamilyNames(region_->Range().start_key()));
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.sm][region({})] flush before snapshot failed, error: {}", region_->Id(),
+                                      status.error_str());
+      done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "flush before snapshot failed");
+      done->Run();
+      return;
+    }
+  }
+
   auto event = std::make_shared<SmSnapshotSaveEvent>();
   event->engine = engine_;
   event->writer = writer;
@@ -283,6 +321,9 @@ void StoreStateMachine::on_snapshot_save(braft::SnapshotWriter* writer, braft::C
 
   DispatchEvent(EventType::kSmSnapshotSave, event);
 
+  // The raft log is truncated by the previous snapshot, release the import files the replay never reach.
+  VectorImporter::CleanAppliedImport(region_->Id());
+
   if (raft_meta_ != nullptr) {
     Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
   }
@@ -379,6 +420,8 @@ int StoreStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
 
 void StoreStateMachine::on_leader_start(int64_t term) {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_leader_start term({})", region_->Id(), term);
+  // a region change given up after the flush of pessimistic locks leaves them in lock cf until the next leader
+  region_->SetDisablePessimisticLockInMemory(false);
 
   auto event = std::make_shared<SmLeaderStartEvent>();
   event->term = term;
@@ -394,6 +437,9 @@ void StoreStateMachine::on_leader_start(int64_t term) {
 void StoreStateMachine::on_leader_stop(const butil::Status& status) {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_leader_stop, error: {} {}", region_->Id(),
                                  status.error_code(), status.error_str());
+  // the pessimistic locks in memory are flushed before planned leader change, the rest can not be written now
+  TxnEngineHelper::DropPessimisticLocks(region_);
+
   auto event = std::make_shared<SmLeaderStopEvent>();
   event->status = status;
   event->region = region_;
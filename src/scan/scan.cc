@@ -16,13 +16,18 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/macros.h"     // IWYU pragma: keep
@@ -35,11 +40,31 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #if defined(ENABLE_SCAN_OPTIMIZATION)
-#include "bthread/bthread.h"
+#include "bvar/bvar.h"
+#include "scan/scan_manager.h"
 #endif
 
 namespace dingodb {
 
+#if defined(ENABLE_SCAN_OPTIMIZATION)
+// continue served by the read ahead batch or by the iterator
+static bvar::Adder<int64_t> g_scan_prefetch_hit("scan_prefetch_hit");
+static bvar::Adder<int64_t> g_scan_prefetch_miss("scan_prefetch_miss");
+// read ahead not started as the prefetch memory of ScanManager is used up
+static bvar::Adder<int64_t> g_scan_prefetch_reject("scan_prefetch_reject");
+
+static double GetScanPrefetchHitRate(void*) {
+  int64_t hit = g_scan_prefetch_hit.get_value();
+  int64_t total = hit + g_scan_prefetch_miss.get_value();
+  return total == 0 ? 0.0 : static_cast<double>(hit) / total;
+}
+
+static bvar::PassiveStatus<double> g_scan_prefetch_hit_rate("scan_prefetch_hit_rate", GetScanPrefetchHitRate,
+                                                            nullptr);
+
+static int64_t KeyValueBytes(const pb::common::KeyValue& kv) { return kv.key().size() + kv.value().size(); }
+#endif
+
 // timeout millisecond to destroy
 int64_t ScanContext::timeout_ms_ = 0;
 
@@ -49,6 +74,81 @@ int64_t ScanContext::max_bytes_rpc_ = 0;
 // kv count per transfer specified by the server
 int64_t ScanContext::max_fetch_cnt_by_server_ = 0;
 
+// max sub-ranges of a parallel scan specified by the server
+int64_t ScanContext::max_parallelism_ = 0;
+
+// pieces per sub-range when split range, more pieces balance the sub-ranges better
+static const int64_t kSplitRangeGranularity = 4;
+
+// Middle of start_key and end_key as big endian numbers, one more byte than the longer key for precision.
+static std::string MiddleKey(const std::string& start_key, const std::string& end_key) {
+  size_t size = std::max(start_key.size(), end_key.size()) + 1;
+
+  std::string middle_key(size, '\0');
+  uint32_t carry = 0;
+  for (size_t i = size; i > 0; i--) {
+    uint32_t sum = carry;
+    sum += i <= start_key.size() ? static_cast<uint8_t>(start_key[i - 1]) : 0;
+    sum += i <= end_key.size() ? static_cast<uint8_t>(end_key[i - 1]) : 0;
+    middle_key[i - 1] = static_cast<char>(sum & 0xFF);
+    carry = sum >> 8;
+  }
+
+  // divide the sum by 2
+  uint32_t remainder = carry;
+  for (auto& c : middle_key) {
+    uint32_t value = (remainder << 8) | static_cast<uint8_t>(c);
+    c = static_cast<char>(value >> 1);
+    remainder = value & 1;
+  }
+
+  return middle_key;
+}
+
+// Sub-ranges of a parallel scan, every bthread takes the next sub-range until all are done.
+struct ParallelScanTask {
+  RawEngine::ReaderPtr reader;
+  std::string cf_name;
+  SnapshotPtr snapshot;
+  const pb::store::Coprocessor* coprocessor;
+  std::vector<pb::common::Range> ranges;
+  std::vector<std::shared_ptr<Coprocessor>> partials;
+  std::vector<butil::Status> statuses;
+  // aggregation quota of every sub-range, 0 is no limit
+  int64_t memory_limit{0};
+  std::atomic<size_t> next{0};
+};
+
+static butil::Status ExecuteSubRange(ParallelScanTask* task, size_t index) {
+  auto partial = std::make_shared<Coprocessor>();
+  butil::Status status = partial->Open(*task->coprocessor);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Coprocessor::Open failed");
+    return status;
+  }
+  partial->SetAggregationMemoryLimit(task->memory_limit);
+  task->partials[index] = partial;
+
+  IteratorOptions options;
+  options.upper_bound = task->ranges[index].end_key();
+  auto iter = task->reader->NewIterator(task->cf_name, task->snapshot, options);
+  if (!iter) {
+    DINGO_LOG(ERROR) << fmt::format("RawEngine::Reader::NewIterator failed");
+    return butil::Status(pb::error::EINTERNAL, "Internal error : create iter failed");
+  }
+  iter->Seek(task->ranges[index].start_key());
+
+  return partial->ExecutePartial(iter);
+}
+
+static void* ExecuteSubRanges(void* arg) {
+  auto* task = static_cast<ParallelScanTask*>(arg);
+  for (size_t i = task->next.fetch_add(1); i < task->ranges.size(); i = task->next.fetch_add(1)) {
+    task->statuses[i] = ExecuteSubRange(task, i);
+  }
+  return nullptr;
+}
+
 ScanContext::ScanContext()
     : region_id_(0),
       max_fetch_cnt_(0),
@@ -60,19 +160,26 @@ ScanContext::ScanContext()
       last_time_ms_(GetCurrentTime())
 #if defined(ENABLE_SCAN_OPTIMIZATION)
       ,
-      seek_state_(SeekState::kUninit)
+      seek_state_(SeekState::kUninit),
+      prefetched_bytes_(0)
 #endif
 
       ,
-      disable_coprocessor_(true) {
+      disable_coprocessor_(true),
+      parallelism_(0) {
   bthread_mutex_init(&mutex_, nullptr);
+#if defined(ENABLE_SCAN_OPTIMIZATION)
+  bthread_cond_init(&seek_cond_, nullptr);
+#endif
 }
 ScanContext::~ScanContext() { Close(); }
 
-void ScanContext::Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server) {
+void ScanContext::Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server,
+                       int64_t max_parallelism) {
   timeout_ms_ = timeout_ms;
   max_bytes_rpc_ = max_bytes_rpc;
   max_fetch_cnt_by_server_ = max_fetch_cnt_by_server;
+  max_parallelism_ = max_parallelism;
 }
 
 butil::Status ScanContext::Open(const std::string& scan_id, std::shared_ptr<RawEngine> engine,
@@ -120,6 +227,11 @@ void ScanContext::Close() {
   iter_ = nullptr;
   last_time_ms_.zero();
   coprocessor_.reset();
+  parallelism_ = 0;
+#if defined(ENABLE_SCAN_OPTIMIZATION)
+  ClearPrefetchedKeyValue();
+  bthread_cond_destroy(&seek_cond_);
+#endif
   bthread_mutex_destroy(&mutex_);
 }
 
@@ -131,11 +243,11 @@ std::chrono::milliseconds ScanContext::GetCurrentTime() {
   return millisec;
 }
 
-butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs) {
+butil::Status ScanContext::GetKeyValue(KeyValueSink* sink) {
   if (!disable_coprocessor_) {
     butil::Status status;
     status = coprocessor_->Execute(iter_, key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes_rpc_,
-                                   &kvs);
+                                   sink);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("Coprocessor::Execute failed");
     }
@@ -145,38 +257,221 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs) {
   ScanFilter scan_filter = ScanFilter(key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes_rpc_);
 
   while (iter_->Valid()) {
-    pb::common::KeyValue kv;
-    *kv.mutable_key() = iter_->Key();
-    if (!key_only_) {
-      *kv.mutable_value() = iter_->Value();
+    std::string_view key = iter_->Key();
+    std::string_view value = key_only_ ? std::string_view() : iter_->Value();
+    sink->Append(key, value);
+
+    bool upto_limit = scan_filter.UptoLimit(key, value);
+    iter_->Next();
+    if (upto_limit) {
+      break;
     }
+  }
 
-    kvs.emplace_back(kv);
-    if (scan_filter.UptoLimit(kv)) {
-      iter_->Next();
+  return butil::Status();
+}
+
+std::vector<pb::common::Range> ScanContext::SplitRange(std::shared_ptr<RawEngine> engine, const std::string& cf_name,
+                                                       const pb::common::Range& range, int64_t count) {
+  if (count <= 1) {
+    return {range};
+  }
+
+  struct Piece {
+    pb::common::Range range;
+    int64_t size;
+    int depth;
+    bool splittable;
+  };
+
+  std::vector<pb::common::Range> ranges = {range};
+  std::vector<Piece> pieces = {Piece{range, engine->GetApproximateSizes(cf_name, ranges)[0], 0, true}};
+
+  // halve the largest piece until it is small enough, the shallower one first if same size, such as the data is all
+  // in memtable which has no approximate size.
+  int64_t total = pieces[0].size;
+  int64_t max_pieces = count * kSplitRangeGranularity;
+  for (int64_t i = 0; i < max_pieces * kSplitRangeGranularity; i++) {
+    auto largest = std::max_element(pieces.begin(), pieces.end(), [](const Piece& lhs, const Piece& rhs) {
+      if (lhs.splittable != rhs.splittable) {
+        return !lhs.splittable;
+      }
+      return lhs.size != rhs.size ? lhs.size < rhs.size : lhs.depth > rhs.depth;
+    });
+    if (!largest->splittable) {
+      break;
+    }
+    if (total > 0 ? largest->size * max_pieces <= total : static_cast<int64_t>(pieces.size()) >= max_pieces) {
       break;
     }
-    kv.Clear();
 
-    iter_->Next();
+    const std::string& start_key = largest->range.start_key();
+    const std::string& end_key = largest->range.end_key();
+    std::string middle_key = MiddleKey(start_key, end_key);
+    if (middle_key <= start_key || middle_key >= end_key) {
+      largest->splittable = false;
+      continue;
+    }
+
+    ranges.resize(2);
+    ranges[0].set_start_key(start_key);
+    ranges[0].set_end_key(middle_key);
+    ranges[1].set_start_key(middle_key);
+    ranges[1].set_end_key(end_key);
+    auto sizes = engine->GetApproximateSizes(cf_name, ranges);
+
+    int depth = largest->depth + 1;
+    *largest = Piece{ranges[0], sizes[0], depth, true};
+    pieces.insert(largest + 1, Piece{ranges[1], sizes[1], depth, true});
+  }
+
+  // merge the adjacent pieces, cut when the accumulated size reaches the next 1/count of total.
+  total = 0;
+  for (const auto& piece : pieces) {
+    total += piece.size;
+  }
+  // no approximate size, weight every piece the same
+  int64_t total_weight = total > 0 ? total : static_cast<int64_t>(pieces.size());
+
+  std::vector<pb::common::Range> sub_ranges;
+  std::string start_key = range.start_key();
+  int64_t weight = 0;
+  int64_t last_weight = 0;
+  for (size_t i = 0; i + 1 < pieces.size() && static_cast<int64_t>(sub_ranges.size()) + 1 < count; i++) {
+    weight += total > 0 ? pieces[i].size : 1;
+    // no empty sub-range
+    if (weight > last_weight && weight * count >= total_weight * static_cast<int64_t>(sub_ranges.size() + 1)) {
+      last_weight = weight;
+      auto& sub_range = sub_ranges.emplace_back();
+      sub_range.set_start_key(start_key);
+      sub_range.set_end_key(pieces[i].range.end_key());
+      start_key = pieces[i].range.end_key();
+    }
+  }
+
+  auto& sub_range = sub_ranges.emplace_back();
+  sub_range.set_start_key(start_key);
+  sub_range.set_end_key(range.end_key());
+
+  return sub_ranges;
+}
+
+butil::Status ScanContext::ParallelExecute(const pb::store::Coprocessor& coprocessor) {
+  int64_t start_time = Helper::TimestampMs();
+
+  ParallelScanTask task;
+  task.ranges = SplitRange(engine_, cf_name_, range_, parallelism_);
+  if (task.ranges.size() <= 1) {
+    return butil::Status();
+  }
+
+  task.reader = engine_->Reader();
+  task.cf_name = cf_name_;
+  task.snapshot = engine_->GetSnapshot();
+  task.coprocessor = &coprocessor;
+  task.partials.resize(task.ranges.size());
+  task.statuses.resize(task.ranges.size());
+  // the sub-ranges are kept until merged, they share the aggregation quota of the scan
+  int64_t memory_limit = coprocessor_->AggregationMemoryLimit();
+  if (memory_limit > 0) {
+    task.memory_limit = std::max<int64_t>(1, memory_limit / static_cast<int64_t>(task.ranges.size()));
+  }
+
+  std::vector<bthread_t> tids;
+  tids.reserve(task.ranges.size());
+  for (size_t i = 0; i < task.ranges.size(); i++) {
+    bthread_t tid;
+    int ret = bthread_start_background(&tid, nullptr, ExecuteSubRanges, &task);
+    if (ret != 0) {
+      // the started bthreads take the rest sub-ranges
+      DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail, ret : {}", ret);
+      break;
+    }
+    tids.push_back(tid);
+  }
+  if (tids.empty()) {
+    ExecuteSubRanges(&task);
+  }
+  for (auto tid : tids) {
+    bthread_join(tid, nullptr);
+  }
+
+  for (size_t i = 0; i < task.ranges.size(); i++) {
+    if (!task.statuses[i].ok()) {
+      DINGO_LOG(ERROR) << fmt::format("execute sub-range {} failed : {}", Helper::RangeToString(task.ranges[i]),
+                                      task.statuses[i].error_str());
+      return task.statuses[i];
+    }
+
+    butil::Status status = coprocessor_->MergePartial(task.partials[i].get());
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Coprocessor::MergePartial failed");
+      return status;
+    }
+    task.partials[i] = nullptr;
   }
 
+  // all rows are consumed by the sub-ranges, the results are read from coprocessor_ by GetKeyValue.
+  iter_->Seek(range_.end_key());
+
+  DINGO_LOG(INFO) << fmt::format("scan {} parallel execute sub-ranges : {} bthreads : {} elapsed time {}ms", scan_id_,
+                                 task.ranges.size(), tids.size(), Helper::TimestampMs() - start_time);
+
   return butil::Status();
 }
 
 #if defined(ENABLE_SCAN_OPTIMIZATION)
-butil::Status ScanContext::AsyncWork() {
-  auto lambda_call = [this]() {
-    BAIDU_SCOPED_LOCK(mutex_);
-    seek_state_ = ScanContext::SeekState::kInitting;
-    last_time_ms_ = GetCurrentTime();
-    seek_state_ = SeekState::kInitted;
+void ScanContext::AsyncWork() {
+  seek_state_ = SeekState::kInitted;
+
+  // nothing to read ahead, or the next continue is already covered
+  if (max_fetch_cnt_ <= 0 || !prefetch_status_.ok() ||
+      static_cast<int64_t>(prefetched_kvs_.size()) >= std::min(max_fetch_cnt_, max_fetch_cnt_by_server_)) {
+    return;
+  }
+  if (disable_coprocessor_ && !iter_->Valid()) {
+    return;
+  }
+
+  // a batch is bounded by max_bytes_rpc_, reserve it before reading
+  int64_t reserved_bytes = max_bytes_rpc_;
+  if (!ScanManager::GetInstance().TryAcquirePrefetchMemory(reserved_bytes)) {
+    g_scan_prefetch_reject << 1;
+    return;
+  }
+
+  auto self = shared_from_this();
+  auto lambda_call = [self, reserved_bytes]() {
+    BAIDU_SCOPED_LOCK(self->mutex_);
+    std::vector<pb::common::KeyValue> kvs;
+    VectorKeyValueSink sink(&kvs);
+    self->prefetch_status_ = self->GetKeyValue(&sink);
+    if (!self->prefetch_status_.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed in read ahead : {}", self->scan_id_);
+    }
+
+    int64_t bytes = 0;
+    for (auto& kv : kvs) {
+      bytes += KeyValueBytes(kv);
+      self->prefetched_kvs_.emplace_back(std::move(kv));
+    }
+    self->prefetched_bytes_ += bytes;
+    if (bytes > reserved_bytes) {
+      // the last kv of the batch may pass max_bytes_rpc, the kvs are read already, charge the overshoot
+      ScanManager::GetInstance().ChargePrefetchMemory(bytes - reserved_bytes);
+    }
+    // return the unused part of the reservation
+    ScanManager::GetInstance().ReleasePrefetchMemory(std::max<int64_t>(0, reserved_bytes - bytes));
+
+    self->seek_state_ = SeekState::kInitted;
+    bthread_cond_broadcast(&self->seek_cond_);
   };
 
   std::function<void()>* call = new std::function<void()>;
   *call = lambda_call;
   bthread_t th;
 
+  seek_state_ = SeekState::kInitting;
   int ret = bthread_start_background(
       &th, nullptr,
       [](void* arg) -> void* {
@@ -187,23 +482,48 @@ butil::Status ScanContext::AsyncWork() {
       },
       call);
   if (ret != 0) {
-    state_ = ScanState::kError;
-    DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail");
-    return butil::Status(pb::error::EINTERNAL, "scan_id is empty");
+    // the next continue reads the iterator itself
+    delete call;
+    seek_state_ = SeekState::kInitted;
+    ScanManager::GetInstance().ReleasePrefetchMemory(reserved_bytes);
+    DINGO_LOG(WARNING) << fmt::format("bthread_start_background fail, skip read ahead : {}", scan_id_);
   }
-
-  return butil::Status();
 }
 
 void ScanContext::WaitForReady() {
-  int i = 0;
-  while (ScanContext::SeekState::kUninit == seek_state_) {
-    if (i++ >= 1000) {
-      bthread_yield();
-      i = 0;
-    }
+  while (ScanContext::SeekState::kInitting == seek_state_) {
+    bthread_cond_wait(&seek_cond_, &mutex_);
+  }
+}
+
+bool ScanContext::TakePrefetchedKeyValue(KeyValueSink* sink) {
+  if (prefetched_kvs_.empty()) {
+    g_scan_prefetch_miss << 1;
+    return false;
+  }
+
+  int64_t bytes = 0;
+  int64_t max_fetch_cnt = std::min(max_fetch_cnt_, max_fetch_cnt_by_server_);
+  for (int64_t i = 0; i < max_fetch_cnt && !prefetched_kvs_.empty(); i++) {
+    bytes += KeyValueBytes(prefetched_kvs_.front());
+    sink->Append(std::move(prefetched_kvs_.front()));
+    prefetched_kvs_.pop_front();
+  }
+  prefetched_bytes_ -= bytes;
+  ScanManager::GetInstance().ReleasePrefetchMemory(bytes);
+
+  g_scan_prefetch_hit << 1;
+  return true;
+}
+
+void ScanContext::ClearPrefetchedKeyValue() {
+  prefetched_kvs_.clear();
+  if (prefetched_bytes_ != 0) {
+    ScanManager::GetInstance().ReleasePrefetchMemory(prefetched_bytes_);
+    prefetched_bytes_ = 0;
   }
 }
+
 butil::Status ScanContext::SeekCheck() {
   if (ScanContext::SeekState::kInitted != seek_state_) {
     std::string s = fmt::format("ScanHandler::ScanContinue failed  state wrong : {} {} seek_state : {} {}",
@@ -351,8 +671,8 @@ const char* ScanContext::GetSeekState(SeekState state) {
 butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64_t region_id,
                                      const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
                                      bool disable_auto_release, bool disable_coprocessor,
-                                     const pb::store::Coprocessor& coprocessor,
-                                     std::vector<pb::common::KeyValue>* kvs) {
+                                     const pb::store::Coprocessor& coprocessor, int64_t parallelism,
+                                     KeyValueSink* sink) {
   if (BAIDU_UNLIKELY(range.start_key().empty() || range.end_key().empty())) {
     DINGO_LOG(ERROR) << fmt::format("start_key or end_key empty not support");
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "range wrong");
@@ -410,37 +730,39 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
   }
   context->iter_->Seek(context->range_.start_key());
 
-  if (context->max_fetch_cnt_ > 0) {
-    butil::Status s = context->GetKeyValue(*kvs);
+  context->parallelism_ = std::min(parallelism, context->max_parallelism_);
+  if (context->coprocessor_ && context->parallelism_ > 1 && context->coprocessor_->IsParallelizable()) {
+    butil::Status s = context->ParallelExecute(coprocessor);
     if (!s.ok()) {
       context->state_ = ScanState::kError;
-      DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
+      DINGO_LOG(ERROR) << fmt::format("ScanContext::ParallelExecute failed");
       return s;
     }
-
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-    context->seek_state_ = ScanContext::SeekState::kInitted;
-#endif
-
   }
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  else {  // NOLINT
-    butil::Status s = context->AsyncWork();
+
+  if (context->max_fetch_cnt_ > 0) {
+    butil::Status s = context->GetKeyValue(sink);
     if (!s.ok()) {
+      context->state_ = ScanState::kError;
+      DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
       return s;
     }
+
   }
-#endif
 
   context->state_ = ScanState::kBegun;
 
   context->last_time_ms_ = context->GetCurrentTime();
 
+#if defined(ENABLE_SCAN_OPTIMIZATION)
+  context->AsyncWork();
+#endif
+
   return butil::Status();
 }
 
 butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, const std::string& scan_id,
-                                        int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>* kvs) {
+                                        int64_t max_fetch_cnt, KeyValueSink* sink) {
   if (BAIDU_UNLIKELY(scan_id.empty() || scan_id != context->scan_id_)) {
     DINGO_LOG(ERROR) << fmt::format("scan_id empty or unequal not support");
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "scan_id is empty");
@@ -451,11 +773,11 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "max_fetch_cnt == 0");
   }
 
+  BAIDU_SCOPED_LOCK(context->mutex_);
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   context->WaitForReady();
 #endif
 
-  BAIDU_SCOPED_LOCK(context->mutex_);
   if (ScanState::kBegun != context->state_ && ScanState::kContinued != context->state_) {
     std::string s = fmt::format("ScanHandler::ScanContinue failed : {} {}", static_cast<int>(context->state_),
                                 context->GetScanState(context->state_));
@@ -478,7 +800,14 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
 
   context->state_ = ScanState::kContinuing;
 
-  s = context->GetKeyValue(*kvs);
+#if defined(ENABLE_SCAN_OPTIMIZATION)
+  s = context->prefetch_status_;
+  if (s.ok() && !context->TakePrefetchedKeyValue(sink)) {
+    s = context->GetKeyValue(sink);
+  }
+#else
+  s = context->GetKeyValue(sink);
+#endif
   if (!s.ok()) {
     context->state_ = ScanState::kError;
     DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
@@ -488,9 +817,29 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
   context->state_ = ScanState::kContinued;
   context->last_time_ms_ = context->GetCurrentTime();
 
+#if defined(ENABLE_SCAN_OPTIMIZATION)
+  context->AsyncWork();
+#endif
+
   return butil::Status();
 }
 
+butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64_t region_id,
+                                     const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
+                                     bool disable_auto_release, bool disable_coprocessor,
+                                     const pb::store::Coprocessor& coprocessor,
+                                     std::vector<pb::common::KeyValue>* kvs) {
+  VectorKeyValueSink sink(kvs);
+  return ScanBegin(context, region_id, range, max_fetch_cnt, key_only, disable_auto_release, disable_coprocessor,
+                   coprocessor, 0, &sink);
+}
+
+butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, const std::string& scan_id,
+                                        int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>* kvs) {
+  VectorKeyValueSink sink(kvs);
+  return ScanContinue(context, scan_id, max_fetch_cnt, &sink);
+}
+
 butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
                                        [[maybe_unused]] const std::string& scan_id) {
   if (BAIDU_UNLIKELY(scan_id.empty() || scan_id != context->scan_id_)) {
@@ -498,11 +847,11 @@ butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "scan_id is empty");
   }
 
+  BAIDU_SCOPED_LOCK(context->mutex_);
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   context->WaitForReady();
 #endif
 
-  BAIDU_SCOPED_LOCK(context->mutex_);
   if (ScanState::kBegun != context->state_ && ScanState::kContinued != context->state_) {
     std::string s = fmt::format("ScanHandler::ScanRelease failed : {} {}", static_cast<int>(context->state_),
                                 context->GetScanState(context->state_));
@@ -519,6 +868,8 @@ butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
     DINGO_LOG(ERROR) << str;
     return s;
   }
+
+  context->ClearPrefetchedKeyValue();
 #endif
 
   context->state_ = ScanState::kReleasing;
@@ -18,6 +18,7 @@
 #include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "common/context.h"
 #include "coprocessor/coprocessor.h"
 #include "engine/iterator.h"
+#include "engine/key_value_sink.h"
 #include "engine/raw_engine.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -38,8 +40,6 @@ namespace dingodb {
 #define ENABLE_SCAN_OPTIMIZATION
 #endif
 
-#undef ENABLE_SCAN_OPTIMIZATION
-
 enum class ScanState : unsigned char {
   kUninit = 0,
   kOpening = 1,
@@ -61,7 +61,7 @@ enum class ScanState : unsigned char {
 
 class ScanHandler;
 
-class ScanContext {
+class ScanContext : public std::enable_shared_from_this<ScanContext> {
  public:
   ScanContext();
   ~ScanContext();
@@ -71,7 +71,8 @@ class ScanContext {
   ScanContext(ScanContext&& rhs) = delete;
   ScanContext& operator=(ScanContext&& rhs) = delete;
 
-  static void Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server);
+  static void Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server,
+                   int64_t max_parallelism);
 
   butil::Status Open(const std::string& scan_id, std::shared_ptr<RawEngine> engine, const std::string& cf_name);
 
@@ -80,17 +81,29 @@ class ScanContext {
 
   static const char* GetScanState(ScanState state);
 
+  // Split range to at most count sub-ranges of similar approximate size, in key order.
+  static std::vector<pb::common::Range> SplitRange(std::shared_ptr<RawEngine> engine, const std::string& cf_name,
+                                                   const pb::common::Range& range, int64_t count);
+
  protected:
   friend class ScanHandler;
 
  private:
   void Close();
   static std::chrono::milliseconds GetCurrentTime();
-  butil::Status GetKeyValue(std::vector<pb::common::KeyValue>& kvs);  // NOLINT
+  butil::Status GetKeyValue(KeyValueSink* sink);
+  // Run the coprocessor on parallelism_ sub-ranges concurrently over one snapshot, and merge the partial results to
+  // coprocessor_, with the lock held by caller.
+  butil::Status ParallelExecute(const pb::store::Coprocessor& coprocessor);
 #if defined(ENABLE_SCAN_OPTIMIZATION)
-  butil::Status AsyncWork();
+  // Read ahead the next batch in background after the response is returned, with the lock held by caller.
+  void AsyncWork();
+  // Wait for the read ahead to finish, with the lock held by caller.
   void WaitForReady();
   butil::Status SeekCheck();
+  // Move at most max_fetch_cnt_ prefetched kvs to sink, return false if nothing is prefetched.
+  bool TakePrefetchedKeyValue(KeyValueSink* sink);
+  void ClearPrefetchedKeyValue();
 #endif
   std::string scan_id_;
 
@@ -125,8 +138,15 @@ class ScanContext {
 
   static const char* GetSeekState(SeekState state);
 
-  // default = kUninit
-  volatile SeekState seek_state_;
+  // default = kUninit, kInitting while the read ahead is running
+  SeekState seek_state_;
+  bthread_cond_t seek_cond_;
+
+  // kvs of the next batch, read ahead by the background bthread
+  std::deque<pb::common::KeyValue> prefetched_kvs_;
+  // memory acquired from ScanManager for prefetched_kvs_
+  int64_t prefetched_bytes_;
+  butil::Status prefetch_status_;
 #endif
 
   bool disable_coprocessor_;
@@ -134,6 +154,9 @@ class ScanContext {
   // coprocessor
   std::shared_ptr<Coprocessor> coprocessor_;
 
+  // sub-ranges scanned concurrently by coprocessor, capped by max_parallelism_
+  int64_t parallelism_;
+
   // timeout millisecond to destroy
   static int64_t timeout_ms_;
 
@@ -142,6 +165,9 @@ class ScanContext {
 
   // kv count per transfer specified by the server
   static int64_t max_fetch_cnt_by_server_;
+
+  // max sub-ranges of a parallel scan specified by the server
+  static int64_t max_parallelism_;
 };
 
 class ScanHandler {
@@ -154,11 +180,19 @@ class ScanHandler {
   ScanHandler(ScanHandler&& rhs) = delete;
   ScanHandler& operator=(ScanHandler&& rhs) = delete;
 
+  // parallelism > 1 scans the sub-ranges concurrently if the coprocessor is aggregation or order by.
+  static butil::Status ScanBegin(std::shared_ptr<ScanContext> context, int64_t region_id,
+                                 const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
+                                 bool disable_auto_release, bool disable_coprocessor,
+                                 const pb::store::Coprocessor& coprocessor, int64_t parallelism,
+                                 KeyValueSink* sink);
   static butil::Status ScanBegin(std::shared_ptr<ScanContext> context, int64_t region_id,
                                  const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
                                  bool disable_auto_release, bool disable_coprocessor,
                                  const pb::store::Coprocessor& coprocessor, std::vector<pb::common::KeyValue>* kvs);
 
+  static butil::Status ScanContinue(std::shared_ptr<ScanContext> context, const std::string& scan_id,
+                                    int64_t max_fetch_cnt, KeyValueSink* sink);
   static butil::Status ScanContinue(std::shared_ptr<ScanContext> context, const std::string& scan_id,
                                     int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>* kvs);
 
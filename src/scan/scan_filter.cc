@@ -23,15 +23,17 @@ ScanFilter::ScanFilter(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rp
       cur_fetch_cnt_(0),
       cur_bytes_rpc_(0) {}
 
-bool ScanFilter::UptoLimit(const pb::common::KeyValue& kv) {
+bool ScanFilter::UptoLimit(const pb::common::KeyValue& kv) { return UptoLimit(kv.key(), kv.value()); }
+
+bool ScanFilter::UptoLimit(std::string_view key, std::string_view value) {
   cur_fetch_cnt_++;
   if (cur_fetch_cnt_ >= max_fetch_cnt_) {
     return true;
   }
 
-  cur_bytes_rpc_ += kv.key().size();
+  cur_bytes_rpc_ += key.size();
   if (!key_only_) {
-    cur_bytes_rpc_ += kv.value().size();
+    cur_bytes_rpc_ += value.size();
   }
 
   if (cur_bytes_rpc_ >= max_bytes_rpc_) {
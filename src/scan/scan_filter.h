@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 #include "proto/common.pb.h"
 
@@ -32,6 +33,7 @@ class ScanFilter {
   ScanFilter& operator=(ScanFilter&& rhs) = default;
 
   bool UptoLimit(const pb::common::KeyValue& kv);
+  bool UptoLimit(std::string_view key, std::string_view value);
 
   void Reset();
 
@@ -16,16 +16,24 @@
 #include <memory>
 
 #include "butil/guid.h"
+#include "bvar/bvar.h"
 #include "common/constant.h"
 #include "common/logging.h"
 
 namespace dingodb {
 
+static int64_t GetScanPrefetchBytes(void*) { return ScanManager::GetInstance().GetPrefetchBytes(); }
+
+static bvar::PassiveStatus<int64_t> g_scan_prefetch_bytes("scan_prefetch_bytes", GetScanPrefetchBytes, nullptr);
+
 ScanManager::ScanManager()
     : timeout_ms_(60 * 1000),
       max_bytes_rpc_(4 * 1024 * 1024),
       max_fetch_cnt_by_server_(1000),
-      scan_interval_ms_(60 * 1000) {
+      scan_interval_ms_(60 * 1000),
+      max_prefetch_bytes_(256 * 1024 * 1024),
+      max_parallelism_(8),
+      prefetch_bytes_(0) {
   bthread_mutex_init(&mutex_, nullptr);
 }
 ScanManager::~ScanManager() {
@@ -33,6 +41,8 @@ ScanManager::~ScanManager() {
   max_bytes_rpc_ = 4 * 1024 * 1024;
   max_fetch_cnt_by_server_ = 1000;
   scan_interval_ms_ = 60 * 1000;
+  max_prefetch_bytes_ = 256 * 1024 * 1024;
+  max_parallelism_ = 8;
   alive_scans_.clear();
   waiting_destroyed_scans_.clear();
   bthread_mutex_destroy(&mutex_);
@@ -75,7 +85,21 @@ bool ScanManager::Init(std::shared_ptr<Config> config) {
     }
   }
 
-  ScanContext::Init(timeout_ms_, max_bytes_rpc_, max_fetch_cnt_by_server_);
+  iter = conf.find(Constant::kStoreScanMaxPrefetchBytes);
+  if (iter != conf.end()) {
+    if (iter->second != 0) {
+      max_prefetch_bytes_ = iter->second;
+    }
+  }
+
+  iter = conf.find(Constant::kStoreScanMaxParallelism);
+  if (iter != conf.end()) {
+    if (iter->second != 0) {
+      max_parallelism_ = iter->second;
+    }
+  }
+
+  ScanContext::Init(timeout_ms_, max_bytes_rpc_, max_fetch_cnt_by_server_, max_parallelism_);
 
   return true;
 }
@@ -133,6 +157,27 @@ void ScanManager::TryDeleteScan(const std::string& scan_id) {
   }
 }
 
+bool ScanManager::TryAcquirePrefetchMemory(int64_t bytes) {
+  int64_t old_bytes = prefetch_bytes_.load(std::memory_order_relaxed);
+  do {
+    if (old_bytes + bytes > max_prefetch_bytes_) {
+      return false;
+    }
+  } while (!prefetch_bytes_.compare_exchange_weak(old_bytes, old_bytes + bytes, std::memory_order_relaxed));
+
+  return true;
+}
+
+void ScanManager::ChargePrefetchMemory(int64_t bytes) {
+  DCHECK_GE(bytes, 0);
+  prefetch_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void ScanManager::ReleasePrefetchMemory(int64_t bytes) {
+  DCHECK_GE(bytes, 0);
+  prefetch_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
 void ScanManager::RegularCleaningHandler(void*) {
   ScanManager& manager = ScanManager::GetInstance();
 
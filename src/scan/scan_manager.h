@@ -15,6 +15,7 @@
 #ifndef DINGODB_ENGINE_SCAN_MANAGER_H_  // NOLINT
 #define DINGODB_ENGINE_SCAN_MANAGER_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -44,6 +45,15 @@ class ScanManager {
   int64_t GetMaxBytesRpc() const { return max_bytes_rpc_; }
   int64_t GetMaxFetchCntByServer() const { return max_fetch_cnt_by_server_; }
   int64_t GetScanIntervalMs() const { return scan_interval_ms_; }
+  int64_t GetMaxPrefetchBytes() const { return max_prefetch_bytes_; }
+  int64_t GetMaxParallelism() const { return max_parallelism_; }
+  int64_t GetPrefetchBytes() const { return prefetch_bytes_.load(std::memory_order_relaxed); }
+
+  // Memory of the read ahead kvs of all scans, bounded by max_prefetch_bytes_.
+  bool TryAcquirePrefetchMemory(int64_t bytes);
+  // Charge the bytes which are read already even if over the bound.
+  void ChargePrefetchMemory(int64_t bytes);
+  void ReleasePrefetchMemory(int64_t bytes);
 
   static void RegularCleaningHandler(void* arg);
 
@@ -57,6 +67,9 @@ class ScanManager {
   int64_t max_bytes_rpc_;
   int64_t max_fetch_cnt_by_server_;
   int64_t scan_interval_ms_;
+  int64_t max_prefetch_bytes_;
+  int64_t max_parallelism_;
+  std::atomic<int64_t> prefetch_bytes_;
   bthread_mutex_t mutex_;
 };
 
@@ -0,0 +1,250 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "scan/scan_stream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/compiler_specific.h"
+#include "butil/time.h"
+#include "common/logging.h"
+#include "coprocessor/utils.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "scan/scan_manager.h"
+
+namespace dingodb {
+
+// tags of the wire format of KvScanStreamData.kvs and pb::common::KeyValue
+static const uint32_t kKvsTag = (2 << 3) | 2;
+static const uint32_t kKeyTag = (1 << 3) | 2;
+static const uint32_t kValueTag = (2 << 3) | 2;
+
+ScanStream::ScanStream(std::shared_ptr<RawEngine> engine, const std::string& cf_name)
+    : engine_(engine),
+      cf_name_(cf_name),
+      max_fetch_cnt_(0),
+      max_bytes_rpc_(0),
+      key_only_(false),
+      stream_id_(brpc::INVALID_STREAM_ID),
+      closed_(false) {}
+
+butil::Status ScanStream::Open(const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
+                               bool disable_coprocessor, const pb::store::Coprocessor& coprocessor) {
+  if (BAIDU_UNLIKELY(range.start_key().empty() || range.end_key().empty() || range.start_key() >= range.end_key())) {
+    DINGO_LOG(ERROR) << fmt::format("range wrong");
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "range wrong");
+  }
+
+  ScanManager& manager = ScanManager::GetInstance();
+  range_ = range;
+  max_fetch_cnt_ = max_fetch_cnt > 0 ? std::min(max_fetch_cnt, manager.GetMaxFetchCntByServer())
+                                     : manager.GetMaxFetchCntByServer();
+  max_bytes_rpc_ = manager.GetMaxBytesRpc();
+  key_only_ = key_only;
+
+  if (!disable_coprocessor && !Utils::CoprocessorParamEmpty(coprocessor)) {
+    coprocessor_ = std::make_shared<Coprocessor>();
+    butil::Status status = coprocessor_->Open(coprocessor);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Coprocessor::Open failed");
+      return status;
+    }
+  }
+
+  IteratorOptions options;
+  options.upper_bound = range_.end_key();
+  iter_ = engine_->Reader()->NewIterator(cf_name_, options);
+  if (!iter_) {
+    DINGO_LOG(ERROR) << fmt::format("RawEngine::Reader::NewIterator failed");
+    return butil::Status(pb::error::EINTERNAL, "Internal error : create iter failed");
+  }
+  iter_->Seek(range_.start_key());
+
+  return butil::Status();
+}
+
+void ScanStream::Start(brpc::StreamId stream_id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // closed before the response is returned
+    if (closed_) {
+      return;
+    }
+    stream_id_ = stream_id;
+    self_ = shared_from_this();
+  }
+
+  auto* call = new std::function<void()>([self = shared_from_this()]() { self->Run(); });
+  bthread_t th;
+  int ret = bthread_start_background(
+      &th, nullptr,
+      [](void* arg) -> void* {
+        auto* call = static_cast<std::function<void()>*>(arg);
+        (*call)();
+        delete call;
+        return nullptr;
+      },
+      call);
+  if (ret != 0) {
+    delete call;
+    DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail, close stream {}", stream_id_);
+    brpc::StreamClose(stream_id_);
+  }
+}
+
+int ScanStream::on_received_messages(brpc::StreamId /*id*/, butil::IOBuf* const /*messages*/[], size_t /*size*/) {
+  return 0;
+}
+
+void ScanStream::on_idle_timeout(brpc::StreamId /*id*/) {}
+
+void ScanStream::on_closed(brpc::StreamId /*id*/) {
+  std::shared_ptr<ScanStream> self;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    self.swap(self_);
+  }
+}
+
+void ScanStream::WriteKeyValue(std::string_view key, std::string_view value,
+                               google::protobuf::io::CodedOutputStream* out) {
+  using google::protobuf::io::CodedOutputStream;
+
+  size_t size = 2 + CodedOutputStream::VarintSize32(key.size()) + key.size() +
+                CodedOutputStream::VarintSize32(value.size()) + value.size();
+  out->WriteTag(kKvsTag);
+  out->WriteVarint32(size);
+  out->WriteTag(kKeyTag);
+  out->WriteVarint32(key.size());
+  out->WriteRaw(key.data(), key.size());
+  out->WriteTag(kValueTag);
+  out->WriteVarint32(value.size());
+  out->WriteRaw(value.data(), value.size());
+}
+
+butil::Status ScanStream::ReadBatch(butil::IOBuf* buf, bool* end) {
+  butil::IOBufAsZeroCopyOutputStream wrapper(buf);
+  google::protobuf::io::CodedOutputStream out(&wrapper);
+
+  int64_t count = 0;
+  int64_t bytes = 0;
+  while (iter_->Valid()) {
+    std::string_view key = iter_->Key();
+    std::string_view value = key_only_ ? std::string_view() : iter_->Value();
+    WriteKeyValue(key, value, &out);
+    // same limit as ScanFilter
+    bytes += key.size() + value.size();
+    iter_->Next();
+
+    if (++count >= max_fetch_cnt_ || bytes >= max_bytes_rpc_) {
+      break;
+    }
+  }
+
+  *end = !iter_->Valid();
+  return iter_->Status();
+}
+
+butil::Status ScanStream::ReadCoprocessorBatch(butil::IOBuf* buf, bool* end) {
+  std::vector<pb::common::KeyValue> kvs;
+  butil::Status status = coprocessor_->Execute(iter_, key_only_, max_fetch_cnt_, max_bytes_rpc_, &kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Coprocessor::Execute failed");
+    return status;
+  }
+
+  butil::IOBufAsZeroCopyOutputStream wrapper(buf);
+  google::protobuf::io::CodedOutputStream out(&wrapper);
+  for (const auto& kv : kvs) {
+    WriteKeyValue(kv.key(), kv.value(), &out);
+  }
+
+  // same as the client of ScanContinue, no result means no more data
+  *end = kvs.empty();
+  return butil::Status();
+}
+
+butil::Status ScanStream::Write(const butil::IOBuf& buf) {
+  while (!closed_) {
+    int ret = brpc::StreamWrite(stream_id_, buf);
+    if (ret == 0) {
+      return butil::Status();
+    }
+    if (ret != EAGAIN) {
+      return butil::Status(pb::error::EINTERNAL, "StreamWrite failed, error: %d", ret);
+    }
+
+    // the client does not consume the window, give up as a scan timeout
+    timespec due_time = butil::milliseconds_from_now(ScanManager::GetInstance().GetTimeoutMs());
+    ret = brpc::StreamWait(stream_id_, &due_time);
+    if (ret != 0) {
+      return butil::Status(pb::error::EINTERNAL, "StreamWait failed, error: %d", ret);
+    }
+  }
+
+  return butil::Status(pb::error::EINTERNAL, "stream is closed");
+}
+
+void ScanStream::Run() {
+  butil::Status status;
+  while (!closed_) {
+    butil::IOBuf buf;
+    bool end = false;
+    status = coprocessor_ ? ReadCoprocessorBatch(&buf, &end) : ReadBatch(&buf, &end);
+    if (!status.ok()) {
+      break;
+    }
+
+    // protobuf merges the concatenated messages, append the end flag to the last batch
+    if (end) {
+      pb::store::KvScanStreamData data;
+      data.set_end(true);
+      butil::IOBufAsZeroCopyOutputStream wrapper(&buf);
+      data.SerializeToZeroCopyStream(&wrapper);
+    }
+
+    status = Write(buf);
+    if (!status.ok() || end) {
+      break;
+    }
+  }
+
+  if (!status.ok() && !closed_) {
+    DINGO_LOG(ERROR) << fmt::format("scan stream {} failed : {}", stream_id_, status.error_str());
+    pb::store::KvScanStreamData data;
+    data.mutable_error()->set_errcode(static_cast<pb::error::Errno>(status.error_code()));
+    data.mutable_error()->set_errmsg(status.error_str());
+    butil::IOBuf buf;
+    butil::IOBufAsZeroCopyOutputStream wrapper(&buf);
+    data.SerializeToZeroCopyStream(&wrapper);
+    brpc::StreamWrite(stream_id_, buf);
+  }
+
+  iter_.reset();
+  coprocessor_.reset();
+  brpc::StreamClose(stream_id_);
+}
+
+}  // namespace dingodb
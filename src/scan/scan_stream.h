@@ -0,0 +1,92 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_SCAN_STREAM_H_  // NOLINT
+#define DINGODB_ENGINE_SCAN_STREAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "brpc/stream.h"
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "coprocessor/coprocessor.h"
+#include "engine/iterator.h"
+#include "engine/raw_engine.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// Server side of KvScanStream. The whole range is pushed to the brpc stream as KvScanStreamData messages by a
+// background bthread, the write waits when the window of the client is full. Nothing is kept in ScanManager, the
+// iterator and coprocessor are released when the scan is done or the stream is closed by client.
+class ScanStream : public brpc::StreamInputHandler, public std::enable_shared_from_this<ScanStream> {
+ public:
+  ScanStream(std::shared_ptr<RawEngine> engine, const std::string& cf_name);
+  ~ScanStream() override = default;
+
+  ScanStream(const ScanStream& rhs) = delete;
+  ScanStream& operator=(const ScanStream& rhs) = delete;
+  ScanStream(ScanStream&& rhs) = delete;
+  ScanStream& operator=(ScanStream&& rhs) = delete;
+
+  // Open the coprocessor and seek the range, before the stream is accepted.
+  butil::Status Open(const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only, bool disable_coprocessor,
+                     const pb::store::Coprocessor& coprocessor);
+
+  // Write the range to the accepted stream in background, the stream is closed at the end.
+  void Start(brpc::StreamId stream_id);
+
+  // The client sends nothing.
+  int on_received_messages(brpc::StreamId id, butil::IOBuf* const messages[], size_t size) override;
+  void on_idle_timeout(brpc::StreamId id) override;
+  void on_closed(brpc::StreamId id) override;
+
+  // Append a kv in the wire format of KvScanStreamData.kvs, without building pb::common::KeyValue.
+  static void WriteKeyValue(std::string_view key, std::string_view value, google::protobuf::io::CodedOutputStream* out);
+
+ private:
+  void Run();
+  // Read the next batch into buf, set end if the range is done.
+  butil::Status ReadBatch(butil::IOBuf* buf, bool* end);
+  butil::Status ReadCoprocessorBatch(butil::IOBuf* buf, bool* end);
+  // Write buf to stream, wait if the window of client is full.
+  butil::Status Write(const butil::IOBuf& buf);
+
+  std::shared_ptr<RawEngine> engine_;
+  std::string cf_name_;
+  pb::common::Range range_;
+  int64_t max_fetch_cnt_;
+  int64_t max_bytes_rpc_;
+  bool key_only_;
+
+  IteratorPtr iter_;
+  std::shared_ptr<Coprocessor> coprocessor_;
+
+  brpc::StreamId stream_id_;
+  std::atomic<bool> closed_;
+  // keep alive until the stream is closed, guarded by mutex_
+  std::shared_ptr<ScanStream> self_;
+  std::mutex mutex_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_SCAN_STREAM_H_  // NOLINT
@@ -14,6 +14,9 @@
 
 #include "buf.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "serial/utils.h"
 
 namespace dingodb {
@@ -69,78 +72,21 @@ void Buf::Init(const std::string& buf) {
 
 void Buf::SetForwardPos(int fp) { this->forward_pos_ = fp; }
 
+int Buf::GetForwardPos() const { return this->forward_pos_; }
+
 void Buf::SetReversePos(int rp) { this->reverse_pos_ = rp; }
 
 void Buf::Write(uint8_t b) { buf_.at(forward_pos_++) = b; }
 
 void Buf::WriteWithNegation(uint8_t b) { buf_.at(forward_pos_++) = ~b; }
 
-void Buf::Write(const std::string& data) {
-  for (auto it : data) {
-    buf_.at(forward_pos_++) = it;
-  }
-}
+void Buf::Write(const std::string& data) { Write(data.data(), data.size()); }
 
-void Buf::WriteInt(int32_t i) {
-  uint32_t* ii = (uint32_t*)&i;
-  if (this->le_) {
-    Write(*ii >> 24);
-    Write(*ii >> 16);
-    Write(*ii >> 8);
-    Write(*ii);
-  } else {
-    Write(*ii);
-    Write(*ii >> 8);
-    Write(*ii >> 16);
-    Write(*ii >> 24);
-  }
-}
+void Buf::WriteInt(int32_t i) { WriteUint32(i, this->le_); }
 
-void Buf::WriteLong(int64_t l) {
-  uint64_t* ll = (uint64_t*)&l;
-  if (this->le_) {
-    Write(*ll >> 56);
-    Write(*ll >> 48);
-    Write(*ll >> 40);
-    Write(*ll >> 32);
-    Write(*ll >> 24);
-    Write(*ll >> 16);
-    Write(*ll >> 8);
-    Write(*ll);
-  } else {
-    Write(*ll);
-    Write(*ll >> 8);
-    Write(*ll >> 16);
-    Write(*ll >> 24);
-    Write(*ll >> 32);
-    Write(*ll >> 40);
-    Write(*ll >> 48);
-    Write(*ll >> 56);
-  }
-}
+void Buf::WriteLong(int64_t l) { WriteUint64(l, this->le_); }
 
-void Buf::WriteLongWithNegation(int64_t l) {
-  uint64_t* ll = (uint64_t*)&l;
-  if (this->le_) {
-    WriteWithNegation(*ll >> 56);
-    WriteWithNegation(*ll >> 48);
-    WriteWithNegation(*ll >> 40);
-    WriteWithNegation(*ll >> 32);
-    WriteWithNegation(*ll >> 24);
-    WriteWithNegation(*ll >> 16);
-    WriteWithNegation(*ll >> 8);
-    WriteWithNegation(*ll);
-  } else {
-    WriteWithNegation(*ll);
-    WriteWithNegation(*ll >> 8);
-    WriteWithNegation(*ll >> 16);
-    WriteWithNegation(*ll >> 24);
-    WriteWithNegation(*ll >> 32);
-    WriteWithNegation(*ll >> 40);
-    WriteWithNegation(*ll >> 48);
-    WriteWithNegation(*ll >> 56);
-  }
-}
+void Buf::WriteLongWithNegation(int64_t l) { WriteUint64(~static_cast<uint64_t>(l), this->le_); }
 
 void Buf::ReverseWrite(uint8_t b) { buf_.at(reverse_pos_--) = b; }
 
@@ -162,64 +108,22 @@ void Buf::ReverseWriteInt(int32_t i) {
 uint8_t Buf::Peek() { return buf_.at(forward_pos_); }
 
 int32_t Buf::PeekInt() {
-  if (this->le_) {
-    return 
-      (
-          ( buf_.at(forward_pos_    ) & 0xFF) << 24) 
-        | ((buf_.at(forward_pos_ + 1) & 0xFF) << 16) 
-        | ((buf_.at(forward_pos_ + 2) & 0xFF) << 8 ) 
-        | ( buf_.at(forward_pos_ + 3) & 0xFF
-      );
-  } else {
-    return
-      (
-          ( buf_.at(forward_pos_    ) & 0xFF)
-        | ((buf_.at(forward_pos_ + 1) & 0xFF) << 8 ) 
-        | ((buf_.at(forward_pos_ + 2) & 0xFF) << 16) 
-        | ((buf_.at(forward_pos_ + 3) & 0xFF) << 24)
-      );
-  }
+  int32_t i = ReadUint32(this->le_);
+  forward_pos_ -= 4;
+  return i;
 }
 
 int64_t Buf::PeekLong() {
-  uint64_t l = (buf_.at(forward_pos_)) & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= (buf_.at(forward_pos_ + i + 1)) & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)(buf_.at(forward_pos_ + i)) & 0xFF) << (8 * i));
-    }
-  }
+  int64_t l = ReadUint64(this->le_);
+  forward_pos_ -= 8;
   return l;
 }
 
 uint8_t Buf::Read() { return buf_.at(forward_pos_++); }
 
-int32_t Buf::ReadInt() {
-  if (this->le_) {
-    return ((Read() & 0xFF) << 24) | ((Read() & 0xFF) << 16) | ((Read() & 0xFF) << 8) | (Read() & 0xFF);
-  } else {
-    return (Read() & 0xFF) | ((Read() & 0xFF) << 8) | ((Read() & 0xFF) << 16) | ((Read() & 0xFF) << 24);
-  }
-}
+int32_t Buf::ReadInt() { return ReadUint32(this->le_); }
 
-int64_t Buf::ReadLong() {
-  uint64_t l = Read() & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)Read() & 0xFF) << (8 * i));
-    }
-  }
-  return l;
-}
+int64_t Buf::ReadLong() { return ReadUint64(this->le_); }
 
 uint8_t Buf::ReverseRead() { return buf_.at(reverse_pos_--); }
 
@@ -241,25 +145,14 @@ void Buf::ReverseSkip(int size) { reverse_pos_ -= size; }
 
 void Buf::EnsureRemainder(int length) {
   if ((forward_pos_ + length - 1) > reverse_pos_) {
-    int new_size;
-    if (length > 100) {
-      new_size = buf_.size() + length;
-    } else {
-      new_size = buf_.size() + 100;
-    }
-    std::string new_buf;
-    new_buf.resize(new_size);
-    for (int i = 0; i < forward_pos_; i++) {
-      new_buf.at(i) = buf_.at(i);
-    }
+    // grow at least double, so a record is usually encoded with one or two allocations
+    int new_size = buf_.size() + std::max(length, std::max(static_cast<int>(buf_.size()), 100));
     int reverse_size = buf_.size() - reverse_pos_ - 1;
-    int buf_start = reverse_pos_ + 1;
-    int new_buf_start = new_size - reverse_size;
-    for (int i = 0; i < reverse_size; i++) {
-      new_buf.at(new_buf_start + i) = buf_.at(buf_start + i);
-    }
+    std::string new_buf(new_size, 0);
+    memcpy(new_buf.data(), buf_.data(), forward_pos_);
+    memcpy(new_buf.data() + new_size - reverse_size, buf_.data() + reverse_pos_ + 1, reverse_size);
     reverse_pos_ = new_size - reverse_size - 1;
-    buf_ = new_buf;
+    buf_.swap(new_buf);
   }
 }
 
@@ -284,13 +177,8 @@ int Buf::GetBytes(std::string& s) {
   if (empty_size > 0) {
     int final_size = buf_.size() - empty_size;
     s.resize(final_size);
-    for (int i = 0; i < forward_pos_; i++) {
-      s[i] = buf_.at(i);
-    }
-    int curr = reverse_pos_ + 1;
-    for (int i = forward_pos_; i < final_size; i++) {
-      s[i] = buf_.at(curr++);
-    }
+    memcpy(s.data(), buf_.data(), forward_pos_);
+    memcpy(s.data() + forward_pos_, buf_.data() + reverse_pos_ + 1, final_size - forward_pos_);
     return final_size;
   }
 
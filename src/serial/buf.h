@@ -15,7 +15,10 @@
 #ifndef DINGO_SERIAL_BUF_H_
 #define DINGO_SERIAL_BUF_H_
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -41,6 +44,7 @@ class Buf {
   void Init(std::string* buf);
   void Init(const std::string& buf);
   void SetForwardPos(int fp);
+  int GetForwardPos() const;
   void SetReversePos(int rp);
   void Write(uint8_t b);
   void WriteWithNegation(uint8_t b);
@@ -51,6 +55,16 @@ class Buf {
   void ReverseWrite(uint8_t b);
   void ReverseWriteInt(int32_t i);
 
+  // Fast path of whole words and bytes. Write is unchecked, the caller must EnsureRemainder first.
+  // le is the host order flag same as the constructor, true write the big endian bytes like WriteInt/WriteLong.
+  inline void Write(const char* data, int size);
+  inline void WriteUint32(uint32_t i, bool le);
+  inline void WriteUint64(uint64_t l, bool le);
+  // Check the bound once for the whole read, throw std::out_of_range like the byte read.
+  inline void Read(char* data, int size);
+  inline uint32_t ReadUint32(bool le);
+  inline uint64_t ReadUint64(bool le);
+
   uint8_t Peek();
   int32_t PeekInt();
   int64_t PeekLong();
@@ -69,8 +83,73 @@ class Buf {
   std::string GetString();
   bool IsLe() const;
   bool IsEnd() const;
+
+ private:
+  inline void CheckRead(int size) const;
+
+  // big endian bytes if le is true, little endian bytes otherwise
+  static inline uint32_t ToBufOrder(uint32_t i, bool le) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return le ? __builtin_bswap32(i) : i;
+#else
+    return le ? i : __builtin_bswap32(i);
+#endif
+  }
+
+  static inline uint64_t ToBufOrder(uint64_t l, bool le) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return le ? __builtin_bswap64(l) : l;
+#else
+    return le ? l : __builtin_bswap64(l);
+#endif
+  }
 };
 
+inline void Buf::CheckRead(int size) const {
+  if (size < 0 || forward_pos_ < 0 || forward_pos_ + size > static_cast<int>(buf_.size())) {
+    throw std::out_of_range("Buf read out of range");
+  }
+}
+
+inline void Buf::Write(const char* data, int size) {
+  memcpy(&buf_[forward_pos_], data, size);
+  forward_pos_ += size;
+}
+
+inline void Buf::WriteUint32(uint32_t i, bool le) {
+  i = ToBufOrder(i, le);
+  memcpy(&buf_[forward_pos_], &i, 4);
+  forward_pos_ += 4;
+}
+
+inline void Buf::WriteUint64(uint64_t l, bool le) {
+  l = ToBufOrder(l, le);
+  memcpy(&buf_[forward_pos_], &l, 8);
+  forward_pos_ += 8;
+}
+
+inline void Buf::Read(char* data, int size) {
+  CheckRead(size);
+  memcpy(data, buf_.data() + forward_pos_, size);
+  forward_pos_ += size;
+}
+
+inline uint32_t Buf::ReadUint32(bool le) {
+  CheckRead(4);
+  uint32_t i;
+  memcpy(&i, buf_.data() + forward_pos_, 4);
+  forward_pos_ += 4;
+  return ToBufOrder(i, le);
+}
+
+inline uint64_t Buf::ReadUint64(bool le) {
+  CheckRead(8);
+  uint64_t l;
+  memcpy(&l, buf_.data() + forward_pos_, 8);
+  forward_pos_ += 8;
+  return ToBufOrder(l, le);
+}
+
 }  // namespace dingodb
 
 #endif
@@ -0,0 +1,130 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "record_codec.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "serial/utils.h"
+
+namespace dingodb {
+
+// codecs of dropped tables or old schema versions are not evicted one by one, the cache is cleared when it is full.
+static const size_t kMaxCacheSize = 4096;
+
+static std::mutex cache_mutex;
+static std::map<std::pair<long, int>, std::shared_ptr<RecordCodec>> cache;
+
+static bool IsFixedSize(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBool:
+    case BaseSchema::kInteger:
+    case BaseSchema::kFloat:
+    case BaseSchema::kLong:
+    case BaseSchema::kDouble:
+      return true;
+    default:
+      return false;
+  }
+}
+
+RecordCodec::RecordCodec(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                         long common_id, bool le)
+    : schema_version_(schema_version),
+      schemas_(std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(*schemas)),
+      common_id_(common_id),
+      le_(le),
+      decoder_(std::make_shared<RecordDecoder>(schema_version, schemas_, common_id, le)) {
+  // |namespace|common id| ...
+  int key_offset = 9;
+  // |schema version| ...
+  int value_offset = 4;
+
+  columns_.reserve(schemas_->size());
+  for (const auto& schema : *schemas_) {
+    ColumnPlan column{};
+    if (!schema) {
+      column.empty = true;
+      column.offset = -1;
+      columns_.push_back(column);
+      continue;
+    }
+
+    column.type = schema->GetType();
+    column.is_key = schema->IsKey();
+    column.allow_null = schema->AllowNull();
+    column.le = column.type == BaseSchema::kFloat ? true : le;
+    bool fixed_size = IsFixedSize(column.type);
+    column.length = fixed_size ? schema->GetLength() : 0;
+
+    int& offset = column.is_key ? key_offset : value_offset;
+    column.offset = offset;
+    // null of bool key is only the tag
+    if (offset < 0 || !fixed_size || (column.is_key && column.type == BaseSchema::kBool && column.allow_null)) {
+      offset = -1;
+    } else {
+      offset += column.length;
+    }
+    columns_.push_back(column);
+  }
+}
+
+std::shared_ptr<RecordCodec> RecordCodec::Get(int schema_version,
+                                              std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                                              long common_id) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+
+  auto key = std::make_pair(common_id, schema_version);
+  auto it = cache.find(key);
+  if (it != cache.end() && it->second->Match(*schemas)) {
+    return it->second;
+  }
+
+  if (cache.size() >= kMaxCacheSize) {
+    cache.clear();
+  }
+  auto codec = std::make_shared<RecordCodec>(schema_version, schemas, common_id, IsLE());
+  cache[key] = codec;
+  return codec;
+}
+
+size_t RecordCodec::CacheSize() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  return cache.size();
+}
+
+bool RecordCodec::Match(const std::vector<std::shared_ptr<BaseSchema>>& schemas) const {
+  if (schemas.size() != columns_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < schemas.size(); i++) {
+    const auto& schema = schemas[i];
+    const auto& column = columns_[i];
+    if (!schema) {
+      if (!column.empty) {
+        return false;
+      }
+      continue;
+    }
+    if (column.empty || schema->GetType() != column.type || schema->IsKey() != column.is_key ||
+        schema->AllowNull() != column.allow_null) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_RECORD_CODEC_H_
+#define DINGO_SERIAL_RECORD_CODEC_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "record_decoder.h"
+#include "schema/base_schema.h"
+
+namespace dingodb {
+
+// Column of the compiled plan, resolved from the schema once.
+struct ColumnPlan {
+  // no schema of the column
+  bool empty;
+  BaseSchema::Type type;
+  bool is_key;
+  bool allow_null;
+  // byte order of the column, float keeps the default order of its schema as FormatSchema does not set it
+  bool le;
+  // encoded length with the null tag of fixed size types, 0 for string and list
+  int length;
+  // key column: offset from the start of key
+  // value column: offset from the start of value of the format without offset table
+  // -1 if there is a variable size column before it
+  int offset;
+};
+
+// Schema compiled to a flat plan of column types, null handling and offsets, so the reader of a record does not
+// call the virtual methods of schema or cast std::any for every field.
+// Compiled codec is immutable, Get() cache it by common id and schema version to share between scans.
+class RecordCodec {
+ public:
+  // The schema vector is copied, the caller could clear it later.
+  RecordCodec(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id,
+              bool le);
+
+  // Return the cached codec of the table, compile and cache it if not found or the schemas are changed.
+  static std::shared_ptr<RecordCodec> Get(int schema_version,
+                                          std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                                          long common_id);
+
+  // Number of cached codecs, for test.
+  static size_t CacheSize();
+
+  int SchemaVersion() const { return schema_version_; }
+  long CommonId() const { return common_id_; }
+  bool IsLe() const { return le_; }
+  const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& Schemas() const { return schemas_; }
+  const std::vector<ColumnPlan>& Columns() const { return columns_; }
+  // Decoder of the columns not resolved by the plan, it keeps no state of decoding and is shared by the readers.
+  RecordDecoder& Decoder() const { return *decoder_; }
+
+  // Same column types, key and null of schemas.
+  bool Match(const std::vector<std::shared_ptr<BaseSchema>>& schemas) const;
+
+ private:
+  int schema_version_;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas_;
+  long common_id_;
+  bool le_;
+  std::vector<ColumnPlan> columns_;
+  std::shared_ptr<RecordDecoder> decoder_;
+};
+
+}  // namespace dingodb
+
+#endif
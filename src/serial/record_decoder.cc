@@ -114,7 +114,14 @@ bool RecordDecoder::CheckReverseTag(Buf* buf) const {
 }
 
 bool RecordDecoder::CheckSchemaVersion(Buf* buf) const {
-  return buf->ReadInt() <= schema_version_;
+  int32_t schema_version = buf->ReadInt();
+  if (schema_version & kColumnOffsetFlag) {
+    // columns are decoded in order, skip the offset table
+    int32_t column_count = buf->ReadInt();
+    buf->Skip(column_count * 4);
+    schema_version &= ~kColumnOffsetFlag;
+  }
+  return schema_version <= schema_version_;
 }
 
 void DecodeOrSkip(
@@ -38,6 +38,12 @@
 
 namespace dingodb {
 
+// Value of column offset format, the schema version is or-ed with this flag. The old decoder see a larger schema
+// version and reject the record instead of reading the offset table as columns.
+// |schema_version | flag|column count|offset of every column ...|columns ...|
+// Offset is from the start of value, int32 in the same byte order of schema version, 0 for key column.
+constexpr int32_t kColumnOffsetFlag = 0x40000000;
+
 class RecordDecoder {
  private:
   bool CheckPrefix(Buf* buf) const;
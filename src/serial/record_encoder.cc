@@ -19,6 +19,7 @@
 #include <string>
 
 #include "proto/common.pb.h"
+#include "serial/record_decoder.h"
 #include "serial/keyvalue.h"  // IWYU pragma: keep
 
 namespace dingodb {
@@ -48,6 +49,8 @@ void RecordEncoder::Init(int schema_version, std::shared_ptr<std::vector<std::sh
   delete[] size;
 }
 
+void RecordEncoder::EnableColumnOffset(bool enable) { this->column_offset_ = enable; }
+
 void RecordEncoder::EncodePrefix(Buf* buf) const {
   // TODO for 0.7.1, set default namespace 'r' for not txn region
   buf->Write('r');
@@ -157,11 +160,24 @@ int RecordEncoder::EncodeKey(const std::vector<std::any>& record, std::string& o
 
 int RecordEncoder::EncodeValue(const std::vector<std::any>& record, std::string& output) {
   Buf* value_buf = new Buf(value_buf_size_, this->le_);
-  value_buf->EnsureRemainder(4);
-  EncodeSchemaVersion(value_buf);
+  std::vector<int32_t> offsets;
+  if (column_offset_) {
+    // |schema_version | flag|column count|offset of every column ...|
+    offsets.resize(schemas_->size(), 0);
+    value_buf->EnsureRemainder(8 + offsets.size() * 4);
+    value_buf->WriteInt(schema_version_ | kColumnOffsetFlag);
+    value_buf->WriteInt(offsets.size());
+    value_buf->Skip(offsets.size() * 4);
+  } else {
+    value_buf->EnsureRemainder(4);
+    EncodeSchemaVersion(value_buf);
+  }
   int index = 0;
   for (const auto& bs : *schemas_) {
     if (bs) {
+      if (column_offset_ && !bs->IsKey()) {
+        offsets[index] = value_buf->GetForwardPos();
+      }
       BaseSchema::Type type = bs->GetType();
       switch (type) {
         case BaseSchema::kBool: {
@@ -264,6 +280,15 @@ int RecordEncoder::EncodeValue(const std::vector<std::any>& record, std::string&
     index++;
   }
 
+  if (column_offset_) {
+    int end = value_buf->GetForwardPos();
+    value_buf->SetForwardPos(8);
+    for (auto offset : offsets) {
+      value_buf->WriteInt(offset);
+    }
+    value_buf->SetForwardPos(end);
+  }
+
   int ret = value_buf->GetBytes(output);
   delete value_buf;
 
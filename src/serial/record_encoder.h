@@ -50,6 +50,7 @@ class RecordEncoder {
   int key_buf_size_;
   int value_buf_size_;
   bool le_;
+  bool column_offset_ = false;
 
  public:
   RecordEncoder(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
@@ -58,6 +59,9 @@ class RecordEncoder {
 
   void Init(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
 
+  // Encode value with the column offset table, see kColumnOffsetFlag. Only for readers know the format.
+  void EnableColumnOffset(bool enable);
+
   int Encode(const std::vector<std::any>& record, pb::common::KeyValue& key_value /*output*/);
   int Encode(const std::vector<std::any>& record, std::string& key, std::string& value);
 
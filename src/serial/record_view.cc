@@ -0,0 +1,362 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "record_view.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace dingodb {
+
+static constexpr uint8_t kNullTag = 0;
+
+// read list column by the schema
+template <typename T>
+static std::any DecodeListValue(const std::shared_ptr<BaseSchema>& schema, std::string_view value, bool le) {
+  Buf buf(std::string(value), le);
+  auto dingo_schema = std::dynamic_pointer_cast<DingoSchema<std::optional<T>>>(schema);
+  return dingo_schema->DecodeValue(&buf);
+}
+
+RecordView::RecordView(std::shared_ptr<RecordCodec> codec)
+    : codec_(codec),
+      columns_(codec->Columns()),
+      schema_version_(codec->SchemaVersion()),
+      common_id_(codec->CommonId()),
+      le_(codec->IsLe()),
+      has_offset_table_(false),
+      offset_count_(0),
+      next_column_(0),
+      next_offset_(0),
+      key_decoded_(false) {}
+
+RecordView::RecordView(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                       long common_id)
+    : RecordView(schema_version, schemas, common_id, IsLE()) {}
+
+RecordView::RecordView(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                       long common_id, bool le)
+    : RecordView(std::make_shared<RecordCodec>(schema_version, schemas, common_id, le)) {}
+
+uint32_t RecordView::ReadUint32(std::string_view data, int offset, bool le) {
+  const auto* p = reinterpret_cast<const uint8_t*>(data.data()) + offset;
+  if (le) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+  }
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t RecordView::ReadUint64(std::string_view data, int offset, bool le) {
+  uint64_t high = ReadUint32(data, offset, le);
+  uint64_t low = ReadUint32(data, offset + 4, le);
+  return le ? ((high << 32) | low) : ((low << 32) | high);
+}
+
+int RecordView::Reset(std::string_view key, std::string_view value) {
+  key_ = key;
+  value_ = value;
+  key_decoded_ = false;
+
+  // |namespace|common id| ... |tag|
+  if (key_.size() < 13 || static_cast<int64_t>(ReadUint64(key_, 1)) != common_id_) {
+    // "Wrong Common Id"
+    return -1;
+  }
+  if (static_cast<uint8_t>(key_.back()) > codec_version_) {
+    // "Wrong Codec Version"
+    return -1;
+  }
+
+  if (value_.size() < 4) {
+    return -1;
+  }
+  int32_t schema_version = static_cast<int32_t>(ReadUint32(value_, 0));
+  has_offset_table_ = (schema_version & kColumnOffsetFlag) != 0;
+  schema_version &= ~kColumnOffsetFlag;
+  if (schema_version > schema_version_) {
+    // "Wrong Schema Version"
+    return -1;
+  }
+
+  if (has_offset_table_) {
+    if (value_.size() < 8) {
+      return -1;
+    }
+    offset_count_ = static_cast<int32_t>(ReadUint32(value_, 4));
+    if (offset_count_ < 0 || value_.size() < 8 + static_cast<size_t>(offset_count_) * 4) {
+      return -1;
+    }
+  } else {
+    offsets_.resize(columns_.size());
+    next_column_ = 0;
+    next_offset_ = 4;
+  }
+
+  return 0;
+}
+
+int RecordView::ValueLength(const ColumnPlan& column, int offset) const {
+  if (column.length > 0) {
+    return column.length;
+  }
+  BaseSchema::Type type = column.type;
+
+  // |null tag|size| ...
+  int length = 0;
+  if (column.allow_null) {
+    if (static_cast<uint8_t>(value_[offset]) == kNullTag) {
+      return 1;
+    }
+    length = 1;
+  }
+  if (offset + length + 4 > value_.size()) {
+    return value_.size() - offset;
+  }
+  int size = static_cast<int32_t>(ReadUint32(value_, offset + length));
+  length += 4;
+
+  switch (type) {
+    case BaseSchema::kString:
+    case BaseSchema::kBoolList:
+      return length + size;
+    case BaseSchema::kIntegerList:
+    case BaseSchema::kFloatList:
+      return length + size * 4;
+    case BaseSchema::kLongList:
+    case BaseSchema::kDoubleList:
+      return length + size * 8;
+    case BaseSchema::kStringList:
+      for (int i = 0; i < size && offset + length + 4 <= value_.size(); i++) {
+        length += 4 + static_cast<int32_t>(ReadUint32(value_, offset + length));
+      }
+      return length;
+    default:
+      return value_.size() - offset;
+  }
+}
+
+int RecordView::GetOffset(int index) {
+  if (has_offset_table_) {
+    if (index >= offset_count_) {
+      return -1;
+    }
+    int offset = static_cast<int32_t>(ReadUint32(value_, 8 + index * 4));
+    return (offset <= 0 || offset >= value_.size()) ? -1 : offset;
+  }
+
+  // resolved by the plan, the offset is not changed by the column added later
+  const auto& column = columns_[index];
+  if (column.offset >= 0) {
+    return column.offset < value_.size() ? column.offset : -1;
+  }
+
+  // skip the columns before, same order as RecordDecoder
+  while (next_column_ <= index) {
+    const auto& column = columns_[next_column_];
+    if (column.empty || column.is_key) {
+      offsets_[next_column_] = -1;
+    } else {
+      int offset = column.offset >= 0 ? column.offset : next_offset_;
+      if (offset >= value_.size()) {
+        offsets_[next_column_] = -1;
+      } else {
+        offsets_[next_column_] = offset;
+        next_offset_ = offset + ValueLength(column, offset);
+      }
+    }
+    next_column_++;
+  }
+
+  return offsets_[index];
+}
+
+bool RecordView::DecodeKey() {
+  if (!key_decoded_) {
+    if (codec_->Decoder().DecodeKey(std::string(key_), key_record_) < 0) {
+      return false;
+    }
+    key_decoded_ = true;
+  }
+  return true;
+}
+
+template <typename U>
+U RecordView::KeyBits(U bits, bool is_float, bool le) {
+  U sign = le ? (static_cast<U>(1) << (sizeof(U) * 8 - 1)) : static_cast<U>(0x80);
+  if (!is_float || (bits & sign) != 0) {
+    return bits ^ sign;
+  }
+  return ~bits;
+}
+
+template <typename T>
+std::optional<T> RecordView::Get(int index) {
+  const auto& column = columns_[index];
+  if (column.empty) {
+    return std::nullopt;
+  }
+
+  std::string_view data;
+  int offset;
+  if (column.is_key) {
+    if (column.offset < 0) {
+      if (!DecodeKey()) {
+        return std::nullopt;
+      }
+      return std::any_cast<std::optional<T>>(key_record_[index]);
+    }
+    data = key_;
+    offset = column.offset;
+  } else {
+    data = value_;
+    offset = GetOffset(index);
+    if (offset < 0) {
+      return std::nullopt;
+    }
+  }
+
+  if (column.allow_null) {
+    if (offset >= data.size() || static_cast<uint8_t>(data[offset]) == kNullTag) {
+      return std::nullopt;
+    }
+    offset++;
+  }
+
+  if (offset + sizeof(T) > data.size()) {
+    return std::nullopt;
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    return data[offset] != 0;
+  } else if constexpr (sizeof(T) == 4) {
+    uint32_t bits = ReadUint32(data, offset, column.le);
+    if (column.is_key) {
+      bits = KeyBits(bits, std::is_floating_point_v<T>, column.le);
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  } else {
+    uint64_t bits = ReadUint64(data, offset, column.le);
+    if (column.is_key) {
+      bits = KeyBits(bits, std::is_floating_point_v<T>, column.le);
+    }
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+}
+
+template std::optional<bool> RecordView::Get<bool>(int index);
+template std::optional<int32_t> RecordView::Get<int32_t>(int index);
+template std::optional<float> RecordView::Get<float>(int index);
+template std::optional<int64_t> RecordView::Get<int64_t>(int index);
+template std::optional<double> RecordView::Get<double>(int index);
+
+std::optional<std::string_view> RecordView::GetString(int index) {
+  const auto& column = columns_[index];
+  if (column.empty) {
+    return std::nullopt;
+  }
+  if (column.is_key) {
+    if (!DecodeKey()) {
+      return std::nullopt;
+    }
+    const auto& value = std::any_cast<const std::optional<std::shared_ptr<std::string>>&>(key_record_[index]);
+    if (!value.has_value()) {
+      return std::nullopt;
+    }
+    return std::string_view(*value.value());
+  }
+
+  int offset = GetOffset(index);
+  if (offset < 0) {
+    return std::nullopt;
+  }
+  if (column.allow_null) {
+    if (static_cast<uint8_t>(value_[offset]) == kNullTag) {
+      return std::nullopt;
+    }
+    offset++;
+  }
+
+  if (offset + 4 > value_.size()) {
+    return std::nullopt;
+  }
+  int size = static_cast<int32_t>(ReadUint32(value_, offset));
+  if (size < 0 || offset + 4 + size > value_.size()) {
+    return std::nullopt;
+  }
+  return value_.substr(offset + 4, size);
+}
+
+std::any RecordView::GetAny(int index) {
+  const auto& column = columns_[index];
+  if (column.empty) {
+    return std::any();
+  }
+  switch (column.type) {
+    case BaseSchema::kBool:
+      return Get<bool>(index);
+    case BaseSchema::kInteger:
+      return Get<int32_t>(index);
+    case BaseSchema::kFloat:
+      return Get<float>(index);
+    case BaseSchema::kLong:
+      return Get<int64_t>(index);
+    case BaseSchema::kDouble:
+      return Get<double>(index);
+    case BaseSchema::kString: {
+      auto value = GetString(index);
+      if (!value.has_value()) {
+        return std::optional<std::shared_ptr<std::string>>(std::nullopt);
+      }
+      return std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(value.value()));
+    }
+    default:
+      break;
+  }
+
+  const auto& schema = (*codec_->Schemas())[index];
+  int offset = GetOffset(index);
+  std::string_view value = offset < 0 ? std::string_view() : value_.substr(offset);
+  switch (column.type) {
+    case BaseSchema::kBoolList:
+      return offset < 0 ? std::optional<std::shared_ptr<std::vector<bool>>>()
+                        : DecodeListValue<std::shared_ptr<std::vector<bool>>>(schema, value, le_);
+    case BaseSchema::kIntegerList:
+      return offset < 0 ? std::optional<std::shared_ptr<std::vector<int32_t>>>()
+                        : DecodeListValue<std::shared_ptr<std::vector<int32_t>>>(schema, value, le_);
+    case BaseSchema::kFloatList:
+      return offset < 0 ? std::optional<std::shared_ptr<std::vector<float>>>()
+                        : DecodeListValue<std::shared_ptr<std::vector<float>>>(schema, value, le_);
+    case BaseSchema::kLongList:
+      return offset < 0 ? std::optional<std::shared_ptr<std::vector<int64_t>>>()
+                        : DecodeListValue<std::shared_ptr<std::vector<int64_t>>>(schema, value, le_);
+    case BaseSchema::kDoubleList:
+      return offset < 0 ? std::optional<std::shared_ptr<std::vector<double>>>()
+                        : DecodeListValue<std::shared_ptr<std::vector<double>>>(schema, value, le_);
+    case BaseSchema::kStringList:
+      return offset < 0 ? std::optional<std::shared_ptr<std::vector<std::string>>>()
+                        : DecodeListValue<std::shared_ptr<std::vector<std::string>>>(schema, value, le_);
+    default:
+      return std::any();
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_RECORD_VIEW_H_
+#define DINGO_SERIAL_RECORD_VIEW_H_
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "record_codec.h"
+#include "record_decoder.h"
+#include "schema/base_schema.h"
+
+namespace dingodb {
+
+// Lazy decoded record over the key and value slices, nothing is copied or boxed in std::any.
+// Columns are located by the offset of compiled plan, the offset table of column offset format, or by skipping the
+// columns before it once for the old format. Value columns and fixed size key columns are read in place, the other
+// key columns are decoded together at the first access.
+class RecordView {
+ public:
+  explicit RecordView(std::shared_ptr<RecordCodec> codec);
+  RecordView(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id);
+  RecordView(int schema_version, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas, long common_id,
+             bool le);
+
+  // Key and value must be alive until next Reset, return -1 if common id, codec version or schema version is wrong.
+  int Reset(std::string_view key, std::string_view value);
+
+  // index is the position in schemas, same as column_indexes of RecordDecoder::Decode.
+  // T is bool/int32_t/float/int64_t/double of the column type.
+  template <typename T>
+  std::optional<T> Get(int index);
+
+  // String of value column is a view of the value slice.
+  std::optional<std::string_view> GetString(int index);
+
+  // Same as the column of RecordDecoder::Decode, for list types.
+  std::any GetAny(int index);
+
+ private:
+  // Offset of value column, -1 if the column is not in value, such as column added after the record is written.
+  int GetOffset(int index);
+  int ValueLength(const ColumnPlan& column, int offset) const;
+  bool DecodeKey();
+  // key of integer and float types is the sign flipped or complemented bits
+  template <typename U>
+  static U KeyBits(U bits, bool is_float, bool le);
+
+  // same byte order as Buf
+  uint32_t ReadUint32(std::string_view data, int offset) const { return ReadUint32(data, offset, le_); }
+  uint64_t ReadUint64(std::string_view data, int offset) const { return ReadUint64(data, offset, le_); }
+  static uint32_t ReadUint32(std::string_view data, int offset, bool le);
+  static uint64_t ReadUint64(std::string_view data, int offset, bool le);
+
+  int codec_version_ = 1;
+  std::shared_ptr<RecordCodec> codec_;
+  const std::vector<ColumnPlan>& columns_;
+  int schema_version_;
+  long common_id_;
+  bool le_;
+
+  std::string_view key_;
+  std::string_view value_;
+  bool has_offset_table_;
+  int offset_count_;
+  // old format, columns before next_column_ are located
+  std::vector<int> offsets_;
+  int next_column_;
+  int next_offset_;
+  bool key_decoded_;
+  std::vector<std::any> key_record_;
+};
+
+}  // namespace dingodb
+
+#endif
@@ -23,27 +23,13 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetWithNul
 void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::LeInternalEncodeValue(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  buf->Write(bits >> 56);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
+  buf->WriteUint64(bits, true);
 }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::BeInternalEncodeValue(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 56);
+  buf->WriteUint64(bits, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::GetType() { return kDoubleList; }
@@ -117,21 +103,10 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::EncodeVal
 }
 
 double DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::InternalDecodeData(Buf* buf) {
-  uint64_t l = buf->Read() & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
-  // double d;
-  // memcpy(&d, &l, 8);
-  return *reinterpret_cast<double*>(&l);
-  // return d;
+  uint64_t bits = buf->ReadUint64(this->le_);
+  double d;
+  memcpy(&d, &bits, 8);
+  return d;
 }
 
 std::optional<std::shared_ptr<std::vector<double>>> DingoSchema<std::optional<std::shared_ptr<std::vector<double>>>>::DecodeValue(Buf* buf) {
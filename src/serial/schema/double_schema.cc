@@ -21,88 +21,31 @@ int DingoSchema<std::optional<double>>::GetDataLength() { return 8; }
 int DingoSchema<std::optional<double>>::GetWithNullTagLength() { return 9; }
 
 void DingoSchema<std::optional<double>>::InternalEncodeNull(Buf* buf) {
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
+  buf->WriteUint64(0, true);
 }
 
 void DingoSchema<std::optional<double>>::LeInternalEncodeKey(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  if (data >= 0) {
-    buf->Write(bits >> 56 ^ 0x80);
-    buf->Write(bits >> 48);
-    buf->Write(bits >> 40);
-    buf->Write(bits >> 32);
-    buf->Write(bits >> 24);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 8);
-    buf->Write(bits);
-  } else {
-    buf->Write(~bits >> 56);
-    buf->Write(~bits >> 48);
-    buf->Write(~bits >> 40);
-    buf->Write(~bits >> 32);
-    buf->Write(~bits >> 24);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits);
-  }
+  buf->WriteUint64(data >= 0 ? bits ^ 0x8000000000000000 : ~bits, true);
 }
 
 void DingoSchema<std::optional<double>>::BeInternalEncodeKey(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  if (data >= 0) {
-    buf->Write(bits ^ 0x80);
-    buf->Write(bits >> 8);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 24);
-    buf->Write(bits >> 32);
-    buf->Write(bits >> 40);
-    buf->Write(bits >> 48);
-    buf->Write(bits >> 56);
-  } else {
-    buf->Write(~bits);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 24);
-    buf->Write(~bits >> 32);
-    buf->Write(~bits >> 40);
-    buf->Write(~bits >> 48);
-    buf->Write(~bits >> 56);
-  }
+  buf->WriteUint64(data >= 0 ? bits ^ 0x80 : ~bits, false);
 }
 
 void DingoSchema<std::optional<double>>::LeInternalEncodeValue(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  buf->Write(bits >> 56);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
+  buf->WriteUint64(bits, true);
 }
 
 void DingoSchema<std::optional<double>>::BeInternalEncodeValue(Buf* buf, double data) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 32);
-  buf->Write(bits >> 40);
-  buf->Write(bits >> 48);
-  buf->Write(bits >> 56);
+  buf->WriteUint64(bits, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<double>>::GetType() { return kDouble; }
@@ -164,33 +107,13 @@ std::optional<double> DingoSchema<std::optional<double>>::DecodeKey(Buf* buf) {
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF;
+  uint64_t l;
   if (this->le_) {
-    if (l >= 0x80) {
-      l = l ^ 0x80;
-      for (int i = 0; i < 7; i++) {
-        l <<= 8;
-        l |= buf->Read() & 0xFF;
-      }
-    } else {
-      l = ~l;
-      for (int i = 0; i < 7; i++) {
-        l <<= 8;
-        l |= ~buf->Read() & 0xFF;
-      }
-    }
+    l = buf->ReadUint64(true);
+    l = (l >> 56) >= 0x80 ? l ^ 0x8000000000000000 : ~l;
   } else {
-    if (l >= 0x80) {
-      l = l ^ 0x80;
-      for (int i = 1; i < 8; i++) {
-        l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-      }
-    } else {
-      for (int i = 1; i < 8; i++) {
-        l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-      }
-      l = ~l;
-    }
+    l = buf->ReadUint64(false);
+    l = (l & 0xFF) >= 0x80 ? l ^ 0x80 : ~l;
   }
   double d;
   memcpy(&d, &l, 8);
@@ -234,18 +157,7 @@ std::optional<double> DingoSchema<std::optional<double>>::DecodeValue(Buf* buf)
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF;
-  ;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
+  uint64_t l = buf->ReadUint64(this->le_);
   double d;
   memcpy(&d, &l, 8);
   return d;
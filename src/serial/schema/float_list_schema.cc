@@ -23,19 +23,13 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetWithNull
 void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::LeInternalEncodeValue(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
+  buf->WriteUint32(bits, true);
 }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::BeInternalEncodeValue(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
+  buf->WriteUint32(bits, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::GetType() { return kFloatList; }
@@ -109,21 +103,10 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::EncodeValu
 }
 
 float DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::InternalDecodeData(Buf* buf) {
-  uint32_t in = buf->Read() & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 3; i++) {
-      in <<= 8;
-      in |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 4; i++) {
-      in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
-//   float d;
-//   memcpy(&d, &in, 4);
-//   return d;
-  return *reinterpret_cast<float*>(&in);
+  uint32_t bits = buf->ReadUint32(this->le_);
+  float d;
+  memcpy(&d, &bits, 4);
+  return d;
 }
 
 std::optional<std::shared_ptr<std::vector<float>>> DingoSchema<std::optional<std::shared_ptr<std::vector<float>>>>::DecodeValue(Buf* buf) {
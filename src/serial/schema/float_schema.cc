@@ -21,60 +21,31 @@ int DingoSchema<std::optional<float>>::GetDataLength() { return 4; }
 int DingoSchema<std::optional<float>>::GetWithNullTagLength() { return 5; }
 
 void DingoSchema<std::optional<float>>::InternalEncodeNull(Buf* buf) {
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
+  buf->WriteUint32(0, true);
 }
 
 void DingoSchema<std::optional<float>>::LeInternalEncodeKey(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  if (data >= 0) {
-    buf->Write(bits >> 24 ^ 0x80);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 8);
-    buf->Write(bits);
-  } else {
-    buf->Write(~bits >> 24);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits);
-  }
+  buf->WriteUint32(data >= 0 ? bits ^ 0x80000000 : ~bits, true);
 }
 
 void DingoSchema<std::optional<float>>::BeInternalEncodeKey(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  if (data >= 0) {
-    buf->Write(bits ^ 0x80);
-    buf->Write(bits >> 8);
-    buf->Write(bits >> 16);
-    buf->Write(bits >> 24);
-  } else {
-    buf->Write(~bits);
-    buf->Write(~bits >> 8);
-    buf->Write(~bits >> 16);
-    buf->Write(~bits >> 24);
-  }
+  buf->WriteUint32(data >= 0 ? bits ^ 0x80 : ~bits, false);
 }
 
 void DingoSchema<std::optional<float>>::LeInternalEncodeValue(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  buf->Write(bits >> 24);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 8);
-  buf->Write(bits);
+  buf->WriteUint32(bits, true);
 }
 
 void DingoSchema<std::optional<float>>::BeInternalEncodeValue(Buf* buf, float data) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  buf->Write(bits);
-  buf->Write(bits >> 8);
-  buf->Write(bits >> 16);
-  buf->Write(bits >> 24);
+  buf->WriteUint32(bits, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<float>>::GetType() { return kFloat; }
@@ -136,33 +107,13 @@ std::optional<float> DingoSchema<std::optional<float>>::DecodeKey(Buf* buf) {
       return std::nullopt;
     }
   }
-  uint32_t in = buf->Read() & 0xFF;
+  uint32_t in;
   if (this->le_) {
-    if (in >= 0x80) {
-      in = in ^ 0x80;
-      for (int i = 0; i < 3; i++) {
-        in <<= 8;
-        in |= buf->Read() & 0xFF;
-      }
-    } else {
-      in = ~in;
-      for (int i = 0; i < 3; i++) {
-        in <<= 8;
-        in |= ~buf->Read() & 0xFF;
-      }
-    }
+    in = buf->ReadUint32(true);
+    in = (in >> 24) >= 0x80 ? in ^ 0x80000000 : ~in;
   } else {
-    if (in >= 0x80) {
-      in = in ^ 0x80;
-      for (int i = 1; i < 4; i++) {
-        in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-      }
-    } else {
-      for (int i = 1; i < 4; i++) {
-        in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-      }
-      in= ~in;
-    }
+    in = buf->ReadUint32(false);
+    in = (in & 0xFF) >= 0x80 ? in ^ 0x80 : ~in;
   }
   float d;
   memcpy(&d, &in, 4);
@@ -206,18 +157,7 @@ std::optional<float> DingoSchema<std::optional<float>>::DecodeValue(Buf* buf) {
       return std::nullopt;
     }
   }
-  uint32_t in = buf->Read() & 0xFF;
-  ;
-  if (this->le_) {
-    for (int i = 0; i < 3; i++) {
-      in <<= 8;
-      in |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 4; i++) {
-      in |= (((uint32_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
+  uint32_t in = buf->ReadUint32(this->le_);
   float d;
   memcpy(&d, &in, 4);
   return d;
@@ -21,19 +21,11 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetDataLe
 int DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetWithNullTagLength() { return 5; }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::LeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i >> 24);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 8);
-  buf->Write(*i);
+  buf->WriteUint32(data, true);
 }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::BeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i);
-  buf->Write(*i >> 8);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 24);
+  buf->WriteUint32(data, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::GetType() { return kIntegerList; }
@@ -110,15 +102,7 @@ void DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::EncodeVa
 }
 
 uint32_t DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::InternalDecodeData(Buf* buf) {
-  if (this->le_) {
-    uint32_t r = ((buf->Read() & 0xFF) << 24) | ((buf->Read() & 0xFF) << 16) | ((buf->Read() & 0xFF) << 8) |
-                 (buf->Read() & 0xFF);
-    return r;
-  } else {
-    uint32_t r = (buf->Read() & 0xFF) | ((buf->Read() & 0xFF) << 8) | ((buf->Read() & 0xFF) << 16) |
-                 ((buf->Read() & 0xFF) << 24);
-    return r;
-  }
+  return buf->ReadUint32(this->le_);
 }
 
 std::optional<std::shared_ptr<std::vector<int32_t>>> DingoSchema<std::optional<std::shared_ptr<std::vector<int32_t>>>>::DecodeValue(Buf* buf) {
@@ -21,42 +21,23 @@ int DingoSchema<std::optional<int32_t>>::GetDataLength() { return 4; }
 int DingoSchema<std::optional<int32_t>>::GetWithNullTagLength() { return 5; }
 
 void DingoSchema<std::optional<int32_t>>::InternalEncodeNull(Buf* buf) {
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
+  buf->WriteUint32(0, true);
 }
 
 void DingoSchema<std::optional<int32_t>>::LeInternalEncodeKey(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i >> 24 ^ 0x80);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 8);
-  buf->Write(*i);
+  buf->WriteUint32(static_cast<uint32_t>(data) ^ 0x80000000, true);
 }
 
 void DingoSchema<std::optional<int32_t>>::BeInternalEncodeKey(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i ^ 0x80);
-  buf->Write(*i >> 8);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 24);
+  buf->WriteUint32(static_cast<uint32_t>(data) ^ 0x80, false);
 }
 
 void DingoSchema<std::optional<int32_t>>::LeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i >> 24);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 8);
-  buf->Write(*i);
+  buf->WriteUint32(data, true);
 }
 
 void DingoSchema<std::optional<int32_t>>::BeInternalEncodeValue(Buf* buf, int32_t data) {
-  uint32_t* i = (uint32_t*)&data;
-  buf->Write(*i);
-  buf->Write(*i >> 8);
-  buf->Write(*i >> 16);
-  buf->Write(*i >> 24);
+  buf->WriteUint32(data, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<int32_t>>::GetType() { return kInteger; }
@@ -122,13 +103,9 @@ std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeKey(Buf* buf)
     }
   }
   if (this->le_) {
-    uint32_t r = ((buf->Read() & 0xFF ^ 0x80) << 24) | ((buf->Read() & 0xFF) << 16) | ((buf->Read() & 0xFF) << 8) |
-                 (buf->Read() & 0xFF);
-    return r;
+    return buf->ReadUint32(true) ^ 0x80000000;
   } else {
-    uint32_t r = ((buf->Read() & 0xFF) ^ 0x80) | ((buf->Read() & 0xFF) << 8) | ((buf->Read() & 0xFF) << 16) |
-                 ((buf->Read() & 0xFF) << 24);
-    return r;
+    return buf->ReadUint32(false) ^ 0x80;
   }
 }
 
@@ -169,15 +146,7 @@ std::optional<int32_t> DingoSchema<std::optional<int32_t>>::DecodeValue(Buf* buf
       return std::nullopt;
     }
   }
-  if (this->le_) {
-    uint32_t r = ((buf->Read() & 0xFF) << 24) | ((buf->Read() & 0xFF) << 16) | ((buf->Read() & 0xFF) << 8) |
-                 (buf->Read() & 0xFF);
-    return r;
-  } else {
-    uint32_t r = (buf->Read() & 0xFF) | ((buf->Read() & 0xFF) << 8) | ((buf->Read() & 0xFF) << 16) |
-                 ((buf->Read() & 0xFF) << 24);
-    return r;
-  }
+  return buf->ReadUint32(this->le_);
 }
 
 void DingoSchema<std::optional<int32_t>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
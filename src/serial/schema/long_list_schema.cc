@@ -21,27 +21,11 @@ int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetDataLe
 int DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetWithNullTagLength() { return 9; }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::LeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l >> 56);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 8);
-  buf->Write(*l);
+  buf->WriteUint64(data, true);
 }
 
 void DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::BeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l);
-  buf->Write(*l >> 8);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 56);
+  buf->WriteUint64(data, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::GetType() { return kLongList; }
@@ -118,18 +102,7 @@ if (this->allow_null_) {
 }
 
 uint64_t DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::InternalDecodeData(Buf* buf) {
- uint64_t l = buf->Read() & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
-  return l;
+  return buf->ReadUint64(this->le_);
 }
 
 std::optional<std::shared_ptr<std::vector<int64_t>>> DingoSchema<std::optional<std::shared_ptr<std::vector<int64_t>>>>::DecodeValue(Buf* buf) {
@@ -21,14 +21,7 @@ int DingoSchema<std::optional<int64_t>>::GetDataLength() { return 8; }
 int DingoSchema<std::optional<int64_t>>::GetWithNullTagLength() { return 9; }
 
 void DingoSchema<std::optional<int64_t>>::InternalEncodeNull(Buf* buf) {
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
-  buf->Write(0);
+  buf->WriteUint64(0, true);
 }
 
 void DingoSchema<std::optional<int64_t>>::InternalEncodeKey(Buf* buf, int64_t data) {
@@ -40,51 +33,19 @@ void DingoSchema<std::optional<int64_t>>::InternalEncodeKey(Buf* buf, int64_t da
 }
 
 void DingoSchema<std::optional<int64_t>>::LeInternalEncodeKey(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l >> 56 ^ 0x80);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 8);
-  buf->Write(*l);
+  buf->WriteUint64(static_cast<uint64_t>(data) ^ 0x8000000000000000, true);
 }
 
 void DingoSchema<std::optional<int64_t>>::BeInternalEncodeKey(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l ^ 0x80);
-  buf->Write(*l >> 8);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 56);
+  buf->WriteUint64(static_cast<uint64_t>(data) ^ 0x80, false);
 }
 
 void DingoSchema<std::optional<int64_t>>::LeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l >> 56);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 8);
-  buf->Write(*l);
+  buf->WriteUint64(data, true);
 }
 
 void DingoSchema<std::optional<int64_t>>::BeInternalEncodeValue(Buf* buf, int64_t data) {
-  uint64_t* l = (uint64_t*)&data;
-  buf->Write(*l);
-  buf->Write(*l >> 8);
-  buf->Write(*l >> 16);
-  buf->Write(*l >> 24);
-  buf->Write(*l >> 32);
-  buf->Write(*l >> 40);
-  buf->Write(*l >> 48);
-  buf->Write(*l >> 56);
+  buf->WriteUint64(data, false);
 }
 
 BaseSchema::Type DingoSchema<std::optional<int64_t>>::GetType() { return kLong; }
@@ -143,19 +104,11 @@ void DingoSchema<std::optional<int64_t>>::EncodeKeyPrefix(Buf* buf, std::optiona
 }
 
 int64_t DingoSchema<std::optional<int64_t>>::InternalDecodeKey(Buf* buf) {
-  uint64_t l = buf->Read() & 0xFF ^ 0x80;
   if (buf->IsLe()) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
+    return buf->ReadUint64(true) ^ 0x8000000000000000;
   } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
+    return buf->ReadUint64(false) ^ 0x80;
   }
-
-  return l;
 }
 
 std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey(Buf* buf) {
@@ -165,18 +118,11 @@ std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeKey(Buf* buf)
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF ^ 0x80;
   if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
+    return buf->ReadUint64(true) ^ 0x8000000000000000;
   } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
+    return buf->ReadUint64(false) ^ 0x80;
   }
-  return l;
 }
 
 void DingoSchema<std::optional<int64_t>>::SkipKey(Buf* buf) { buf->Skip(GetLength()); }
@@ -216,18 +162,7 @@ std::optional<int64_t> DingoSchema<std::optional<int64_t>>::DecodeValue(Buf* buf
       return std::nullopt;
     }
   }
-  uint64_t l = buf->Read() & 0xFF;
-  if (this->le_) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf->Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf->Read() & 0xFF) << (8 * i));
-    }
-  }
-  return l;
+  return buf->ReadUint64(this->le_);
 }
 
 void DingoSchema<std::optional<int64_t>>::SkipValue(Buf* buf) { buf->Skip(GetLength()); }
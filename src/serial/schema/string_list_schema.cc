@@ -113,10 +113,8 @@ std::optional<std::shared_ptr<std::vector<std::string>>> DingoSchema<std::option
   data->reserve(length);
   for (int i = 0; i < length; i++) {
     int str_len = buf->ReadInt();
-    std::string str;
-    for (int j = 0; j < str_len; j++) {
-      str.push_back(buf->Read());
-    }
+    std::string str(str_len, 0);
+    buf->Read(str.data(), str_len);
     data->push_back(std::move(str));
   }
 
@@ -38,15 +38,12 @@ int DingoSchema<std::optional<std::shared_ptr<std::string>>>::InternalEncodeKey(
   buf->EnsureRemainder(size + 4);
   int curr = 0;
   for (int i = 0; i < group_num; i++) {
-    for (int j = 0; j < 8; j++) {
-      buf->Write(data->at(curr++));
-    }
+    buf->Write(data->data() + curr, 8);
+    curr += 8;
     buf->Write((uint8_t)255);
   }
   if (remainder_size < 8) {
-    for (int j = 0; j < remainder_size; j++) {
-      buf->Write(data->at(curr++));
-    }
+    buf->Write(data->data() + curr, remainder_size);
   }
   for (int i = 0; i < remainder_zero; i++) {
     buf->Write((uint8_t)0);
@@ -150,16 +147,12 @@ std::optional<std::shared_ptr<std::string>> DingoSchema<std::optional<std::share
     int curr = 0;
     group_num--;
     for (int i = 0; i < group_num; i++) {
-      for (int j = 0; j < 8; j++) {
-        (*data)[curr++] = buf->Read();
-      }
+      buf->Read(data->data() + curr, 8);
+      curr += 8;
       buf->Skip(1);
     }
     if (remainder_zero != 8) {
-      int non_zero_count = 8 - remainder_zero;
-      for (int j = 0; j < non_zero_count; j++) {
-        (*data)[curr++] = buf->Read();
-      }
+      buf->Read(data->data() + curr, 8 - remainder_zero);
     }
   }
 
@@ -204,10 +197,7 @@ std::optional<std::shared_ptr<std::string>> DingoSchema<std::optional<std::share
   }
   int length = buf->ReadInt();
   auto su8 = std::make_shared<std::string>(length, 0);
-
-  for (int i = 0; i < length; i++) {
-    (*su8)[i] = buf->Read();
-  }
+  buf->Read(su8->data(), length);
 
   return std::optional<std::shared_ptr<std::string>>{su8};
 }
@@ -44,6 +44,8 @@ namespace dingodb {
 
 DEFINE_uint64(vector_max_batch_count, 1024, "vector max batch count in one request");
 DEFINE_uint64(vector_max_request_size, 8388608, "vector max batch count in one request");
+DEFINE_uint64(vector_import_max_batch_count, 100000, "vector max batch count in one import request");
+DEFINE_uint64(vector_import_max_request_size, 33554432, "vector max request size in one import request");
 DEFINE_bool(enable_async_vector_search, true, "enable async vector search");
 DEFINE_bool(enable_async_vector_add, true, "enable async vector add");
 DEFINE_bool(enable_async_vector_delete, true, "enable async vector delete");
@@ -901,6 +903,134 @@ void IndexServiceImpl::VectorCount(google::protobuf::RpcController* controller,
   }
 }
 
+static butil::Status ValidateVectorImportRequest(StoragePtr storage, const pb::index::VectorImportRequest* request,
+                                                 store::RegionPtr region) {
+  if (region == nullptr) {
+    return butil::Status(
+        pb::error::EREGION_NOT_FOUND,
+        fmt::format("Not found region {} at server {}", request->context().region_id(), Server::GetInstance().Id()));
+  }
+
+  auto status = ServiceHelper::ValidateRegionEpoch(request->context().region_epoch(), request->context().region_id());
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (request->context().region_id() == 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param region_id is error");
+  }
+
+  if (request->vectors().empty() && !request->finish()) {
+    return butil::Status(pb::error::EVECTOR_EMPTY, "Vector quantity is empty");
+  }
+
+  if (request->vectors_size() > FLAGS_vector_import_max_batch_count) {
+    return butil::Status(pb::error::EVECTOR_EXCEED_MAX_BATCH_COUNT,
+                         fmt::format("Param vectors size {} is exceed max batch count {}", request->vectors_size(),
+                                     FLAGS_vector_import_max_batch_count));
+  }
+
+  if (request->ByteSizeLong() > FLAGS_vector_import_max_request_size) {
+    return butil::Status(pb::error::EVECTOR_EXCEED_MAX_REQUEST_SIZE,
+                         fmt::format("Param vectors size {} is exceed max batch size {}", request->ByteSizeLong(),
+                                     FLAGS_vector_import_max_request_size));
+  }
+
+  status = storage->ValidateLeader(request->context().region_id());
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Vector index will be rebuilt after ingest, so not require it is ready.
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (vector_index_wrapper == nullptr) {
+    return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND,
+                         fmt::format("Not found vector index {}", region->Id()));
+  }
+
+  auto dimension = vector_index_wrapper->GetDimension();
+  for (const auto& vector : request->vectors()) {
+    if (vector.id() == 0 || vector.id() == INT64_MAX || vector.id() < 0) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           "Param vector id is not allowed to be zero or NINT64_MAX or netative");
+    }
+
+    if (vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW ||
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+      if (vector.vector().float_values().size() != dimension) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                             "Param vector dimension is error, correct dimension is " + std::to_string(dimension));
+      }
+    } else {
+      if (vector.vector().binary_values().size() != dimension) {
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                             "Param vector dimension is error, correct dimension is " + std::to_string(dimension));
+      }
+    }
+  }
+
+  status = ServiceHelper::ValidateClusterReadOnly();
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::vector<int64_t> vector_ids;
+  for (const auto& vector : request->vectors()) {
+    vector_ids.push_back(vector.id());
+  }
+
+  return ServiceHelper::ValidateIndexRegion(region, vector_ids);
+}
+
+void DoVectorImport(StoragePtr storage, google::protobuf::RpcController* controller,
+                    const pb::index::VectorImportRequest* request, pb::index::VectorImportResponse* response,
+                    google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+
+  int64_t region_id = request->context().region_id();
+
+  auto region = Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->GetRegion(region_id);
+  auto status = ValidateVectorImportRequest(storage, request, region);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region_id, response->mutable_error());
+    return;
+  }
+
+  auto ctx = std::make_shared<Context>(cntl, nullptr, request, response);
+  ctx->SetRegionId(request->context().region_id());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionEpoch(request->context().region_epoch());
+
+  std::vector<pb::common::VectorWithId> vectors(request->vectors().begin(), request->vectors().end());
+
+  status = storage->VectorImport(ctx, vectors, request->finish());
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  response->set_import_count(vectors.size());
+}
+
+void IndexServiceImpl::VectorImport(google::protobuf::RpcController* controller,
+                                    const pb::index::VectorImportRequest* request,
+                                    pb::index::VectorImportResponse* response, google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  // Run in queue.
+  StoragePtr storage = storage_;
+  auto task = std::make_shared<ServiceTask>([=]() { DoVectorImport(storage, controller, request, response, svr_done); });
+  bool ret = worker_set_->ExecuteHashByRegionId(request->context().region_id(), task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL, "Commit execute queue failed");
+  }
+}
+
 static butil::Status ValidateVectorSearchDebugRequest(StoragePtr storage,
                                                       const pb::index::VectorSearchDebugRequest* request,
                                                       store::RegionPtr region) {
@@ -50,6 +50,8 @@ class IndexServiceImpl : public pb::index::IndexService {
 
   void VectorCount(google::protobuf::RpcController* controller, const pb::index::VectorCountRequest* request,
                    pb::index::VectorCountResponse* response, ::google::protobuf::Closure* done) override;
+  void VectorImport(google::protobuf::RpcController* controller, const pb::index::VectorImportRequest* request,
+                    pb::index::VectorImportResponse* response, ::google::protobuf::Closure* done) override;
 
   // for debug
   void VectorSearchDebug(google::protobuf::RpcController* controller,
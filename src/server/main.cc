@@ -727,6 +727,7 @@ int main(int argc, char *argv[]) {
   store_service.SetWorkSet(worker_set);
   index_service.SetWorkSet(worker_set);
   util_service.SetWorkSet(worker_set);
+  dingo_server.SetServiceWorkerSet(worker_set);
 
   brpc::Server brpc_server;
   brpc::Server raft_server;
@@ -925,6 +926,10 @@ int main(int argc, char *argv[]) {
       DINGO_LOG(ERROR) << "InitCoordinatorInteraction failed!";
       return -1;
     }
+    if (!dingo_server.InitCoordinatorInteractionForMeta()) {
+      DINGO_LOG(ERROR) << "InitCoordinatorInteractionForMeta failed!";
+      return -1;
+    }
     if (!dingo_server.ValiateCoordinator()) {
       DINGO_LOG(ERROR) << "ValiateCoordinator failed!";
       return -1;
@@ -997,6 +1002,10 @@ int main(int argc, char *argv[]) {
       DINGO_LOG(ERROR) << "InitCoordinatorInteraction failed!";
       return -1;
     }
+    if (!dingo_server.InitCoordinatorInteractionForMeta()) {
+      DINGO_LOG(ERROR) << "InitCoordinatorInteractionForMeta failed!";
+      return -1;
+    }
     if (!dingo_server.ValiateCoordinator()) {
       DINGO_LOG(ERROR) << "ValiateCoordinator failed!";
       return -1;
@@ -36,6 +36,7 @@
 #include "proto/node.pb.h"
 #include "server/server.h"
 #include "server/service_helper.h"
+#include "vector/vector_import.h"
 #include "vector/vector_index_snapshot_manager.h"
 
 namespace dingodb {
@@ -469,6 +470,20 @@ void NodeServiceImpl::GetVectorIndexSnapshot(google::protobuf::RpcController* co
                                  response->ShortDebugString());
 }
 
+void NodeServiceImpl::GetVectorImportFiles(google::protobuf::RpcController* /*controller*/,
+                                           const pb::node::GetVectorImportFilesRequest* request,
+                                           pb::node::GetVectorImportFilesResponse* response,
+                                           google::protobuf::Closure* done) {
+  brpc::ClosureGuard done_guard(done);
+
+  auto status = VectorImporter::HandlePullImportFiles(request->region_id(), request->import_id(), response);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  }
+  DINGO_LOG(INFO) << fmt::format("GetVectorImportFiles request: {} response: {}", request->ShortDebugString(),
+                                 response->ShortDebugString());
+}
+
 void NodeServiceImpl::CheckVectorIndex(google::protobuf::RpcController* /*controller*/,
                                        const pb::node::CheckVectorIndexRequest* request,
                                        pb::node::CheckVectorIndexResponse* response, google::protobuf::Closure* done) {
@@ -59,6 +59,10 @@ class NodeServiceImpl : public pb::node::NodeService {
                               pb::node::GetVectorIndexSnapshotResponse* response,
                               google::protobuf::Closure* done) override;
 
+  void GetVectorImportFiles(google::protobuf::RpcController* controller,
+                            const pb::node::GetVectorImportFilesRequest* request,
+                            pb::node::GetVectorImportFilesResponse* response, google::protobuf::Closure* done) override;
+
   void CheckVectorIndex(google::protobuf::RpcController* controller, const pb::node::CheckVectorIndexRequest* request,
                         pb::node::CheckVectorIndexResponse* response, google::protobuf::Closure* done) override;
 
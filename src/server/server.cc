@@ -32,6 +32,7 @@
 #include "common/version.h"
 #include "config/config.h"
 #include "config/config_manager.h"
+#include "coprocessor/aggregation_manager.h"
 #include "coordinator/coordinator_control.h"
 #include "engine/engine.h"
 #include "engine/mem_engine.h"
@@ -49,6 +50,7 @@
 #include "scan/scan_manager.h"
 #include "store/heartbeat.h"
 #include "store/region_controller.h"
+#include "vector/vector_import.h"
 
 DEFINE_string(coor_url, "",
               "coor service name, e.g. file://<path>, list://<addr1>,<addr2>..., bns://<bns-name>, "
@@ -354,12 +356,29 @@ bool Server::InitCoordinatorInteractionForAutoIncrement() {
   }
 }
 
+bool Server::InitCoordinatorInteractionForMeta() {
+  coordinator_interaction_meta_ = std::make_shared<CoordinatorInteraction>();
+
+  auto config = ConfigManager::GetInstance().GetRoleConfig();
+
+  if (!FLAGS_coor_url.empty()) {
+    return coordinator_interaction_meta_->InitByNameService(FLAGS_coor_url,
+                                                            pb::common::CoordinatorServiceType::ServiceTypeMeta);
+
+  } else {
+    return coordinator_interaction_meta_->Init(config->GetString("coordinator.peers"),
+                                               pb::common::CoordinatorServiceType::ServiceTypeMeta);
+  }
+}
+
 bool Server::InitLogStorageManager() {
   log_storage_ = std::make_shared<LogStorageManager>();
   return true;
 }
 
 bool Server::InitStorage() {
+  AggregationManager::CleanSpillPath();
+
   storage_ = std::make_shared<Storage>(raft_engine_);
   return true;
 }
@@ -565,6 +584,9 @@ bool Server::InitStoreMetricsManager() {
 }
 
 bool Server::InitVectorIndexManager() {
+  // No ingest is applying before raft start.
+  VectorImporter::CleanImportPath();
+
   vector_index_manager_ = VectorIndexManager::New();
   return vector_index_manager_->Init();
 }
@@ -21,6 +21,7 @@
 
 #include "brpc/channel.h"
 #include "common/meta_control.h"
+#include "common/runnable.h"
 #include "common/safe_map.h"
 #include "config/config_manager.h"
 #include "coordinator/auto_increment_control.h"
@@ -72,6 +73,7 @@ class Server {
   // Init coordinator interaction
   bool InitCoordinatorInteraction();
   bool InitCoordinatorInteractionForAutoIncrement();
+  bool InitCoordinatorInteractionForMeta();
 
   // Init log Storage manager.
   bool InitLogStorageManager();
@@ -134,6 +136,7 @@ class Server {
 
   std::shared_ptr<CoordinatorInteraction> GetCoordinatorInteraction() { return coordinator_interaction_; }
   std::shared_ptr<CoordinatorInteraction> GetCoordinatorInteractionIncr() { return coordinator_interaction_incr_; }
+  std::shared_ptr<CoordinatorInteraction> GetCoordinatorInteractionMeta() { return coordinator_interaction_meta_; }
 
   std::shared_ptr<Engine> GetEngine() { return raft_engine_; }
   std::shared_ptr<RawEngine> GetRawEngine() { return raw_engine_; }
@@ -200,6 +203,10 @@ class Server {
 
   std::shared_ptr<PreSplitChecker> GetPreSplitChecker() { return pre_split_checker_; }
 
+  // The workers of store/index service, the txn commands of a region run on one worker in order.
+  WorkerSetPtr GetServiceWorkerSet() { return service_worker_set_; }
+  void SetServiceWorkerSet(WorkerSetPtr worker_set) { service_worker_set_ = worker_set; }
+
   Server(const Server&) = delete;
   const Server& operator=(const Server&) = delete;
 
@@ -235,6 +242,8 @@ class Server {
   // coordinator interaction
   std::shared_ptr<CoordinatorInteraction> coordinator_interaction_;
   std::shared_ptr<CoordinatorInteraction> coordinator_interaction_incr_;
+  // for store/index to get tso
+  std::shared_ptr<CoordinatorInteraction> coordinator_interaction_meta_;
 
   // All store engine, include MemEngine/RaftStoreEngine/RocksEngine
   std::shared_ptr<Engine> raft_engine_;
@@ -289,6 +298,9 @@ class Server {
   // Pre split checker
   std::shared_ptr<PreSplitChecker> pre_split_checker_;
 
+  // Service worker set
+  WorkerSetPtr service_worker_set_;
+
   // Crontab config
   std::vector<CrontabConfig> crontab_configs_;
 
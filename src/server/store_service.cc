@@ -27,12 +27,14 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "engine/key_value_sink.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
+#include "scan/scan_stream.h"
 #include "server/server.h"
 #include "server/service_helper.h"
 
@@ -898,21 +900,19 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
 
   auto correction_range = Helper::IntersectRange(region->Range(), uniform_range);
 
-  std::vector<pb::common::KeyValue> kvs;  // NOLINT
-  std::string scan_id;                    // NOLINT
+  std::string scan_id;  // NOLINT
 
+  // kvs are written to response directly
+  RepeatedKeyValueSink sink(response->mutable_kvs());
   status = storage->KvScanBegin(ctx, Constant::kStoreDataCF, region_id, correction_range, request->max_fetch_cnt(),
                                 request->key_only(), request->disable_auto_release(), request->disable_coprocessor(),
-                                request->coprocessor(), &scan_id, &kvs);
+                                request->coprocessor(), request->parallelism(), &scan_id, &sink);
   if (!status.ok()) {
+    response->clear_kvs();
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     return;
   }
 
-  if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
-  }
-
   *response->mutable_scan_id() = scan_id;
 }
 
@@ -982,18 +982,15 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
   ctx->SetCfName(Constant::kStoreDataCF);
   ctx->SetRegionEpoch(request->context().region_epoch());
 
-  std::vector<pb::common::KeyValue> kvs;  // NOLINT
-  status = storage->KvScanContinue(ctx, request->scan_id(), request->max_fetch_cnt(), &kvs);
+  RepeatedKeyValueSink sink(response->mutable_kvs());
+  status = storage->KvScanContinue(ctx, request->scan_id(), request->max_fetch_cnt(), &sink);
 
   if (!status.ok()) {
+    response->clear_kvs();
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
     return;
   }
-
-  if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
-  }
 }
 
 void StoreServiceImpl::KvScanContinue(google::protobuf::RpcController* controller,
@@ -1086,6 +1083,102 @@ void StoreServiceImpl::KvScanRelease(google::protobuf::RpcController* controller
   }
 }
 
+static butil::Status ValidateKvScanStreamRequest(const dingodb::pb::store::KvScanStreamRequest* request,
+                                                 store::RegionPtr region, const pb::common::Range& req_range) {
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region at server %lu", Server::GetInstance().Id());
+  }
+
+  auto status = ServiceHelper::ValidateRegionEpoch(request->context().region_epoch(), request->context().region_id());
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ServiceHelper::ValidateRange(req_range);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ServiceHelper::ValidateRangeInRange(region->Range(), req_range);
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = ServiceHelper::ValidateRegionState(region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return butil::Status();
+}
+
+void DoKvScanStream(StoragePtr storage, google::protobuf::RpcController* controller,
+                    const dingodb::pb::store::KvScanStreamRequest* request,
+                    dingodb::pb::store::KvScanStreamResponse* response, google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+
+  int64_t region_id = request->context().region_id();
+
+  auto region = Server::GetInstance().GetStoreMetaManager()->GetStoreRegionMeta()->GetRegion(region_id);
+  auto uniform_range = Helper::TransformRangeWithOptions(request->range());
+  butil::Status status = ValidateKvScanStreamRequest(request, region, uniform_range);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    ServiceHelper::GetStoreRegionInfo(region_id, response->mutable_error());
+    return;
+  }
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  ctx->SetRegionId(region_id);
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetRegionEpoch(request->context().region_epoch());
+
+  auto correction_range = Helper::IntersectRange(region->Range(), uniform_range);
+
+  std::shared_ptr<ScanStream> scan_stream;
+  status = storage->KvScanStream(ctx, Constant::kStoreDataCF, correction_range, request->max_fetch_cnt(),
+                                 request->key_only(), request->disable_coprocessor(), request->coprocessor(),
+                                 &scan_stream);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
+  brpc::StreamOptions options;
+  options.handler = scan_stream.get();
+  brpc::StreamId stream_id;
+  if (brpc::StreamAccept(&stream_id, *cntl, &options) != 0) {
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EINTERNAL, "Accept stream failed");
+    return;
+  }
+
+  // the stream is connected after the response is returned
+  done_guard.reset(nullptr);
+  scan_stream->Start(stream_id);
+}
+
+void StoreServiceImpl::KvScanStream(google::protobuf::RpcController* controller,
+                                    const ::dingodb::pb::store::KvScanStreamRequest* request,
+                                    ::dingodb::pb::store::KvScanStreamResponse* response,
+                                    ::google::protobuf::Closure* done) {
+  auto* svr_done = new ServiceClosure(__func__, done, request, response);
+
+  if (!FLAGS_enable_async_store_operation) {
+    return DoKvScanStream(storage_, controller, request, response, svr_done);
+  }
+
+  // Run in queue.
+  StoragePtr storage = storage_;
+  auto task =
+      std::make_shared<ServiceTask>([=]() { DoKvScanStream(storage, controller, request, response, svr_done); });
+  bool ret = worker_set_->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(svr_done);
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL, "Commit execute queue failed");
+  }
+}
+
 // txn
 
 static butil::Status ValidateTxnGetRequest(const dingodb::pb::store::TxnGetRequest* request) {
@@ -74,6 +74,10 @@ class StoreServiceImpl : public pb::store::StoreService {
                      const ::dingodb::pb::store::KvScanReleaseRequest* request,
                      ::dingodb::pb::store::KvScanReleaseResponse* response, ::google::protobuf::Closure* done) override;
 
+  void KvScanStream(google::protobuf::RpcController* controller,
+                    const ::dingodb::pb::store::KvScanStreamRequest* request,
+                    ::dingodb::pb::store::KvScanStreamResponse* response, ::google::protobuf::Closure* done) override;
+
   // txn read
   void TxnGet(google::protobuf::RpcController* controller, const pb::store::TxnGetRequest* request,
               pb::store::TxnGetResponse* response, google::protobuf::Closure* done) override;
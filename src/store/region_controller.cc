@@ -30,6 +30,7 @@
 #include "common/service_access.h"
 #include "config/config_helper.h"
 #include "config/config_manager.h"
+#include "engine/txn_engine_helper.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -42,6 +43,7 @@
 #include "server/server.h"
 #include "store/heartbeat.h"
 #include "vector/codec.h"
+#include "vector/vector_import.h"
 #include "vector/vector_index_hnsw.h"
 #include "vector/vector_index_snapshot_manager.h"
 
@@ -214,8 +216,8 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
   // Delete data
   DINGO_LOG(DEBUG) << fmt::format("[control.region][region({})] delete region, delete data", region_id);
   if (!Helper::InvalidRange(region->Range())) {
-    auto writer = Server::GetInstance().GetRawEngine()->Writer();
-    status = writer->KvDeleteRange(Helper::GetColumnFamilyNames(region->Range().start_key()), region->Range());
+    auto raw_engine = Server::GetInstance().GetRawEngine();
+    status = raw_engine->DropRange(Helper::GetColumnFamilyNames(region->Range().start_key()), region->Range());
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("[control.region][region({})] delete region data failled, error: {} {}.",
                                       region_id, pb::error::Errno_Name(status.error_code()), status.error_str());
@@ -228,6 +230,8 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
     if (vector_index_wrapper != nullptr) {
       vector_index_wrapper->Destroy();
     }
+
+    VectorImporter::DeleteImportFiles(region_id);
   }
 
   // Delete region executor
@@ -387,16 +391,28 @@ butil::Status SplitRegionTask::SplitRegion() {
     return butil::Status(pb::error::EREGION_NOT_FOUND, "Parent region not exist.");
   }
 
+  // the child region may elect its leader on other store
+  status = TxnEngineHelper::FlushPessimisticLocks(Server::GetInstance().GetEngine(), parent_region);
+  if (!status.ok()) {
+    return status;
+  }
+
   // Commit raft log
   ctx_->SetRegionId(region_cmd_->split_request().split_from_region_id());
   ctx_->SetRegionEpoch(parent_region->Epoch());
-  return Server::GetInstance().GetEngine()->AsyncWrite(
+  status = Server::GetInstance().GetEngine()->AsyncWrite(
       ctx_, WriteDataBuilder::BuildWrite(region_cmd_->id(), region_cmd_->split_request(), parent_region->Epoch()),
-      [](std::shared_ptr<Context>, butil::Status status) {
+      [parent_region](std::shared_ptr<Context>, butil::Status status) {
         if (!status.ok()) {
           LOG(ERROR) << fmt::format("[control.region][region()] write split failed, error: {}", status.error_str());
+          parent_region->SetDisablePessimisticLockInMemory(false);
         }
       });
+  if (!status.ok()) {
+    parent_region->SetDisablePessimisticLockInMemory(false);
+  }
+
+  return status;
 }
 
 void SplitRegionTask::Run() {
@@ -637,6 +653,12 @@ butil::Status MergeRegionTask::MergeRegion() {
     return status;
   }
 
+  // the target region leader may be on other store
+  status = TxnEngineHelper::FlushPessimisticLocks(Server::GetInstance().GetEngine(), source_region);
+  if (!status.ok()) {
+    return status;
+  }
+
   // Commit raft cmd
   auto ctx = std::make_shared<Context>();
   ctx->SetRegionId(source_region->Id());
@@ -645,6 +667,7 @@ butil::Status MergeRegionTask::MergeRegion() {
   status = Server::GetInstance().GetStorage()->PrepareMerge(ctx, region_cmd_->id(), target_region->Definition(),
                                                             min_applied_log_id);
   if (!status.ok()) {
+    source_region->SetDisablePessimisticLockInMemory(false);
     return status;
   }
 
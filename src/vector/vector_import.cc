@@ -0,0 +1,435 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_import.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/endpoint.h"
+#include "butil/status.h"
+#include "butil/strings/string_split.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/service_access.h"
+#include "config/config_manager.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/file_service.pb.h"
+#include "raft/dingo_filesystem_adaptor.h"
+#include "rocksdb/sst_file_reader.h"
+#include "server/file_service.h"
+#include "server/server.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+DEFINE_int32(vector_import_pull_retry_times, 10, "retry times of pulling import sst files from peers");
+DEFINE_int32(vector_import_pull_retry_interval_ms, 3000, "retry interval of pulling import sst files from peers");
+DEFINE_int32(vector_import_file_retain_s, 3600,
+             "min retain time of the applied import sst files for lagging peers pulling");
+
+static const std::string kTmpPathSuffix = ".tmp";
+// Record the apply log id and time of the ingest marker, format: {log_id} {timestamp}
+static const std::string kAppliedFileName = "APPLIED";
+
+// Parse uri, format: remote://{host}:{port}/{reader_id}
+static bool ParseUri(const std::string& uri, butil::EndPoint& endpoint, int64_t& reader_id) {
+  std::vector<std::string> strs;
+  butil::SplitString(uri, '/', &strs);
+  if (strs.size() < 4) {
+    return false;
+  }
+
+  if (butil::str2endpoint(strs[2].c_str(), &endpoint) != 0) {
+    return false;
+  }
+
+  char* end = nullptr;
+  reader_id = std::strtoll(strs[3].c_str(), &end, 10);
+  return reader_id > 0 && *end == '\0';
+}
+
+std::string VectorImporter::GetImportPath(int64_t region_id, int64_t import_id) {
+  return fmt::format("{}/import/{}/{}", Server::GetStorePath(), region_id, import_id);
+}
+
+void VectorImporter::CleanImportPath() {
+  std::string path = fmt::format("{}/import", Server::GetStorePath());
+  for (const auto& region_dir : Helper::TraverseDirectory(path, false, true)) {
+    std::string region_path = fmt::format("{}/{}", path, region_dir);
+    for (const auto& import_dir : Helper::TraverseDirectory(region_path, false, true)) {
+      if (import_dir.size() > kTmpPathSuffix.size() &&
+          import_dir.compare(import_dir.size() - kTmpPathSuffix.size(), kTmpPathSuffix.size(), kTmpPathSuffix) == 0) {
+        DINGO_LOG(INFO) << fmt::format("[vector_import] clean partial import files {}/{}", region_path, import_dir);
+        Helper::RemoveAllFileOrDirectory(fmt::format("{}/{}", region_path, import_dir));
+      }
+    }
+  }
+}
+
+butil::Status VectorImporter::BuildSstFiles(store::RegionPtr region,
+                                            const std::vector<pb::common::VectorWithId>& vectors, int64_t import_id,
+                                            std::vector<pb::raft::IngestSstFile>& files) {
+  // Build in tmp path, the import path is always complete for ingest and peer pulling.
+  std::string import_path = GetImportPath(region->Id(), import_id);
+  std::string tmp_path = fmt::format("{}{}", import_path, kTmpPathSuffix);
+  Helper::RemoveAllFileOrDirectory(tmp_path);
+  auto status = Helper::CreateDirectories(tmp_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Sst file require key is ordered and unique, the later one win when same vector id.
+  char prefix = region->Range().start_key()[0];
+  int64_t partition_id = region->PartitionId();
+  std::vector<std::pair<std::string, int>> ordered_keys;
+  ordered_keys.reserve(vectors.size());
+  for (int i = 0; i < vectors.size(); ++i) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(prefix, partition_id, vectors[i].id(), key);
+    ordered_keys.emplace_back(std::move(key), i);
+  }
+  std::stable_sort(ordered_keys.begin(), ordered_keys.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  auto write_sst_file = [&](const std::string& cf_name,
+                            std::function<std::string(const pb::common::VectorWithId&)> value_func) -> butil::Status {
+    std::string filename = fmt::format("{}{}", cf_name, Constant::kRaftSnapshotRegionDateFileNameSuffix);
+    std::string filepath = fmt::format("{}/{}", tmp_path, filename);
+
+    SstFileWriter writer(rocksdb::Options{});
+    auto s = writer.Open(filepath);
+    if (!s.ok()) {
+      return butil::Status(pb::error::EINTERNAL, "Open sst file %s failed, %s", filepath.c_str(),
+                           s.ToString().c_str());
+    }
+
+    for (int i = 0; i < ordered_keys.size(); ++i) {
+      // Skip duplicate vector id, keep the last.
+      if (i + 1 < ordered_keys.size() && ordered_keys[i].first == ordered_keys[i + 1].first) {
+        continue;
+      }
+
+      s = writer.Put(ordered_keys[i].first, value_func(vectors[ordered_keys[i].second]));
+      if (!s.ok()) {
+        return butil::Status(pb::error::EINTERNAL, "Put sst file %s failed, %s", filepath.c_str(),
+                             s.ToString().c_str());
+      }
+    }
+
+    s = writer.Finish();
+    if (!s.ok()) {
+      return butil::Status(pb::error::EINTERNAL, "Finish sst file %s failed, %s", filepath.c_str(),
+                           s.ToString().c_str());
+    }
+
+    pb::raft::IngestSstFile file;
+    file.set_cf_name(cf_name);
+    file.set_filename(filename);
+    file.set_size(Helper::GetFileSize(filepath));
+    files.push_back(file);
+
+    return butil::Status();
+  };
+
+  status = write_sst_file(Constant::kVectorDataCF, [](const pb::common::VectorWithId& vector) {
+    return vector.vector().SerializeAsString();
+  });
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = write_sst_file(Constant::kVectorScalarCF, [](const pb::common::VectorWithId& vector) {
+    return vector.scalar_data().SerializeAsString();
+  });
+  if (!status.ok()) {
+    return status;
+  }
+
+  status = write_sst_file(Constant::kVectorTableCF, [](const pb::common::VectorWithId& vector) {
+    return vector.table_data().SerializeAsString();
+  });
+  if (!status.ok()) {
+    return status;
+  }
+
+  return Helper::Rename(tmp_path, import_path);
+}
+
+butil::Status VectorImporter::HandlePullImportFiles(int64_t region_id, int64_t import_id,
+                                                    pb::node::GetVectorImportFilesResponse* response) {
+  std::string import_path = GetImportPath(region_id, import_id);
+  if (!Helper::IsExistPath(import_path)) {
+    return butil::Status(pb::error::EFILE_NOT_FOUND_READER, "Not found import files %s", import_path.c_str());
+  }
+
+  auto config = ConfigManager::GetInstance().GetRoleConfig();
+  auto host = config->GetString("server.host");
+  int port = config->GetInt("server.port");
+  if (host.empty() || port == 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Parse server host or port error.");
+  }
+
+  auto reader = std::make_shared<FileReaderWrapper>(import_path);
+  int64_t reader_id = FileServiceReaderManager::GetInstance().AddReader(reader);
+  response->set_uri(fmt::format("remote://{}:{}/{}", host, port, reader_id));
+
+  return butil::Status();
+}
+
+bool VectorImporter::IsCompleteSstFiles(const std::string& import_path, const pb::raft::IngestSstRequest& request) {
+  for (const auto& file : request.files()) {
+    std::string filepath = fmt::format("{}/{}", import_path, file.filename());
+    if (!Helper::IsExistPath(filepath) || Helper::GetFileSize(filepath) != file.size()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+butil::Status VectorImporter::DownloadSstFiles(const std::string& uri, const std::string& path,
+                                               const pb::raft::IngestSstRequest& request) {
+  butil::EndPoint endpoint;
+  int64_t reader_id = 0;
+  if (!ParseUri(uri, endpoint, reader_id)) {
+    return butil::Status(pb::error::EINTERNAL, "Parse uri %s to reader_id and endpoint error", uri.c_str());
+  }
+
+  butil::Status status;
+  for (const auto& file : request.files()) {
+    std::string filepath = fmt::format("{}/{}", path, file.filename());
+    std::ofstream ofile(filepath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+    int64_t offset = 0;
+    for (;;) {
+      pb::fileservice::GetFileRequest get_file_request;
+      get_file_request.set_reader_id(reader_id);
+      get_file_request.set_filename(file.filename());
+      get_file_request.set_offset(offset);
+      get_file_request.set_size(Constant::kFileTransportChunkSize);
+
+      butil::IOBuf buf;
+      auto response = ServiceAccess::GetFile(get_file_request, endpoint, &buf);
+      if (response == nullptr) {
+        status = butil::Status(pb::error::EINTERNAL, "Get file %s failed", file.filename().c_str());
+        break;
+      }
+
+      ofile << buf;
+
+      if (response->eof()) {
+        break;
+      }
+      offset += response->read_size();
+    }
+    ofile.close();
+
+    if (status.ok() && Helper::GetFileSize(filepath) != file.size()) {
+      status = butil::Status(pb::error::EINTERNAL, "Download file %s size not match", file.filename().c_str());
+    }
+    if (!status.ok()) {
+      break;
+    }
+  }
+
+  pb::fileservice::CleanFileReaderRequest clean_request;
+  clean_request.set_reader_id(reader_id);
+  ServiceAccess::CleanFileReader(clean_request, endpoint);
+
+  return status;
+}
+
+butil::Status VectorImporter::PullSstFiles(store::RegionPtr region, const pb::raft::IngestSstRequest& request) {
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  auto raft_node = raft_store_engine != nullptr ? raft_store_engine->GetNode(region->Id()) : nullptr;
+  if (raft_node == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node %ld", region->Id());
+  }
+
+  std::string import_path = GetImportPath(region->Id(), request.import_id());
+  std::string tmp_path = fmt::format("{}{}", import_path, kTmpPathSuffix);
+
+  pb::node::GetVectorImportFilesRequest get_request;
+  get_request.set_region_id(region->Id());
+  get_request.set_import_id(request.import_id());
+
+  auto self_peer = raft_node->GetPeerId();
+  std::vector<braft::PeerId> peers;
+  raft_node->ListPeers(&peers);
+  for (const auto& peer : peers) {
+    if (peer == self_peer) {
+      continue;
+    }
+
+    pb::node::GetVectorImportFilesResponse get_response;
+    auto status = ServiceAccess::GetVectorImportFiles(get_request, peer.addr, get_response);
+    if (!status.ok()) {
+      continue;
+    }
+
+    Helper::RemoveAllFileOrDirectory(tmp_path);
+    status = Helper::CreateDirectories(tmp_path);
+    if (!status.ok()) {
+      return status;
+    }
+
+    status = DownloadSstFiles(get_response.uri(), tmp_path, request);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_import][region({})] pull import {} from {} failed, error: {}",
+                                        region->Id(), request.import_id(), Helper::EndPointToStr(peer.addr),
+                                        status.error_str());
+      continue;
+    }
+
+    return Helper::Rename(tmp_path, import_path);
+  }
+
+  return butil::Status(pb::error::EINTERNAL, "Not found peer has the import files %ld", request.import_id());
+}
+
+butil::Status VectorImporter::IngestSstFiles(RawEnginePtr raw_engine, const std::string& import_path,
+                                             const pb::raft::IngestSstRequest& request) {
+  std::map<std::string, std::vector<std::string>> cf_files;
+  for (const auto& file : request.files()) {
+    cf_files[file.cf_name()].push_back(fmt::format("{}/{}", import_path, file.filename()));
+  }
+
+  // Copy the files into rocksdb, keep the import files for replay and peer pulling.
+  return raw_engine->IngestExternalFiles(cf_files);
+}
+
+butil::Status VectorImporter::Ingest(store::RegionPtr region, RawEnginePtr raw_engine,
+                                     const pb::raft::IngestSstRequest& request, int64_t log_id) {
+  std::string import_path = GetImportPath(region->Id(), request.import_id());
+
+  butil::Status status;
+  for (int i = 0; i <= FLAGS_vector_import_pull_retry_times; ++i) {
+    if (i > 0) {
+      bthread_usleep(static_cast<int64_t>(FLAGS_vector_import_pull_retry_interval_ms) * 1000);
+    }
+
+    if (!IsCompleteSstFiles(import_path, request)) {
+      status = PullSstFiles(region, request);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[vector_import][region({})] pull import {} failed, retry {} error: {}",
+                                          region->Id(), request.import_id(), i, status.error_str());
+        continue;
+      }
+    }
+
+    status = IngestSstFiles(raw_engine, import_path, request);
+    if (status.ok()) {
+      break;
+    }
+    DINGO_LOG(WARNING) << fmt::format("[vector_import][region({})] ingest import {} failed, retry {} error: {}",
+                                      region->Id(), request.import_id(), i, status.error_str());
+  }
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::ofstream ofile(fmt::format("{}/{}", import_path, kAppliedFileName), std::ofstream::out | std::ofstream::trunc);
+  ofile << log_id << " " << Helper::Timestamp();
+  ofile.close();
+
+  return butil::Status();
+}
+
+butil::Status VectorImporter::LoadVectors(int64_t region_id, const pb::raft::IngestSstRequest& request,
+                                          std::vector<pb::common::VectorWithId>& vectors) {
+  std::string import_path = GetImportPath(region_id, request.import_id());
+  for (const auto& file : request.files()) {
+    if (file.cf_name() != Constant::kVectorDataCF) {
+      continue;
+    }
+
+    std::string filepath = fmt::format("{}/{}", import_path, file.filename());
+    rocksdb::SstFileReader reader(rocksdb::Options{});
+    auto s = reader.Open(filepath);
+    if (!s.ok()) {
+      return butil::Status(pb::error::EINTERNAL, "Open sst file %s failed, %s", filepath.c_str(),
+                           s.ToString().c_str());
+    }
+
+    std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      pb::common::VectorWithId vector;
+      vector.set_id(VectorCodec::DecodeVectorId(iter->key().ToString()));
+      if (!vector.mutable_vector()->ParseFromArray(iter->value().data(), iter->value().size())) {
+        return butil::Status(pb::error::EINTERNAL, "Parse vector failed, sst file %s", filepath.c_str());
+      }
+      vectors.push_back(std::move(vector));
+    }
+    if (!iter->status().ok()) {
+      return butil::Status(pb::error::EINTERNAL, "Read sst file %s failed, %s", filepath.c_str(),
+                           iter->status().ToString().c_str());
+    }
+  }
+
+  return butil::Status();
+}
+
+void VectorImporter::CleanAppliedImport(int64_t region_id) {
+  std::string region_path = fmt::format("{}/import/{}", Server::GetStorePath(), region_id);
+  if (!Helper::IsExistPath(region_path)) {
+    return;
+  }
+
+  auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+  auto raft_node = raft_store_engine != nullptr ? raft_store_engine->GetNode(region_id) : nullptr;
+  if (raft_node == nullptr) {
+    return;
+  }
+  int64_t first_log_index = raft_node->GetStatus()->first_index();
+
+  for (const auto& import_dir : Helper::TraverseDirectory(region_path, false, true)) {
+    std::string import_path = fmt::format("{}/{}", region_path, import_dir);
+    std::ifstream ifile(fmt::format("{}/{}", import_path, kAppliedFileName));
+    int64_t log_id = 0;
+    int64_t applied_time = 0;
+    if (!(ifile >> log_id >> applied_time)) {
+      continue;
+    }
+
+    // The replay of raft log never reach it, and the peers had enough time to pull it.
+    if (log_id < first_log_index && applied_time + FLAGS_vector_import_file_retain_s < Helper::Timestamp()) {
+      DINGO_LOG(INFO) << fmt::format("[vector_import][region({})] clean applied import files {} log_id {}",
+                                     region_id, import_path, log_id);
+      Helper::RemoveAllFileOrDirectory(import_path);
+    }
+  }
+}
+
+void VectorImporter::DeleteImportFiles(int64_t region_id) {
+  std::string region_path = fmt::format("{}/import/{}", Server::GetStorePath(), region_id);
+  if (Helper::IsExistPath(region_path)) {
+    DINGO_LOG(INFO) << fmt::format("[vector_import][region({})] delete import files {}", region_id, region_path);
+    Helper::RemoveAllFileOrDirectory(region_path);
+  }
+}
+
+}  // namespace dingodb
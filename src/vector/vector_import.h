@@ -0,0 +1,78 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_IMPORT_H_
+#define DINGODB_VECTOR_IMPORT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/node.pb.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Bulk load vectors, bypass raft log, memtable/wal and the online vector index insert.
+// The leader writes the vectors to sst files, raft only records an ingest marker, every replica
+// pulls the missing sst files from its peers through file service and ingests them atomically.
+// The import files are retained until the local raft log is truncated past the marker, so the
+// replay and the lagging peers can still find them. The vector index is rebuilt offline once
+// after the last batch of the import.
+class VectorImporter {
+ public:
+  // Import directory, {store.path}/import/{region_id}/{import_id}
+  static std::string GetImportPath(int64_t region_id, int64_t import_id);
+
+  // Remove the partial files of the interrupted build or pull, keep the complete import files.
+  static void CleanImportPath();
+
+  // Write vectors to sst files, one sst file per column family.
+  static butil::Status BuildSstFiles(store::RegionPtr region, const std::vector<pb::common::VectorWithId>& vectors,
+                                     int64_t import_id, std::vector<pb::raft::IngestSstFile>& files);
+
+  // Register file reader of the import files for peer pulling.
+  static butil::Status HandlePullImportFiles(int64_t region_id, int64_t import_id,
+                                             pb::node::GetVectorImportFilesResponse* response);
+
+  // Ingest the sst files of request, pull them from peers when missing local.
+  static butil::Status Ingest(store::RegionPtr region, RawEnginePtr raw_engine,
+                              const pb::raft::IngestSstRequest& request, int64_t log_id);
+
+  // Load the vectors of the ingested sst files, used by replay vector index.
+  static butil::Status LoadVectors(int64_t region_id, const pb::raft::IngestSstRequest& request,
+                                   std::vector<pb::common::VectorWithId>& vectors);
+
+  // Remove the import files which ingest marker is truncated from local raft log.
+  static void CleanAppliedImport(int64_t region_id);
+
+  // Remove all import files of region.
+  static void DeleteImportFiles(int64_t region_id);
+
+ private:
+  static bool IsCompleteSstFiles(const std::string& import_path, const pb::raft::IngestSstRequest& request);
+  static butil::Status PullSstFiles(store::RegionPtr region, const pb::raft::IngestSstRequest& request);
+  static butil::Status DownloadSstFiles(const std::string& uri, const std::string& path,
+                                        const pb::raft::IngestSstRequest& request);
+  static butil::Status IngestSstFiles(RawEnginePtr raw_engine, const std::string& import_path,
+                                      const pb::raft::IngestSstRequest& request);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_IMPORT_H_
@@ -42,6 +42,7 @@
 #include "server/file_service.h"
 #include "server/server.h"
 #include "vector/codec.h"
+#include "vector/vector_import.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_snapshot.h"
@@ -435,6 +436,31 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
           }
           break;
         }
+        // The vectors ingested after the index apply log id, e.g. the index is loaded before the import finish.
+        case pb::raft::INGEST_SST: {
+          if (!ids.empty()) {
+            vector_index->Delete(ids);
+            ids.clear();
+          }
+
+          // The import files are retained until the raft log is truncated past the marker.
+          std::vector<pb::common::VectorWithId> ingest_vectors;
+          auto status = VectorImporter::LoadVectors(vector_index->Id(), request.ingest_sst(), ingest_vectors);
+          if (!status.ok()) {
+            return status;
+          }
+          for (auto& vector : ingest_vectors) {
+            if (vector.id() >= min_vector_id && vector.id() < max_vector_id) {
+              vectors.push_back(std::move(vector));
+            }
+          }
+
+          if (vectors.size() >= Constant::kBuildVectorIndexBatchSize) {
+            vector_index->Upsert(vectors);
+            vectors.clear();
+          }
+          break;
+        }
         case pb::raft::VECTOR_DELETE: {
           if (!vectors.empty()) {
             vector_index->Upsert(vectors);
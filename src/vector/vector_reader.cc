@@ -14,6 +14,7 @@
 
 #include "vector/vector_reader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -55,6 +56,47 @@ butil::Status VectorReader::QueryVectorWithId(const pb::common::Range& region_ra
   return butil::Status();
 }
 
+butil::Status VectorReader::QueryVectorWithIds(const pb::common::Range& region_range, int64_t partition_id,
+                                               const std::vector<int64_t>& vector_ids, bool with_vector_data,
+                                               std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  std::vector<std::string> keys;
+  keys.reserve(vector_ids.size());
+  for (auto vector_id : vector_ids) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
+    keys.push_back(std::move(key));
+  }
+
+  std::vector<pb::common::KeyValue> kvs;
+  auto status = reader_->KvBatchGet(Constant::kStoreDataCF, keys, kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // kvs are the found keys in the order of keys
+  size_t pos = 0;
+  for (size_t i = 0; i < vector_ids.size(); ++i) {
+    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
+    auto& vector_with_id = vector_with_ids.emplace_back();
+    if (pos >= kvs.size() || kvs[pos].key() != keys[i]) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} not found", vector_ids[i]);
+      continue;
+    }
+
+    const auto& value = kvs[pos++].value();
+    if (with_vector_data && !vector_with_id.mutable_vector()->ParseFromString(value)) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} parse proto from string error",
+                                        vector_ids[i]);
+      vector_with_id.Clear();
+      continue;
+    }
+
+    vector_with_id.set_id(vector_ids[i]);
+  }
+
+  return butil::Status();
+}
+
 butil::Status VectorReader::SearchVector(
     int64_t partition_id, VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
@@ -171,21 +213,36 @@ butil::Status VectorReader::SearchVector(
 }
 
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
-                                                 pb::common::VectorWithId& vector_with_id) {
-  std::string key, value;
-  VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id.id(), key);
+                                                 std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::vector<std::string> keys;
+  keys.reserve(vector_with_ids.size());
+  for (auto* vector_with_id : vector_with_ids) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id->id(), key);
+    keys.push_back(std::move(key));
+  }
 
-  auto status = reader_->KvGet(Constant::kVectorTableCF, key, value);
+  std::vector<pb::common::KeyValue> kvs;
+  auto status = reader_->KvBatchGet(Constant::kVectorTableCF, keys, kvs);
   if (!status.ok()) {
     return status;
   }
 
-  pb::common::VectorTableData vector_table;
-  if (!vector_table.ParseFromString(value)) {
-    return butil::Status(pb::error::EINTERNAL, "Decode vector table data failed");
-  }
+  // kvs are the found keys in the order of keys
+  size_t pos = 0;
+  for (size_t i = 0; i < vector_with_ids.size() && pos < kvs.size(); ++i) {
+    if (kvs[pos].key() != keys[i]) {
+      continue;
+    }
+
+    pb::common::VectorTableData vector_table;
+    if (!vector_table.ParseFromString(kvs[pos++].value())) {
+      DINGO_LOG(WARNING) << fmt::format("Decode vector table data failed, vector_id: {}", vector_with_ids[i]->id());
+      continue;
+    }
 
-  *(vector_with_id.mutable_table_data()) = vector_table;
+    vector_with_ids[i]->mutable_table_data()->Swap(&vector_table);
+  }
 
   return butil::Status();
 }
@@ -193,52 +250,66 @@ butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorTableData(region_range, partition_id, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return QueryVectorTableData(region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorTableData(region_range, partition_id, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return QueryVectorTableData(region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                                  std::vector<std::string> selected_scalar_keys,
-                                                  pb::common::VectorWithId& vector_with_id) {
-  std::string key, value;
-  // VectorCodec::EncodeVectorScalar(partition_id, vector_with_id.id(), key);
-  VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id.id(), key);
+                                                  const std::vector<std::string>& selected_scalar_keys,
+                                                  std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::vector<std::string> keys;
+  keys.reserve(vector_with_ids.size());
+  for (auto* vector_with_id : vector_with_ids) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id->id(), key);
+    keys.push_back(std::move(key));
+  }
 
-  auto status = reader_->KvGet(Constant::kVectorScalarCF, key, value);
+  std::vector<pb::common::KeyValue> kvs;
+  auto status = reader_->KvBatchGet(Constant::kVectorScalarCF, keys, kvs);
   if (!status.ok()) {
     return status;
   }
 
-  pb::common::VectorScalardata vector_scalar;
-  if (!vector_scalar.ParseFromString(value)) {
-    return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
-  }
+  // kvs are the found keys in the order of keys
+  size_t pos = 0;
+  for (size_t i = 0; i < vector_with_ids.size() && pos < kvs.size(); ++i) {
+    if (kvs[pos].key() != keys[i]) {
+      continue;
+    }
 
-  auto* scalar = vector_with_id.mutable_scalar_data()->mutable_scalar_data();
-  for (const auto& [key, value] : vector_scalar.scalar_data()) {
-    if (!selected_scalar_keys.empty() &&
-        std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+    pb::common::VectorScalardata vector_scalar;
+    if (!vector_scalar.ParseFromString(kvs[pos++].value())) {
+      DINGO_LOG(WARNING) << fmt::format("Decode vector scalar data failed, vector_id: {}", vector_with_ids[i]->id());
       continue;
     }
 
-    scalar->insert({key, value});
+    auto* scalar = vector_with_ids[i]->mutable_scalar_data()->mutable_scalar_data();
+    for (const auto& [key, value] : vector_scalar.scalar_data()) {
+      if (!selected_scalar_keys.empty() &&
+          std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+        continue;
+      }
+
+      scalar->insert({key, value});
+    }
   }
 
   return butil::Status();
@@ -248,26 +319,26 @@ butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& regio
                                                   std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
                                                   std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::CompareVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
@@ -339,44 +410,34 @@ butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorRead
 
 butil::Status VectorReader::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                              std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  for (auto vector_id : ctx->vector_ids) {
-    pb::common::VectorWithId vector_with_id;
-    auto status =
-        QueryVectorWithId(ctx->region_range, ctx->partition_id, vector_id, ctx->with_vector_data, vector_with_id);
-    if (!status.ok()) {
-      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} error: {} ", vector_id,
-                                        status.error_str());
-    }
-
-    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
-    vector_with_ids.push_back(vector_with_id);
+  auto status = QueryVectorWithIds(ctx->region_range, ctx->partition_id, ctx->vector_ids, ctx->with_vector_data,
+                                   vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, error: {}", status.error_str());
+    // one empty vector_with_id for each id, sdk client will handle this
+    vector_with_ids.resize(ctx->vector_ids.size());
   }
 
-  if (ctx->with_scalar_data) {
+  if (ctx->with_scalar_data || ctx->with_table_data) {
+    std::vector<pb::common::VectorWithId*> exist_vector_with_ids;
     for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
+      if (vector_with_id.ByteSizeLong() > 0) {
+        exist_vector_with_ids.push_back(&vector_with_id);
       }
+    }
 
+    if (ctx->with_scalar_data) {
       auto status =
-          QueryVectorScalarData(ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys, vector_with_id);
+          QueryVectorScalarData(ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys, exist_vector_with_ids);
       if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
+        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, error: {}", status.error_str());
       }
     }
-  }
 
-  if (ctx->with_table_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status = QueryVectorTableData(ctx->region_range, ctx->partition_id, vector_with_id);
+    if (ctx->with_table_data) {
+      auto status = QueryVectorTableData(ctx->region_range, ctx->partition_id, exist_vector_with_ids);
       if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
+        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, error: {}", status.error_str());
       }
     }
   }
@@ -414,44 +475,33 @@ butil::Status VectorReader::VectorScanQuery(std::shared_ptr<Engine::VectorReader
   }
 
   // query vector with id
-  for (auto vector_id : vector_ids) {
-    pb::common::VectorWithId vector_with_id;
-    auto status =
-        QueryVectorWithId(ctx->region_range, ctx->partition_id, vector_id, ctx->with_vector_data, vector_with_id);
-    if (!status.ok()) {
-      DINGO_LOG(WARNING) << fmt::format("Query vector data failed, vector_id {} error: {}", vector_id,
-                                        status.error_str());
-    }
-
-    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
-    vector_with_ids.push_back(vector_with_id);
+  status = QueryVectorWithIds(ctx->region_range, ctx->partition_id, vector_ids, ctx->with_vector_data, vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query vector data failed, error: {}", status.error_str());
+    // one empty vector_with_id for each id, sdk client will handle this
+    vector_with_ids.resize(vector_ids.size());
   }
 
-  if (ctx->with_scalar_data) {
+  if (ctx->with_scalar_data || ctx->with_table_data) {
+    std::vector<pb::common::VectorWithId*> exist_vector_with_ids;
     for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
+      if (vector_with_id.ByteSizeLong() > 0) {
+        exist_vector_with_ids.push_back(&vector_with_id);
       }
+    }
 
+    if (ctx->with_scalar_data) {
       auto status =
-          QueryVectorScalarData(ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys, vector_with_id);
+          QueryVectorScalarData(ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys, exist_vector_with_ids);
       if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector_id {} error: {]",
-                                          vector_with_id.id(), status.error_str());
+        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, error: {}", status.error_str());
       }
     }
-  }
-
-  if (ctx->with_table_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
 
-      auto status = QueryVectorTableData(ctx->region_range, ctx->partition_id, vector_with_id);
+    if (ctx->with_table_data) {
+      auto status = QueryVectorTableData(ctx->region_range, ctx->partition_id, exist_vector_with_ids);
       if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector_id {} error: {]", vector_with_id.id(),
-                                          status.error_str());
+        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, error: {}", status.error_str());
       }
     }
   }
@@ -64,14 +64,19 @@ class VectorReader {
  private:
   butil::Status QueryVectorWithId(const pb::common::Range& region_range, int64_t partition_id, int64_t vector_id,
                                   bool with_vector_data, pb::common::VectorWithId& vector_with_id);
+  // Read the vectors of ids in one batch, the vector_with_id of missing id is empty.
+  butil::Status QueryVectorWithIds(const pb::common::Range& region_range, int64_t partition_id,
+                                   const std::vector<int64_t>& vector_ids, bool with_vector_data,
+                                   std::vector<pb::common::VectorWithId>& vector_with_ids);
   butil::Status SearchVector(int64_t partition_id, VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
                              const std::vector<pb::common::VectorWithId>& vector_with_ids,
                              const pb::common::VectorSearchParameter& parameter,
                              std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
 
+  // Fill the scalar data of vector_with_ids by one batch read.
   butil::Status QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                      std::vector<std::string> selected_scalar_keys,
-                                      pb::common::VectorWithId& vector_with_id);
+                                      const std::vector<std::string>& selected_scalar_keys,
+                                      std::vector<pb::common::VectorWithId*>& vector_with_ids);
   butil::Status QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
                                       std::vector<std::string> selected_scalar_keys,
                                       std::vector<pb::common::VectorWithDistance>& vector_with_distances);
@@ -82,8 +87,9 @@ class VectorReader {
   butil::Status CompareVectorScalarData(const pb::common::Range& region_range, int64_t partition_id, int64_t vector_id,
                                         const pb::common::VectorScalardata& source_scalar_data, bool& compare_result);
 
+  // Fill the table data of vector_with_ids by one batch read.
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
-                                     pb::common::VectorWithId& vector_with_id);
+                                     std::vector<pb::common::VectorWithId*>& vector_with_ids);
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                      std::vector<pb::common::VectorWithDistance>& vector_with_distances);
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
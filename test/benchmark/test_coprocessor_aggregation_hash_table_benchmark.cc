@@ -0,0 +1,184 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/aggregation_hash_table.h"
+#include "coprocessor/aggregation_manager.h"
+#include "coprocessor/column_batch.h"
+#include "coprocessor/utils.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class CoprocessorAggregationHashTableBenchmarkTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {}
+
+  static void TearDownTestSuite() {}
+
+  void SetUp() override {}
+
+  void TearDown() override {}
+
+  // SUM(long), COUNT(long), MAX(long), MIN(long)
+  static std::shared_ptr<AggregationManager> OpenAggregationManager() {
+    google::protobuf::RepeatedPtrField<pb::store::Schema> pb_schemas;
+    ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators;
+    std::vector<pb::store::AggregationType> opers = {pb::store::SUM, pb::store::COUNT, pb::store::MAX, pb::store::MIN};
+    for (int i = 0; i < opers.size(); i++) {
+      pb::store::Schema schema;
+      schema.set_type(::dingodb::pb::store::Schema_Type::Schema_Type_LONG);
+      schema.set_is_key(false);
+      schema.set_is_nullable(true);
+      schema.set_index(i);
+      pb_schemas.Add(std::move(schema));
+
+      pb::store::AggregationOperator aggregation_operator;
+      aggregation_operator.set_index_of_column(0);
+      aggregation_operator.set_oper(opers[i]);
+      aggregation_operators.Add(std::move(aggregation_operator));
+    }
+
+    auto group_by_operator_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    butil::Status ok = Utils::TransToSerialSchema(pb_schemas, &group_by_operator_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    auto result_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    ok = Utils::TransToSerialSchema(pb_schemas, &result_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    auto aggregation_manager = std::make_shared<AggregationManager>();
+    ok = aggregation_manager->Open(group_by_operator_serial_schemas, aggregation_operators, result_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    return aggregation_manager;
+  }
+
+  static std::string GroupByKey(int64_t i) { return "group_by_key_" + std::to_string(i); }
+
+  static constexpr int64_t kRowCount = 400000;
+  static constexpr int64_t kGroupCount = 100000;
+};
+
+// Compare high cardinality group by with the std::map based implementation.
+TEST_F(CoprocessorAggregationHashTableBenchmarkTest, HighCardinality) {
+  std::vector<std::string> group_by_keys;
+  group_by_keys.reserve(kRowCount);
+  for (int64_t i = 0; i < kRowCount; i++) {
+    group_by_keys.push_back(GroupByKey((i * 7919) % kGroupCount));
+  }
+
+  // baseline, std::map and one heap allocated state per group
+  {
+    auto start = std::chrono::steady_clock::now();
+    std::map<std::string, std::shared_ptr<std::vector<std::any>>> groups;
+    for (int64_t i = 0; i < kRowCount; i++) {
+      auto it = groups.find(group_by_keys[i]);
+      if (it == groups.end()) {
+        it = groups
+                 .emplace(group_by_keys[i],
+                          std::make_shared<std::vector<std::any>>(4, std::any(std::optional<int64_t>(0))))
+                 .first;
+      }
+      auto& sum = std::any_cast<std::optional<int64_t>&>((*it->second)[0]);
+      sum.value() += i;
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(kGroupCount, groups.size());
+    std::cout << "std::map groups: " << groups.size() << " cost: " << cost.count() << "ms" << '\n';
+  }
+
+  // hash table, row by row
+  {
+    auto aggregation_manager = OpenAggregationManager();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::any> group_by_operator_record(4);
+    for (int64_t i = 0; i < kRowCount; i++) {
+      std::fill(group_by_operator_record.begin(), group_by_operator_record.end(),
+                std::any(std::optional<int64_t>(i)));
+      butil::Status ok = aggregation_manager->Execute(group_by_keys[i], group_by_operator_record);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    int64_t group_count = 0;
+    auto iter = aggregation_manager->CreateIterator();
+    while (iter->HasNext()) {
+      group_count++;
+      iter->Next();
+    }
+    EXPECT_EQ(kGroupCount, group_count);
+    std::cout << "hash table row groups: " << group_count << " cost: " << cost.count() << "ms" << '\n';
+  }
+
+  // hash table, batch
+  {
+    auto aggregation_manager = OpenAggregationManager();
+    ColumnBatch batch;
+    butil::Status ok = batch.Open({BaseSchema::kLong}, 1024);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::any> record(1);
+    std::vector<std::string> batch_keys;
+    std::vector<uint32_t> rows;
+    std::vector<int> column_indexes(4, 0);
+    for (int64_t i = 0; i < kRowCount; i++) {
+      record[0] = std::optional<int64_t>(i);
+      ok = batch.AppendRecord(record);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      rows.push_back(rows.size());
+      batch_keys.push_back(group_by_keys[i]);
+
+      if (batch.Size() == 1024 || i + 1 == kRowCount) {
+        ok = aggregation_manager->ExecuteBatch(batch_keys, batch, column_indexes, rows);
+        EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+        batch.Clear();
+        batch_keys.clear();
+        rows.clear();
+      }
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    auto sorted_start = std::chrono::steady_clock::now();
+    int64_t group_count = 0;
+    auto iter = aggregation_manager->CreateIterator(true);
+    std::string prev_key;
+    while (iter->HasNext()) {
+      EXPECT_LT(prev_key, iter->GetKey());
+      prev_key = iter->GetKey();
+      group_count++;
+      iter->Next();
+    }
+    auto sorted_cost =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - sorted_start);
+    EXPECT_EQ(kGroupCount, group_count);
+    std::cout << "hash table batch groups: " << group_count << " cost: " << cost.count()
+              << "ms sorted output cost: " << sorted_cost.count() << "ms" << '\n';
+  }
+}
+
+}  // namespace dingodb
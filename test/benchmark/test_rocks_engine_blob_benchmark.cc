@@ -0,0 +1,147 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/iterator.h"
+#include "engine/raw_rocks_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {  // NOLINT
+
+static const std::string kDefaultCf = "default";
+
+static const std::vector<std::string> kAllCFs = {kDefaultCf};
+
+const std::string kRootPath = "./unit_test_blob_benchmark";
+
+// Write amplification and scan speed of the vector data column family, with and without blob files.
+class RawRocksEngineBlobBenchmarkTest : public testing::Test {
+ protected:
+  static const int kVectorCount = 10000;
+  static const int kDimension = 768;
+  // every vector is overwritten, as rebuild and update do
+  static const int kWriteRound = 3;
+
+  static void SetUpTestSuite() { Helper::CreateDirectories(kRootPath); }
+  static void TearDownTestSuite() { Helper::RemoveAllFileOrDirectory(kRootPath); }
+
+  // small memtable and level base, so there are enough compactions in the benchmark
+  static std::string GenConfig(const std::string& store_path, bool enable_blob_files) {
+    return "cluster:\n"
+           "  name: dingodb\n"
+           "  instance_id: 12345\n"
+           "log:\n"
+           "  path: " +
+           kRootPath +
+           "/log\n"
+           "store:\n"
+           "  path: " +
+           store_path +
+           "\n"
+           "  default:\n"
+           "    write_buffer_size: 4194304\n"
+           "    target_file_size_base: 4194304\n"
+           "    max_bytes_for_level_base: 16777216\n"
+           "    enable_blob_files: " +
+           (enable_blob_files ? "true" : "false") + "\n";
+  }
+
+  // The bytes written by this process, include wal, flush and compaction.
+  static int64_t WrittenBytes() {
+    std::ifstream file("/proc/self/io");
+    std::string name;
+    int64_t value = 0;
+    while (file >> name >> value) {
+      if (name == "wchar:") {
+        return value;
+      }
+    }
+    return 0;
+  }
+
+  static std::string GenVectorValue(std::mt19937& rng) {
+    std::uniform_real_distribution<float> distrib(0.0, 1.0);
+    std::string value(kDimension * sizeof(float), '\0');
+    auto* data = reinterpret_cast<float*>(value.data());
+    for (int i = 0; i < kDimension; ++i) {
+      data[i] = distrib(rng);
+    }
+    return value;
+  }
+
+  static void Run(const std::string& name, bool enable_blob_files) {
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(GenConfig(kRootPath + "/" + name, enable_blob_files)));
+
+    auto engine = std::make_shared<RawRocksEngine>();
+    ASSERT_TRUE(engine->Init(config, kAllCFs));
+
+    auto writer = engine->Writer();
+    std::mt19937 rng(12345);
+    int64_t user_bytes = 0;
+    int64_t start_written_bytes = WrittenBytes();
+    for (int round = 0; round < kWriteRound; ++round) {
+      for (int i = 0; i < kVectorCount; ++i) {
+        pb::common::KeyValue kv;
+        kv.set_key(fmt::format("r{:016}", i));
+        kv.set_value(GenVectorValue(rng));
+        user_bytes += kv.key().size() + kv.value().size();
+        ASSERT_TRUE(writer->KvPut(kDefaultCf, kv).ok());
+      }
+    }
+    engine->Flush(kDefaultCf);
+    ASSERT_TRUE(engine->Compact(kDefaultCf).ok());
+    int64_t written_bytes = WrittenBytes() - start_written_bytes;
+
+    int64_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    IteratorOptions options;
+    options.upper_bound = "s";
+    auto iter = engine->Reader()->NewIterator(kDefaultCf, options);
+    for (iter->Seek("r"); iter->Valid(); iter->Next()) {
+      EXPECT_EQ(kDimension * sizeof(float), iter->Value().size());
+      ++count;
+    }
+    auto scan_cost =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(kVectorCount, count);
+
+    std::cout << name << " write amplification: " << static_cast<double>(written_bytes) / user_bytes
+              << " scan: " << scan_cost / count << "ns/vector" << '\n';
+
+    iter.reset();
+    engine->Close();
+    engine->Destroy();
+  }
+};
+
+TEST_F(RawRocksEngineBlobBenchmarkTest, Inline) { Run("inline", false); }
+
+TEST_F(RawRocksEngineBlobBenchmarkTest, BlobFiles) { Run("blob", true); }
+
+}  // namespace dingodb
@@ -0,0 +1,152 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <serial/record_decoder.h>
+#include <serial/record_encoder.h>
+
+#include <any>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {  // NOLINT
+
+class SerialBenchmarkTest : public testing::Test {
+ protected:
+  static const long kCommonId = 101;
+  static const int kColumnCount = 8;
+  static const int kRecordCount = 100000;
+
+  template <typename T>
+  static std::shared_ptr<BaseSchema> NewSchema(int index, bool is_key, bool allow_null) {
+    auto schema = std::make_shared<DingoSchema<std::optional<T>>>();
+    schema->SetIndex(index);
+    schema->SetIsKey(is_key);
+    schema->SetAllowNull(allow_null);
+    return schema;
+  }
+
+  // kColumnCount value columns of the type after an int key column
+  template <typename T>
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> ValueSchemas() {
+    auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    schemas->push_back(NewSchema<int32_t>(0, true, false));
+    for (int i = 1; i <= kColumnCount; i++) {
+      schemas->push_back(NewSchema<T>(i, false, true));
+    }
+    return schemas;
+  }
+
+  // kColumnCount key columns of the type
+  template <typename T>
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> KeySchemas() {
+    auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    for (int i = 0; i < kColumnCount; i++) {
+      schemas->push_back(NewSchema<T>(i, true, false));
+    }
+    return schemas;
+  }
+
+  template <typename T>
+  static std::vector<std::vector<std::any>> Records(int key_count, std::function<T(int)> value_func) {
+    std::vector<std::vector<std::any>> records;
+    records.reserve(kRecordCount);
+    for (int i = 0; i < kRecordCount; i++) {
+      std::vector<std::any> record;
+      if (key_count == 1) {
+        record.emplace_back(std::optional<int32_t>(i));
+      }
+      for (int j = 0; j < kColumnCount; j++) {
+        record.emplace_back(std::optional<T>(value_func(i + j)));
+      }
+      records.push_back(std::move(record));
+    }
+    return records;
+  }
+
+  static void Run(const std::string& name, std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> schemas,
+                  const std::vector<std::vector<std::any>>& records) {
+    RecordEncoder encoder(1, schemas, kCommonId);
+    RecordDecoder decoder(1, schemas, kCommonId);
+
+    std::vector<std::string> keys(records.size());
+    std::vector<std::string> values(records.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < records.size(); i++) {
+      ASSERT_EQ(0, encoder.Encode(records[i], keys[i], values[i]));
+    }
+    auto encode_cost =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<std::any> record;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < records.size(); i++) {
+      ASSERT_EQ(0, decoder.Decode(keys[i], values[i], record));
+    }
+    auto decode_cost =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << " encode: " << encode_cost / records.size()
+              << "ns/record decode: " << decode_cost / records.size() << "ns/record" << std::endl;
+  }
+};
+
+TEST_F(SerialBenchmarkTest, Benchmark) {
+  Run("bool value", ValueSchemas<bool>(), Records<bool>(1, [](int i) { return i % 2 == 0; }));
+  Run("int value", ValueSchemas<int32_t>(), Records<int32_t>(1, [](int i) { return i * 7 - 1000; }));
+  Run("float value", ValueSchemas<float>(), Records<float>(1, [](int i) { return i / 3.0F; }));
+  Run("long value", ValueSchemas<int64_t>(), Records<int64_t>(1, [](int i) { return i * 100000007L; }));
+  Run("double value", ValueSchemas<double>(), Records<double>(1, [](int i) { return i / 7.0; }));
+  Run("string value", ValueSchemas<std::shared_ptr<std::string>>(), Records<std::shared_ptr<std::string>>(1, [](int i) {
+        return std::make_shared<std::string>("string value " + std::to_string(i));
+      }));
+  Run("bool list value", ValueSchemas<std::shared_ptr<std::vector<bool>>>(),
+      Records<std::shared_ptr<std::vector<bool>>>(
+          1, [](int i) { return std::make_shared<std::vector<bool>>(std::vector<bool>(8, i % 2 == 0)); }));
+  Run("int list value", ValueSchemas<std::shared_ptr<std::vector<int32_t>>>(),
+      Records<std::shared_ptr<std::vector<int32_t>>>(
+          1, [](int i) { return std::make_shared<std::vector<int32_t>>(std::vector<int32_t>(8, i)); }));
+  Run("float list value", ValueSchemas<std::shared_ptr<std::vector<float>>>(),
+      Records<std::shared_ptr<std::vector<float>>>(
+          1, [](int i) { return std::make_shared<std::vector<float>>(std::vector<float>(8, i / 3.0F)); }));
+  Run("long list value", ValueSchemas<std::shared_ptr<std::vector<int64_t>>>(),
+      Records<std::shared_ptr<std::vector<int64_t>>>(
+          1, [](int i) { return std::make_shared<std::vector<int64_t>>(std::vector<int64_t>(8, i)); }));
+  Run("double list value", ValueSchemas<std::shared_ptr<std::vector<double>>>(),
+      Records<std::shared_ptr<std::vector<double>>>(
+          1, [](int i) { return std::make_shared<std::vector<double>>(std::vector<double>(8, i / 7.0)); }));
+  Run("string list value", ValueSchemas<std::shared_ptr<std::vector<std::string>>>(),
+      Records<std::shared_ptr<std::vector<std::string>>>(1, [](int i) {
+        return std::make_shared<std::vector<std::string>>(std::vector<std::string>(4, std::to_string(i)));
+      }));
+
+  Run("bool key", KeySchemas<bool>(), Records<bool>(0, [](int i) { return i % 2 == 0; }));
+  Run("int key", KeySchemas<int32_t>(), Records<int32_t>(0, [](int i) { return i * 7 - 1000; }));
+  Run("float key", KeySchemas<float>(), Records<float>(0, [](int i) { return i / 3.0F - 100; }));
+  Run("long key", KeySchemas<int64_t>(), Records<int64_t>(0, [](int i) { return i * 100000007L; }));
+  Run("double key", KeySchemas<double>(), Records<double>(0, [](int i) { return i / 7.0 - 100; }));
+  Run("string key", KeySchemas<std::shared_ptr<std::string>>(), Records<std::shared_ptr<std::string>>(0, [](int i) {
+        return std::make_shared<std::string>("string key " + std::to_string(i));
+      }));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,166 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+static const std::vector<std::string> kTxnCFs = {Constant::kTxnDataCF, Constant::kTxnLockCF, Constant::kTxnWriteCF};
+
+const std::string kRootPath = "./unit_test_txn_short_value_benchmark";
+
+// TxnBatchGet and TxnScan of small rows, with the values inlined in write cf and in data cf.
+class TxnShortValueBenchmarkTest : public testing::Test {
+ protected:
+  static const int kRowCount = 10000;
+  static const int kValueSize = 100;
+  static const int kBatchSize = 1000;
+  static const int64_t kStartTs = 100;
+  static const int64_t kCommitTs = 101;
+  static const int64_t kReadTs = 200;
+
+  static void SetUpTestSuite() { Helper::CreateDirectories(kRootPath); }
+  static void TearDownTestSuite() { Helper::RemoveAllFileOrDirectory(kRootPath); }
+
+  static std::string GenConfig(const std::string& store_path) {
+    return "cluster:\n"
+           "  name: dingodb\n"
+           "  instance_id: 12345\n"
+           "log:\n"
+           "  path: " +
+           kRootPath +
+           "/log\n"
+           "store:\n"
+           "  path: " +
+           store_path + "\n";
+  }
+
+  static std::string GenKey(int i) { return fmt::format("r{:016}", i); }
+
+  // The committed rows, as DoTxnCommit writes them.
+  static void Load(std::shared_ptr<RawRocksEngine> engine, bool inline_value) {
+    auto writer = engine->Writer();
+    for (int i = 0; i < kRowCount; ++i) {
+      std::string value(kValueSize, 'a' + i % 26);
+
+      pb::store::WriteInfo write_info;
+      write_info.set_start_ts(kStartTs);
+      write_info.set_op(pb::store::Op::Put);
+      if (inline_value) {
+        write_info.set_short_value(value);
+      } else {
+        pb::common::KeyValue data_kv;
+        data_kv.set_key(Helper::EncodeTxnKey(GenKey(i), kStartTs));
+        data_kv.set_value(value);
+        ASSERT_TRUE(writer->KvPut(Constant::kTxnDataCF, data_kv).ok());
+      }
+
+      pb::common::KeyValue write_kv;
+      write_kv.set_key(Helper::EncodeTxnKey(GenKey(i), kCommitTs));
+      write_kv.set_value(write_info.SerializeAsString());
+      ASSERT_TRUE(writer->KvPut(Constant::kTxnWriteCF, write_kv).ok());
+    }
+
+    for (const auto& cf_name : kTxnCFs) {
+      engine->Flush(cf_name);
+    }
+  }
+
+  static void Run(const std::string& name, bool inline_value) {
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(GenConfig(kRootPath + "/" + name)));
+
+    auto engine = std::make_shared<RawRocksEngine>();
+    ASSERT_TRUE(engine->Init(config, kTxnCFs));
+    Load(engine, inline_value);
+
+    // batch get
+    int64_t batch_get_count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i + kBatchSize <= kRowCount; i += kBatchSize) {
+      std::vector<std::string> keys;
+      keys.reserve(kBatchSize);
+      // the kvs are returned in the order of keys, not sorted
+      for (int j = i + kBatchSize - 1; j >= i; --j) {
+        keys.push_back(GenKey(j));
+      }
+
+      std::vector<pb::common::KeyValue> kvs;
+      pb::store::TxnResultInfo txn_result_info;
+      auto status = TxnEngineHelper::BatchGet(engine, pb::store::IsolationLevel::SnapshotIsolation, kReadTs, keys,
+                                              kvs, txn_result_info);
+      ASSERT_TRUE(status.ok());
+      ASSERT_EQ(kBatchSize, kvs.size());
+      EXPECT_EQ(keys.front(), kvs.front().key());
+      EXPECT_EQ(std::string(kValueSize, 'a' + (i + kBatchSize - 1) % 26), kvs.front().value());
+      batch_get_count += kvs.size();
+    }
+    auto batch_get_cost =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // scan
+    int64_t scan_count = 0;
+    start = std::chrono::steady_clock::now();
+    pb::common::Range range;
+    range.set_start_key(GenKey(0));
+    range.set_end_key(GenKey(kRowCount));
+    while (scan_count < kRowCount) {
+      std::vector<pb::common::KeyValue> kvs;
+      pb::store::TxnResultInfo txn_result_info;
+      bool has_more = false;
+      std::string end_key;
+      auto status = TxnEngineHelper::Scan(engine, pb::store::IsolationLevel::SnapshotIsolation, kReadTs, range,
+                                          kBatchSize, false, false, txn_result_info, kvs, has_more, end_key);
+      ASSERT_TRUE(status.ok());
+      if (kvs.empty()) {
+        break;
+      }
+      EXPECT_EQ(kValueSize, kvs.back().value().size());
+      scan_count += kvs.size();
+      range.set_start_key(kvs.back().key() + '\0');
+    }
+    auto scan_cost =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(kRowCount, scan_count);
+
+    std::cout << name << " batch get: " << batch_get_cost / batch_get_count << "ns/row"
+              << " scan: " << scan_cost / scan_count << "ns/row" << '\n';
+
+    engine->Close();
+    engine->Destroy();
+  }
+};
+
+TEST_F(TxnShortValueBenchmarkTest, DataCf) { Run("data_cf", false); }
+
+TEST_F(TxnShortValueBenchmarkTest, ShortValue) { Run("short_value", true); }
+
+}  // namespace dingodb
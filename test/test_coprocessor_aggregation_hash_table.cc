@@ -0,0 +1,278 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/aggregation_hash_table.h"
+#include "coprocessor/aggregation_manager.h"
+#include "coprocessor/utils.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class CoprocessorAggregationHashTableTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {}
+
+  static void TearDownTestSuite() {}
+
+  void SetUp() override {}
+
+  void TearDown() override {}
+
+  // SUM(long), COUNT(long), MAX(long), MIN(long)
+  static std::shared_ptr<AggregationManager> OpenAggregationManager() {
+    google::protobuf::RepeatedPtrField<pb::store::Schema> pb_schemas;
+    ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators;
+    std::vector<pb::store::AggregationType> opers = {pb::store::SUM, pb::store::COUNT, pb::store::MAX, pb::store::MIN};
+    for (int i = 0; i < opers.size(); i++) {
+      pb::store::Schema schema;
+      schema.set_type(::dingodb::pb::store::Schema_Type::Schema_Type_LONG);
+      schema.set_is_key(false);
+      schema.set_is_nullable(true);
+      schema.set_index(i);
+      pb_schemas.Add(std::move(schema));
+
+      pb::store::AggregationOperator aggregation_operator;
+      aggregation_operator.set_index_of_column(0);
+      aggregation_operator.set_oper(opers[i]);
+      aggregation_operators.Add(std::move(aggregation_operator));
+    }
+
+    auto group_by_operator_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    butil::Status ok = Utils::TransToSerialSchema(pb_schemas, &group_by_operator_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    auto result_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    ok = Utils::TransToSerialSchema(pb_schemas, &result_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    auto aggregation_manager = std::make_shared<AggregationManager>();
+    ok = aggregation_manager->Open(group_by_operator_serial_schemas, aggregation_operators, result_serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    return aggregation_manager;
+  }
+
+  static std::string GroupByKey(int64_t i) { return "group_by_key_" + std::to_string(i); }
+};
+
+TEST_F(CoprocessorAggregationHashTableTest, FindOrInsert) {
+  AggregationHashTable hash_table(4);
+
+  bool inserted = false;
+  for (int64_t i = 0; i < 10000; i++) {
+    EXPECT_EQ(i, hash_table.FindOrInsert(GroupByKey(i), inserted));
+    EXPECT_TRUE(inserted);
+  }
+  EXPECT_EQ(10000, hash_table.Size());
+
+  for (int64_t i = 10000 - 1; i >= 0; i--) {
+    EXPECT_EQ(i, hash_table.FindOrInsert(GroupByKey(i), inserted));
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(GroupByKey(i), hash_table.GetKey(i));
+  }
+
+  // empty key is a valid group, no group by.
+  EXPECT_EQ(10000, hash_table.FindOrInsert("", inserted));
+  EXPECT_TRUE(inserted);
+  EXPECT_GT(hash_table.MemoryUsage(), 0);
+
+  hash_table.Clear();
+  EXPECT_EQ(0, hash_table.Size());
+  EXPECT_EQ(0, hash_table.FindOrInsert(GroupByKey(1), inserted));
+  EXPECT_TRUE(inserted);
+}
+
+TEST_F(CoprocessorAggregationHashTableTest, SortedIterator) {
+  auto aggregation_manager = OpenAggregationManager();
+
+  std::vector<int64_t> keys = {5, 3, 9, 1, 3, 5};
+  for (auto key : keys) {
+    std::vector<std::any> group_by_operator_record(4, std::any(std::optional<int64_t>(key)));
+    butil::Status ok = aggregation_manager->Execute(GroupByKey(key), group_by_operator_record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  // insertion order
+  std::vector<int64_t> expect_keys = {5, 3, 9, 1};
+  auto iter = aggregation_manager->CreateIterator();
+  for (auto key : expect_keys) {
+    EXPECT_TRUE(iter->HasNext());
+    EXPECT_EQ(GroupByKey(key), iter->GetKey());
+    auto value = iter->GetValue();
+    int64_t count = (key == 5 || key == 3) ? 2 : 1;
+    EXPECT_EQ(key * count, std::any_cast<std::optional<int64_t>>((*value)[0]).value());
+    EXPECT_EQ(count, std::any_cast<std::optional<int64_t>>((*value)[1]).value());
+    EXPECT_EQ(key, std::any_cast<std::optional<int64_t>>((*value)[2]).value());
+    EXPECT_EQ(key, std::any_cast<std::optional<int64_t>>((*value)[3]).value());
+    iter->Next();
+  }
+  EXPECT_FALSE(iter->HasNext());
+
+  // sorted by key
+  expect_keys = {1, 3, 5, 9};
+  iter = aggregation_manager->CreateIterator(true);
+  for (auto key : expect_keys) {
+    EXPECT_TRUE(iter->HasNext());
+    EXPECT_EQ(GroupByKey(key), iter->GetKey());
+    iter->Next();
+  }
+  EXPECT_FALSE(iter->HasNext());
+}
+
+TEST_F(CoprocessorAggregationHashTableTest, StreamingClear) {
+  auto aggregation_manager = OpenAggregationManager();
+
+  // rows of a group are adjacent, clear after every group like streaming aggregation.
+  for (int64_t key = 0; key < 1000; key++) {
+    for (int64_t i = 0; i < 3; i++) {
+      std::vector<std::any> group_by_operator_record(4, std::any(std::optional<int64_t>(key + i)));
+      butil::Status ok = aggregation_manager->Execute(GroupByKey(key), group_by_operator_record);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    }
+
+    auto iter = aggregation_manager->CreateIterator();
+    EXPECT_TRUE(iter->HasNext());
+    EXPECT_EQ(GroupByKey(key), iter->GetKey());
+    auto value = iter->GetValue();
+    EXPECT_EQ(key * 3 + 3, std::any_cast<std::optional<int64_t>>((*value)[0]).value());
+    EXPECT_EQ(3, std::any_cast<std::optional<int64_t>>((*value)[1]).value());
+    EXPECT_EQ(key + 2, std::any_cast<std::optional<int64_t>>((*value)[2]).value());
+    EXPECT_EQ(key, std::any_cast<std::optional<int64_t>>((*value)[3]).value());
+    iter->Next();
+    EXPECT_FALSE(iter->HasNext());
+
+    aggregation_manager->Clear();
+  }
+
+  // only reset used slots, keys must be found again after clear.
+  AggregationHashTable hash_table(64);
+  bool inserted = false;
+  for (int64_t round = 0; round < 3; round++) {
+    for (int64_t i = 0; i < 4; i++) {
+      EXPECT_EQ(i, hash_table.FindOrInsert(GroupByKey(i + round), inserted));
+      EXPECT_TRUE(inserted);
+    }
+    EXPECT_EQ(3, hash_table.FindOrInsert(GroupByKey(3 + round), inserted));
+    EXPECT_FALSE(inserted);
+    hash_table.Clear();
+    EXPECT_EQ(0, hash_table.Size());
+  }
+}
+
+TEST_F(CoprocessorAggregationHashTableTest, Spill) {
+  auto aggregation_manager = OpenAggregationManager();
+  auto spill_aggregation_manager = OpenAggregationManager();
+  aggregation_manager->SetMemoryLimit(0);
+  spill_aggregation_manager->SetMemoryLimit(64 * 1024);
+
+  const int64_t group_count = 20000;
+  for (int64_t i = 0; i < 100000; i++) {
+    std::vector<std::any> group_by_operator_record(4, std::any(std::optional<int64_t>(i)));
+    if (i % 7 == 0) {
+      group_by_operator_record[0] = std::optional<int64_t>(std::nullopt);
+    }
+    std::string group_by_key = GroupByKey((i * 7919) % group_count);
+    butil::Status ok = aggregation_manager->Execute(group_by_key, group_by_operator_record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ok = spill_aggregation_manager->Execute(group_by_key, group_by_operator_record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+  EXPECT_EQ(0, aggregation_manager->SpillCount());
+  EXPECT_GT(spill_aggregation_manager->SpillCount(), 1);
+  EXPECT_LE(spill_aggregation_manager->MemoryUsage(), 64 * 1024);
+
+  // merged result is same as in memory result
+  auto iter = aggregation_manager->CreateIterator(true);
+  auto spill_iter = spill_aggregation_manager->CreateIterator();
+  ASSERT_NE(spill_iter, nullptr);
+  int64_t count = 0;
+  while (iter->HasNext()) {
+    ASSERT_TRUE(spill_iter->HasNext());
+    EXPECT_EQ(iter->GetKey(), spill_iter->GetKey());
+    auto value = iter->GetValue();
+    auto spill_value = spill_iter->GetValue();
+    for (size_t i = 0; i < value->size(); i++) {
+      EXPECT_EQ(std::any_cast<std::optional<int64_t>>((*value)[i]),
+                std::any_cast<std::optional<int64_t>>((*spill_value)[i]));
+    }
+    count++;
+    iter->Next();
+    spill_iter->Next();
+  }
+  EXPECT_FALSE(spill_iter->HasNext());
+  EXPECT_EQ(spill_iter->GetStatus().error_code(), pb::error::Errno::OK);
+  EXPECT_EQ(group_count, count);
+
+  spill_aggregation_manager->Close();
+  EXPECT_EQ(0, spill_aggregation_manager->SpillCount());
+}
+
+// partial results of sub-ranges merged, same as the result of the whole range
+TEST_F(CoprocessorAggregationHashTableTest, Merge) {
+  auto aggregation_manager = OpenAggregationManager();
+  auto merge_aggregation_manager = OpenAggregationManager();
+  std::vector<std::shared_ptr<AggregationManager>> partials = {OpenAggregationManager(), OpenAggregationManager(),
+                                                               OpenAggregationManager()};
+
+  const int64_t group_count = 1000;
+  const int64_t row_count = 30000;
+  for (int64_t i = 0; i < row_count; i++) {
+    std::vector<std::any> group_by_operator_record(4, std::any(std::optional<int64_t>(i)));
+    if (i % 7 == 0) {
+      group_by_operator_record[0] = std::optional<int64_t>(std::nullopt);
+    }
+    std::string group_by_key = GroupByKey((i * 7919) % group_count);
+    butil::Status ok = aggregation_manager->Execute(group_by_key, group_by_operator_record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ok = partials[i * partials.size() / row_count]->Execute(group_by_key, group_by_operator_record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  for (const auto& partial : partials) {
+    auto partial_iter = partial->CreateIterator();
+    butil::Status ok = merge_aggregation_manager->Merge(partial_iter.get());
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  auto iter = aggregation_manager->CreateIterator(true);
+  auto merge_iter = merge_aggregation_manager->CreateIterator(true);
+  int64_t count = 0;
+  while (iter->HasNext()) {
+    ASSERT_TRUE(merge_iter->HasNext());
+    EXPECT_EQ(iter->GetKey(), merge_iter->GetKey());
+    auto value = iter->GetValue();
+    auto merge_value = merge_iter->GetValue();
+    for (size_t i = 0; i < value->size(); i++) {
+      EXPECT_EQ(std::any_cast<std::optional<int64_t>>((*value)[i]),
+                std::any_cast<std::optional<int64_t>>((*merge_value)[i]));
+    }
+    count++;
+    iter->Next();
+    merge_iter->Next();
+  }
+  EXPECT_FALSE(merge_iter->HasNext());
+  EXPECT_EQ(group_count, count);
+}
+
+}  // namespace dingodb
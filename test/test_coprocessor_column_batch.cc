@@ -0,0 +1,201 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/aggregation_manager.h"
+#include "coprocessor/column_batch.h"
+#include "coprocessor/utils.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class CoprocessorColumnBatchTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {}
+
+  static void TearDownTestSuite() {}
+
+  void SetUp() override {}
+
+  void TearDown() override {}
+
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> CreateSchemas(
+      const std::vector<pb::store::Schema_Type>& types) {
+    google::protobuf::RepeatedPtrField<pb::store::Schema> pb_schemas;
+    for (int i = 0; i < types.size(); i++) {
+      pb::store::Schema schema;
+      schema.set_type(types[i]);
+      schema.set_is_key(false);
+      schema.set_is_nullable(true);
+      schema.set_index(i);
+      pb_schemas.Add(std::move(schema));
+    }
+
+    auto serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+    butil::Status ok = Utils::TransToSerialSchema(pb_schemas, &serial_schemas);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    return serial_schemas;
+  }
+};
+
+TEST_F(CoprocessorColumnBatchTest, AppendAndGet) {
+  ColumnBatch batch;
+  butil::Status ok =
+      batch.Open({BaseSchema::kLong, BaseSchema::kString, BaseSchema::kBool, BaseSchema::kLongList}, 4);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  for (int64_t i = 0; i < 3; i++) {
+    std::vector<std::any> record;
+    record.emplace_back(i == 1 ? std::optional<int64_t>(std::nullopt) : std::optional<int64_t>(i));
+    record.emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(std::to_string(i))));
+    record.emplace_back(std::optional<bool>(i % 2 == 0));
+    record.emplace_back(std::optional<std::shared_ptr<std::vector<int64_t>>>(std::nullopt));
+    ok = batch.AppendRecord(record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  EXPECT_EQ(3, batch.Size());
+  EXPECT_EQ(4, batch.ColumnSize());
+
+  const auto& longs = std::get<ColumnVector<int64_t>>(batch.GetColumn(0));
+  EXPECT_FALSE(longs.IsNull(0));
+  EXPECT_TRUE(longs.IsNull(1));
+  EXPECT_EQ(2, longs.values[2]);
+
+  auto value = std::any_cast<std::optional<std::shared_ptr<std::string>>>(batch.GetValue(1, 2));
+  EXPECT_EQ("2", *value.value());
+
+  std::vector<std::any> record;
+  batch.GetRecord(1, record);
+  EXPECT_EQ(4, record.size());
+  EXPECT_FALSE(std::any_cast<std::optional<int64_t>>(record[0]).has_value());
+  EXPECT_FALSE(std::any_cast<std::optional<bool>>(record[2]).value());
+
+  // type mismatch
+  std::vector<std::any> bad_record;
+  bad_record.emplace_back(std::optional<int32_t>(1));
+  bad_record.emplace_back(std::optional<std::shared_ptr<std::string>>(std::nullopt));
+  bad_record.emplace_back(std::optional<bool>(true));
+  bad_record.emplace_back(std::optional<std::shared_ptr<std::vector<int64_t>>>(std::nullopt));
+  ok = batch.AppendRecord(bad_record);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+
+  batch.Clear();
+  EXPECT_EQ(0, batch.Size());
+  EXPECT_EQ(0, std::get<ColumnVector<int64_t>>(batch.GetColumn(0)).Size());
+}
+
+// Batch aggregation must be same as row by row aggregation.
+TEST_F(CoprocessorColumnBatchTest, ExecuteBatchSameAsExecute) {
+  auto operator_schemas =
+      CreateSchemas({pb::store::Schema_Type::Schema_Type_LONG, pb::store::Schema_Type::Schema_Type_LONG,
+                     pb::store::Schema_Type::Schema_Type_LONG, pb::store::Schema_Type::Schema_Type_LONG,
+                     pb::store::Schema_Type::Schema_Type_STRING, pb::store::Schema_Type::Schema_Type_LONG});
+  auto result_schemas =
+      CreateSchemas({pb::store::Schema_Type::Schema_Type_LONG, pb::store::Schema_Type::Schema_Type_LONG,
+                     pb::store::Schema_Type::Schema_Type_LONG, pb::store::Schema_Type::Schema_Type_LONG,
+                     pb::store::Schema_Type::Schema_Type_STRING, pb::store::Schema_Type::Schema_Type_LONG});
+
+  ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators;
+  std::vector<pb::store::AggregationType> opers = {pb::store::SUM, pb::store::COUNT,         pb::store::MAX,
+                                                   pb::store::MIN, pb::store::MAX,           pb::store::COUNTWITHNULL};
+  std::vector<int> column_indexes = {0, 0, 0, 0, 1, 0};
+  for (int i = 0; i < opers.size(); i++) {
+    pb::store::AggregationOperator aggregation_operator;
+    aggregation_operator.set_index_of_column(column_indexes[i]);
+    aggregation_operator.set_oper(opers[i]);
+    aggregation_operators.Add(std::move(aggregation_operator));
+  }
+
+  auto row_manager = std::make_shared<AggregationManager>();
+  butil::Status ok = row_manager->Open(operator_schemas, aggregation_operators, result_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  auto batch_manager = std::make_shared<AggregationManager>();
+  ok = batch_manager->Open(operator_schemas, aggregation_operators, result_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  ColumnBatch batch;
+  ok = batch.Open({BaseSchema::kLong, BaseSchema::kString}, 16);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::vector<std::string> group_by_keys;
+  std::vector<uint32_t> rows;
+  for (int64_t i = 0; i < 16; i++) {
+    auto long_value = (i % 5 == 0) ? std::optional<int64_t>(std::nullopt) : std::optional<int64_t>(i * 7 % 11);
+    auto string_value = std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(std::to_string(i)));
+    std::vector<std::any> record = {long_value, string_value};
+    ok = batch.AppendRecord(record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    // skip some rows, like filtered by expression
+    if (i != 7) {
+      rows.push_back(i);
+      group_by_keys.push_back(std::to_string(i % 3));
+    }
+  }
+
+  // row by row aggregation of the same rows
+  for (auto row : rows) {
+    std::vector<std::any> group_by_operator_record;
+    for (auto index : column_indexes) {
+      group_by_operator_record.emplace_back(batch.GetValue(index, row));
+    }
+    ok = row_manager->Execute(std::to_string(row % 3), group_by_operator_record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  ok = batch_manager->ExecuteBatch(group_by_keys, batch, column_indexes, rows);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  auto row_iter = row_manager->CreateIterator();
+  auto batch_iter = batch_manager->CreateIterator();
+  int group_count = 0;
+  while (row_iter->HasNext()) {
+    EXPECT_TRUE(batch_iter->HasNext());
+    EXPECT_EQ(row_iter->GetKey(), batch_iter->GetKey());
+
+    const auto& row_value = *row_iter->GetValue();
+    const auto& batch_value = *batch_iter->GetValue();
+    for (int i = 0; i < row_value.size(); i++) {
+      if (i == 4) {
+        auto lhs = std::any_cast<std::optional<std::shared_ptr<std::string>>>(row_value[i]);
+        auto rhs = std::any_cast<std::optional<std::shared_ptr<std::string>>>(batch_value[i]);
+        EXPECT_EQ(*lhs.value(), *rhs.value());
+      } else {
+        EXPECT_EQ(std::any_cast<std::optional<int64_t>>(row_value[i]),
+                  std::any_cast<std::optional<int64_t>>(batch_value[i]));
+      }
+    }
+
+    row_iter->Next();
+    batch_iter->Next();
+    group_count++;
+  }
+  EXPECT_FALSE(batch_iter->HasNext());
+  EXPECT_EQ(3, group_count);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,317 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/column_batch.h"
+#include "coprocessor/expression.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {  // NOLINT
+
+// code of libexpr runner
+static const char kTypeInt32 = 0x01;
+static const char kTypeInt64 = 0x02;
+static const char kTypeBool = 0x03;
+static const char kTypeDouble = 0x05;
+static const char kTypeString = 0x07;
+
+static const char kAnd = 0x52;
+static const char kOr = 0x53;
+static const char kNot = 0x51;
+static const char kAdd = static_cast<char>(0x83);
+static const char kMul = static_cast<char>(0x85);
+static const char kDiv = static_cast<char>(0x86);
+static const char kEq = static_cast<char>(0x91);
+static const char kGt = static_cast<char>(0x93);
+static const char kLt = static_cast<char>(0x95);
+static const char kIsNull = static_cast<char>(0xA1);
+static const char kCast = static_cast<char>(0xF0);
+
+class CoprocessorExpressionTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {}
+
+  static void TearDownTestSuite() {}
+
+  void SetUp() override {}
+
+  void TearDown() override {}
+
+  static std::string Varint(uint64_t value) {
+    std::string code;
+    while (value >= 0x80) {
+      code.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    code.push_back(static_cast<char>(value));
+    return code;
+  }
+
+  static std::string Var(char type, int index) {
+    return std::string(1, static_cast<char>(0x30 | type)) + Varint(index);
+  }
+
+  static std::string Const(char type, int64_t value) {
+    return std::string(1, static_cast<char>((value < 0 ? 0x20 : 0x10) | type)) + Varint(value < 0 ? -value : value);
+  }
+
+  static std::string ConstBool(bool value) {
+    return std::string(1, static_cast<char>((value ? 0x10 : 0x20) | kTypeBool));
+  }
+
+  static std::string ConstDouble(double value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::string code(1, static_cast<char>(0x10 | kTypeDouble));
+    for (int i = 7; i >= 0; i--) {
+      code.push_back(static_cast<char>((bits >> (i * 8)) & 0xFF));
+    }
+    return code;
+  }
+
+  static std::string ConstString(const std::string& value) {
+    return std::string(1, static_cast<char>(0x10 | kTypeString)) + Varint(value.size()) + value;
+  }
+
+  static std::string Null(char type) { return std::string(1, type); }
+
+  static std::string Op(char op, char type) { return std::string(1, op) + std::string(1, type); }
+
+  static std::string Op(char op) { return std::string(1, op); }
+
+  // same types as test_scan_with_coprocessor
+  static std::vector<BaseSchema::Type> Types() {
+    return {BaseSchema::kBool, BaseSchema::kInteger, BaseSchema::kFloat,
+            BaseSchema::kLong, BaseSchema::kDouble,  BaseSchema::kString};
+  }
+
+  static void AppendRow(ColumnBatch& batch, std::optional<bool> b, std::optional<int32_t> i, std::optional<float> f,
+                        std::optional<int64_t> l, std::optional<double> d, std::optional<std::string> s) {
+    std::vector<std::any> record;
+    record.emplace_back(b);
+    record.emplace_back(i);
+    record.emplace_back(f);
+    record.emplace_back(l);
+    record.emplace_back(d);
+    record.emplace_back(s.has_value()
+                            ? std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(*s))
+                            : std::optional<std::shared_ptr<std::string>>(std::nullopt));
+    butil::Status ok = batch.AppendRecord(record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  // rows 0..4
+  static void OpenBatch(ColumnBatch& batch) {
+    butil::Status ok = batch.Open(Types(), 16);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    AppendRow(batch, true, 1, 1.5F, 10, 0.5, "a");
+    AppendRow(batch, false, 2, 2.5F, 20, 1.5, "b");
+    AppendRow(batch, std::nullopt, 3, 3.5F, std::nullopt, 2.5, "c");
+    AppendRow(batch, true, -4, 4.5F, 40, std::nullopt, std::nullopt);
+    AppendRow(batch, false, 5, 5.5F, -50, 4.5, "a");
+  }
+
+  static std::vector<uint32_t> Filter(const std::string& code) {
+    ColumnBatch batch;
+    OpenBatch(batch);
+
+    Expression expression;
+    butil::Status ok = expression.Compile(code, Types());
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<uint32_t> rows;
+    ok = expression.Filter(batch, rows);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    return rows;
+  }
+};
+
+TEST_F(CoprocessorExpressionTest, Compile) {
+  Expression expression;
+
+  // not bool
+  butil::Status ok = expression.Compile(Var(kTypeInt64, 3), Types());
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::ENOT_SUPPORT);
+
+  // var type not match column type
+  ok = expression.Compile(Var(kTypeInt32, 3) + Const(kTypeInt32, 1) + Op(kGt, kTypeInt32), Types());
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::ENOT_SUPPORT);
+
+  // var index out of range
+  ok = expression.Compile(Var(kTypeBool, 6), Types());
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::ENOT_SUPPORT);
+
+  // stack underflow
+  ok = expression.Compile(Var(kTypeInt64, 3) + Op(kGt, kTypeInt64), Types());
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::ENOT_SUPPORT);
+
+  // unknown operator
+  ok = expression.Compile(Var(kTypeBool, 0) + std::string(1, static_cast<char>(0xF1)), Types());
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::ENOT_SUPPORT);
+
+  ok = expression.Compile(Var(kTypeBool, 0), Types());
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+}
+
+TEST_F(CoprocessorExpressionTest, Compare) {
+  // l > 15
+  EXPECT_EQ(std::vector<uint32_t>({1, 3}), Filter(Var(kTypeInt64, 3) + Const(kTypeInt64, 15) + Op(kGt, kTypeInt64)));
+  // 15 > l
+  EXPECT_EQ(std::vector<uint32_t>({0, 4}), Filter(Const(kTypeInt64, 15) + Var(kTypeInt64, 3) + Op(kGt, kTypeInt64)));
+  // i < -3
+  EXPECT_EQ(std::vector<uint32_t>({3}), Filter(Var(kTypeInt32, 1) + Const(kTypeInt32, -3) + Op(kLt, kTypeInt32)));
+  // d = 2.5
+  EXPECT_EQ(std::vector<uint32_t>({2}), Filter(Var(kTypeDouble, 4) + ConstDouble(2.5) + Op(kEq, kTypeDouble)));
+  // s = 'a'
+  EXPECT_EQ(std::vector<uint32_t>({0, 4}), Filter(Var(kTypeString, 5) + ConstString("a") + Op(kEq, kTypeString)));
+  // i * 10 = l, compare of two expressions
+  EXPECT_EQ(std::vector<uint32_t>({0, 1}),
+            Filter(Var(kTypeInt32, 1) + Op(kCast, static_cast<char>(kTypeInt64 << 4 | kTypeInt32)) +
+                   Const(kTypeInt64, 10) + Op(kMul, kTypeInt64) + Var(kTypeInt64, 3) +
+                   Op(kEq, kTypeInt64)));
+  // compare with null is null
+  EXPECT_TRUE(Filter(Var(kTypeInt64, 3) + Null(kTypeInt64) + Op(kEq, kTypeInt64)).empty());
+}
+
+TEST_F(CoprocessorExpressionTest, Logic) {
+  std::string b = Var(kTypeBool, 0);
+  std::string l_gt_15 = Var(kTypeInt64, 3) + Const(kTypeInt64, 15) + Op(kGt, kTypeInt64);
+
+  EXPECT_EQ(std::vector<uint32_t>({0, 3}), Filter(b));
+  EXPECT_EQ(std::vector<uint32_t>({1, 4}), Filter(b + Op(kNot)));
+  EXPECT_EQ(std::vector<uint32_t>({2}), Filter(b + Op(kIsNull, kTypeBool)));
+
+  // b and l > 15
+  EXPECT_EQ(std::vector<uint32_t>({3}), Filter(b + l_gt_15 + Op(kAnd)));
+  // b or l > 15
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 3}), Filter(b + l_gt_15 + Op(kOr)));
+
+  // three-valued logic, row 2: b is null, l is null
+  // not (b and l > 15) : row 2 is null
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 4}), Filter(b + l_gt_15 + Op(kAnd) + Op(kNot)));
+  // not (b or l > 15) : row 4 false or false
+  EXPECT_EQ(std::vector<uint32_t>({4}), Filter(b + l_gt_15 + Op(kOr) + Op(kNot)));
+  // null or true is true
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 4}), Filter(Null(kTypeBool) + ConstBool(true) + Op(kOr)));
+  // null and false is false
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 4}),
+            Filter(Null(kTypeBool) + ConstBool(false) + Op(kAnd) + Op(kNot)));
+}
+
+TEST_F(CoprocessorExpressionTest, Arithmetic) {
+  // l / (i - 2) < 0, divide by zero is null at row 1
+  std::string code = Var(kTypeInt64, 3) + Var(kTypeInt32, 1) + Const(kTypeInt32, -2) + Op(kAdd, kTypeInt32) +
+                     Op(kCast, static_cast<char>(kTypeInt64 << 4 | kTypeInt32)) + Op(kDiv, kTypeInt64) +
+                     Const(kTypeInt64, 0) + Op(kLt, kTypeInt64);
+  EXPECT_EQ(std::vector<uint32_t>({0, 3, 4}), Filter(code));
+
+  code = Var(kTypeInt64, 3) + Var(kTypeInt32, 1) + Const(kTypeInt32, -2) + Op(kAdd, kTypeInt32) +
+         Op(kCast, static_cast<char>(kTypeInt64 << 4 | kTypeInt32)) + Op(kDiv, kTypeInt64) +
+         Op(kIsNull, kTypeInt64);
+  EXPECT_EQ(std::vector<uint32_t>({1, 2}), Filter(code));
+}
+
+// Filter rows of test_scan_with_coprocessor like data sets, the compiled expression selects the rows of row by row.
+TEST_F(CoprocessorExpressionTest, RowByRow) {
+  const size_t batch_size = 1024;
+
+  ColumnBatch batch;
+  butil::Status ok = batch.Open(Types(), batch_size);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  for (size_t i = 0; i < batch_size; i++) {
+    AppendRow(batch, i % 2 == 0, static_cast<int32_t>(i), static_cast<float>(i) / 3,
+              i % 100 == 0 ? std::nullopt : std::optional<int64_t>(i * 1000), static_cast<double>(i) / 7,
+              "name_" + std::to_string(i % 16));
+  }
+
+  struct Case {
+    std::string name;
+    std::string code;
+    // row by row version of the expression
+    std::function<bool(const std::vector<std::any>&)> row_filter;
+  };
+
+  auto get_long = [](const std::vector<std::any>& record, int index) {
+    return std::any_cast<std::optional<int64_t>>(record[index]);
+  };
+  auto get_int = [](const std::vector<std::any>& record, int index) {
+    return std::any_cast<std::optional<int32_t>>(record[index]);
+  };
+  auto get_string = [](const std::vector<std::any>& record, int index) {
+    return std::any_cast<std::optional<std::shared_ptr<std::string>>>(record[index]);
+  };
+
+  std::vector<Case> cases = {
+      {"l > 500000", Var(kTypeInt64, 3) + Const(kTypeInt64, 500000) + Op(kGt, kTypeInt64),
+       [&](const std::vector<std::any>& record) {
+         auto l = get_long(record, 3);
+         return l.has_value() && l.value() > 500000;
+       }},
+      {"i < 100 and s = 'name_3'",
+       Var(kTypeInt32, 1) + Const(kTypeInt32, 100) + Op(kLt, kTypeInt32) + Var(kTypeString, 5) +
+           ConstString("name_3") + Op(kEq, kTypeString) + Op(kAnd),
+       [&](const std::vector<std::any>& record) {
+         auto i = get_int(record, 1);
+         auto s = get_string(record, 5);
+         return i.has_value() && i.value() < 100 && s.has_value() && *s.value() == "name_3";
+       }},
+      {"b or l + i > 1000000",
+       Var(kTypeBool, 0) + Var(kTypeInt64, 3) + Var(kTypeInt32, 1) +
+           Op(kCast, static_cast<char>(kTypeInt64 << 4 | kTypeInt32)) + Op(kAdd, kTypeInt64) +
+           Const(kTypeInt64, 1000000) + Op(kGt, kTypeInt64) + Op(kOr),
+       [&](const std::vector<std::any>& record) {
+         auto b = std::any_cast<std::optional<bool>>(record[0]);
+         if (b.has_value() && b.value()) {
+           return true;
+         }
+         auto l = get_long(record, 3);
+         auto i = get_int(record, 1);
+         return l.has_value() && i.has_value() && l.value() + i.value() > 1000000;
+       }},
+  };
+
+  for (const auto& c : cases) {
+    Expression expression;
+    ok = expression.Compile(c.code, Types());
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<uint32_t> rows;
+    ok = expression.Filter(batch, rows);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<std::any> record;
+    std::vector<uint32_t> expect_rows;
+    for (uint32_t row = 0; row < batch.Size(); row++) {
+      batch.GetRecord(row, record);
+      if (c.row_filter(record)) {
+        expect_rows.push_back(row);
+      }
+    }
+
+    EXPECT_EQ(expect_rows, rows) << c.name;
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,193 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "coprocessor/top_n.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class CoprocessorTopNTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {}
+
+  static void TearDownTestSuite() {}
+
+  void SetUp() override {}
+
+  void TearDown() override {}
+
+  static void AddOrderBy(::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy>& order_by_columns,
+                         int index, bool desc) {
+    pb::store::Coprocessor::OrderBy order_by;
+    order_by.set_index_of_column(index);
+    order_by.set_desc(desc);
+    order_by_columns.Add(std::move(order_by));
+  }
+
+  static std::vector<std::any> Record(std::optional<int64_t> l, std::optional<std::string> s) {
+    std::vector<std::any> record;
+    record.emplace_back(l);
+    record.emplace_back(s.has_value() ? std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(*s))
+                                      : std::optional<std::shared_ptr<std::string>>(std::nullopt));
+    return record;
+  }
+
+  // push records to top n, the value of result kv is the index of record.
+  static std::vector<std::string> Execute(TopN& top_n, const std::vector<std::vector<std::any>>& records,
+                                          size_t begin = 0, size_t end = SIZE_MAX) {
+    for (size_t i = begin; i < records.size() && i < end; i++) {
+      std::string sort_key;
+      butil::Status ok = top_n.EncodeSortKey(records[i], sort_key);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      if (!top_n.Accept(sort_key)) {
+        continue;
+      }
+      pb::common::KeyValue kv;
+      kv.set_value(std::to_string(i));
+      top_n.Push(std::move(sort_key), std::move(kv));
+    }
+
+    top_n.Finish();
+    std::vector<std::string> result;
+    for (size_t i = 0; i < top_n.Size(); i++) {
+      result.push_back(top_n.Get(i).value());
+    }
+    return result;
+  }
+};
+
+TEST_F(CoprocessorTopNTest, Open) {
+  std::vector<BaseSchema::Type> types = {BaseSchema::kLong, BaseSchema::kString};
+  ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy> order_by_columns;
+  AddOrderBy(order_by_columns, 0, false);
+
+  TopN top_n;
+  butil::Status ok = top_n.Open(order_by_columns, types, 0);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+
+  AddOrderBy(order_by_columns, 2, false);
+  ok = top_n.Open(order_by_columns, types, 10);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+
+  order_by_columns.RemoveLast();
+  ok = top_n.Open(order_by_columns, types, 10);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+}
+
+TEST_F(CoprocessorTopNTest, OrderByLong) {
+  std::vector<BaseSchema::Type> types = {BaseSchema::kLong, BaseSchema::kString};
+  std::vector<std::vector<std::any>> records = {Record(5, "a"),  Record(-3, "b"),          Record(100, "c"),
+                                                Record(0, "d"),  Record(std::nullopt, "e"), Record(-3, "f"),
+                                                Record(42, "g"), Record(-100000000000, "h")};
+
+  // asc, null first, same key keep scan order
+  {
+    ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy> order_by_columns;
+    AddOrderBy(order_by_columns, 0, false);
+    TopN top_n;
+    butil::Status ok = top_n.Open(order_by_columns, types, 4);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<std::string> expect = {"4", "7", "1", "5"};
+    EXPECT_EQ(expect, Execute(top_n, records));
+  }
+
+  // desc, null last
+  {
+    ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy> order_by_columns;
+    AddOrderBy(order_by_columns, 0, true);
+    TopN top_n;
+    butil::Status ok = top_n.Open(order_by_columns, types, 3);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<std::string> expect = {"2", "6", "0"};
+    EXPECT_EQ(expect, Execute(top_n, records));
+  }
+
+  // limit more than rows
+  {
+    ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy> order_by_columns;
+    AddOrderBy(order_by_columns, 0, true);
+    TopN top_n;
+    butil::Status ok = top_n.Open(order_by_columns, types, 100);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+    std::vector<std::string> expect = {"2", "6", "0", "3", "1", "5", "7", "4"};
+    EXPECT_EQ(expect, Execute(top_n, records));
+  }
+}
+
+TEST_F(CoprocessorTopNTest, OrderByMultiColumn) {
+  std::vector<BaseSchema::Type> types = {BaseSchema::kLong, BaseSchema::kString};
+  std::vector<std::vector<std::any>> records = {
+      Record(1, "abcdefghij"), Record(1, "abcdefgh"), Record(2, "b"),  Record(1, std::nullopt),
+      Record(1, "abd"),        Record(2, "a"),        Record(1, ""),   Record(2, "abcdefghijklmnopq")};
+
+  // long asc, string desc
+  ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy> order_by_columns;
+  AddOrderBy(order_by_columns, 0, false);
+  AddOrderBy(order_by_columns, 1, true);
+  TopN top_n;
+  butil::Status ok = top_n.Open(order_by_columns, types, 6);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::vector<std::string> expect = {"4", "0", "1", "6", "3", "2"};
+  EXPECT_EQ(expect, Execute(top_n, records));
+}
+
+// top n of sub-ranges merged in scan order, same as top n of the whole range
+TEST_F(CoprocessorTopNTest, Merge) {
+  std::vector<BaseSchema::Type> types = {BaseSchema::kLong, BaseSchema::kString};
+  std::vector<std::vector<std::any>> records = {Record(5, "a"),  Record(-3, "b"),          Record(100, "c"),
+                                                Record(0, "d"),  Record(std::nullopt, "e"), Record(-3, "f"),
+                                                Record(42, "g"), Record(-100000000000, "h")};
+
+  ::google::protobuf::RepeatedPtrField<pb::store::Coprocessor::OrderBy> order_by_columns;
+  AddOrderBy(order_by_columns, 0, false);
+
+  TopN partial1;
+  butil::Status ok = partial1.Open(order_by_columns, types, 4);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  Execute(partial1, records, 0, 4);
+
+  TopN partial2;
+  ok = partial2.Open(order_by_columns, types, 4);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  Execute(partial2, records, 4);
+
+  TopN top_n;
+  ok = top_n.Open(order_by_columns, types, 4);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  top_n.Merge(&partial1);
+  top_n.Merge(&partial2);
+  EXPECT_EQ(partial1.Size(), 0);
+  EXPECT_EQ(partial2.Size(), 0);
+
+  std::vector<std::string> expect = {"4", "7", "1", "5"};
+  EXPECT_EQ(expect, Execute(top_n, records, 0, 0));
+}
+
+}  // namespace dingodb
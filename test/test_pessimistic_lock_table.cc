@@ -0,0 +1,134 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "engine/pessimistic_lock_table.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class PessimisticLockTableTest : public testing::Test {
+ protected:
+  void TearDown() override { PessimisticLockTable::GetInstance().EraseRange("", "\xff"); }
+
+  static pb::store::LockInfo GenLockInfo(const std::string& key, int64_t lock_ts, int64_t for_update_ts) {
+    pb::store::LockInfo lock_info;
+    lock_info.set_key(key);
+    lock_info.set_primary_lock(key);
+    lock_info.set_lock_ts(lock_ts);
+    lock_info.set_for_update_ts(for_update_ts);
+    lock_info.set_lock_type(pb::store::Op::Lock);
+    return lock_info;
+  }
+};
+
+TEST_F(PessimisticLockTableTest, PutGetErase) {
+  auto& table = PessimisticLockTable::GetInstance();
+  pb::store::LockInfo lock_info;
+  EXPECT_FALSE(table.Get("key1", lock_info));
+
+  table.Put(GenLockInfo("key1", 100, 101));
+  ASSERT_TRUE(table.Get("key1", lock_info));
+  EXPECT_EQ(101, lock_info.for_update_ts());
+  EXPECT_EQ(1, table.Size());
+
+  // the same txn with a new for_update_ts
+  table.Put(GenLockInfo("key1", 100, 105));
+  ASSERT_TRUE(table.Get("key1", lock_info));
+  EXPECT_EQ(105, lock_info.for_update_ts());
+  EXPECT_EQ(1, table.Size());
+
+  table.Erase("key1");
+  EXPECT_FALSE(table.Get("key1", lock_info));
+  EXPECT_EQ(0, table.Size());
+}
+
+TEST_F(PessimisticLockTableTest, Range) {
+  auto& table = PessimisticLockTable::GetInstance();
+  table.Put(GenLockInfo("a1", 100, 101));
+  table.Put(GenLockInfo("b1", 100, 101));
+  table.Put(GenLockInfo("b2", 100, 101));
+  table.Put(GenLockInfo("c1", 100, 101));
+
+  EXPECT_EQ(2, table.GetLocks("b", "c").size());
+  EXPECT_EQ(3, table.GetLocks("a", "c").size());
+
+  table.EraseRange("b", "c");
+  EXPECT_EQ(2, table.Size());
+  EXPECT_TRUE(table.GetLocks("b", "c").empty());
+}
+
+TEST_F(PessimisticLockTableTest, EraseIfMatch) {
+  auto& table = PessimisticLockTable::GetInstance();
+  table.Put(GenLockInfo("key1", 100, 105));
+
+  // the lock of other txn, or of an older for_update_ts of the same txn, is kept
+  EXPECT_FALSE(table.EraseIfMatch("key1", 200, 105));
+  EXPECT_FALSE(table.EraseIfMatch("key1", 100, 101));
+  EXPECT_FALSE(table.EraseIfMatch("key2", 100, 105));
+  EXPECT_EQ(1, table.Size());
+
+  EXPECT_TRUE(table.EraseIfMatch("key1", 100, 105));
+  pb::store::LockInfo lock_info;
+  EXPECT_FALSE(table.Get("key1", lock_info));
+  EXPECT_EQ(0, table.Size());
+}
+
+// A flush of pessimistic locks runs while a 1PC write is in flight.
+TEST_F(PessimisticLockTableTest, OnePcLock) {
+  auto& table = PessimisticLockTable::GetInstance();
+  // key1 is locked by the pessimistic lock of the txn before its 1PC prewrite
+  table.Put(GenLockInfo("key1", 100, 105));
+  auto one_pc_lock1 = GenLockInfo("key1", 100, 105);
+  one_pc_lock1.set_lock_type(pb::store::Op::Put);
+  auto one_pc_lock2 = GenLockInfo("key2", 100, 0);
+  one_pc_lock2.set_lock_type(pb::store::Op::Put);
+  table.PutOnePcLock(one_pc_lock1);
+  table.PutOnePcLock(one_pc_lock2);
+  EXPECT_EQ(3, table.Size());
+
+  // the readers see the 1PC locks
+  pb::store::LockInfo lock_info;
+  ASSERT_TRUE(table.Get("key1", lock_info));
+  EXPECT_EQ(pb::store::Op::Put, lock_info.lock_type());
+  ASSERT_TRUE(table.Get("key2", lock_info));
+  EXPECT_EQ(pb::store::Op::Put, lock_info.lock_type());
+  EXPECT_EQ(2, table.GetLocks("key", "kez").size());
+
+  // the flush reads only the pessimistic lock
+  auto flush_locks = table.GetPessimisticLocks("key", "kez");
+  ASSERT_EQ(1, flush_locks.size());
+  EXPECT_EQ("key1", flush_locks[0].key());
+  EXPECT_EQ(pb::store::Op::Lock, flush_locks[0].lock_type());
+  EXPECT_FALSE(table.GetPessimisticLock("key2", lock_info));
+
+  // the applied flush erases the pessimistic lock, the 1PC locks are kept until the 1PC write is done
+  EXPECT_TRUE(table.EraseIfMatch("key1", 100, 105));
+  EXPECT_FALSE(table.EraseIfMatch("key2", 100, 0));
+  ASSERT_TRUE(table.Get("key1", lock_info));
+  EXPECT_EQ(pb::store::Op::Put, lock_info.lock_type());
+  EXPECT_EQ(2, table.Size());
+
+  table.EraseOnePcLock("key1");
+  table.EraseOnePcLock("key2");
+  EXPECT_FALSE(table.Get("key1", lock_info));
+  EXPECT_FALSE(table.Get("key2", lock_info));
+  EXPECT_EQ(0, table.Size());
+}
+
+}  // namespace dingodb
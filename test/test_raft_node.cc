@@ -58,7 +58,6 @@ const std::string kYamlConfigContent =
     "  path: ./rocks_example\n"
     "  base:\n"
     "    block_size: 131072\n"
-    "    block_cache: 67108864\n"
     "    arena_block_size: 67108864\n"
     "    min_write_buffer_number_to_merge: 4\n"
     "    max_write_buffer_number: 4\n"
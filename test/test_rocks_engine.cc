@@ -612,6 +612,39 @@ TEST_F(RawRocksEngineTest, KvGet) {
   }
 }
 
+TEST_F(RawRocksEngineTest, KvBatchGet) {
+  const std::string &cf_name = kDefaultCf;
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  // key empty
+  {
+    std::vector<std::string> keys = {"key1", ""};
+    std::vector<pb::common::KeyValue> kvs;
+
+    butil::Status ok = reader->KvBatchGet(cf_name, keys, kvs);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // the found keys are in the order of keys, the missing keys are skipped
+  {
+    std::vector<std::string> keys = {"key2", "not_found_key", "key1"};
+    std::vector<pb::common::KeyValue> kvs;
+
+    butil::Status ok = reader->KvBatchGet(cf_name, keys, kvs);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(kvs.size(), 2);
+    EXPECT_EQ(kvs[0].key(), "key2");
+    EXPECT_EQ(kvs[1].key(), "key1");
+
+    for (const auto &kv : kvs) {
+      std::string value;
+      ok = reader->KvGet(cf_name, kv.key(), value);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      EXPECT_EQ(kv.value(), value);
+    }
+  }
+}
+
 TEST_F(RawRocksEngineTest, KvCompareAndSet) {
   const std::string &cf_name = kDefaultCf;
   auto writer = RawRocksEngineTest::engine->Writer();
@@ -2573,6 +2606,73 @@ TEST_F(RawRocksEngineTest, Iterator) {
   EXPECT_GE(count, 1);
 }
 
+TEST_F(RawRocksEngineTest, RegionSstPartitioner) {
+  rocks::RegionSstPartitioner partitioner({"bb", "dd"});
+
+  auto should_partition = [&partitioner](const std::string &prev_key, const std::string &current_key) {
+    rocksdb::Slice prev_user_key(prev_key);
+    rocksdb::Slice current_user_key(current_key);
+    rocksdb::PartitionerRequest request(prev_user_key, current_user_key, 0);
+    return partitioner.ShouldPartition(request) == rocksdb::kRequired;
+  };
+
+  EXPECT_FALSE(should_partition("aa", "ab"));
+  // the boundary is the first key of the next file
+  EXPECT_TRUE(should_partition("ba", "bb"));
+  EXPECT_FALSE(should_partition("bb", "bc"));
+  EXPECT_TRUE(should_partition("bc", "ee"));
+  EXPECT_FALSE(should_partition("de", "ee"));
+
+  EXPECT_TRUE(partitioner.CanDoTrivialMove("bb", "cc"));
+  EXPECT_FALSE(partitioner.CanDoTrivialMove("aa", "bb"));
+  EXPECT_FALSE(partitioner.CanDoTrivialMove("cc", "ee"));
+}
+
+TEST_F(RawRocksEngineTest, IngestExternalFiles) {
+  const std::string sst_path = kRootPath + "/ingest";
+  Helper::CreateDirectories(sst_path);
+
+  auto write_sst_file = [&](const std::string &filename, const std::string &key_prefix) {
+    std::vector<pb::common::KeyValue> kvs;
+    for (int i = 0; i < 10; ++i) {
+      pb::common::KeyValue kv;
+      kv.set_key(key_prefix + std::to_string(i));
+      kv.set_value("value" + std::to_string(i));
+      kvs.push_back(kv);
+    }
+
+    rocks::SstFileWriter writer(rocksdb::Options{});
+    EXPECT_TRUE(writer.SaveFile(kvs, filename).ok());
+  };
+
+  std::string file1 = sst_path + "/ingest_1.sst";
+  std::string file2 = sst_path + "/ingest_2.sst";
+  write_sst_file(file1, "ingest_a");
+  write_sst_file(file2, "ingest_b");
+
+  auto reader = RawRocksEngineTest::engine->Reader();
+  std::string value;
+
+  // One missing file fails the whole ingest, nothing is visible.
+  auto status = RawRocksEngineTest::engine->IngestExternalFiles(
+      {{kDefaultCf, {file1, sst_path + "/ingest_not_exist.sst"}}});
+  EXPECT_FALSE(status.ok());
+  EXPECT_FALSE(reader->KvGet(kDefaultCf, "ingest_a0", value).ok());
+
+  status = RawRocksEngineTest::engine->IngestExternalFiles({{kDefaultCf, {file1, file2}}});
+  EXPECT_TRUE(status.ok());
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, "ingest_a9", value).ok());
+  EXPECT_EQ("value9", value);
+  EXPECT_TRUE(reader->KvGet(kDefaultCf, "ingest_b0", value).ok());
+  EXPECT_EQ("value0", value);
+
+  // The source files are copied, not moved.
+  EXPECT_TRUE(Helper::IsExistPath(file1));
+  EXPECT_TRUE(Helper::IsExistPath(file2));
+
+  Helper::RemoveAllFileOrDirectory(sst_path);
+}
+
 // TEST_F(RawRocksEngineTest, Checkpoint) {
 //   auto writer = RawRocksEngineTest::engine->Writer();
 
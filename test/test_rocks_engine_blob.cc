@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/iterator.h"
+#include "engine/raw_rocks_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {  // NOLINT
+
+static const std::string kDefaultCf = "default";
+
+static const std::vector<std::string> kAllCFs = {kDefaultCf};
+
+const std::string kRootPath = "./unit_test_blob";
+const std::string kStorePath = kRootPath + "/db";
+
+const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "log:\n"
+    "  path: " +
+    kRootPath +
+    "/log\n"
+    "store:\n"
+    "  path: " +
+    kStorePath +
+    "\n"
+    "  default:\n"
+    "    enable_blob_files: true\n"
+    "    min_blob_size: 1024\n";
+
+class RawRocksEngineBlobTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kStorePath);
+
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kYamlConfigContent));
+
+    engine = std::make_shared<RawRocksEngine>();
+    ASSERT_TRUE(engine->Init(config, kAllCFs));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  static int BlobFileCount() {
+    int count = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(kStorePath)) {
+      if (entry.path().extension() == ".blob") {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  // the large values go to blob files, the small values stay inline
+  static std::string GenValue(int i, int round) {
+    size_t size = (i % 2 == 0) ? 4096 : 100;
+    return std::string(size, static_cast<char>('a' + (i + round) % 26));
+  }
+
+  static std::shared_ptr<RawRocksEngine> engine;
+};
+
+std::shared_ptr<RawRocksEngine> RawRocksEngineBlobTest::engine = nullptr;
+
+TEST_F(RawRocksEngineBlobTest, ReadWrite) {
+  const int kCount = 100;
+  auto writer = engine->Writer();
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < kCount; ++i) {
+      pb::common::KeyValue kv;
+      kv.set_key(fmt::format("key{:06}", i));
+      kv.set_value(GenValue(i, round));
+      ASSERT_TRUE(writer->KvPut(kDefaultCf, kv).ok());
+    }
+    engine->Flush(kDefaultCf);
+  }
+  EXPECT_GT(BlobFileCount(), 0);
+
+  ASSERT_TRUE(engine->Compact(kDefaultCf).ok());
+
+  auto reader = engine->Reader();
+  for (int i = 0; i < kCount; ++i) {
+    std::string value;
+    ASSERT_TRUE(reader->KvGet(kDefaultCf, fmt::format("key{:06}", i), value).ok());
+    EXPECT_EQ(GenValue(i, 1), value);
+  }
+
+  int count = 0;
+  IteratorOptions options;
+  options.upper_bound = "kez";
+  auto iter = reader->NewIterator(kDefaultCf, options);
+  for (iter->Seek("key"); iter->Valid(); iter->Next()) {
+    EXPECT_EQ(fmt::format("key{:06}", count), iter->Key());
+    EXPECT_EQ(GenValue(count, 1), iter->Value());
+    ++count;
+  }
+  EXPECT_EQ(kCount, count);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,169 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/store_internal.pb.h"
+
+namespace dingodb {  // NOLINT
+
+static const std::string kDefaultCf = "default";
+
+static const std::vector<std::string> kAllCFs = {kDefaultCf, Constant::kStoreMetaCF};
+
+const std::string kRootPath = "./unit_test_disable_wal";
+const std::string kStorePath = kRootPath + "/db";
+// the files of kStorePath copied without close, as they are after a crash
+const std::string kCrashStorePath = kRootPath + "/crash_db";
+
+// The raft log is replayed from the persisted applied index after a crash, as the state machine does.
+class RawRocksEngineDisableWalTest : public testing::Test {
+ protected:
+  static constexpr int64_t kRegionId = 1;
+  static constexpr int kSaveAppliedIndexStep = 10;
+
+  static void SetUpTestSuite() {
+    FLAGS_rocksdb_disable_wal = true;
+    Helper::CreateDirectories(kStorePath);
+  }
+
+  static void TearDownTestSuite() {
+    FLAGS_rocksdb_disable_wal = false;
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  static std::shared_ptr<RawRocksEngine> OpenEngine(const std::string& store_path) {
+    auto config = std::make_shared<YamlConfig>();
+    std::string content = fmt::format(
+        "cluster:\n"
+        "  name: dingodb\n"
+        "  instance_id: 12345\n"
+        "log:\n"
+        "  path: {}/log\n"
+        "store:\n"
+        "  path: {}\n",
+        kRootPath, store_path);
+    if (config->Load(content) != 0) {
+      return nullptr;
+    }
+
+    auto engine = std::make_shared<RawRocksEngine>();
+    if (!engine->Init(config, kAllCFs)) {
+      return nullptr;
+    }
+    return engine;
+  }
+
+  static std::string GenKey(int64_t log_index) { return fmt::format("key{:06}", log_index); }
+
+  static std::string RaftMetaKey() { return fmt::format("{}_{}", Constant::kStoreRaftMetaPrefix, kRegionId); }
+
+  // Apply the raft log of [start_index, end_index], the applied index is saved every kSaveAppliedIndexStep entries.
+  static void Apply(std::shared_ptr<RawRocksEngine> engine, int64_t start_index, int64_t end_index) {
+    for (int64_t index = start_index; index <= end_index; ++index) {
+      pb::common::KeyValue kv;
+      kv.set_key(GenKey(index));
+      kv.set_value(std::to_string(index));
+      ASSERT_TRUE(engine->Writer()->KvPut(kDefaultCf, kv).ok());
+
+      if (index % kSaveAppliedIndexStep == 0) {
+        pb::store_internal::RaftMeta raft_meta;
+        raft_meta.set_region_id(kRegionId);
+        raft_meta.set_applied_index(index);
+        pb::common::KeyValue meta_kv;
+        meta_kv.set_key(RaftMetaKey());
+        meta_kv.set_value(raft_meta.SerializeAsString());
+        ASSERT_TRUE(engine->PutWithoutWal(Constant::kStoreMetaCF, meta_kv).ok());
+      }
+    }
+  }
+
+  static int64_t GetAppliedIndex(std::shared_ptr<RawRocksEngine> engine) {
+    std::string value;
+    if (!engine->Reader()->KvGet(Constant::kStoreMetaCF, RaftMetaKey(), value).ok()) {
+      return 0;
+    }
+    pb::store_internal::RaftMeta raft_meta;
+    raft_meta.ParseFromString(value);
+    return raft_meta.applied_index();
+  }
+
+  static bool IsApplied(std::shared_ptr<RawRocksEngine> engine, int64_t log_index) {
+    std::string value;
+    return engine->Reader()->KvGet(kDefaultCf, GenKey(log_index), value).ok() && value == std::to_string(log_index);
+  }
+};
+
+TEST_F(RawRocksEngineDisableWalTest, RestartReplay) {
+  auto engine = OpenEngine(kStorePath);
+  ASSERT_NE(nullptr, engine);
+
+  // persisted by flush with the applied index 20
+  Apply(engine, 1, 25);
+  ASSERT_TRUE(engine->FlushUnpersisted({kDefaultCf}).ok());
+
+  // lost by crash, the applied index 30 and 40 too
+  Apply(engine, 26, 43);
+
+  // the region meta keeps wal
+  pb::common::KeyValue region_kv;
+  region_kv.set_key(fmt::format("{}_{}", Constant::kStoreRegionMetaPrefix, kRegionId));
+  region_kv.set_value("region");
+  ASSERT_TRUE(engine->Writer()->KvPut(Constant::kStoreMetaCF, region_kv).ok());
+
+  std::filesystem::copy(kStorePath, kCrashStorePath, std::filesystem::copy_options::recursive);
+  engine->Close();
+  engine->Destroy();
+
+  auto crash_engine = OpenEngine(kCrashStorePath);
+  ASSERT_NE(nullptr, crash_engine);
+
+  std::string value;
+  EXPECT_TRUE(crash_engine->Reader()->KvGet(Constant::kStoreMetaCF, region_kv.key(), value).ok());
+  EXPECT_EQ("region", value);
+
+  // every entry up to the persisted applied index is in the engine
+  int64_t applied_index = GetAppliedIndex(crash_engine);
+  EXPECT_EQ(20, applied_index);
+  for (int64_t index = 1; index <= applied_index; ++index) {
+    EXPECT_TRUE(IsApplied(crash_engine, index)) << index;
+  }
+  EXPECT_FALSE(IsApplied(crash_engine, 26));
+
+  // replay the raft log after the applied index, 21-25 are applied twice
+  Apply(crash_engine, applied_index + 1, 43);
+  for (int64_t index = 1; index <= 43; ++index) {
+    EXPECT_TRUE(IsApplied(crash_engine, index)) << index;
+  }
+  EXPECT_EQ(40, GetAppliedIndex(crash_engine));
+
+  crash_engine->Close();
+  crash_engine->Destroy();
+}
+
+}  // namespace dingodb
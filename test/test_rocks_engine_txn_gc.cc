@@ -0,0 +1,212 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+static const std::vector<std::string> kAllCFs = {Constant::kStoreMetaCF, Constant::kTxnDataCF, Constant::kTxnLockCF,
+                                                 Constant::kTxnWriteCF};
+
+const std::string kRootPath = "./unit_test_txn_gc";
+const std::string kStorePath = kRootPath + "/db";
+// the files of kStorePath copied without close, as they are after a crash
+const std::string kRestartStorePath = kRootPath + "/restart_db";
+
+class RawRocksEngineTxnGcTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kStorePath);
+    engine = OpenEngine(kStorePath);
+    ASSERT_NE(nullptr, engine);
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  static std::shared_ptr<RawRocksEngine> OpenEngine(const std::string& store_path) {
+    auto config = std::make_shared<YamlConfig>();
+    std::string content = fmt::format(
+        "cluster:\n"
+        "  name: dingodb\n"
+        "  instance_id: 12345\n"
+        "log:\n"
+        "  path: {}/log\n"
+        "store:\n"
+        "  path: {}\n",
+        kRootPath, store_path);
+    if (config->Load(content) != 0) {
+      return nullptr;
+    }
+
+    auto raw_engine = std::make_shared<RawRocksEngine>();
+    if (!raw_engine->Init(config, kAllCFs)) {
+      return nullptr;
+    }
+    return raw_engine;
+  }
+
+  static void Put(const std::string& cf_name, const std::string& key, const std::string& value) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    ASSERT_TRUE(engine->Writer()->KvPut(cf_name, kv).ok());
+  }
+
+  // prewrite
+  static void PutData(const std::string& key, int64_t start_ts) {
+    Put(Constant::kTxnDataCF, Helper::EncodeTxnKey(key, start_ts), fmt::format("{}_{}", key, start_ts));
+  }
+
+  static void PutLock(const std::string& key, int64_t start_ts) {
+    pb::store::LockInfo lock_info;
+    lock_info.set_primary_lock(key);
+    lock_info.set_key(key);
+    lock_info.set_lock_ts(start_ts);
+    Put(Constant::kTxnLockCF, Helper::EncodeTxnKey(key, Constant::kLockVer), lock_info.SerializeAsString());
+  }
+
+  // commit or rollback
+  static void PutWrite(const std::string& key, int64_t commit_ts, int64_t start_ts, pb::store::Op op) {
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(op);
+    Put(Constant::kTxnWriteCF, Helper::EncodeTxnKey(key, commit_ts), write_info.SerializeAsString());
+  }
+
+  static bool Exist(const std::string& cf_name, const std::string& key, int64_t ts) {
+    std::string value;
+    return engine->Reader()->KvGet(cf_name, Helper::EncodeTxnKey(key, ts), value).ok();
+  }
+
+  static std::shared_ptr<RawRocksEngine> engine;
+};
+
+std::shared_ptr<RawRocksEngine> RawRocksEngineTxnGcTest::engine = nullptr;
+
+TEST_F(RawRocksEngineTxnGcTest, CompactionFilter) {
+  // key1, the put at 90 is the newest before the safe point
+  PutData("key1", 60);
+  PutWrite("key1", 70, 60, pb::store::Op::Put);
+  PutData("key1", 80);
+  PutWrite("key1", 90, 80, pb::store::Op::Put);
+  PutWrite("key1", 95, 95, pb::store::Op::Rollback);
+  PutData("key1", 110);
+  PutWrite("key1", 120, 110, pb::store::Op::Put);
+
+  // key2, locked and rolled back txns before the safe point
+  PutData("key2", 40);
+  PutData("key2", 50);
+  PutLock("key2", 50);
+
+  // key3, committed after the safe point
+  PutData("key3", 40);
+  PutWrite("key3", 50, 40, pb::store::Op::Put);
+  PutData("key3", 90);
+  PutWrite("key3", 110, 90, pb::store::Op::Put);
+
+  // key10 has key1 as prefix, it is skipped when the versions of key1 are checked
+  PutData("key10", 30);
+  PutWrite("key10", 35, 30, pb::store::Op::Delete);
+
+  ASSERT_TRUE(engine->UpdateTxnGcSafePoint(100).ok());
+  ASSERT_TRUE(engine->Compact(Constant::kTxnWriteCF).ok());
+  ASSERT_TRUE(engine->Compact(Constant::kTxnDataCF).ok());
+
+  EXPECT_FALSE(Exist(Constant::kTxnWriteCF, "key1", 70));
+  EXPECT_FALSE(Exist(Constant::kTxnDataCF, "key1", 60));
+  EXPECT_TRUE(Exist(Constant::kTxnWriteCF, "key1", 90));
+  EXPECT_TRUE(Exist(Constant::kTxnDataCF, "key1", 80));
+  EXPECT_FALSE(Exist(Constant::kTxnWriteCF, "key1", 95));
+  EXPECT_TRUE(Exist(Constant::kTxnWriteCF, "key1", 120));
+  EXPECT_TRUE(Exist(Constant::kTxnDataCF, "key1", 110));
+
+  EXPECT_FALSE(Exist(Constant::kTxnDataCF, "key2", 40));
+  EXPECT_TRUE(Exist(Constant::kTxnDataCF, "key2", 50));
+
+  EXPECT_TRUE(Exist(Constant::kTxnWriteCF, "key3", 50));
+  EXPECT_TRUE(Exist(Constant::kTxnDataCF, "key3", 40));
+  EXPECT_TRUE(Exist(Constant::kTxnWriteCF, "key3", 110));
+  EXPECT_TRUE(Exist(Constant::kTxnDataCF, "key3", 90));
+
+  // the value of a delete is never read
+  EXPECT_TRUE(Exist(Constant::kTxnWriteCF, "key10", 35));
+  EXPECT_FALSE(Exist(Constant::kTxnDataCF, "key10", 30));
+}
+
+TEST_F(RawRocksEngineTxnGcTest, SafePointRestart) {
+  ASSERT_TRUE(engine->UpdateTxnGcSafePoint(200).ok());
+  // never moves back
+  ASSERT_TRUE(engine->UpdateTxnGcSafePoint(150).ok());
+  EXPECT_EQ(200, engine->GetTxnGcSafePoint());
+
+  std::filesystem::copy(kStorePath, kRestartStorePath, std::filesystem::copy_options::recursive);
+  auto restart_engine = OpenEngine(kRestartStorePath);
+  ASSERT_NE(nullptr, restart_engine);
+  EXPECT_EQ(200, restart_engine->GetTxnGcSafePoint());
+
+  restart_engine->Close();
+  restart_engine->Destroy();
+}
+
+TEST_F(RawRocksEngineTxnGcTest, RejectReadBeforeSafePoint) {
+  ASSERT_TRUE(engine->UpdateTxnGcSafePoint(200).ok());
+
+  std::vector<std::string> keys = {"key1"};
+  std::vector<pb::common::KeyValue> kvs;
+  pb::store::TxnResultInfo txn_result_info;
+  auto ret = TxnEngineHelper::BatchGet(engine, pb::store::SnapshotIsolation, 150, keys, kvs, txn_result_info);
+  EXPECT_EQ(pb::error::Errno::ETXN_BEFORE_GC_SAFE_POINT, ret.error_code());
+
+  ret = TxnEngineHelper::BatchGet(engine, pb::store::SnapshotIsolation, 250, keys, kvs, txn_result_info);
+  EXPECT_TRUE(ret.ok());
+
+  // read committed reads the latest versions
+  kvs.clear();
+  txn_result_info.Clear();
+  ret = TxnEngineHelper::BatchGet(engine, pb::store::ReadCommitted, 150, keys, kvs, txn_result_info);
+  EXPECT_TRUE(ret.ok());
+
+  pb::common::Range range;
+  range.set_start_key("key");
+  range.set_end_key("kez");
+  bool has_more = false;
+  std::string end_key;
+  kvs.clear();
+  txn_result_info.Clear();
+  ret = TxnEngineHelper::Scan(engine, pb::store::SnapshotIsolation, 150, range, 10, false, false, txn_result_info, kvs,
+                              has_more, end_key);
+  EXPECT_EQ(pb::error::Errno::ETXN_BEFORE_GC_SAFE_POINT, ret.error_code());
+}
+
+}  // namespace dingodb
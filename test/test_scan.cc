@@ -18,6 +18,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -30,12 +31,15 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "common/constant.h"
 #include "config/config_manager.h"
+#include "engine/key_value_sink.h"
 #include "engine/raw_rocks_engine.h"
 #include "proto/common.pb.h"
 #include "scan/scan.h"
 #include "scan/scan_manager.h"
+#include "scan/scan_stream.h"
 #include "server/server.h"
 
 namespace dingodb {
@@ -785,6 +789,212 @@ TEST_F(ScanTest, scan) {
   this->DeleteScan();
 }
 
+// continue is served by the batch read ahead after the previous response, same kvs as one batch
+TEST_F(ScanTest, ScanPrefetch) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  std::string scan_id;
+
+  butil::Status ok;
+
+  int64_t region_id = 1;
+  pb::common::Range range;
+  range.set_start_key("keyAA");
+  range.set_end_key("keyZZ");
+
+  std::vector<pb::common::KeyValue> all_kvs;
+  {
+    this->DeleteScan();
+    auto scan = this->GetScan(&scan_id);
+    ok = scan->Open(scan_id, raw_rocks_engine, kDefaultCf);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+    ok = ScanHandler::ScanBegin(scan, region_id, range, 1000, false, true, true, {}, &all_kvs);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    ok = ScanHandler::ScanRelease(scan, scan_id);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    this->DeleteScan();
+  }
+
+  auto scan = this->GetScan(&scan_id);
+  ok = scan->Open(scan_id, raw_rocks_engine, kDefaultCf);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  int64_t max_fetch_cnt = 3;
+  std::vector<pb::common::KeyValue> kvs;
+  std::vector<pb::common::KeyValue> scan_kvs;
+  ok = ScanHandler::ScanBegin(scan, region_id, range, max_fetch_cnt, false, true, true, {}, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  while (!kvs.empty()) {
+    EXPECT_LE(kvs.size(), static_cast<size_t>(max_fetch_cnt));
+    scan_kvs.insert(scan_kvs.end(), kvs.begin(), kvs.end());
+    kvs.clear();
+    ok = ScanHandler::ScanContinue(scan, scan_id, max_fetch_cnt, &kvs);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  }
+
+  ASSERT_EQ(scan_kvs.size(), all_kvs.size());
+  for (size_t i = 0; i < all_kvs.size(); i++) {
+    EXPECT_EQ(scan_kvs[i].key(), all_kvs[i].key());
+    EXPECT_EQ(scan_kvs[i].value(), all_kvs[i].value());
+  }
+
+  ok = ScanHandler::ScanRelease(scan, scan_id);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(this->GetManager().GetPrefetchBytes(), 0);
+
+  this->DeleteScan();
+}
+
+// the read ahead batch of one kv larger than max_bytes_rpc charges the whole kv, and releases all of it when taken
+TEST_F(ScanTest, ScanPrefetchLargeKeyValue) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  std::string scan_id;
+
+  butil::Status ok;
+
+  const int64_t max_bytes_rpc = 1024;
+  auto &manager = this->GetManager();
+  ScanContext::Init(manager.GetTimeoutMs(), max_bytes_rpc, manager.GetMaxFetchCntByServer(),
+                    manager.GetMaxParallelism());
+
+  pb::common::KeyValue small_kv;
+  small_kv.set_key("prefetch_a");
+  small_kv.set_value("small");
+  pb::common::KeyValue large_kv;
+  large_kv.set_key("prefetch_b");
+  large_kv.set_value(std::string(64 * 1024, 'v'));
+  int64_t large_kv_bytes = large_kv.key().size() + large_kv.value().size();
+  ASSERT_GT(large_kv_bytes, max_bytes_rpc);
+  ok = raw_rocks_engine->Writer()->KvPut(kDefaultCf, small_kv);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  ok = raw_rocks_engine->Writer()->KvPut(kDefaultCf, large_kv);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  pb::common::Range range;
+  range.set_start_key("prefetch_");
+  range.set_end_key("prefetch_z");
+
+  this->DeleteScan();
+  auto scan = this->GetScan(&scan_id);
+  ok = scan->Open(scan_id, raw_rocks_engine, kDefaultCf);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  std::vector<pb::common::KeyValue> kvs;
+  ok = ScanHandler::ScanBegin(scan, 1, range, 1, false, true, true, {}, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  ASSERT_EQ(kvs.size(), 1);
+  EXPECT_EQ(kvs[0].key(), small_kv.key());
+
+  // the large kv is read ahead, the overshoot of the reservation is charged
+  for (int i = 0; i < 1000 && manager.GetPrefetchBytes() != large_kv_bytes; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(manager.GetPrefetchBytes(), large_kv_bytes);
+
+  kvs.clear();
+  ok = ScanHandler::ScanContinue(scan, scan_id, 1, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  ASSERT_EQ(kvs.size(), 1);
+  EXPECT_EQ(kvs[0].key(), large_kv.key());
+  EXPECT_EQ(kvs[0].value(), large_kv.value());
+
+  ok = ScanHandler::ScanRelease(scan, scan_id);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(manager.GetPrefetchBytes(), 0);
+
+  this->DeleteScan();
+  ScanContext::Init(manager.GetTimeoutMs(), manager.GetMaxBytesRpc(), manager.GetMaxFetchCntByServer(),
+                    manager.GetMaxParallelism());
+
+  pb::common::Range delete_range;
+  delete_range.set_start_key("prefetch_");
+  delete_range.set_end_key("prefetch_z");
+  ok = raw_rocks_engine->Writer()->KvDeleteRange(kDefaultCf, delete_range);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+}
+
+// kvs written from slices are parsed as KvScanStreamData, merged with the end flag appended
+TEST_F(ScanTest, ScanStreamWriteKeyValue) {
+  std::string data;
+  {
+    google::protobuf::io::StringOutputStream wrapper(&data);
+    google::protobuf::io::CodedOutputStream out(&wrapper);
+    ScanStream::WriteKeyValue("keyAA", "valueAA", &out);
+    ScanStream::WriteKeyValue(std::string(300, 'k'), "", &out);
+  }
+  pb::store::KvScanStreamData end_data;
+  end_data.set_end(true);
+  data += end_data.SerializeAsString();
+
+  pb::store::KvScanStreamData scan_data;
+  EXPECT_TRUE(scan_data.ParseFromString(data));
+  ASSERT_EQ(scan_data.kvs_size(), 2);
+  EXPECT_EQ(scan_data.kvs(0).key(), "keyAA");
+  EXPECT_EQ(scan_data.kvs(0).value(), "valueAA");
+  EXPECT_EQ(scan_data.kvs(1).key(), std::string(300, 'k'));
+  EXPECT_EQ(scan_data.kvs(1).value(), "");
+  EXPECT_TRUE(scan_data.end());
+}
+
+// kvs are appended to the response, same as the kvs of vector
+TEST_F(ScanTest, ScanToRepeatedKeyValueSink) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  auto reader = raw_rocks_engine->Reader();
+  const std::string &cf_name = kDefaultCf;
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  butil::Status ok = reader->KvScan(cf_name, "key", "keyZZZ", kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  pb::store::KvScanBeginResponse response;
+  RepeatedKeyValueSink sink(response.mutable_kvs());
+  ok = reader->KvScan(cf_name, raw_rocks_engine->GetSnapshot(), "key", "keyZZZ", &sink);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  ASSERT_EQ(static_cast<size_t>(response.kvs_size()), kvs.size());
+  for (size_t i = 0; i < kvs.size(); i++) {
+    EXPECT_EQ(response.kvs(i).key(), kvs[i].key());
+    EXPECT_EQ(response.kvs(i).value(), kvs[i].value());
+  }
+
+  sink.Append("keyZZZ", "value");
+  EXPECT_EQ(sink.Size(), kvs.size() + 1);
+  EXPECT_EQ(sink.Back()->key(), "keyZZZ");
+  EXPECT_EQ(response.kvs(response.kvs_size() - 1).value(), "value");
+}
+
+// sub-ranges are adjacent and cover the range
+TEST_F(ScanTest, SplitRange) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+
+  pb::common::Range range;
+  range.set_start_key("key");
+  range.set_end_key("keyZZZ");
+
+  auto sub_ranges = ScanContext::SplitRange(raw_rocks_engine, kDefaultCf, range, 1);
+  ASSERT_EQ(sub_ranges.size(), 1);
+  EXPECT_EQ(sub_ranges[0].start_key(), range.start_key());
+  EXPECT_EQ(sub_ranges[0].end_key(), range.end_key());
+
+  sub_ranges = ScanContext::SplitRange(raw_rocks_engine, kDefaultCf, range, 4);
+  ASSERT_GT(sub_ranges.size(), 1);
+  ASSERT_LE(sub_ranges.size(), 4);
+  EXPECT_EQ(sub_ranges.front().start_key(), range.start_key());
+  EXPECT_EQ(sub_ranges.back().end_key(), range.end_key());
+  for (size_t i = 0; i < sub_ranges.size(); i++) {
+    EXPECT_LT(sub_ranges[i].start_key(), sub_ranges[i].end_key());
+    if (i > 0) {
+      EXPECT_EQ(sub_ranges[i - 1].end_key(), sub_ranges[i].start_key());
+    }
+  }
+
+  // no key between start_key and end_key
+  range.set_end_key(std::string("key\0", 4));
+  sub_ranges = ScanContext::SplitRange(raw_rocks_engine, kDefaultCf, range, 4);
+  EXPECT_EQ(sub_ranges.size(), 1);
+}
+
 TEST_F(ScanTest, Init2) {
   auto raw_rocks_engine = this->GetRawRocksEngine();
   std::string scan_id;
@@ -0,0 +1,179 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <serial/record_decoder.h>
+#include <serial/record_encoder.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {  // NOLINT
+
+class SerialFormatTest : public testing::Test {
+ protected:
+  static const long kCommonId = 101;
+
+  template <typename T>
+  static std::shared_ptr<BaseSchema> NewSchema(int index, bool is_key, bool allow_null) {
+    auto schema = std::make_shared<DingoSchema<std::optional<T>>>();
+    schema->SetIndex(index);
+    schema->SetIsKey(is_key);
+    schema->SetAllowNull(allow_null);
+    return schema;
+  }
+
+  static std::string ToHex(const std::string& data) {
+    static const char* kHex = "0123456789abcdef";
+    std::string hex;
+    for (unsigned char c : data) {
+      hex.push_back(kHex[c >> 4]);
+      hex.push_back(kHex[c & 0xF]);
+    }
+    return hex;
+  }
+
+  // one column of every type, the key columns are memcomparable format
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> AllTypeSchemas() {
+    return std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(std::vector<std::shared_ptr<BaseSchema>>{
+        NewSchema<int32_t>(0, true, false),
+        NewSchema<int64_t>(1, true, true),
+        NewSchema<float>(2, true, false),
+        NewSchema<double>(3, true, true),
+        NewSchema<std::shared_ptr<std::string>>(4, true, false),
+        NewSchema<bool>(5, false, true),
+        NewSchema<int32_t>(6, false, true),
+        NewSchema<int64_t>(7, false, false),
+        NewSchema<float>(8, false, true),
+        NewSchema<double>(9, false, false),
+        NewSchema<std::shared_ptr<std::string>>(10, false, true),
+        NewSchema<std::shared_ptr<std::vector<bool>>>(11, false, true),
+        NewSchema<std::shared_ptr<std::vector<int32_t>>>(12, false, true),
+        NewSchema<std::shared_ptr<std::vector<float>>>(13, false, true),
+        NewSchema<std::shared_ptr<std::vector<int64_t>>>(14, false, true),
+        NewSchema<std::shared_ptr<std::vector<double>>>(15, false, true),
+        NewSchema<std::shared_ptr<std::vector<std::string>>>(16, false, true),
+        NewSchema<int64_t>(17, false, true),
+    });
+  }
+
+  static std::vector<std::any> AllTypeRecord(bool negative) {
+    int sign = negative ? -1 : 1;
+    return {
+        std::optional<int32_t>(sign * 123456),
+        std::optional<int64_t>(sign * 214748364700L),
+        std::optional<float>(sign * 1.25F),
+        std::optional<double>(sign * 873485.4234),
+        std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("key string over eight bytes")),
+        std::optional<bool>(!negative),
+        std::optional<int32_t>(sign * 20),
+        std::optional<int64_t>(sign * 1234567890123L),
+        std::optional<float>(sign * 3.5F),
+        std::optional<double>(sign * 0.125),
+        std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("value 测试")),
+        std::optional<std::shared_ptr<std::vector<bool>>>(std::make_shared<std::vector<bool>>(
+            std::vector<bool>{true, false, true})),
+        std::optional<std::shared_ptr<std::vector<int32_t>>>(std::make_shared<std::vector<int32_t>>(
+            std::vector<int32_t>{1, -2, 3})),
+        std::optional<std::shared_ptr<std::vector<float>>>(std::make_shared<std::vector<float>>(
+            std::vector<float>{1.5F, -2.5F})),
+        std::optional<std::shared_ptr<std::vector<int64_t>>>(std::make_shared<std::vector<int64_t>>(
+            std::vector<int64_t>{-1L, 1L << 40})),
+        std::optional<std::shared_ptr<std::vector<double>>>(std::make_shared<std::vector<double>>(
+            std::vector<double>{0.5, -0.25})),
+        std::optional<std::shared_ptr<std::vector<std::string>>>(std::make_shared<std::vector<std::string>>(
+            std::vector<std::string>{"a", "", "bcd"})),
+        std::optional<int64_t>(std::nullopt),
+    };
+  }
+};
+
+// The byte format must not change, the expected bytes are encoded by the byte by byte version of Buf.
+TEST_F(SerialFormatTest, Format) {
+  struct Case {
+    bool le;
+    bool negative;
+    std::string key;
+    std::string value;
+  };
+  std::vector<Case> cases = {
+      {true, false,
+       "7200000000000000658001e2400180000031ffffff9cbfa0000001c12aa81ad8c7e2826b65792073747269ff6e67206f76657220"
+       "ff6569676874206279ff7465730000000000fa2400000000000001",
+       "00000001010101000000140000011f71fb04cb01406000003fc0000000000000010000000c76616c756520e6b58be8af95010000"
+       "0003010001010000000300000001fffffffe0000000301000000023fc00000c02000000100000002ffffffffffffffff00000100"
+       "0000000001000000023fe0000000000000bfd0000000000000010000000300000001610000000000000003626364000000000000"
+       "000000"},
+      {true, true,
+       "7200000000000000657ffe1dc0017fffffce00000064405fffff013ed557e527381d7d6b65792073747269ff6e67206f76657220"
+       "ff6569676874206279ff7465730000000000fa2400000000000001",
+       "00000001010001ffffffecfffffee08e04fb3501c0600000bfc0000000000000010000000c76616c756520e6b58be8af95010000"
+       "0003010001010000000300000001fffffffe0000000301000000023fc00000c02000000100000002ffffffffffffffff00000100"
+       "0000000001000000023fe0000000000000bfd0000000000000010000000300000001610000000000000003626364000000000000"
+       "000000"},
+      {false, false,
+       "726500000000000000c0e20100011cffffff31000000bfa000000102e2c7d81aa82a416b65792073747269ff6e67206f76657220"
+       "ff6569676874206279ff7465730000000000fa0000002400000001",
+       "0100000001010114000000cb04fb711f0100000140600000000000000000c03f010c00000076616c756520e6b58be8af95010300"
+       "0000010001010300000001000000feffffff0300000001020000003fc00000c02000000102000000ffffffffffffffff00000000"
+       "000100000102000000000000000000e03f000000000000d0bf010300000001000000610000000003000000626364000000000000"
+       "000000"},
+      {false, true,
+       "726500000000000000401dfeff01e4000000ceffffff405fffff017d1d3827e557d53e6b65792073747269ff6e67206f76657220"
+       "ff6569676874206279ff7465730000000000fa0000002400000001",
+       "01000000010001ecffffff35fb048ee0feffff01c0600000000000000000c0bf010c00000076616c756520e6b58be8af95010300"
+       "0000010001010300000001000000feffffff0300000001020000003fc00000c02000000102000000ffffffffffffffff00000000"
+       "000100000102000000000000000000e03f000000000000d0bf010300000001000000610000000003000000626364000000000000"
+       "000000"},
+  };
+
+  auto schemas = AllTypeSchemas();
+  for (const auto& c : cases) {
+    RecordEncoder encoder(1, schemas, kCommonId, c.le);
+    std::string key;
+    std::string value;
+    ASSERT_EQ(0, encoder.Encode(AllTypeRecord(c.negative), key, value));
+    EXPECT_EQ(c.key, ToHex(key));
+    EXPECT_EQ(c.value, ToHex(value));
+  }
+}
+
+TEST_F(SerialFormatTest, EncodeDecode) {
+  for (bool le : {true, false}) {
+    for (bool negative : {false, true}) {
+      auto schemas = AllTypeSchemas();
+      RecordEncoder encoder(1, schemas, kCommonId, le);
+      RecordDecoder decoder(1, schemas, kCommonId, le);
+      std::string key;
+      std::string value;
+      ASSERT_EQ(0, encoder.Encode(AllTypeRecord(negative), key, value));
+
+      std::vector<std::any> record;
+      ASSERT_EQ(0, decoder.Decode(key, value, record));
+      std::string other_key;
+      std::string other_value;
+      ASSERT_EQ(0, encoder.Encode(record, other_key, other_value));
+      EXPECT_EQ(key, other_key);
+      EXPECT_EQ(value, other_value);
+    }
+  }
+}
+
+}  // namespace dingodb
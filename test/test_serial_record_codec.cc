@@ -0,0 +1,205 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <serial/record_codec.h>
+#include <serial/record_encoder.h>
+#include <serial/record_view.h>
+
+#include <any>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {  // NOLINT
+
+class RecordCodecTest : public testing::Test {
+ protected:
+  static const long kCommonId = 202;
+
+  template <typename T>
+  static std::shared_ptr<BaseSchema> NewSchema(int index, bool is_key, bool allow_null) {
+    auto schema = std::make_shared<DingoSchema<std::optional<T>>>();
+    schema->SetIndex(index);
+    schema->SetIsKey(is_key);
+    schema->SetAllowNull(allow_null);
+    return schema;
+  }
+
+  // fixed size keys before the string key, value columns before and after a string column
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> NewSchemas() {
+    return std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(std::vector<std::shared_ptr<BaseSchema>>{
+        NewSchema<int32_t>(0, true, false),
+        NewSchema<int64_t>(1, true, true),
+        NewSchema<float>(2, true, false),
+        NewSchema<double>(3, true, true),
+        NewSchema<std::shared_ptr<std::string>>(4, true, false),
+        NewSchema<int32_t>(5, true, false),
+        NewSchema<bool>(6, false, true),
+        NewSchema<int64_t>(7, false, false),
+        NewSchema<std::shared_ptr<std::string>>(8, false, true),
+        NewSchema<double>(9, false, true),
+        NewSchema<float>(10, false, false),
+    });
+  }
+
+  static std::vector<std::any> NewRecord(int sign) {
+    return {
+        std::optional<int32_t>(sign * 123456),
+        std::optional<int64_t>(sign * 214748364700L),
+        std::optional<float>(sign * 1.25F),
+        std::optional<double>(std::nullopt),
+        std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("key string over eight bytes")),
+        std::optional<int32_t>(sign * 7),
+        std::optional<bool>(sign > 0),
+        std::optional<int64_t>(sign * 1234567890123L),
+        std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("value")),
+        std::optional<double>(sign * 0.125),
+        std::optional<float>(sign * 2.5F),
+    };
+  }
+};
+
+TEST_F(RecordCodecTest, Plan) {
+  RecordCodec codec(1, NewSchemas(), kCommonId, true);
+  const auto& columns = codec.Columns();
+  ASSERT_EQ(11, columns.size());
+
+  // key: |namespace|common id|int|null tag|long|float|null tag|double|string ...
+  EXPECT_EQ(9, columns[0].offset);
+  EXPECT_EQ(13, columns[1].offset);
+  EXPECT_EQ(22, columns[2].offset);
+  EXPECT_EQ(26, columns[3].offset);
+  EXPECT_EQ(35, columns[4].offset);
+  EXPECT_EQ(-1, columns[5].offset);
+
+  // value: |schema version|null tag|bool|long|string ...
+  EXPECT_EQ(4, columns[6].offset);
+  EXPECT_EQ(2, columns[6].length);
+  EXPECT_EQ(6, columns[7].offset);
+  EXPECT_EQ(14, columns[8].offset);
+  EXPECT_EQ(0, columns[8].length);
+  EXPECT_EQ(-1, columns[9].offset);
+  EXPECT_EQ(-1, columns[10].offset);
+
+  EXPECT_TRUE(codec.Match(*NewSchemas()));
+  auto other_schemas = NewSchemas();
+  other_schemas->at(9) = NewSchema<double>(9, false, false);
+  EXPECT_FALSE(codec.Match(*other_schemas));
+}
+
+TEST_F(RecordCodecTest, ReadKeyInPlace) {
+  for (bool le : {true, false}) {
+    for (int sign : {1, -1}) {
+      RecordEncoder encoder(1, NewSchemas(), kCommonId, le);
+      std::string key;
+      std::string value;
+      ASSERT_EQ(0, encoder.Encode(NewRecord(sign), key, value));
+
+      RecordView view(1, NewSchemas(), kCommonId, le);
+      ASSERT_EQ(0, view.Reset(key, value));
+      EXPECT_EQ(sign * 123456, view.Get<int32_t>(0));
+      EXPECT_EQ(sign * 214748364700L, view.Get<int64_t>(1));
+      EXPECT_EQ(sign * 1.25F, view.Get<float>(2));
+      EXPECT_FALSE(view.Get<double>(3).has_value());
+      EXPECT_EQ("key string over eight bytes", view.GetString(4));
+      // after the string key, decoded by the decoder
+      EXPECT_EQ(sign * 7, view.Get<int32_t>(5));
+      EXPECT_EQ(sign > 0, view.Get<bool>(6));
+      EXPECT_EQ(sign * 1234567890123L, view.Get<int64_t>(7));
+      EXPECT_EQ("value", view.GetString(8));
+      EXPECT_EQ(sign * 0.125, view.Get<double>(9));
+      // float is encoded in the default byte order of its schema
+      EXPECT_EQ(sign * 2.5F, view.Get<float>(10));
+    }
+  }
+}
+
+TEST_F(RecordCodecTest, Cache) {
+  auto codec = RecordCodec::Get(1, NewSchemas(), kCommonId);
+  EXPECT_EQ(codec, RecordCodec::Get(1, NewSchemas(), kCommonId));
+  EXPECT_NE(codec, RecordCodec::Get(2, NewSchemas(), kCommonId));
+
+  // the schemas is changed without a new version
+  auto other_schemas = NewSchemas();
+  other_schemas->at(9) = NewSchema<double>(9, false, false);
+  auto other_codec = RecordCodec::Get(1, other_schemas, kCommonId);
+  EXPECT_NE(codec, other_codec);
+  EXPECT_EQ(other_codec, RecordCodec::Get(1, other_schemas, kCommonId));
+
+  // the caller clear the schemas, like Coprocessor::Close
+  auto schemas = NewSchemas();
+  auto cleared_codec = RecordCodec::Get(1, schemas, kCommonId + 1);
+  schemas->clear();
+  EXPECT_EQ(11, cleared_codec->Schemas()->size());
+}
+
+// Read the value columns of a wide row, compare the compiled view with the decoder.
+TEST_F(RecordCodecTest, Benchmark) {
+  const int column_count = 32;
+  const int record_count = 10000;
+
+  auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  schemas->push_back(NewSchema<int64_t>(0, true, false));
+  std::vector<std::any> record;
+  record.emplace_back(std::optional<int64_t>(1));
+  for (int i = 1; i < column_count; i++) {
+    schemas->push_back(NewSchema<int64_t>(i, false, true));
+    record.emplace_back(std::optional<int64_t>(i * 1000));
+  }
+
+  RecordEncoder encoder(1, schemas, kCommonId);
+  std::string key;
+  std::string value;
+  ASSERT_EQ(0, encoder.Encode(record, key, value));
+
+  // the last columns of the row
+  std::vector<int> column_indexes = {0, column_count - 2, column_count - 1};
+
+  RecordDecoder decoder(1, schemas, kCommonId);
+  std::vector<std::any> decoded;
+  int64_t decoder_sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < record_count; i++) {
+    ASSERT_EQ(0, decoder.Decode(key, value, column_indexes, decoded));
+    for (const auto& column : decoded) {
+      decoder_sum += std::any_cast<std::optional<int64_t>>(column).value();
+    }
+  }
+  auto decoder_cost =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RecordView view(RecordCodec::Get(1, schemas, kCommonId));
+  int64_t view_sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < record_count; i++) {
+    ASSERT_EQ(0, view.Reset(key, value));
+    for (int index : column_indexes) {
+      view_sum += view.Get<int64_t>(index).value();
+    }
+  }
+  auto view_cost =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(decoder_sum, view_sum);
+  std::cout << "decoder: " << decoder_cost / record_count << "ns/record compiled view: " << view_cost / record_count
+            << "ns/record" << std::endl;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <serial/record_decoder.h>
+#include <serial/record_encoder.h>
+#include <serial/record_view.h>
+
+#include <any>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serial/schema/base_schema.h"
+
+namespace dingodb {  // NOLINT
+
+class RecordViewTest : public testing::Test {
+ protected:
+  static const long kCommonId = 101;
+
+  template <typename T>
+  static std::shared_ptr<BaseSchema> NewSchema(int index, bool is_key, bool allow_null) {
+    auto schema = std::make_shared<DingoSchema<std::optional<T>>>();
+    schema->SetIndex(index);
+    schema->SetIsKey(is_key);
+    schema->SetAllowNull(allow_null);
+    return schema;
+  }
+
+  // id, name are key, the others are value
+  static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> NewSchemas(int column_count) {
+    std::vector<std::shared_ptr<BaseSchema>> schemas = {
+        NewSchema<int32_t>(0, true, false),
+        NewSchema<std::shared_ptr<std::string>>(1, true, false),
+        NewSchema<std::shared_ptr<std::string>>(2, false, true),
+        NewSchema<bool>(3, false, false),
+        NewSchema<int32_t>(4, false, true),
+        NewSchema<int32_t>(5, false, false),
+        NewSchema<int64_t>(6, false, false),
+        NewSchema<double>(7, false, true),
+        NewSchema<float>(8, false, false),
+        NewSchema<std::shared_ptr<std::vector<std::string>>>(9, false, true),
+    };
+    schemas.resize(column_count);
+    return std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>(schemas);
+  }
+
+  static std::vector<std::any> NewRecord() {
+    std::vector<std::any> record(10);
+    record[0] = std::optional<int32_t>(7);
+    record[1] = std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("tn"));
+    record[2] = std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("test address 测试"));
+    record[3] = std::optional<bool>(true);
+    record[4] = std::optional<int32_t>(std::nullopt);
+    record[5] = std::optional<int32_t>(-20);
+    record[6] = std::optional<int64_t>(-214748364700L);
+    record[7] = std::optional<double>(873485.4234);
+    record[8] = std::optional<float>(1.5F);
+    record[9] = std::optional<std::shared_ptr<std::vector<std::string>>>(
+        std::make_shared<std::vector<std::string>>(std::vector<std::string>{"a", "", "bcd"}));
+    return record;
+  }
+
+  static void Encode(int column_count, bool column_offset, std::string& key, std::string& value) {
+    RecordEncoder encoder(1, NewSchemas(column_count), kCommonId);
+    encoder.EnableColumnOffset(column_offset);
+    std::vector<std::any> record = NewRecord();
+    record.resize(column_count);
+    EXPECT_EQ(0, encoder.Encode(record, key, value));
+  }
+
+  // visit the columns in reverse order, the old format locate the columns at the first access
+  static void CheckRecord(RecordView& view) {
+    auto tags = std::any_cast<std::optional<std::shared_ptr<std::vector<std::string>>>>(view.GetAny(9));
+    ASSERT_TRUE(tags.has_value());
+    EXPECT_EQ(std::vector<std::string>({"a", "", "bcd"}), *tags.value());
+    EXPECT_EQ(1.5F, view.Get<float>(8));
+    EXPECT_EQ(873485.4234, view.Get<double>(7));
+    EXPECT_EQ(-214748364700L, view.Get<int64_t>(6));
+    EXPECT_EQ(-20, view.Get<int32_t>(5));
+    EXPECT_FALSE(view.Get<int32_t>(4).has_value());
+    EXPECT_EQ(true, view.Get<bool>(3));
+    EXPECT_EQ("test address 测试", view.GetString(2));
+    EXPECT_EQ("tn", view.GetString(1));
+    EXPECT_EQ(7, view.Get<int32_t>(0));
+  }
+};
+
+TEST_F(RecordViewTest, OldFormat) {
+  std::string key;
+  std::string value;
+  Encode(10, false, key, value);
+
+  RecordView view(1, NewSchemas(10), kCommonId);
+  ASSERT_EQ(0, view.Reset(key, value));
+  CheckRecord(view);
+
+  // same as the decoder
+  RecordDecoder decoder(1, NewSchemas(10), kCommonId);
+  std::vector<std::any> record;
+  ASSERT_EQ(0, decoder.Decode(key, value, record));
+  ASSERT_EQ(0, view.Reset(key, value));
+  auto name = std::any_cast<std::optional<std::shared_ptr<std::string>>>(view.GetAny(2));
+  EXPECT_EQ(*std::any_cast<std::optional<std::shared_ptr<std::string>>>(record[2]).value(), *name.value());
+  EXPECT_EQ(std::any_cast<std::optional<int64_t>>(record[6]), std::any_cast<std::optional<int64_t>>(view.GetAny(6)));
+}
+
+TEST_F(RecordViewTest, ColumnOffset) {
+  std::string old_key;
+  std::string old_value;
+  Encode(10, false, old_key, old_value);
+
+  std::string key;
+  std::string value;
+  Encode(10, true, key, value);
+  EXPECT_EQ(old_key, key);
+  EXPECT_EQ(old_value.size() + 4 + 10 * 4, value.size());
+
+  RecordView view(1, NewSchemas(10), kCommonId);
+  ASSERT_EQ(0, view.Reset(key, value));
+  CheckRecord(view);
+
+  // the decoder skip the offset table
+  RecordDecoder decoder(1, NewSchemas(10), kCommonId);
+  std::vector<std::any> record;
+  ASSERT_EQ(0, decoder.Decode(key, value, std::vector<int>{5, 7, 9}, record));
+  EXPECT_EQ(-20, std::any_cast<std::optional<int32_t>>(record[0]));
+  EXPECT_EQ(873485.4234, std::any_cast<std::optional<double>>(record[1]));
+  EXPECT_EQ(3, std::any_cast<std::optional<std::shared_ptr<std::vector<std::string>>>>(record[2]).value()->size());
+}
+
+TEST_F(RecordViewTest, AddedColumn) {
+  for (bool column_offset : {false, true}) {
+    std::string key;
+    std::string value;
+    Encode(7, column_offset, key, value);
+
+    // columns added after the record is written are null
+    RecordView view(2, NewSchemas(10), kCommonId);
+    ASSERT_EQ(0, view.Reset(key, value));
+    EXPECT_FALSE(view.Get<float>(8).has_value());
+    EXPECT_FALSE(view.Get<double>(7).has_value());
+    EXPECT_EQ(-214748364700L, view.Get<int64_t>(6));
+    EXPECT_FALSE(std::any_cast<std::optional<std::shared_ptr<std::vector<std::string>>>>(view.GetAny(9)).has_value());
+  }
+}
+
+TEST_F(RecordViewTest, WrongRecord) {
+  std::string key;
+  std::string value;
+  Encode(10, true, key, value);
+
+  RecordView other_table(1, NewSchemas(10), kCommonId + 1);
+  EXPECT_EQ(-1, other_table.Reset(key, value));
+
+  // record of newer schema
+  RecordView old_schema(0, NewSchemas(10), kCommonId);
+  EXPECT_EQ(-1, old_schema.Reset(key, value));
+
+  RecordView view(1, NewSchemas(10), kCommonId);
+  EXPECT_EQ(-1, view.Reset(key, value.substr(0, 2)));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,286 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/raft.pb.h"
+#include "proto/store.pb.h"
+
+DECLARE_bool(enable_txn_one_pc);
+
+namespace dingodb {  // NOLINT
+
+static const std::vector<std::string> kTxnCFs = {Constant::kTxnDataCF, Constant::kTxnLockCF, Constant::kTxnWriteCF};
+
+const std::string kRootPath = "./unit_test_txn_engine_helper";
+const std::string kStorePath = kRootPath + "/db";
+
+const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "log:\n"
+    "  path: " +
+    kRootPath +
+    "/log\n"
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+class TxnEngineHelperTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kStorePath);
+
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kYamlConfigContent));
+
+    engine = std::make_shared<RawRocksEngine>();
+    ASSERT_TRUE(engine->Init(config, kTxnCFs));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  // A committed put, as DoTxnCommit writes it.
+  static void Commit(const std::string& key, const std::string& value, int64_t start_ts, int64_t commit_ts,
+                     bool inline_value) {
+    auto writer = engine->Writer();
+
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(pb::store::Op::Put);
+    if (inline_value) {
+      write_info.set_short_value(value);
+    } else {
+      pb::common::KeyValue data_kv;
+      data_kv.set_key(Helper::EncodeTxnKey(key, start_ts));
+      data_kv.set_value(value);
+      ASSERT_TRUE(writer->KvPut(Constant::kTxnDataCF, data_kv).ok());
+    }
+
+    pb::common::KeyValue write_kv;
+    write_kv.set_key(Helper::EncodeTxnKey(key, commit_ts));
+    write_kv.set_value(write_info.SerializeAsString());
+    ASSERT_TRUE(writer->KvPut(Constant::kTxnWriteCF, write_kv).ok());
+  }
+
+  static std::shared_ptr<RawRocksEngine> engine;
+};
+
+std::shared_ptr<RawRocksEngine> TxnEngineHelperTest::engine = nullptr;
+
+// The values inlined in write cf, in data cf and the empty value are all read back.
+TEST_F(TxnEngineHelperTest, ShortValue) {
+  Commit("sv_inline", std::string(100, 'a'), 100, 101, true);
+  Commit("sv_data", std::string(1000, 'b'), 100, 101, false);
+  Commit("sv_empty", "", 100, 101, false);
+
+  std::vector<std::string> keys = {"sv_inline", "sv_data", "sv_empty"};
+  std::vector<pb::common::KeyValue> kvs;
+  pb::store::TxnResultInfo txn_result_info;
+  auto status =
+      TxnEngineHelper::BatchGet(engine, pb::store::IsolationLevel::SnapshotIsolation, 200, keys, kvs, txn_result_info);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(3, kvs.size());
+  EXPECT_EQ("sv_inline", kvs[0].key());
+  EXPECT_EQ(std::string(100, 'a'), kvs[0].value());
+  EXPECT_EQ("sv_data", kvs[1].key());
+  EXPECT_EQ(std::string(1000, 'b'), kvs[1].value());
+  EXPECT_EQ("sv_empty", kvs[2].key());
+  EXPECT_TRUE(kvs[2].value().empty());
+
+  pb::common::Range range;
+  range.set_start_key("sv_");
+  range.set_end_key("sv_z");
+  kvs.clear();
+  bool has_more = false;
+  std::string end_key;
+  status = TxnEngineHelper::Scan(engine, pb::store::IsolationLevel::SnapshotIsolation, 200, range, 10, false, false,
+                                 txn_result_info, kvs, has_more, end_key);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(3, kvs.size());
+  EXPECT_EQ("sv_data", kvs[0].key());
+  EXPECT_EQ(std::string(1000, 'b'), kvs[0].value());
+  EXPECT_EQ("sv_empty", kvs[1].key());
+  EXPECT_TRUE(kvs[1].value().empty());
+  EXPECT_EQ("sv_inline", kvs[2].key());
+  EXPECT_EQ(std::string(100, 'a'), kvs[2].value());
+  EXPECT_FALSE(has_more);
+}
+
+// The key which is the prefix of another key sorts after it in write cf, as the version is appended to the key.
+TEST_F(TxnEngineHelperTest, BatchGetPrefixKey) {
+  Commit("pk_a", "value_a", 100, 101, true);
+  Commit("pk_ab", "value_ab", 100, 101, false);
+  Commit("pk_abc", "value_abc", 100, 101, true);
+
+  for (auto isolation_level :
+       {pb::store::IsolationLevel::SnapshotIsolation, pb::store::IsolationLevel::ReadCommitted}) {
+    std::vector<std::string> keys = {"pk_abc", "pk_a", "pk_ab", "pk_a"};
+    std::vector<pb::common::KeyValue> kvs;
+    pb::store::TxnResultInfo txn_result_info;
+    auto status = TxnEngineHelper::BatchGet(engine, isolation_level, 200, keys, kvs, txn_result_info);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    ASSERT_EQ(4, kvs.size());
+    EXPECT_EQ("pk_abc", kvs[0].key());
+    EXPECT_EQ("value_abc", kvs[0].value());
+    EXPECT_EQ("pk_a", kvs[1].key());
+    EXPECT_EQ("value_a", kvs[1].value());
+    EXPECT_EQ("pk_ab", kvs[2].key());
+    EXPECT_EQ("value_ab", kvs[2].value());
+    EXPECT_EQ("pk_a", kvs[3].key());
+    EXPECT_EQ("value_a", kvs[3].value());
+  }
+}
+
+TEST_F(TxnEngineHelperTest, BatchGetInvalidIsolationLevel) {
+  std::vector<std::string> keys = {"pk_a"};
+  std::vector<pb::common::KeyValue> kvs;
+  pb::store::TxnResultInfo txn_result_info;
+  auto status = TxnEngineHelper::BatchGet(engine, pb::store::IsolationLevel::InvalidIsolationLevel, 200, keys, kvs,
+                                          txn_result_info);
+  EXPECT_EQ(pb::error::Errno::EILLEGAL_PARAMTETERS, status.error_code());
+  EXPECT_TRUE(kvs.empty());
+}
+
+TEST_F(TxnEngineHelperTest, CanOnePcCommit) {
+  pb::store::TxnPrewriteResponse response;
+  EXPECT_TRUE(TxnEngineHelper::CanOnePcCommit(response, 2, 2));
+  // a mutation without lock, e.g. the key of PutIfAbsent is written by the txn itself
+  EXPECT_FALSE(TxnEngineHelper::CanOnePcCommit(response, 2, 1));
+
+  FLAGS_enable_txn_one_pc = false;
+  EXPECT_FALSE(TxnEngineHelper::CanOnePcCommit(response, 2, 2));
+  FLAGS_enable_txn_one_pc = true;
+
+  // the existed key of PutIfAbsent falls back to 2PC
+  response.add_keys_already_exist()->set_key("key1");
+  EXPECT_FALSE(TxnEngineHelper::CanOnePcCommit(response, 2, 2));
+
+  response.Clear();
+  response.add_txn_result()->mutable_locked()->set_key("key1");
+  EXPECT_FALSE(TxnEngineHelper::CanOnePcCommit(response, 2, 2));
+}
+
+TEST_F(TxnEngineHelperTest, IsOnePcCommitTsValid) {
+  EXPECT_TRUE(TxnEngineHelper::IsOnePcCommitTsValid(100, 0, 101));
+  EXPECT_TRUE(TxnEngineHelper::IsOnePcCommitTsValid(100, 200, 200));
+  EXPECT_FALSE(TxnEngineHelper::IsOnePcCommitTsValid(100, 0, 100));
+  EXPECT_FALSE(TxnEngineHelper::IsOnePcCommitTsValid(100, 0, 99));
+  // commit_ts is beyond max_commit_ts, falls back to 2PC
+  EXPECT_FALSE(TxnEngineHelper::IsOnePcCommitTsValid(100, 200, 201));
+}
+
+// The 1PC write is read as the commit of the prewrite at commit_ts.
+TEST_F(TxnEngineHelperTest, OnePcWrite) {
+  const int64_t start_ts = 300;
+  const int64_t commit_ts = 310;
+
+  auto gen_lock_info = [](const std::string& key, pb::store::Op op, int64_t for_update_ts) {
+    pb::store::LockInfo lock_info;
+    lock_info.set_primary_lock("op_inline");
+    lock_info.set_key(key);
+    lock_info.set_lock_ts(start_ts);
+    lock_info.set_for_update_ts(for_update_ts);
+    lock_info.set_lock_type(op);
+    return lock_info;
+  };
+
+  Commit("op_delete", "old_value", 100, 101, true);
+  Commit("op_exist", "exist_value", 100, 101, true);
+
+  // the pessimistic lock of the txn which is flushed to lock cf
+  auto pessimistic_lock = gen_lock_info("op_exist", pb::store::Op::Lock, 305);
+  pb::common::KeyValue lock_kv;
+  lock_kv.set_key(Helper::EncodeTxnKey(std::string("op_exist"), Constant::kLockVer));
+  lock_kv.set_value(pessimistic_lock.SerializeAsString());
+  ASSERT_TRUE(engine->Writer()->KvPut(Constant::kTxnLockCF, lock_kv).ok());
+  // the lock left by an earlier optimistic prewrite of the txn
+  auto prewrite_lock = gen_lock_info("op_data", pb::store::Op::Put, 0);
+  lock_kv.set_key(Helper::EncodeTxnKey(std::string("op_data"), Constant::kLockVer));
+  lock_kv.set_value(prewrite_lock.SerializeAsString());
+  ASSERT_TRUE(engine->Writer()->KvPut(Constant::kTxnLockCF, lock_kv).ok());
+
+  std::vector<pb::store::LockInfo> lock_infos;
+  lock_infos.push_back(gen_lock_info("op_inline", pb::store::Op::Put, 0));
+  lock_infos.back().set_short_value("inline_value");
+  lock_infos.push_back(gen_lock_info("op_data", pb::store::Op::Put, 0));
+  lock_infos.push_back(gen_lock_info("op_delete", pb::store::Op::Delete, 0));
+  lock_infos.push_back(gen_lock_info("op_exist", pb::store::Op::PutIfAbsent, 305));
+
+  std::vector<pb::common::KeyValue> kv_puts_data(1);
+  kv_puts_data[0].set_key(Helper::EncodeTxnKey(std::string("op_data"), start_ts));
+  kv_puts_data[0].set_value("data_value");
+
+  pb::raft::MultiCfPutAndDeleteRequest request;
+  TxnEngineHelper::GenOnePcWrite(lock_infos, kv_puts_data, start_ts, commit_ts, request);
+
+  std::map<std::string, std::vector<pb::common::KeyValue>> kv_puts_with_cf;
+  std::map<std::string, std::vector<std::string>> kv_deletes_with_cf;
+  for (const auto& puts : request.puts_with_cf()) {
+    kv_puts_with_cf[puts.cf_name()].assign(puts.kvs().begin(), puts.kvs().end());
+  }
+  for (const auto& dels : request.deletes_with_cf()) {
+    kv_deletes_with_cf[dels.cf_name()].assign(dels.keys().begin(), dels.keys().end());
+  }
+  EXPECT_EQ(3, kv_puts_with_cf[Constant::kTxnWriteCF].size());
+  EXPECT_EQ(4, kv_deletes_with_cf[Constant::kTxnLockCF].size());
+  ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf).ok());
+
+  std::vector<std::string> keys = {"op_inline", "op_data", "op_delete", "op_exist"};
+  std::vector<pb::common::KeyValue> kvs;
+  pb::store::TxnResultInfo txn_result_info;
+  auto status = TxnEngineHelper::BatchGet(engine, pb::store::IsolationLevel::SnapshotIsolation, commit_ts, keys, kvs,
+                                          txn_result_info);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(4, kvs.size());
+  EXPECT_EQ("inline_value", kvs[0].value());
+  EXPECT_EQ("data_value", kvs[1].value());
+  EXPECT_TRUE(kvs[2].value().empty());
+  EXPECT_EQ("exist_value", kvs[3].value());
+  // the flushed pessimistic lock and the prewrite lock are deleted
+  EXPECT_EQ(0, txn_result_info.ByteSizeLong());
+
+  // not visible before commit_ts
+  kvs.clear();
+  status = TxnEngineHelper::BatchGet(engine, pb::store::IsolationLevel::SnapshotIsolation, commit_ts - 1, keys, kvs,
+                                     txn_result_info);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  ASSERT_EQ(4, kvs.size());
+  EXPECT_TRUE(kvs[0].value().empty());
+  EXPECT_TRUE(kvs[1].value().empty());
+  EXPECT_EQ("old_value", kvs[2].value());
+  EXPECT_EQ("exist_value", kvs[3].value());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "common/helper.h"
+#include "engine/txn_engine_helper.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {  // NOLINT
+
+class TxnGcCheckerTest : public testing::Test {
+ protected:
+  static std::string GenWriteValue(int64_t start_ts, pb::store::Op op, const std::string& short_value = "") {
+    pb::store::WriteInfo write_info;
+    write_info.set_start_ts(start_ts);
+    write_info.set_op(op);
+    if (!short_value.empty()) {
+      write_info.set_short_value(short_value);
+    }
+    return write_info.SerializeAsString();
+  }
+
+  static bool IsGarbage(TxnGcChecker& checker, const std::string& key, int64_t commit_ts, int64_t start_ts,
+                        pb::store::Op op, std::string& data_key, const std::string& short_value = "") {
+    return checker.IsGarbage(Helper::EncodeTxnKey(key, commit_ts), GenWriteValue(start_ts, op, short_value),
+                             data_key);
+  }
+};
+
+TEST_F(TxnGcCheckerTest, KeepLatestVersion) {
+  TxnGcChecker checker(100);
+  std::string data_key;
+
+  // newer than safe point
+  EXPECT_FALSE(IsGarbage(checker, "key1", 120, 110, pb::store::Op::Put, data_key));
+  // rollback before the latest version
+  EXPECT_TRUE(IsGarbage(checker, "key1", 95, 95, pb::store::Op::Rollback, data_key));
+  EXPECT_TRUE(data_key.empty());
+  // the latest version at safe point
+  EXPECT_FALSE(IsGarbage(checker, "key1", 90, 80, pb::store::Op::Put, data_key));
+  // old versions
+  EXPECT_TRUE(IsGarbage(checker, "key1", 70, 60, pb::store::Op::Put, data_key));
+  EXPECT_EQ(Helper::EncodeTxnKey(std::string("key1"), 60), data_key);
+  EXPECT_TRUE(IsGarbage(checker, "key1", 50, 40, pb::store::Op::Put, data_key, "v"));
+  EXPECT_TRUE(data_key.empty());
+
+  // next key
+  EXPECT_FALSE(IsGarbage(checker, "key2", 50, 40, pb::store::Op::Delete, data_key));
+  EXPECT_TRUE(IsGarbage(checker, "key2", 30, 20, pb::store::Op::Put, data_key));
+  EXPECT_EQ(Helper::EncodeTxnKey(std::string("key2"), 20), data_key);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,110 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/txn_latches.h"
+
+namespace dingodb {  // NOLINT
+
+class TxnLatchesTest : public testing::Test {};
+
+TEST_F(TxnLatchesTest, GenSlots) {
+  TxnLatches latches(16);
+  auto slots = latches.GenSlots({"key3", "key1", "key2", "key1"});
+  EXPECT_TRUE(std::is_sorted(slots.begin(), slots.end()));
+  EXPECT_EQ(slots.end(), std::adjacent_find(slots.begin(), slots.end()));
+  EXPECT_LE(slots.size(), 3);
+  for (auto slot : slots) {
+    EXPECT_LT(slot, 16);
+  }
+
+  EXPECT_TRUE(latches.GenSlots({}).empty());
+}
+
+TEST_F(TxnLatchesTest, Conflict) {
+  TxnLatches latches(1024);
+  std::atomic<bool> acquired{false};
+
+  std::thread holder;
+  {
+    TxnLatchGuard guard(latches, {"key1", "key2"});
+    holder = std::thread([&]() {
+      TxnLatchGuard other_guard(latches, {"key2", "key3"});
+      acquired = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(acquired.load());
+  }
+
+  holder.join();
+  EXPECT_TRUE(acquired.load());
+}
+
+TEST_F(TxnLatchesTest, NoConflict) {
+  TxnLatches latches(1024);
+  auto slots1 = latches.GenSlots({"key1"});
+  auto slots2 = latches.GenSlots({"key2"});
+  if (slots1 == slots2) {
+    GTEST_SKIP() << "key1 and key2 are in the same slot";
+  }
+
+  TxnLatchGuard guard(latches, {"key1"});
+  std::atomic<bool> acquired{false};
+  std::thread other([&]() {
+    TxnLatchGuard other_guard(latches, {"key2"});
+    acquired = true;
+  });
+  other.join();
+  EXPECT_TRUE(acquired.load());
+}
+
+TEST_F(TxnLatchesTest, Fifo) {
+  TxnLatches latches(1024);
+  auto slots = latches.GenSlots({"key1"});
+
+  auto first = latches.GenCommandId();
+  latches.Acquire(slots, first);
+
+  std::vector<int64_t> order;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    auto command_id = latches.GenCommandId();
+    threads.emplace_back([&, command_id]() {
+      latches.Acquire(slots, command_id);
+      order.push_back(command_id);
+      latches.Release(slots, command_id);
+    });
+    // make the command queued before the next one
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  latches.Release(slots, first);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(4, order.size());
+  EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+}  // namespace dingodb